@@ -1,45 +1,287 @@
 import time
 import os
 import sys
+import threading
 import subprocess
 import tty
+from collections import deque
 from tenacity import retry, wait_fixed, stop_after_attempt
-import timeout_decorator
 from chipshouter import ChipSHOUTER
-from .USBUtils import find_usb_port_by_tty, find_tty_by_id
+from .simpleserial.deadline import Deadline
+from .USBUtils import find_usb_port_by_tty, find_usb_device
+from .errors import ArmFault, ArmingTimeoutError, ShouterFaultError
+
+
+class ChargeModel:
+    """
+    Online model of capacitor recharge time per pulse shape.
+
+    Recharge after a pulse depends on the voltage setpoint and the pulse
+    energy (width x repeats); a fixed inter-shot sleep either over-waits
+    or risks firing undercharged. The model keeps an exponentially
+    weighted mean of observed recharge times per (setpoint, width,
+    repeats) bucket, fed by wait_charge_ready's own measurements, and
+    predicts the residual recharge for the next shot so the wait can
+    sleep through most of it in one go instead of polling from zero.
+    export() serializes the fitted buckets for the results metadata.
+    """
+
+    # EWMA weight of a new observation; low enough to ride out single
+    # outliers (a slow serial read inflates one sample)
+    ALPHA = 0.2
+
+    def __init__(self):
+        self._buckets = {}
+        self._global_mean = None
+
+    @staticmethod
+    def _key(setpoint, width, repeats):
+        return (int(setpoint), int(width), int(repeats))
+
+    def observe(self, setpoint, width, repeats, recharge_s):
+        key = self._key(setpoint, width, repeats)
+        bucket = self._buckets.get(key)
+        if bucket is None:
+            self._buckets[key] = [recharge_s, 1]
+        else:
+            bucket[0] += self.ALPHA * (recharge_s - bucket[0])
+            bucket[1] += 1
+        if self._global_mean is None:
+            self._global_mean = recharge_s
+        else:
+            self._global_mean += self.ALPHA * (recharge_s - self._global_mean)
+
+    def predict(self, setpoint, width, repeats):
+        """Expected recharge time in seconds; the global mean covers
+        shapes not yet observed, 0.0 means no data at all."""
+        bucket = self._buckets.get(self._key(setpoint, width, repeats))
+        if bucket is not None:
+            return bucket[0]
+        return self._global_mean or 0.0
+
+    def export(self):
+        """Model parameters for the results metadata, so reproducibility
+        audits can verify the shots were charge-gated."""
+        return {
+            "alpha": self.ALPHA,
+            "buckets": {
+                f"{setpoint}V/{width}ns/x{repeats}": {
+                    "mean_ms": round(mean * 1000, 3),
+                    "samples": samples,
+                }
+                for (setpoint, width, repeats), (mean, samples)
+                in sorted(self._buckets.items())
+            },
+        }
+
+
+class HeatingModel:
+    """
+    Online model of coil heating per execution batch and pulse shape.
+
+    The thermal monitor gates shooting once the coil trips, but the gate
+    is binary: a campaign mixing 400V and 150V configs sleeps through
+    cooldown windows the low-voltage work could have filled. The model
+    estimates the temperature rise one execution batch of a given
+    (setpoint, width, repeats) shape causes, fed by before/after samples
+    of the monitor's hottest sensor, so the scheduler can ask "which
+    pending work still fits in the remaining headroom" instead of
+    waiting (see PriorityScheduler.pop and run_campaign_prioritized).
+
+    Shapes without observations are ranked by their pulse-energy proxy
+    (setpoint^2 x width x repeats - capacitor energy goes with V^2)
+    scaled by a coefficient fitted across all observed shapes, so a
+    never-run 400V config is ordered above an observed 200V one from the
+    first pop.
+    """
+
+    ALPHA = ChargeModel.ALPHA
+
+    def __init__(self):
+        self._buckets = {}
+        self._coefficient = None
+
+    @staticmethod
+    def _key(setpoint, width, repeats):
+        return (int(setpoint), int(width), int(repeats))
+
+    @staticmethod
+    def _energy(setpoint, width, repeats):
+        # Arbitrary-unit pulse-train energy proxy; only ratios matter
+        return setpoint * setpoint * width * repeats / 1e6
+
+    def observe(self, setpoint, width, repeats, delta_temp):
+        """Feed one batch's temperature rise in degC (hottest sensor
+        after minus before; negative means the batch net-cooled)."""
+        key = self._key(setpoint, width, repeats)
+        bucket = self._buckets.get(key)
+        if bucket is None:
+            self._buckets[key] = [delta_temp, 1]
+        else:
+            bucket[0] += self.ALPHA * (delta_temp - bucket[0])
+            bucket[1] += 1
+        energy = self._energy(setpoint, width, repeats)
+        if delta_temp > 0 and energy > 0:
+            ratio = delta_temp / energy
+            if self._coefficient is None:
+                self._coefficient = ratio
+            else:
+                self._coefficient += self.ALPHA * (ratio - self._coefficient)
+
+    def predict(self, setpoint, width, repeats):
+        """Expected degC rise of one batch; energy-scaled estimate for
+        shapes not yet observed, 0.0 with no data at all (the caller
+        then schedules as if heating were free, which only costs one
+        trip before observations exist)."""
+        bucket = self._buckets.get(self._key(setpoint, width, repeats))
+        if bucket is not None:
+            return max(0.0, bucket[0])
+        if self._coefficient is None:
+            return 0.0
+        return self._coefficient * self._energy(setpoint, width, repeats)
+
+    def export(self):
+        """Model parameters for the results metadata, alongside the
+        charge model's."""
+        return {
+            "alpha": self.ALPHA,
+            "energy_coefficient": self._coefficient,
+            "buckets": {
+                f"{setpoint}V/{width}ns/x{repeats}": {
+                    "mean_degc": round(mean, 3),
+                    "samples": samples,
+                }
+                for (setpoint, width, repeats), (mean, samples)
+                in sorted(self._buckets.items())
+            },
+        }
 
 
 class ChipShouter:
-    def __init__(self, tty_or_id="NewAE_ChipSHOUTER_Serial"):
+    # Re-assert armed at most every 30s: comfortably inside the
+    # ChipShouter's 60s auto-disarm timeout, cheap enough to not matter
+    KEEP_ARMED_REFRESH_S = 30.0
+
+    # Default staleness bound for mirrored status values (trigger_safe,
+    # state); temperatures change slowly and use a larger bound
+    STATUS_MAX_AGE_S = 1.0
+    TEMPS_MAX_AGE_S = 10.0
+
+    def __init__(self, tty_or_id="NewAE_ChipSHOUTER_Serial", warm_connect=True):
         self._tty_or_id=tty_or_id
 
-        # Find ChipShouter tty
+        # Keep-armed cache: once arm() succeeds, ensure_armed() trusts
+        # this flag and only re-asserts armed when the refresh is due,
+        # instead of querying state over serial before every shot.
+        self._armed_cached = False
+        self._last_arm_refresh = 0.0
+
+        # Voltage setpoint tracking (see set_voltage()): the last value
+        # known to be applied on the device, and a value waiting to be
+        # folded into the next arm() while disarmed. None = unknown.
+        self._voltage_applied = None
+        self._pending_voltage = None
+
+        # Serializes access to the ChipShouter tty: the thermal monitor
+        # thread samples temperatures concurrently with shot-path queries
+        self._serial_lock = threading.RLock()
+
+        # Thermal monitor state (see start_thermal_monitor)
+        self._thermal_thread = None
+        self._thermal_stop = threading.Event()
+        self._thermal_ready = True
+        self._thermal_resume_temp = 55
+        self._thermal_trip_temp = 65
+
+        # Recent (timestamp, hottest sensor) samples from the thermal
+        # monitor, for the cooldown slope estimate in clear_faults
+        self._temp_history = deque(maxlen=24)
+
+        # Background fault-clear state (see clear_faults_async)
+        self._fault_clear_thread = None
+        self._fault_clear_error = None
+
+        # Recharge-time model (see ChargeModel); the pulse shape of the
+        # active glitch config is fed in via note_pulse_shape
+        self.charge_model = ChargeModel()
+        self.heating_model = HeatingModel()
+        self._pulse_shape = (0, 0)
+
+        # Status mirror: field -> (value, monotonic timestamp). Serves
+        # the shot path from cache within a staleness bound instead of
+        # one serial roundtrip per query; invalidated on state changes.
+        self._status_cache = {}
+
+        # Find ChipShouter tty plus the USB hub_path and hub_port_num
+        # (used for power cycling with uhubctl)
+        self._hub_path = None
+        self._hub_port_num = None
         if tty_or_id.startswith("/dev/tty"):
             # If tty_or_id starts with /dev/tty check if the specified device exists
             if os.path.exists(tty_or_id):
                 self._tty = tty_or_id
             else:
                 raise FileNotFoundError(f"TTY device '{tty_or_id}' not found.")
+            try:
+                self._hub_path, self._hub_port_num = find_usb_port_by_tty(self._tty)
+            except Exception as e:
+                print(f"ChipShouter: {str(e)}")
         else:
-            # Else try to find tty by substring matching serial_ids (from /dev/serial/by-id)
+            # Else resolve by serial_id through the persistent topology
+            # cache, skipping the sysfs walk on reconnects and warm starts
             try:
-                self._tty = find_tty_by_id(tty_or_id)
+                self._tty, self._hub_path, self._hub_port_num = find_usb_device(tty_or_id)
             except Exception as e:
                 raise FileNotFoundError(f"ChipShouter USB: {str(e)}")
 
-        # Find ChipShouter USB hub_path and hub_port_num (used for power cycling with uhubctl)
-        try:
-            self._hub_path, self._hub_port_num = find_usb_port_by_tty(self._tty)
-        except Exception as e:
-            print(f"ChipShouter: {str(e)}")
+        if not (self._hub_path and self._hub_port_num):
             print("ChipShouter: USB Power cycling unavailable!")
 
-        # Initialize ChipShouter
+        # Initialize ChipShouter: keep a healthy session as-is instead of
+        # paying the ~5s reset on every profiler start and every
+        # __init__-based reconnect after a power cycle
         self.cs = ChipSHOUTER(self._tty)
-        self.reset() # takes about 5s
+        if not (warm_connect and self._warm_connect()):
+            self.reset() # takes about 5s
         print("Chipshouter connected!")
 
+    def _warm_connect(self):
+        """
+        Probe the device and keep the session when it is sane.
+
+        Reads state and faults_current; anything other than a clean
+        armed/disarmed answer (faults, garbage, serial timeout) returns
+        False so __init__ falls back to the full reset. On success only
+        the settings that are not already correct are rewritten.
+        """
+        try:
+            with self._serial_lock:
+                state = self.cs.state
+                faults = self.cs.faults_current
+        except Exception as e:
+            print(f"ChipShouter warm connect failed ({str(e)}), resetting")
+            return False
+
+        if state not in ("armed", "disarmed") or faults:
+            return False
+
+        # _last_arm_refresh stays 0 so the first ensure_armed() re-asserts
+        self._armed_cached = state == "armed"
+        self._apply_settings()
+        return True
+
+    def _apply_settings(self):
+        """Ensure absent_temp/mute, writing only values that differ (a
+        read costs one roundtrip, a write costs one plus device EEPROM
+        churn and the audible un-mute blip)."""
+        with self._serial_lock:
+            if self.cs.absent_temp != 60:
+                self.cs.absent_temp = 60
+            if not self.cs.mute:
+                self.cs.mute = True
+
     def disconnect(self):
+        self.stop_thermal_monitor()
         self.disarm()
         self.cs.disconnect()
         del self.cs
@@ -61,94 +303,477 @@ class ChipShouter:
 
     def reset(self):
         # Reset ChipShouter
-        self.cs.reset = True
+        self._armed_cached = False
+        self._voltage_applied = None  # reset reverts the setpoint
+        self._mirror_invalidate()
+        with self._serial_lock:
+            self.cs.reset = True
         # Wait till ChipShouter is reset and ready
         time.sleep(0.5)
 
-        self.cs.absent_temp = 60
-        self.cs.mute = True
+        # Post-reset the settings are at their defaults: write both in
+        # one burst, no read-compare roundtrips (unlike _apply_settings)
+        with self._serial_lock:
+            self.cs.absent_temp = 60
+            self.cs.mute = True
+
+    def cooldown_estimate_s(self, target_temp=None):
+        """
+        Predicted seconds until the hottest sensor reaches target_temp
+        (the thermal monitor's resume temperature by default), linearly
+        extrapolated from the monitor's recent sample history. Returns
+        None when the monitor has too little history or the coil is not
+        cooling (slope >= 0), and 0 when already at the target.
+        """
+        if target_temp is None:
+            target_temp = self._thermal_resume_temp
+        history = list(self._temp_history)
+        if len(history) < 2:
+            return None
+        (t_first, temp_first), (t_last, temp_last) = history[0], history[-1]
+        if temp_last <= target_temp:
+            return 0.0
+        span = t_last - t_first
+        if span <= 0:
+            return None
+        slope = (temp_last - temp_first) / span  # degC per second
+        if slope >= 0:
+            return None  # still heating or flat: no usable prediction
+        return (temp_last - target_temp) / -slope
 
     @retry(wait=wait_fixed(5), stop=stop_after_attempt(3))
-    def clear_faults(self):
-        print(f"Chipshouter faults: current={self.cs.faults_current}, latched={self.cs.faults_latched}. Clearing...")
+    def clear_faults(self, timeout_s=300):
+        self._armed_cached = False
+        self._voltage_applied = None  # fault handling may have changed it
+        self._mirror_invalidate()
+        with self._serial_lock:
+            print(f"Chipshouter faults: current={self.cs.faults_current}, latched={self.cs.faults_latched}. Clearing...")
 
         # This sometimes does not work (overtemp faults cannot be cleared even though this passes)
         # There might be additional temp sensors that are not available through ChipShouter python library
-        while self.temps_too_high():
-            print("Chipshouter Temp too high, waiting...")
-            time.sleep(10)
-
-        # Try to clear overtemp fault for 5 minutes
-        overtemp_clear_try = 1
-        overtemp_clear_max_tries = 30
-        while "fault_overtemp" in self.cs.faults_current and overtemp_clear_try < overtemp_clear_max_tries:
-            print("Trying to clear ChiShouter overtemp fault (try {overtemp_clear_try}/{overtemp_clear_max_tries})...")
-            self.cs.faults_current = 0
-            time.sleep(10)
-            overtemp_clear_try += 1
+        #
+        # Overtemp faults only clear once the coil has cooled, so instead
+        # of fixed 10s steps the wait is the thermal monitor's slope
+        # prediction when one is available, with exponential backoff as
+        # the fallback (and as a floor against over-optimistic slopes).
+        deadline = Deadline(timeout_s * 1000.0)
+        backoff_s = 1.0
+        while not deadline.expired():
+            if self.thermal_ready():
+                with self._serial_lock:
+                    self.cs.faults_current = 0
+                    overtemp = "fault_overtemp" in self.cs.faults_current
+                if not overtemp:
+                    break
+            estimate = self.cooldown_estimate_s()
+            if estimate is None:
+                wait_s = backoff_s
+            else:
+                wait_s = min(max(estimate, backoff_s), 60.0)
+            print(f"Chipshouter overtemp, waiting {wait_s:.0f}s"
+                  + ("" if estimate is None else " (slope estimate)"))
+            time.sleep(wait_s)
+            backoff_s = min(backoff_s * 2, 60.0)
 
         # Clear faults (also non-overtemp faults)
-        self.cs.faults_current = 0
-        # Raise error if faults persist
-        current = self.cs.faults_current
+        with self._serial_lock:
+            self.cs.faults_current = 0
+            # Raise error if faults persist
+            current = self.cs.faults_current
         if current:
-            raise RuntimeError(f"Failed to clear ChipSHOUTER faults: {current}!")
+            raise ShouterFaultError(f"Failed to clear ChipSHOUTER faults: {current}!")
+
+    def clear_faults_async(self):
+        """
+        Run clear_faults() in a background thread so the campaign keeps
+        going (skipping shots cheaply) while the hot coil recovers,
+        instead of blocking for up to the full cooldown. Idempotent: a
+        second call while a clear is pending returns immediately.
+        Completion is observable via fault_clear_pending(); a failure is
+        kept in _fault_clear_error and re-raised by the next call here.
+        """
+        if self._fault_clear_thread is not None and self._fault_clear_thread.is_alive():
+            return
+        if self._fault_clear_error is not None:
+            error = self._fault_clear_error
+            self._fault_clear_error = None
+            raise error
+
+        def run():
+            try:
+                self.clear_faults()
+            except Exception as e:
+                self._fault_clear_error = e
+
+        self._fault_clear_thread = threading.Thread(
+            target=run, name="cs-clear-faults", daemon=True)
+        self._fault_clear_thread.start()
+
+    def fault_clear_pending(self):
+        """True while a background clear_faults() is still running."""
+        return (self._fault_clear_thread is not None
+                and self._fault_clear_thread.is_alive())
+
+    def _mirror_read(self, field, reader, max_age=None):
+        """
+        Serve a status field from the mirror, refreshing over serial
+        only when the cached value is older than the staleness bound.
+        """
+        max_age = self.STATUS_MAX_AGE_S if max_age is None else max_age
+        cached = self._status_cache.get(field)
+        if cached is not None and time.monotonic() - cached[1] <= max_age:
+            return cached[0]
+        with self._serial_lock:
+            value = reader()
+        self._status_cache[field] = (value, time.monotonic())
+        return value
+
+    def _mirror_invalidate(self, *fields):
+        """Drop mirrored fields (all of them without arguments) after an
+        event that changes device state."""
+        if not fields:
+            self._status_cache.clear()
+        for field in fields:
+            self._status_cache.pop(field, None)
+
+    def read_temps(self, max_age=None):
+        """(diode, mosfet, xformer) temperatures, mirrored. The thermal
+        monitor keeps this fresh, so callers normally never hit serial."""
+        return self._mirror_read(
+            "temps",
+            lambda: (
+                self.cs.temperature_diode,
+                self.cs.temperature_mosfet,
+                self.cs.temperature_xformer,
+            ),
+            self.TEMPS_MAX_AGE_S if max_age is None else max_age,
+        )
 
-    def temps_too_high(self, threshold=65):
-        return any(temp > threshold for temp in [
-            self.cs.temperature_diode,
-            self.cs.temperature_mosfet,
-            self.cs.temperature_xformer,
-        ])
+    def temps_too_high(self, threshold=65, max_age=None):
+        return any(temp > threshold for temp in self.read_temps(max_age))
+
+    def trigger_safe(self, max_age=None):
+        """Cached trigger_safe check for the per-shot validation."""
+        return self._mirror_read("trigger_safe", lambda: self.cs.trigger_safe, max_age)
+
+    def state(self, max_age=None):
+        """Cached device state string (armed/disarmed/fault)."""
+        return self._mirror_read("state", lambda: self.cs.state, max_age)
+
+    def read_status(self, include_faults=False, max_age=0):
+        """
+        Consolidated status read: state, trigger_safe and the three
+        temperatures (plus faults_current on request) fetched
+        back-to-back under one lock acquisition and published into the
+        status mirror with a shared timestamp.
+
+        The chipshouter library only exposes per-field property reads,
+        so this is not a single wire transaction - but batching the
+        fields under one lock collapses the pre-shot checklist from
+        several scattered roundtrips (each separately contending with
+        the thermal monitor for the tty) into one sequence, after which
+        state(), trigger_safe() and the thermal gate are all served
+        from the warm mirror.
+
+        Args:
+            include_faults (bool, optional): Also read faults_current.
+                Defaults to False (it is the slowest query and only
+                relevant once state reports a fault).
+            max_age (float, optional): Serve the whole answer from the
+                mirror when every field is at most this old (seconds).
+                Defaults to 0 (always read).
+
+        Returns:
+            dict: {"state", "trigger_safe", "temps", "faults"} (faults
+                is None unless requested).
+        """
+        if max_age > 0 and not include_faults:
+            cutoff = time.monotonic() - max_age
+            cached = [self._status_cache.get(f) for f in
+                      ("state", "trigger_safe", "temps")]
+            if all(c is not None and c[1] >= cutoff for c in cached):
+                return {"state": cached[0][0], "trigger_safe": cached[1][0],
+                        "temps": cached[2][0], "faults": None}
+
+        with self._serial_lock:
+            state = self.cs.state
+            trigger_safe = self.cs.trigger_safe
+            temps = (
+                self.cs.temperature_diode,
+                self.cs.temperature_mosfet,
+                self.cs.temperature_xformer,
+            )
+            faults = self.cs.faults_current if include_faults else None
+
+        now = time.monotonic()
+        self._status_cache["state"] = (state, now)
+        self._status_cache["trigger_safe"] = (trigger_safe, now)
+        self._status_cache["temps"] = (temps, now)
+        return {"state": state, "trigger_safe": trigger_safe,
+                "temps": temps, "faults": faults}
+
+    def refresh_status(self):
+        """
+        Warm the status mirror with one consolidated read so the next
+        per-shot checklist (armed state, thermal gate, trigger_safe) is
+        served entirely from cache. Meant for overlap windows (while the
+        host waits on a target response); errors are swallowed here -
+        the per-shot path re-reads and raises itself.
+        """
+        try:
+            self.read_status()
+        except Exception:
+            pass
+
+    def _thermal_monitor_loop(self, interval, trip_temp, resume_temp):
+        while not self._thermal_stop.wait(interval):
+            try:
+                with self._serial_lock:
+                    temps = (
+                        self.cs.temperature_diode,
+                        self.cs.temperature_mosfet,
+                        self.cs.temperature_xformer,
+                    )
+            except Exception:
+                continue  # transient serial error: keep the last state
+
+            # Publish into the status mirror so temps_too_high() is free
+            now = time.monotonic()
+            self._status_cache["temps"] = (temps, now)
+            hottest = max(temps)
+            self._temp_history.append((now, hottest))
+
+            if self._thermal_ready:
+                if hottest > trip_temp:
+                    self._thermal_ready = False
+                    print(f"ChipShouter thermal trip at {hottest}C, cooling to {resume_temp}C")
+            elif hottest <= resume_temp:
+                self._thermal_ready = True
+                print(f"ChipShouter cooled to {hottest}C, resuming")
+
+    def start_thermal_monitor(self, interval=5.0, trip_temp=65, resume_temp=55):
+        """
+        Start the background thermal sampler (idempotent).
+
+        Samples the three temperature sensors every `interval` seconds
+        and maintains the cached thermal_ready() flag with hysteresis:
+        trips above trip_temp, resumes only once cooled to resume_temp.
+        Callers can keep doing non-shot work (stage movement, result
+        flushing) during cooldown instead of blocking in 10s sleeps.
+        """
+        if self._thermal_thread is not None and self._thermal_thread.is_alive():
+            return
+        self._thermal_resume_temp = resume_temp
+        self._thermal_trip_temp = trip_temp
+        self._thermal_stop.clear()
+        self._thermal_thread = threading.Thread(
+            target=self._thermal_monitor_loop,
+            args=(interval, trip_temp, resume_temp),
+            name="cs-thermal", daemon=True
+        )
+        self._thermal_thread.start()
+
+    def stop_thermal_monitor(self):
+        self._thermal_stop.set()
+        if self._thermal_thread is not None:
+            self._thermal_thread.join(timeout=2)
+            self._thermal_thread = None
+
+    def thermal_ready(self):
+        """Cached thermal gate: True when shooting is thermally safe.
+        Served from the monitor thread's last sample (no serial traffic);
+        falls back to a direct read when the monitor is not running."""
+        if self._thermal_thread is not None and self._thermal_thread.is_alive():
+            return self._thermal_ready
+        return not self.temps_too_high()
+
+    def thermal_headroom(self):
+        """degC between the monitor's last hottest-sensor sample and
+        its trip temperature (negative while tripped); None when the
+        monitor has no sample yet, so callers without a running monitor
+        fall back to the binary thermal_ready() gate."""
+        if not self._temp_history:
+            return None
+        return self._thermal_trip_temp - self._temp_history[-1][1]
+
+    def note_pulse_shape(self, width, repeats):
+        """Pulse shape of the active glitch config, keying the recharge
+        model's buckets (called by configure_chipshouter)."""
+        self._pulse_shape = (width, repeats)
+
+    def wait_charge_ready(self, tolerance=0.95, timeout=1.0):
+        """
+        Block until the capacitor bank has recharged to the voltage setpoint.
+
+        The recharge model predicts the residual recharge for the active
+        (setpoint, pulse shape) bucket and most of it (90%, so model
+        drift lands in the polls rather than in an undercharged shot) is
+        slept through in one go; polling voltage.measured with a short
+        adaptive interval (5ms growing to 50ms) then confirms the charge
+        is actually back before returning, and the measured duration is
+        fed back into the model. Replaces fixed inter-shot sleeps: fires
+        as soon as the charge is back instead of always waiting
+        worst-case, with one serial poll per shot once the model has
+        settled.
+
+        Returns:
+            bool: True if the setpoint was reached, False on timeout or
+                if the voltage could not be read.
+        """
+        try:
+            with self._serial_lock:
+                setpoint = self.cs.voltage.set
+        except Exception:
+            time.sleep(0.05)  # voltage unreadable: fall back to fixed delay
+            return False
+
+        width, repeats = self._pulse_shape
+        start = time.monotonic()
+        deadline = Deadline(timeout * 1000.0)
+        predicted = self.charge_model.predict(setpoint, width, repeats)
+        if predicted > 0.005:
+            # Cap below the timeout so the confirm polls always run
+            time.sleep(min(predicted * 0.9, timeout * 0.8))
+
+        interval = 0.005
+        while not deadline.expired():
+            try:
+                with self._serial_lock:
+                    measured = self.cs.voltage.measured
+            except Exception:
+                measured = None
+            if measured is not None and measured >= setpoint * tolerance:
+                self.charge_model.observe(
+                    setpoint, width, repeats, time.monotonic() - start
+                )
+                return True
+            time.sleep(interval)
+            interval = min(interval * 1.5, 0.05)
+
+        return False
 
     def _wait_for_safe(self, timeout=1):
         """Wait until trigger_safe becomes True or timeout (in seconds) occurs."""
-        deadline = time.time() + timeout
-        while not self.cs.trigger_safe and time.time() < deadline:
+        deadline = Deadline(timeout * 1000.0)
+        while not self.cs.trigger_safe and not deadline.expired():
             time.sleep(0.1)
         return self.cs.trigger_safe
 
-    class ArmingTimeoutError(TimeoutError):
-        def __init__(self, message="ChipShouter: Arming failed due to timeout!"):
-            super().__init__(message)
+    # Kept as a class attribute for existing except clauses; the class
+    # itself now lives in the shared taxonomy (errors.py)
+    ArmingTimeoutError = ArmingTimeoutError
 
     # @retry(
     #     wait=wait_fixed(1),
     #     stop=stop_after_attempt(3)
     # )
-    @timeout_decorator.timeout(10, timeout_exception=ArmingTimeoutError)
-    def arm(self):
-        state = self.cs.state
+    def arm(self, timeout=10):
+        # Deadline instead of the former SIGALRM-based timeout_decorator:
+        # works from worker threads and costs nothing per arm
+        deadline = Deadline(timeout * 1000.0)
+        state = self.state(max_age=0)
         if state == "armed":
             # Even if already armed, set armed variable again
             # because ChipShouter has internal timeout of 60s
             # and might auto-disarm at bad time
             # self.cs.armed = True
+            if self._pending_voltage is not None:
+                # Setpoint change deferred by set_voltage() while we
+                # believed the shouter was disarmed: apply it now
+                with self._serial_lock:
+                    self.cs.voltage = self._pending_voltage
+                self._voltage_applied = self._pending_voltage
+                self._pending_voltage = None
             return True
         elif state == "disarmed":
             # Always arm at 150V and then set the actual desired voltage
             # https://github.com/newaetech/ChipSHOUTER/issues/5
-            voltage_setpoint = self.cs.voltage.set
-            self.cs.voltage = 150
-            self.cs.armed = True
+            # A setpoint deferred by set_voltage() replaces the readback,
+            # so the pending change rides along on the single post-arm
+            # ramp instead of costing its own; when neither is known the
+            # readback joins the same lock-held command burst. The
+            # chipshouter library is strictly request-response per
+            # command, so one uninterrupted burst per lock hold is as
+            # close to pipelining as the console allows.
+            with self._serial_lock:
+                if self._pending_voltage is not None:
+                    voltage_setpoint = self._pending_voltage
+                elif self._voltage_applied is not None:
+                    voltage_setpoint = self._voltage_applied
+                else:
+                    voltage_setpoint = self.cs.voltage.set
+                self.cs.voltage = 150
+                self.cs.armed = True
         elif state == "fault":
-            raise RuntimeError("ChipShouter has faults!")
+            raise ArmFault("ChipShouter has faults!")
 
-        # wait till CS is armed
+        # wait till CS is armed; dots are rate-limited to 2 Hz - a print
+        # plus flush per 100ms poll is wasted loop time (worse over SSH)
         print("arming.", end="")
-        while self.cs.state != "armed":
+        last_dot = time.monotonic()
+        while True:
+            with self._serial_lock:
+                state = self.cs.state
+            if state == "armed":
+                break
+            if deadline.expired():
+                raise self.ArmingTimeoutError()
             time.sleep(0.1)
-            print(".", end="")
-            sys.stdout.flush()
-        print(f"{self.cs.state}")
-        # Set actual desired voltage after arming
-        self.cs.voltage = voltage_setpoint
+            now = time.monotonic()
+            if now - last_dot >= 0.5:
+                last_dot = now
+                print(".", end="")
+                sys.stdout.flush()
+        print(state)
+        # Set actual desired voltage after arming; the poll loop just
+        # established the armed state, so no re-read is needed
+        with self._serial_lock:
+            self.cs.voltage = voltage_setpoint
+        self._voltage_applied = voltage_setpoint
+        self._pending_voltage = None
+
+        self._armed_cached = True
+        self._last_arm_refresh = time.monotonic()
+        self._mirror_invalidate("state", "trigger_safe")
+        return True
 
-        return self.cs.state == "armed"
+    def ensure_armed(self):
+        """
+        Hot-path replacement for arm(): keep the ChipShouter armed across
+        executions without a serial state query per shot.
+
+        After a successful arm() the armed state is cached; this only
+        touches the serial link every KEEP_ARMED_REFRESH_S seconds to
+        re-assert armed (beating the 60s auto-disarm timeout). The
+        refresh is driven lazily from here rather than a timer thread so
+        the ChipShouter serial link is never used from two threads at
+        once. Falls back to the full arm sequence when the cache is cold
+        (after disarm, reset or cleared faults) or a refresh fails.
+        """
+        now = time.monotonic()
+        if self._armed_cached:
+            if now - self._last_arm_refresh < self.KEEP_ARMED_REFRESH_S:
+                return True
+            # Refresh due: re-assert armed (no 150V workaround needed,
+            # the setpoint is untouched while armed)
+            try:
+                with self._serial_lock:
+                    if self.cs.state == "armed":
+                        self.cs.armed = True
+                        self._last_arm_refresh = now
+                        return True
+            except Exception:
+                pass
+            self._armed_cached = False
+
+        return self.arm()
 
     def disarm(self):
-        self.cs.pulse = False
-        self.cs.armed = False
+        self._armed_cached = False
+        self._mirror_invalidate("state", "trigger_safe")
+        with self._serial_lock:
+            self.cs.pulse = False
+            self.cs.armed = False
 
     def configure_pulsegen(self, deadtime, repeat, width):
         assert deadtime in range(1, 1001), "Chipshouter pulse.deadtime has to be 1 to 1000 ms!"
@@ -160,6 +785,28 @@ class ChipShouter:
         self.cs.pulse.repeat = repeat
         self.cs.pulse.width = width
 
+    def set_voltage(self, value):
+        """
+        Deduplicated voltage setpoint write.
+
+        Every write is a slow ChipShouter serial transaction followed by
+        a capacitor ramp, and consecutive glitch configs usually share
+        the setpoint - identical values are skipped entirely. While
+        disarmed the write is deferred into the next arm(): the
+        arm-at-150V workaround would overwrite the setpoint anyway, so
+        deferring makes the bank ramp once (150V to value) instead of
+        twice.
+        """
+        if value == self._voltage_applied and self._pending_voltage is None:
+            return
+        if not self._armed_cached:
+            self._pending_voltage = value
+            return
+        with self._serial_lock:
+            self.cs.voltage = value
+        self._voltage_applied = value
+        self._pending_voltage = None
+
     @property
     def voltage(self):
         return self.cs.voltage
@@ -167,6 +814,9 @@ class ChipShouter:
     @voltage.setter
     def voltage(self, value):
         self.cs.voltage = value
+        self._voltage_applied = value
+        self._pending_voltage = None
 
     def pulse(self):
-        self.cs.pulse = 1
\ No newline at end of file
+        with self._serial_lock:
+            self.cs.pulse = 1
\ No newline at end of file
@@ -1,48 +1,100 @@
 import time
 import chipwhisperer as cw
 from tenacity import retry, wait_fixed, stop_after_attempt
-import timeout_decorator
 import subprocess
-from .USBUtils import find_usb_port_by_tty, find_tty_by_id
+from .USBUtils import find_usb_device
 
 class ChipWhisperer:
-    # TODO: handle multiple connected ChipWhisperers (pass serial number and get usb hub port from that)
-    def __init__(self, target_type=cw.targets.SimpleSerial):
+    # With several connected ChipWhisperers, pass the serial number (sn)
+    # to address a specific one; the default None keeps working for a
+    # single device
+    def __init__(self, target_type=cw.targets.SimpleSerial, sn=None):
         self._target_type=target_type
-        self.scope = cw.scope()
+        self._sn = sn
+        # Applied-settings cache for configure_scope; None means the
+        # scope state is unknown and the next configure_scope must run
+        # default_setup. Reconnects go through __init__, so any USB
+        # power cycle invalidates it automatically
+        self._scope_settings = None
+        self.scope = cw.scope(sn=sn)
         self.scope.default_setup()
+        self._scope_settings = {}
+        print("INFO: Found ChipWhisperer😍")
+        print(f"sample rate = adc_frequency({self.scope.clock.adc_freq}) * multiplier({self.scope.clock.adc_mul}) = {self.scope.clock.adc_freq * self.scope.clock.adc_mul}")
         try:
             self.target = cw.target(self.scope, target_type)
         except:
             print("INFO: Caught exception on reconnecting to target - attempting to reconnect to self.scope first.")
             print("INFO: This is a work-around when USB has died without Python knowing. Ignore errors above this line.")
-            self.scope = cw.scope()
+            self.scope = cw.scope(sn=sn)
             self.target = cw.target(self.scope, target_type)
 
-        # Find ChipWhisperer USB hub_path and hub_port_num (used for power cycling with uhubctl)
+        # Find ChipWhisperer USB hub_path and hub_port_num (used for power
+        # cycling with uhubctl); served from the persistent topology cache
+        # so __init__-based reconnects skip the sysfs walk. The by-id name
+        # contains the serial number, so matching on sn picks this
+        # device's hub port among several ChipWhisperers
         try:
-            # TODO: handle multiple ChipWhipserers
-            self.chipwhisperer_tty = find_tty_by_id("ChipWhisperer_Lite")
-            self._hub_path, self._hub_port_num = find_usb_port_by_tty(self.chipwhisperer_tty)
+            self.chipwhisperer_tty, self._hub_path, self._hub_port_num = find_usb_device(sn if sn else "ChipWhisperer_Lite")
         except Exception as e:
             print(f"ChipWhisperer: {str(e)}")
+            self._hub_path, self._hub_port_num = None, None
+        if not (self._hub_path and self._hub_port_num):
             print("ChipWhisperer: USB Power cycling unavailable!")
 
-    def configure_scope(self, samples:int, offset:int, decimate:int, timeout:float):
-        self.scope.default_setup()
-        self.scope.adc.decimate = 1
-        self.scope.adc.timeout = 5
-        self.scope.adc.samples = 24400 # max = 24573
-        self.scope.adc.offset = 25000 # number of samples to be skipped (not recorded) after trigger (32 bit uint)
+    def configure_scope(self, samples:int=24400, offset:int=25000, decimate:int=1, timeout:float=5, trigger:str=None):
+        """
+        Idempotent scope setup. default_setup() renegotiates clocks with
+        the CW-Lite over USB and costs a noticeable fraction of a
+        second, so it only runs while the scope state is unknown (fresh
+        object or after a reconnect); adc parameters are written
+        delta-only against the applied-settings cache, making repeated
+        calls and capture-profile switches mid-campaign nearly free.
+        samples max = 24573; offset = samples skipped after trigger
+        (32 bit uint). `trigger` selects the trigger source line
+        (default_setup leaves it on tio4, the target's trigger GPIO);
+        None leaves it untouched.
+        """
+        if self._scope_settings is None:
+            self.scope.default_setup()
+            self._scope_settings = {}
 
-        print("INFO: Found ChipWhisperer😍")
-        print(f"sample rate = adc_frequency({self.scope.clock.adc_freq}) * multiplier({self.scope.clock.adc_mul}) = {self.scope.clock.adc_freq * self.scope.clock.adc_mul}")
+        wanted = {"samples": samples, "offset": offset,
+                  "decimate": decimate, "timeout": timeout}
+        for name, value in wanted.items():
+            if self._scope_settings.get(name) != value:
+                setattr(self.scope.adc, name, value)
+                self._scope_settings[name] = value
+        if trigger is not None and self._scope_settings.get("trigger") != trigger:
+            self.scope.trigger.triggers = trigger
+            self._scope_settings["trigger"] = trigger
+
+    def arm_trigger_counter(self):
+        """
+        Arm the scope purely for its hardware trigger-length counter; no
+        samples are ever read back. The counter latches the number of
+        ADC clock cycles the trigger line stayed high, i.e. the time the
+        firmware spent between set_trigger() and clear_trigger().
+        """
+        self.scope.arm()
+
+    def read_trigger_width_ns(self):
+        """
+        Trigger-high time of the last armed capture in nanoseconds,
+        converted from adc.trig_count at the ADC sample rate (adc_freq *
+        adc_mul, see configure_scope).
+        """
+        count = self.scope.adc.trig_count
+        rate = self.scope.clock.adc_freq * self.scope.clock.adc_mul
+        return count / rate * 1e9
 
-    def reset_target(self):
+    def reset_target(self, hold_s=0.2, settle_s=0.2):
+        # The defaults are conservative guesses; utils/bench_reset.py
+        # measures how far they can be tightened on a given setup
         self.scope.io.nrst = 'low'
-        time.sleep(0.2)
+        time.sleep(hold_s)
         self.scope.io.nrst = 'high'
-        time.sleep(0.2)
+        time.sleep(settle_s)
 
     def power_cycle_usb(self):
         if self._hub_path and self._hub_port_num:
@@ -63,10 +115,53 @@ class ChipWhisperer:
             stdout=subprocess.DEVNULL
         )
         time.sleep(5)
-        self.__init__(self._target_type)
+        self.__init__(self._target_type, sn=self._sn)
+
+    def _flash_matches(self, binary_path):
+        """
+        Read flash back through the STM32F bootloader and compare it
+        against the firmware image. Returns False on any mismatch and
+        also when readout is unavailable (older chipwhisperer versions),
+        so callers can always fall back to a full reprogram.
+        """
+        programmer = None
+        try:
+            from chipwhisperer.capture.utils.IntelHex import IntelHex
+
+            programmer = cw.programmers.STM32FProgrammer()
+            programmer.scope = self.scope
+            programmer.open()
+            programmer.find()
+            stm32 = programmer.stm32prog()
+
+            ih = IntelHex(binary_path)
+            expected = ih.tobinarray(
+                start=ih.minaddr(), size=ih.maxaddr() - ih.minaddr() + 1
+            )
+            return bool(stm32.verifyMemory(ih.minaddr(), expected))
+        except Exception as e:
+            print(f"Flash verify unavailable ({e}), falling back to full reprogram")
+            return False
+        finally:
+            if programmer is not None:
+                try:
+                    programmer.close()
+                except Exception:
+                    pass
+
+    def flash(self, binary_path, verify_first=True):
+        """
+        Program the target, skipping the write when flash already matches.
 
-    def flash(self, binary_path):
+        In most hard-brick recoveries the flash content survived the
+        glitch — only RAM state was corrupted — so a ~2s read-back
+        verify replaces a ~20s erase+program cycle. On mismatch (or when
+        verification is unavailable) the full reprogram runs as before.
+        """
         prog = cw.programmers.STM32FProgrammer
+        if verify_first and self._flash_matches(binary_path):
+            print("Flash content matches firmware image, skipping reprogram")
+            return
         cw.program_target(self.scope, prog, binary_path)
 
 
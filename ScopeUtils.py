@@ -0,0 +1,103 @@
+"""
+Minimal SCPI oscilloscope client for automated pulse verification.
+
+The README's bench procedure measures every glitch config by hand on
+the ChipShouter's 20:1 pulse monitor output; this module automates that
+measurement so CSProfiler can fill GlitchConfig.osc_measured_pulse_*
+during the campaign itself (see CSProfiler._scope_arm_for_config).
+
+The client speaks newline-terminated SCPI over a raw TCP socket (port
+5025, the de-facto LXI convention) and sticks to the measurement
+commands shared by the Rigol/Siglent/Keysight dialects (*IDN?, :SINGle,
+:MEASure:VMAX?, :MEASure:PWIDth?), so no VISA stack is needed. Channel
+setup (coupling, scale, trigger level) stays with the user - the scope
+is expected to be configured once so a pulse on the monitor channel
+triggers a capture.
+"""
+
+import socket
+
+from .errors import ScopeError
+
+
+class Oscilloscope:
+    """One SCPI scope connection, held for the campaign lifetime."""
+
+    # The ChipShouter pulse monitor output divides by 20
+    MONITOR_ATTENUATION = 20
+
+    # SCPI instruments report 9.9e37 for "measurement not available"
+    # (no edge found, clipped signal); anything near it is invalid
+    _SCPI_INVALID = 9e37
+
+    def __init__(self, address, port=5025, channel=1, timeout=5):
+        self.address = address
+        self.channel = channel
+        try:
+            self._socket = socket.create_connection((address, port), timeout)
+            self._socket.settimeout(timeout)
+            self._rx = self._socket.makefile("rb")
+            self.idn = self.query("*IDN?")
+        except OSError as e:
+            raise ScopeError(f"Oscilloscope at {address}:{port}: {e}") from e
+
+    def command(self, text):
+        try:
+            self._socket.sendall(text.encode("ascii") + b"\n")
+        except OSError as e:
+            raise ScopeError(f"Oscilloscope {self.address}: {e}") from e
+
+    def query(self, text):
+        self.command(text)
+        try:
+            line = self._rx.readline()
+        except OSError as e:
+            raise ScopeError(f"Oscilloscope {self.address}: {e}") from e
+        if not line:
+            raise ScopeError(f"Oscilloscope {self.address}: connection closed")
+        return line.decode("ascii", errors="replace").strip()
+
+    def _query_float(self, text):
+        reply = self.query(text)
+        try:
+            value = float(reply)
+        except ValueError:
+            raise ScopeError(f"Oscilloscope {self.address}: non-numeric "
+                             f"reply {reply!r} to {text!r}") from None
+        if abs(value) >= self._SCPI_INVALID:
+            raise ScopeError(f"Oscilloscope {self.address}: no valid "
+                             f"measurement for {text!r} (got {reply})")
+        return value
+
+    def arm_single(self):
+        """Arm a single-shot acquisition; the next trigger (the pulse on
+        the monitor channel) stops it."""
+        self.command(":SINGle")
+
+    def read_pulse(self):
+        """
+        Amplitude and width of the captured pulse.
+
+        Returns
+        -------
+        tuple[float, float]
+            (voltage, width_ns): peak voltage at the probe tip (monitor
+            reading scaled by the 20:1 attenuation) and positive pulse
+            width in nanoseconds.
+
+        Raises
+        ------
+        ScopeError
+            When the scope did not capture a measurable pulse.
+        """
+        source = f"CHANnel{self.channel}"
+        vmax = self._query_float(f":MEASure:VMAX? {source}")
+        width_s = self._query_float(f":MEASure:PWIDth? {source}")
+        return vmax * self.MONITOR_ATTENUATION, width_s * 1e9
+
+    def close(self):
+        try:
+            self._rx.close()
+            self._socket.close()
+        except OSError:
+            pass
@@ -1,5 +1,16 @@
 import os
+import json
+import socket
 import subprocess
+import threading
+
+# Persistent USB topology cache: serial_id -> {by_id_path, tty, hub_path,
+# hub_port_num}. Discovery (udevadm + sysfs walk) costs noticeably on
+# every profiler start and on every __init__-based reconnect after a
+# power cycle; the topology only changes when cables are moved, so cached
+# entries are revalidated with two cheap stats instead.
+_TOPOLOGY_CACHE_PATH = os.path.expanduser("~/.cache/cs-profiler/usb-topology.json")
+_topology_cache = None
 
 def find_usb_port_by_dev_path(dev_path : str) -> tuple[str, str]:
     """
@@ -122,6 +133,12 @@ def find_tty_by_id(serial_id : str) -> str:
         str: Path to tty device (/dev/tty...)
     """
 
+    return os.path.realpath(_find_by_id_link(serial_id))
+
+
+def _find_by_id_link(serial_id : str) -> str:
+    """Find the /dev/serial/by-id symlink matching `serial_id` (substring
+    match, same semantics as find_tty_by_id)."""
     by_id_path = "/dev/serial/by-id"
     if not os.path.exists(by_id_path):
         raise FileNotFoundError("Serial ID directory '/dev/serial/by-id/' does not exist.")
@@ -130,16 +147,223 @@ def find_tty_by_id(serial_id : str) -> str:
     matches = []
     for name in os.listdir(by_id_path):
         if serial_id in name:  # substring match
-            full_path = os.path.join(by_id_path, name)
-            matches.append(os.path.realpath(full_path))
+            matches.append(os.path.join(by_id_path, name))
 
     if not matches:
         raise FileNotFoundError(
             f"No device found with serial ID containing '{serial_id}'."
         )
     elif len(matches) > 1:
+        resolved = ", ".join(os.path.realpath(m) for m in matches)
         raise ValueError(
-            f"Multiple devices match serial ID '{serial_id}' ({', '.join(matches)}).  Please pass the tty device or exact serial id. "
+            f"Multiple devices match serial ID '{serial_id}' ({resolved}).  Please pass the tty device or exact serial id. "
         )
 
-    return matches[0]
\ No newline at end of file
+    return matches[0]
+
+
+def _load_topology_cache() -> dict:
+    global _topology_cache
+    if _topology_cache is None:
+        try:
+            with open(_TOPOLOGY_CACHE_PATH) as f:
+                _topology_cache = json.load(f)
+        except (OSError, ValueError):
+            _topology_cache = {}
+    return _topology_cache
+
+
+def _store_topology_entry(serial_id : str, entry : dict):
+    cache = _load_topology_cache()
+    cache[serial_id] = entry
+    try:
+        os.makedirs(os.path.dirname(_TOPOLOGY_CACHE_PATH), exist_ok=True)
+        with open(_TOPOLOGY_CACHE_PATH, "w") as f:
+            json.dump(cache, f, indent=2)
+    except OSError:
+        pass  # the cache is only an optimization, never fail on it
+
+
+def _topology_entry_valid(entry : dict) -> bool:
+    """
+    Revalidate a cached entry without udevadm or a sysfs walk: the by-id
+    symlink must still resolve to the cached tty (one readlink) and the
+    cached sysfs port directory must still exist (one stat). A replugged
+    or re-enumerated device fails one of the two and triggers a refresh.
+    """
+    try:
+        if os.path.realpath(entry["by_id_path"]) != entry["tty"]:
+            return False
+        hub_path, hub_port_num = entry["hub_path"], entry["hub_port_num"]
+        if hub_path and hub_port_num:
+            # Reverse of the name split in find_usb_port_by_dev_path
+            separator = "." if "-" in hub_path else "-"
+            sysfs_name = f"{hub_path}{separator}{hub_port_num}"
+            if not os.path.exists(f"/sys/bus/usb/devices/{sysfs_name}"):
+                return False
+        return True
+    except (KeyError, OSError):
+        return False
+
+
+def find_usb_device(serial_id : str) -> tuple[str, str, str]:
+    """
+    Resolve tty, hub_path and hub_port_num for a device serial_id,
+    served from the persistent topology cache when still valid.
+
+    On a cache miss (first run, or the device moved) the full discovery
+    runs and the cache is refreshed. Hub information is best-effort:
+    (tty, None, None) is returned - and cached - when the sysfs walk
+    fails, matching the callers that treat power cycling as optional.
+
+    Args:
+        serial_id (str): Serial id substring (see find_tty_by_id)
+
+    Raises:
+        FileNotFoundError: No connected device matches `serial_id`.
+
+    Returns:
+        tuple[str, str, str]: (tty, hub_path, hub_port_num), the hub
+            fields being None when unavailable.
+    """
+    entry = _load_topology_cache().get(serial_id)
+    if entry and _topology_entry_valid(entry):
+        return entry["tty"], entry["hub_path"], entry["hub_port_num"]
+
+    by_id_link = _find_by_id_link(serial_id)
+    tty = os.path.realpath(by_id_link)
+    try:
+        hub_path, hub_port_num = find_usb_port_by_tty(tty)
+    except Exception as e:
+        print(f"USB topology: {str(e)}")
+        hub_path, hub_port_num = None, None
+
+    _store_topology_entry(serial_id, {
+        "by_id_path": by_id_link,
+        "tty": tty,
+        "hub_path": hub_path,
+        "hub_port_num": hub_port_num,
+    })
+    return tty, hub_path, hub_port_num
+
+
+class UdevMonitor:
+    """
+    Proactive USB device-loss detection over the kernel uevent netlink
+    socket.
+
+    A dead device otherwise surfaces only when an operation times out
+    deep inside the shot path, after the full retry ladder. The kernel
+    broadcasts a "remove" uevent the moment a device drops off the bus;
+    subscribing to those flags the loss within a second, so the recovery
+    orchestrator can power-cycle proactively. The monitor is purely
+    passive - it never touches the devices - and "add" events clear the
+    flag again once a power cycle brings the device back.
+
+    Watches match on DEVNAME for tty devices (ChipShouter, Pico) or on
+    the uevent PRODUCT vid/pid string for non-tty devices like the
+    ChipWhisperer:
+
+        monitor = UdevMonitor()
+        monitor.watch_tty("chipshouter", "/dev/ttyUSB0")
+        monitor.watch_product("target", 0x2b3e, 0xace2)
+        monitor.start()
+        ...
+        monitor.lost_devices()  # -> set of watched names currently gone
+    """
+
+    _NETLINK_KOBJECT_UEVENT = 15
+
+    def __init__(self):
+        self._watches = {}
+        self._lost = set()
+        self._lock = threading.Lock()
+        self._stop = threading.Event()
+        self._thread = None
+        self._socket = None
+
+    def watch_tty(self, name, tty):
+        """Watch a tty device; uevents carry DEVNAME without /dev/."""
+        self._watches[name] = {
+            "devname": os.path.basename(os.path.realpath(tty))
+        }
+
+    def watch_product(self, name, vendor_id, product_id):
+        """Watch by USB vendor/product id (uevent PRODUCT=vid/pid/bcd,
+        ids in lowercase hex without padding)."""
+        self._watches[name] = {"product": f"{vendor_id:x}/{product_id:x}/"}
+
+    def start(self):
+        """Bind the netlink socket (group 1, kernel uevents - needs the
+        privileges the uhubctl power cycling needs anyway) and start the
+        monitor thread."""
+        sock = socket.socket(socket.AF_NETLINK, socket.SOCK_RAW,
+                             self._NETLINK_KOBJECT_UEVENT)
+        sock.bind((0, 1))
+        sock.settimeout(1.0)
+        self._socket = sock
+        self._thread = threading.Thread(
+            target=self._monitor_loop, name="udev-monitor", daemon=True
+        )
+        self._thread.start()
+
+    def stop(self):
+        self._stop.set()
+        if self._thread is not None:
+            self._thread.join()
+            self._thread = None
+        if self._socket is not None:
+            self._socket.close()
+            self._socket = None
+
+    def lost_devices(self):
+        """Watched names currently flagged as removed."""
+        with self._lock:
+            return set(self._lost)
+
+    def clear(self, name):
+        """Drop a loss flag manually (e.g. after an out-of-band
+        reconnect the kernel never announced)."""
+        with self._lock:
+            self._lost.discard(name)
+
+    def _monitor_loop(self):
+        while not self._stop.is_set():
+            try:
+                data = self._socket.recv(8192)
+            except socket.timeout:
+                continue
+            except OSError:
+                return
+            self._handle_event(data)
+
+    def _handle_event(self, data):
+        # Kernel uevents are "action@devpath\0KEY=VAL\0..."; udevd's
+        # processed rebroadcasts carry a "libudev" magic instead and
+        # would double-report every event
+        if data.startswith(b"libudev"):
+            return
+        header, _, rest = data.partition(b"\0")
+        action, separator, _ = header.decode(errors="replace").partition("@")
+        if not separator:
+            return
+        properties = dict(
+            field.decode(errors="replace").split("=", 1)
+            for field in rest.split(b"\0")
+            if b"=" in field
+        )
+        for name, match in self._watches.items():
+            if not self._event_matches(match, properties):
+                continue
+            with self._lock:
+                if action == "remove":
+                    self._lost.add(name)
+                elif action in ("add", "bind"):
+                    self._lost.discard(name)
+
+    @staticmethod
+    def _event_matches(match, properties):
+        devname = match.get("devname")
+        if devname is not None:
+            return properties.get("DEVNAME", "").rsplit("/", 1)[-1] == devname
+        return properties.get("PRODUCT", "").startswith(match["product"])
\ No newline at end of file
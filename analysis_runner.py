@@ -0,0 +1,189 @@
+"""
+Parallel analysis runner over results directories.
+
+Post-campaign aggregation over the whole archive was a single process
+re-parsing every results JSON on every run. This runner maps a
+user-supplied aggregation function over results files with a process
+pool and memoizes each file's partial aggregate keyed by content hash,
+so a repeated analysis only parses campaigns that are new or changed -
+the archive-wide pass drops from the JSON-parsing time of everything to
+that of the delta.
+
+The aggregation function takes (data, path) and returns any picklable
+partial; it sees the loaded form of whichever format the file has:
+
+    results_N.json[.gz]  - the results dict (legacy and current)
+    stream_N.jsonl       - list of per-execution records
+    *.parquet            - list of row dicts (needs pyarrow, like
+                           export_parquet.py)
+
+Use from code with an importable function, or from the shell:
+
+    from analysis_runner import run_analysis
+    partials = run_analysis(my_module.fault_counts, "results/")
+
+    python3 analysis_runner.py my_module:fault_counts results/ [-j N]
+
+Partials are returned as {path: partial}; pass reduce_fn to fold them
+into one value. Pool workers re-import the function by reference, so it
+must live in an importable module (not a notebook cell or lambda).
+"""
+
+import hashlib
+import importlib
+import json
+import gzip
+import os
+import pickle
+import sys
+import tempfile
+from functools import reduce as _reduce
+from multiprocessing import Pool
+
+DEFAULT_CACHE_DIR = os.path.expanduser("~/.cache/cs-profiler/analysis")
+
+# File kinds the runner understands, by filename
+_SUPPORTED_SUFFIXES = (".json", ".json.gz", ".jsonl", ".parquet")
+
+
+def discover_files(inputs):
+    """Expand files/directories into the supported results files,
+    sorted for stable ordering."""
+    files = []
+    for entry in inputs:
+        if os.path.isdir(entry):
+            for name in os.listdir(entry):
+                if name.endswith(_SUPPORTED_SUFFIXES):
+                    files.append(os.path.join(entry, name))
+        else:
+            files.append(entry)
+    return sorted(files)
+
+
+def load_results_file(path):
+    """Load one results file into the form handed to the aggregation
+    function (see module docstring)."""
+    if path.endswith(".parquet"):
+        try:
+            import pyarrow.parquet as pq
+        except ImportError as e:
+            raise ImportError(
+                "Parquet input requires pyarrow (pip install pyarrow)"
+            ) from e
+        return pq.read_table(path).to_pylist()
+    if path.endswith(".jsonl"):
+        with open(path) as f:
+            return [json.loads(line) for line in f if line.strip()]
+    opener = gzip.open if path.endswith(".gz") else open
+    with opener(path, "rt") as f:
+        return json.load(f)
+
+
+def _resolve_function(reference):
+    if callable(reference):
+        return reference
+    module_name, _, function_name = reference.partition(":")
+    module = importlib.import_module(module_name)
+    function = module
+    for part in function_name.split("."):
+        function = getattr(function, part)
+    return function
+
+
+def _function_tag(reference):
+    if callable(reference):
+        return f"{reference.__module__}.{reference.__qualname__}"
+    return reference.replace(":", ".")
+
+
+def _file_hash(path):
+    digest = hashlib.sha256()
+    with open(path, "rb") as f:
+        for chunk in iter(lambda: f.read(1 << 20), b""):
+            digest.update(chunk)
+    return digest.hexdigest()
+
+
+def _process_file(args):
+    """Pool worker: serve the partial from the cache when the file and
+    function match, compute and store it otherwise."""
+    path, reference, cache_dir = args
+    cache_path = None
+    if cache_dir:
+        key = f"{_file_hash(path)}_{_function_tag(reference)}"
+        cache_path = os.path.join(cache_dir, hashlib.sha256(key.encode()).hexdigest() + ".pkl")
+        if os.path.exists(cache_path):
+            try:
+                with open(cache_path, "rb") as f:
+                    return path, pickle.load(f)
+            except Exception:
+                pass  # stale/corrupt cache entry: recompute below
+
+    function = _resolve_function(reference)
+    partial = function(load_results_file(path), path)
+
+    if cache_path:
+        # Atomic publish so a parallel run never reads a half-written entry
+        os.makedirs(cache_dir, exist_ok=True)
+        fd, temp_path = tempfile.mkstemp(dir=cache_dir, suffix=".tmp")
+        with os.fdopen(fd, "wb") as f:
+            pickle.dump(partial, f)
+        os.replace(temp_path, cache_path)
+    return path, partial
+
+
+def run_analysis(aggregate, inputs, reduce_fn=None, processes=None,
+                 cache_dir=DEFAULT_CACHE_DIR):
+    """
+    Map `aggregate` over the results files in `inputs` (files and/or
+    directories) with a process pool.
+
+    Returns {path: partial}, or the folded value when reduce_fn (a
+    two-argument combiner over partials) is given. cache_dir=None
+    disables memoization.
+
+    Pass a callable defined in an importable module, or its
+    "module:function" reference string.
+    """
+    if isinstance(inputs, str):
+        inputs = [inputs]
+    files = discover_files(inputs)
+    work = [(path, aggregate, cache_dir) for path in files]
+
+    if processes == 1 or len(files) <= 1:
+        results = [_process_file(item) for item in work]
+    else:
+        with Pool(processes) as pool:
+            results = list(pool.imap_unordered(_process_file, work))
+
+    partials = dict(sorted(results))
+    if reduce_fn is not None:
+        return _reduce(reduce_fn, partials.values())
+    return partials
+
+
+def main():
+    args = sys.argv[1:]
+    processes = None
+    if "-j" in args:
+        index = args.index("-j")
+        processes = int(args[index + 1])
+        del args[index:index + 2]
+    cache_dir = DEFAULT_CACHE_DIR
+    if "--no-cache" in args:
+        args.remove("--no-cache")
+        cache_dir = None
+
+    if len(args) < 2:
+        print("usage: python3 analysis_runner.py <module:function> <files/dirs...> [-j N] [--no-cache]")
+        return 1
+
+    partials = run_analysis(args[0], args[1:], processes=processes,
+                            cache_dir=cache_dir)
+    for path, partial in partials.items():
+        print(f"{path}: {partial}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
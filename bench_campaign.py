@@ -0,0 +1,132 @@
+"""
+Shots-per-second campaign benchmark.
+
+Runs a fixed synthetic campaign - N virtual positions at one physical
+spot (mock table, no movement), M executions of the loop payload per
+position, one known glitch config - with the ChipShouter and pulse
+generator mocked so the coil never fires. What remains is exactly the
+software/serial path a change to CSProfiler, TargetSerial or the
+firmware affects, measured end to end on real target hardware.
+
+    python3 -m <package>.bench_campaign [--build] [--flash] [-n POS] [-m EXEC]
+
+Results go to bench_campaign_<timestamp>.json in a stable schema
+(shots/second, wall time, phase percentiles from the PhaseTimer
+histograms, serial roundtrip throughput), so runs are diffable across
+releases and regressions show up as numbers, not hunches.
+"""
+
+import json
+import os
+import sys
+import time
+
+from .config_classes import GlitchConfig, TargetConfig
+from .profile_target import CSProfiler
+from .sim_target import MockShouter, MockTable, MockDelayController
+
+BENCH_SCHEMA_VERSION = 1
+
+
+def _prepare_bench_hardware(profiler):
+    """prepare_hardware override: real ChipWhisperer + target serial,
+    everything that could move or fire replaced by mocks."""
+    from .CWUtils import ChipWhisperer
+    from simpleserial.simpleserial import TargetSerial
+    from simpleserial.simpleserial_readers.cwlite import SimpleSerial_ChipWhispererLite
+
+    profiler.cw = ChipWhisperer()
+    profiler.target_serial = TargetSerial(SimpleSerial_ChipWhispererLite, profiler.cw.scope)
+    profiler.cs = MockShouter()
+    profiler.table = MockTable()
+    profiler.delay_controller = MockDelayController()
+    profiler._last_pulse_parameters = None
+
+
+def run_benchmark(num_positions=5, num_executions=200, build=False, flash=False):
+    """Run the synthetic campaign and return the benchmark record."""
+    current_dir = os.path.dirname(os.path.abspath(__file__))
+    target_config = TargetConfig(
+        firmware_build_dir=os.path.join(current_dir, "target-firmware", "build"),
+        firmware_build_command=["make", "loop"],
+        firmware_path=os.path.join(current_dir, "target-firmware", "build",
+                                   "emfi-profiler-CW308_STM32F4.hex"),
+    )
+
+    # N virtual positions at the same physical spot: the mock table makes
+    # moves free, so per-position overhead (reset, flush, config) is
+    # still exercised N times without the bench rig moving
+    positions = [[0, 0, 0] for _ in range(num_positions)]
+
+    glitch_config = GlitchConfig(
+        probe="4mm CW",
+        voltage=0,
+        pulse_width=40,
+        pulse_spacing=50,
+        pulse_repeats=0,
+        pulse_offset=0,
+        num_executions=num_executions,
+        dead_timeout=100,
+    )
+
+    profiler = CSProfiler(target_config, positions, [glitch_config])
+    profiler.prepare_hardware = lambda: _prepare_bench_hardware(profiler)
+
+    start = time.monotonic()
+    profiler.run_campaign(build=build, flash=flash, home=False)
+    wall_s = time.monotonic() - start
+
+    executions = num_positions * num_executions
+    phases = profiler.timing.summary()
+    serial = {}
+    for phase in ("send_ack", "response_read"):
+        if phase in phases:
+            serial[phase] = {
+                "roundtrips_per_s": round(
+                    phases[phase]["samples"] / phases[phase]["total_s"], 1
+                ) if phases[phase]["total_s"] else None,
+                "p50_ms": phases[phase]["p50_ms"],
+                "p99_ms": phases[phase]["p99_ms"],
+            }
+
+    return {
+        "schema_version": BENCH_SCHEMA_VERSION,
+        "timestamp": time.strftime("%Y-%m-%dT%H:%M:%S"),
+        "parameters": {
+            "num_positions": num_positions,
+            "num_executions": num_executions,
+            "payload": "loop",
+        },
+        "executions": executions,
+        "wall_s": round(wall_s, 3),
+        "shots_per_second": round(executions / wall_s, 2) if wall_s else None,
+        "serial": serial,
+        "phases": phases,
+    }
+
+
+def main():
+    args = sys.argv[1:]
+
+    def int_arg(flag, default):
+        if flag in args:
+            return int(args[args.index(flag) + 1])
+        return default
+
+    record = run_benchmark(
+        num_positions=int_arg("-n", 5),
+        num_executions=int_arg("-m", 200),
+        build="--build" in args or "-b" in args,
+        flash="--flash" in args or "-f" in args,
+    )
+
+    out_path = f"bench_campaign_{record['timestamp'].replace(':', '-')}.json"
+    with open(out_path, "w") as f:
+        json.dump(record, f, indent=4)
+    print(f"\n{record['executions']} executions in {record['wall_s']}s "
+          f"=> {record['shots_per_second']} shots/s")
+    print(f"Benchmark record written to {out_path}")
+
+
+if __name__ == "__main__":
+    main()
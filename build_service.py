@@ -0,0 +1,327 @@
+"""
+Cached firmware builds and build-on-change watching.
+
+_build_firmware already skips the build entirely when no input changed
+(the .buildstamp hash), but any edit pays the full Makefile.inc
+rebuild: during payload development - dozens of builds an hour - a
+one-line change in a payload recompiles the whole HAL/cw-deps world
+again, ~45s per iteration. This module fronts the compiler with an
+object cache, ccache-style: the `cc` entry point wraps the real
+compiler via a make CC= override, keys each compile step on the
+preprocessed source (so header edits invalidate correctly), the
+compiler version and the flags, and serves unchanged objects from the
+cache instead of recompiling them. A cold cache costs one extra
+preprocessor pass per file; a warm one turns the rebuild into
+preprocessor passes plus the link.
+
+    python3 -m <package>.build_service build -- make loop
+    python3 -m <package>.build_service watch -- make loop
+    python3 -m <package>.build_service stats
+
+`build` runs one cached build (injecting the CC override into make).
+`watch` is the persistent mode for the edit-build-flash-test loop: it
+polls the firmware sources (same file set _firmware_source_hash
+covers) and rebuilds on change, so the image is typically already
+current when the campaign script reaches flash. The shim never breaks
+a build: anything it cannot parse, preprocess or cache falls through
+to the real compiler unchanged.
+"""
+
+import hashlib
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+DEFAULT_BUILD_DIR = "target-firmware/build"
+# Env var the build entry sets for its child cc shims; the default
+# keeps standalone shim use working
+CACHE_DIR_ENV = "CS_OBJCACHE_DIR"
+DEFAULT_CACHE_DIR = os.path.expanduser("~/.cache/emfi-objcache")
+
+# Compiler --version probe results, keyed by compiler path; in watch
+# mode this stays warm across builds
+_version_cache = {}
+
+_SOURCE_SUFFIXES = (".c", ".h", ".S", ".ld")
+
+
+def _cache_dir():
+    return os.environ.get(CACHE_DIR_ENV) or DEFAULT_CACHE_DIR
+
+
+def _compiler_version(compiler):
+    version = _version_cache.get(compiler)
+    if version is None:
+        version = subprocess.run(
+            [compiler, "--version"], capture_output=True, text=True
+        ).stdout.splitlines()[0]
+        _version_cache[compiler] = version
+    return version
+
+
+def _compile_plan(args):
+    """
+    Parse one compiler invocation into {source, out, depfile, args}, or
+    None when it is not a plain single-source compile step (links,
+    preprocessor-only runs, multi-source calls go straight through).
+    """
+    if "-c" not in args or "-E" in args:
+        return None
+    sources = [a for a in args if a.endswith((".c", ".S", ".s"))]
+    if len(sources) != 1:
+        return None
+    out = None
+    depfile = None
+    for index, arg in enumerate(args):
+        if arg == "-o" and index + 1 < len(args):
+            out = args[index + 1]
+        if arg == "-MF" and index + 1 < len(args):
+            depfile = args[index + 1]
+    if out is None or not out.endswith(".o"):
+        return None
+    if depfile is None and any(a in ("-MD", "-MMD") for a in args):
+        depfile = out[:-2] + ".d"
+    return {"source": sources[0], "out": out, "depfile": depfile,
+            "args": args}
+
+
+def _cache_key(compiler, plan):
+    """Key of one compile step: preprocessed source (headers included,
+    so a header edit misses), compiler version and the flags that are
+    not per-invocation paths. None when preprocessing fails."""
+    pp_args = []
+    skip_next = False
+    for arg in plan["args"]:
+        if skip_next:
+            skip_next = False
+            continue
+        if arg in ("-o", "-MF", "-MT", "-MQ"):
+            skip_next = True
+            continue
+        if arg in ("-c", "-MD", "-MMD", "-MP") or arg == plan["source"]:
+            continue
+        pp_args.append(arg)
+    preprocessed = subprocess.run(
+        [compiler] + pp_args + ["-E", plan["source"]], capture_output=True
+    )
+    if preprocessed.returncode != 0:
+        return None
+    digest = hashlib.sha256()
+    digest.update(_compiler_version(compiler).encode())
+    digest.update("\0".join(pp_args).encode())
+    digest.update(b"\0")
+    digest.update(preprocessed.stdout)
+    return digest.hexdigest()
+
+
+def _entry_paths(key):
+    prefix = os.path.join(_cache_dir(), key[:2])
+    return prefix, os.path.join(prefix, key + ".o"), \
+        os.path.join(prefix, key + ".d")
+
+
+def _note(event):
+    # Lock-free per-shim-process tally; `build` diffs it around the run
+    try:
+        with open(os.path.join(_cache_dir(), "events.log"), "a") as f:
+            f.write(event + "\n")
+    except OSError:
+        pass
+
+
+def _restore(key, plan):
+    _, obj_path, dep_path = _entry_paths(key)
+    if not os.path.exists(obj_path):
+        return False
+    if plan["depfile"] and not os.path.exists(dep_path):
+        # Entry stored without the dep file this invocation needs
+        return False
+    shutil.copyfile(obj_path, plan["out"])
+    if plan["depfile"]:
+        shutil.copyfile(dep_path, plan["depfile"])
+    _note("hit")
+    return True
+
+
+def _store(key, plan):
+    prefix, obj_path, dep_path = _entry_paths(key)
+    os.makedirs(prefix, exist_ok=True)
+    for src, dst in ((plan["out"], obj_path), (plan["depfile"], dep_path)):
+        if not src or not os.path.exists(src):
+            continue
+        # Atomic publish: concurrent sub-makes may store the same key
+        fd, tmp = tempfile.mkstemp(dir=prefix, suffix=".tmp")
+        os.close(fd)
+        shutil.copyfile(src, tmp)
+        os.replace(tmp, dst)
+    _note("miss")
+
+
+def run_cc(argv):
+    """The CC shim: `cc <real compiler> <args...>`, installed through
+    make's CC override by `build`. Serves cached objects for unchanged
+    compile steps, falls through to the real compiler otherwise."""
+    compiler, args = argv[0], list(argv[1:])
+    try:
+        plan = _compile_plan(args)
+        key = _cache_key(compiler, plan) if plan else None
+    except Exception:
+        plan, key = None, None
+    if key and _restore(key, plan):
+        return 0
+    returncode = subprocess.call([compiler] + args)
+    if returncode == 0 and key:
+        try:
+            _store(key, plan)
+        except OSError:
+            pass
+    return returncode
+
+
+def _events_offset():
+    try:
+        return os.path.getsize(os.path.join(_cache_dir(), "events.log"))
+    except OSError:
+        return 0
+
+
+def _events_since(offset):
+    hits = misses = 0
+    try:
+        with open(os.path.join(_cache_dir(), "events.log")) as f:
+            f.seek(offset)
+            for line in f:
+                if line.strip() == "hit":
+                    hits += 1
+                elif line.strip() == "miss":
+                    misses += 1
+    except OSError:
+        pass
+    return hits, misses
+
+
+def build_once(command, build_dir=DEFAULT_BUILD_DIR, cache_dir=None,
+               compiler="arm-none-eabi-gcc"):
+    """
+    Run one build command with the compiler cache fronting CC. The
+    override is a make command-line variable, so it wins over any
+    assignment in the Makefiles; non-make commands run unchanged.
+    `compiler` is the real CC the shim hands through (the STM32F4
+    cross compiler unless building for another platform). Returns the
+    command's exit code.
+    """
+    cache_dir = cache_dir or _cache_dir()
+    os.makedirs(cache_dir, exist_ok=True)
+    env = dict(os.environ, **{CACHE_DIR_ENV: cache_dir})
+    if os.path.basename(command[0]) == "make":
+        shim = f"{sys.executable} -m {__package__}.build_service cc"
+        command = list(command) + [f"CC={shim} {compiler}"]
+    offset = _events_offset()
+    start = time.monotonic()
+    returncode = subprocess.run(command, cwd=build_dir, env=env).returncode
+    hits, misses = _events_since(offset)
+    print(f"build_service: {time.monotonic() - start:.1f}s, "
+          f"{hits} cached / {misses} compiled")
+    return returncode
+
+
+def _tree_snapshot(source_root):
+    """(path, mtime) of every build input, the same file set
+    _firmware_source_hash covers (sources, headers, linker scripts,
+    Makefiles; object dirs skipped)."""
+    snapshot = []
+    for dirpath, dirnames, filenames in os.walk(source_root):
+        dirnames[:] = [d for d in dirnames if not d.startswith("objdir")]
+        for name in filenames:
+            if name.endswith(_SOURCE_SUFFIXES) or "Makefile" in name:
+                path = os.path.join(dirpath, name)
+                try:
+                    snapshot.append((path, os.stat(path).st_mtime))
+                except OSError:
+                    pass
+    return snapshot
+
+
+def watch(command, build_dir=DEFAULT_BUILD_DIR, interval=1.0,
+          compiler="arm-none-eabi-gcc"):
+    """Persistent build-on-change loop: poll the firmware sources and
+    run a cached build whenever one changes (polling over inotify for
+    the same reason _poll_control polls: no extra dependency for a
+    file check every second)."""
+    source_root = os.path.dirname(os.path.abspath(build_dir))
+    last = None
+    print(f"Watching {source_root} (Ctrl+C to stop)")
+    while True:
+        snapshot = _tree_snapshot(source_root)
+        if snapshot != last:
+            if last is not None:
+                changed = len(set(snapshot) - set(last))
+                print(f"build_service: {changed} file(s) changed")
+            build_once(command, build_dir, compiler=compiler)
+            # Re-snapshot after the build so stamp/dep updates the
+            # build itself made do not retrigger it
+            snapshot = _tree_snapshot(source_root)
+        last = snapshot
+        time.sleep(interval)
+
+
+def stats():
+    entries = 0
+    size = 0
+    for dirpath, _, filenames in os.walk(_cache_dir()):
+        for name in filenames:
+            if name.endswith(".o"):
+                entries += 1
+                size += os.path.getsize(os.path.join(dirpath, name))
+    hits, misses = _events_since(0)
+    print(f"{entries} cached objects, {size / 1e6:.1f} MB, "
+          f"{hits} hits / {misses} misses all-time "
+          f"({_cache_dir()})")
+    return 0
+
+
+def main():
+    args = sys.argv[1:]
+    if args and args[0] == "cc":
+        return run_cc(args[1:])
+
+    build_dir = DEFAULT_BUILD_DIR
+    if "--build-dir" in args:
+        index = args.index("--build-dir")
+        build_dir = args[index + 1]
+        del args[index:index + 2]
+    compiler = "arm-none-eabi-gcc"
+    if "--compiler" in args:
+        index = args.index("--compiler")
+        compiler = args[index + 1]
+        del args[index:index + 2]
+    command = None
+    if "--" in args:
+        index = args.index("--")
+        command = args[index + 1:]
+        args = args[:index]
+
+    if args == ["stats"]:
+        return stats()
+    if args == ["build"] and command:
+        return build_once(command, build_dir, compiler=compiler)
+    if args == ["watch"] and command:
+        try:
+            watch(command, build_dir, compiler=compiler)
+        except KeyboardInterrupt:
+            return 0
+
+    print("usage: python3 -m <package>.build_service build -- make <goal>\n"
+          "       python3 -m <package>.build_service watch -- make <goal>\n"
+          "       python3 -m <package>.build_service stats\n"
+          "       (cc <compiler> <args...> is the internal CC shim)\n"
+          "       [--build-dir DIR, default target-firmware/build]"
+          " [--compiler CC, default arm-none-eabi-gcc]")
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
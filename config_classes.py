@@ -1,7 +1,8 @@
 
-from dataclasses import dataclass
+from dataclasses import dataclass, fields, replace
 from typing import List, Literal, Type, Union
 import ctypes
+import itertools
 from .simpleserial.simpleserial import TargetSerial
 
 class SimpleSerialPacket:
@@ -46,13 +47,167 @@ class GlitchConfig:
 
     dead_timeout: int
     ack_timeout: int = 100
+    # Pulse-generation path: "pico" (external Pico pulse generator),
+    # "internal" (ChipShouter's built-in generator - no Pico serial hop
+    # or trigger-path latency, but width 80-960ns and no offset), or
+    # "auto" to use the internal generator whenever the parameters fit
+    # its ranges. configure_chipshouter resolves "auto" in place, so the
+    # results metadata records the path that actually ran.
+    pulse_path: str = "auto"
+    # Early stopping (Wald SPRT): stop the execution loop at a position once
+    # the fault probability is confidently (early_stop_confidence) below
+    # early_stop_p_low or above early_stop_p_high. Both must be set to
+    # enable; p_low must be > 0 and p_high < 1. The effective sample count
+    # ends up in results["effective_executions"] for normalization.
+    early_stop_p_low: float = None
+    early_stop_p_high: float = None
+    early_stop_confidence: float = 0.95
     osc_measured_pulse_voltage: float = 0 # (V), measured with oscilloscope on 20:1 port of ChipShouter
     osc_measured_pulse_width: float = 0   # (ns), measured with oscilloscope on 20:1 port of ChipShouter
 
+    def derive(self):
+        """
+        Precompute the derived values the hot loop reads instead of
+        recomputing per position visit: faulting_duration_ns (total
+        pulse-train length) and pulse_parameters (the generator
+        parameter dict configure_chipshouter writes, keyed by path for
+        its dedup check). Set on the instance, not dataclass fields, so
+        asdict() and replace() ignore them; pulse_path must be resolved
+        ("auto" decided) first - see
+        CSProfiler.validate_glitch_configs. Returns self.
+        """
+        self.faulting_duration_ns = (
+            (self.pulse_width + self.pulse_spacing) * self.pulse_repeats
+        )
+        if self.pulse_path == "internal":
+            self.pulse_parameters = ("internal", {
+                "deadtime": max(1, self.pulse_spacing // 1000000),
+                "repeat": max(1, self.pulse_repeats),
+                "width": self.pulse_width,
+            })
+        elif self.pulse_path == "pico":
+            self.pulse_parameters = ("pico", {
+                "offset": self.pulse_offset,
+                "length": self.pulse_width,
+                "spacing": self.pulse_spacing,
+                "repeats": self.pulse_repeats,
+            })
+        else:
+            raise ValueError(
+                f"GlitchConfig.pulse_path: {self.pulse_path!r} "
+                "(expected 'auto', 'internal' or 'pico')")
+        return self
+
+class SweepSpec:
+    """
+    Lazy full-factorial sweep over GlitchConfig fields.
+
+        sweep = SweepSpec(base_config,
+                          probe=["1mm CW", "4mm CW"],
+                          voltage=[200, 300, 400],
+                          pulse_width=[20, 40, 80])
+
+    len(sweep) is the combination count; iterating yields GlitchConfig
+    instances one at a time (dataclasses.replace over the base config),
+    so nothing is materialized up front - see
+    CSProfiler.run_campaign_sweep for the matching incremental counter
+    allocation. The order is reconfiguration-friendly: the probe axis
+    changes slowest (every swap is manual), voltage next and ascending
+    within a probe group (setpoint changes cost charge time), all other
+    axes vary fastest.
+    """
+
+    # Axes iterated outermost, in this order, when present
+    SLOW_AXES = ("probe", "voltage")
+
+    def __init__(self, base: GlitchConfig, **axes):
+        valid = {field.name for field in fields(GlitchConfig)}
+        for name in axes:
+            if name not in valid:
+                raise ValueError(f"SweepSpec: {name} is not a GlitchConfig field")
+        self.base = base
+        self.axes = {name: list(values) for name, values in axes.items()}
+
+    def __len__(self):
+        count = 1
+        for values in self.axes.values():
+            count *= len(values)
+        return count
+
+    def __iter__(self):
+        ordered = [name for name in self.SLOW_AXES if name in self.axes]
+        ordered += [name for name in self.axes if name not in self.SLOW_AXES]
+        values = [sorted(self.axes[name]) if name == "voltage" else self.axes[name]
+                  for name in ordered]
+        for combination in itertools.product(*values):
+            yield replace(self.base, **dict(zip(ordered, combination)))
+
+class ClearanceMap:
+    """
+    Coarse grid of board heights for Z-hop travel moves.
+
+        cmap = ClearanceMap(x_min=0, y_min=0, x_max=40, y_max=30,
+                            heights=[[12.0, 12.0, 9.5],
+                                     [12.0, 14.2, 9.5]],
+                            margin=1.0)
+
+    `heights` covers the rectangle (x_min, y_min)-(x_max, y_max) with
+    rows along Y and columns along X; each value is the table Z at
+    which the probe would touch the tallest feature in that cell
+    (larger Z = probe closer to the board, the emf_table convention).
+    travel_height() returns the safe altitude for an XY move: the
+    smallest cell height over the traversed region, backed off by
+    `margin`. CSProfiler.move_table uses it to translate long moves at
+    altitude and descend only at the shot position; the grid can be
+    user-supplied or built by CSProfiler.build_clearance_map's Z-probe
+    pass.
+    """
+
+    def __init__(self, x_min, y_min, x_max, y_max, heights, margin=1.0):
+        if x_max <= x_min or y_max <= y_min:
+            raise ValueError("ClearanceMap: empty extents")
+        if not heights or not heights[0]:
+            raise ValueError("ClearanceMap: empty height grid")
+        if any(len(row) != len(heights[0]) for row in heights):
+            raise ValueError("ClearanceMap: height grid is not rectangular")
+        self.x_min, self.y_min = x_min, y_min
+        self.x_max, self.y_max = x_max, y_max
+        self.heights = [list(row) for row in heights]
+        self.margin = margin
+
+    def _index_range(self, lo, hi, v_min, v_max, count):
+        """Clamped cell index range [first, last] covering [lo, hi]."""
+        span = (v_max - v_min) / count
+        first = int((min(lo, hi) - v_min) / span)
+        last = int((max(lo, hi) - v_min) / span)
+        return max(0, min(first, count - 1)), max(0, min(last, count - 1))
+
+    def height_at(self, x, y):
+        """Touch height of the cell containing (x, y), without margin."""
+        return self.travel_height(x, y, x, y) + self.margin
+
+    def travel_height(self, x0, y0, x1, y1):
+        """
+        Safe Z for an XY move, over the bounding box of the segment.
+
+        The bounding box over-covers diagonal moves, which only errs
+        toward more clearance.
+        """
+        rows = len(self.heights)
+        cols = len(self.heights[0])
+        col_first, col_last = self._index_range(x0, x1, self.x_min, self.x_max, cols)
+        row_first, row_last = self._index_range(y0, y1, self.y_min, self.y_max, rows)
+        lowest = min(
+            self.heights[row][col]
+            for row in range(row_first, row_last + 1)
+            for col in range(col_first, col_last + 1)
+        )
+        return lowest - self.margin
+
 @dataclass
 class TargetConfig:
     # TODO: future generalizations
-    # target_type: Literal["chipwhisperer"] # implement "standalone" target type, add serial number to chipwhisperer
+    # target_type: Literal["chipwhisperer"] # implement "standalone" target type
     # target_power_cycle_driver: Literal["chipwhisperer"] # implement driver for relay board and benchtop external power supply
     # target_communication_driver: Literal["chipwhisperer-serial"] # in future could also be I2C, SPI, BusPirate, CAN etc.
     # firmware_flash_driver:(chipwhisperer, openocd, script, ...)
@@ -61,6 +216,17 @@ class TargetConfig:
     firmware_build_command: List[str] # command + args (e.g. ["make", "memcpy"])
     firmware_path: str
 
+@dataclass
+class BenchConfig:
+    # One ChipWhisperer/target pair under the shared gantry; see
+    # CSProfiler.run_campaign_multibench. None addresses the only
+    # connected ChipWhisperer (single-bench setups).
+    cw_serial_number: str = None
+    # Table offset of this bench's target relative to the position grid
+    offset_x: float = 0.0
+    offset_y: float = 0.0
+    offset_z: float = 0.0
+
 @dataclass
 class Point:
     x: float
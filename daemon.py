@@ -0,0 +1,213 @@
+"""
+Persistent profiler daemon with warm hardware connections.
+
+Every profiler invocation pays full bring-up in prepare_hardware -
+cw.scope() + default_setup, the ChipShouter init with its ~5s reset,
+table and pulse-generator init - roughly 15 seconds before the first
+shot, which dominates short calibration runs. The daemon does that
+bring-up once, holds the live device sessions, and accepts campaign
+submissions over a local unix socket; a submitted campaign starts
+shooting in well under a second.
+
+Serve on the bench machine, submit from anywhere on it:
+
+    python3 -m <package>.daemon serve [--socket PATH]
+    python3 -m <package>.daemon submit campaign.json
+    python3 -m <package>.daemon status
+    python3 -m <package>.daemon shutdown
+
+A submission file is plain JSON:
+
+    {
+        "target_config": {"firmware_build_dir": ..., "firmware_build_command": [...], "firmware_path": ...},
+        "positions": [[x, y, z], ...],
+        "glitch_configs": [{"probe": ..., "voltage": ..., ...}, ...],
+        "run": {"build": false, "flash": false, "home": false}
+    }
+
+Campaigns run one at a time (they own the hardware); each builds a
+fresh CSProfiler and gets the warm ChipWhisperer/TargetSerial/
+ChipShouter/table handles injected in place of prepare_hardware. The
+pulse-generator session is the exception: run_campaign closes it on
+finish, so it is reopened per campaign (a sub-second serial handshake).
+Results land in results/ exactly as for a direct run; the reply carries
+the campaign id.
+"""
+
+import json
+import os
+import socket
+import sys
+import time
+import traceback
+
+from .config_classes import GlitchConfig, TargetConfig
+from .profile_target import CSProfiler
+
+DEFAULT_SOCKET = os.path.expanduser("~/.cache/cs-profiler/daemon.sock")
+
+
+class ProfilerDaemon:
+    def __init__(self, socket_path=DEFAULT_SOCKET):
+        self.socket_path = socket_path
+        self.started = time.monotonic()
+        self.campaigns_run = 0
+        self.cw = None
+        self.target_serial = None
+        self.cs = None
+        self.table = None
+
+    def _prepare_shared_hardware(self):
+        """The one-time bring-up normally done per invocation by
+        CSProfiler.prepare_hardware."""
+        from .CWUtils import ChipWhisperer
+        from .CSUtils import ChipShouter
+        from .lib.emf_table.table import xyzTable
+        from .simpleserial.simpleserial import TargetSerial
+        from .simpleserial.simpleserial_readers.cwlite import SimpleSerial_ChipWhispererLite
+
+        print("Daemon: hardware bring-up...")
+        start = time.monotonic()
+        self.cw = ChipWhisperer()
+        self.target_serial = TargetSerial(SimpleSerial_ChipWhispererLite, self.cw.scope)
+        self.cs = ChipShouter()
+        self.cs.disarm()
+        self.cs.start_thermal_monitor()
+        self.table = xyzTable(debug=False)
+        print(f"Daemon: hardware ready in {time.monotonic() - start:.1f}s")
+
+    def _attach_hardware(self, profiler):
+        """prepare_hardware replacement for a submitted campaign: warm
+        handles for everything but the pulse generator, which
+        run_campaign closes on finish and so is reopened per campaign."""
+        profiler.cw = self.cw
+        profiler.target_serial = self.target_serial
+        profiler.cs = self.cs
+        profiler.table = self.table
+        profiler._connect_delay_controller()
+
+    def _run_submission(self, request):
+        target_config = TargetConfig(**request["target_config"])
+        positions = [tuple(position) for position in request["positions"]]
+        glitch_configs = [GlitchConfig(**cfg) for cfg in request["glitch_configs"]]
+        run_kwargs = request.get("run", {})
+
+        profiler = CSProfiler(target_config, positions, glitch_configs)
+        profiler.prepare_hardware = lambda: self._attach_hardware(profiler)
+
+        start = time.monotonic()
+        returncode = profiler.run_campaign(
+            build=run_kwargs.get("build", False),
+            flash=run_kwargs.get("flash", False),
+            home=run_kwargs.get("home", False),
+            resume_from=run_kwargs.get("resume_from"),
+        )
+        self.campaigns_run += 1
+        return {
+            "status": "ok" if returncode == 0 else "partial",
+            "returncode": returncode,
+            "campaign_id": profiler._campaign_id,
+            "wall_s": round(time.monotonic() - start, 1),
+        }
+
+    def _handle(self, request):
+        command = request.get("command")
+        if command == "run":
+            return self._run_submission(request)
+        if command == "status":
+            return {
+                "status": "ok",
+                "uptime_s": round(time.monotonic() - self.started, 1),
+                "campaigns_run": self.campaigns_run,
+            }
+        if command == "shutdown":
+            return {"status": "ok", "shutdown": True}
+        return {"status": "error", "error": f"unknown command {command!r}"}
+
+    def serve(self):
+        """Accept loop: one request per connection, campaigns handled
+        sequentially on this thread (they own the hardware, and signal
+        handling in _campaign_setup needs the main thread anyway)."""
+        self._prepare_shared_hardware()
+
+        os.makedirs(os.path.dirname(self.socket_path), exist_ok=True)
+        if os.path.exists(self.socket_path):
+            os.unlink(self.socket_path)
+        server = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        server.bind(self.socket_path)
+        server.listen(1)
+        print(f"Daemon: listening on {self.socket_path}")
+
+        try:
+            while True:
+                connection, _ = server.accept()
+                with connection:
+                    try:
+                        request = json.loads(_recv_line(connection))
+                        reply = self._handle(request)
+                    except Exception as e:
+                        # A bad submission must not take the warm
+                        # hardware down with it
+                        traceback.print_exc()
+                        reply = {"status": "error", "error": str(e)}
+                    connection.sendall((json.dumps(reply) + "\n").encode())
+                    if reply.get("shutdown"):
+                        return 0
+        finally:
+            server.close()
+            if os.path.exists(self.socket_path):
+                os.unlink(self.socket_path)
+
+
+def _recv_line(connection):
+    chunks = []
+    while True:
+        chunk = connection.recv(65536)
+        if not chunk:
+            break
+        chunks.append(chunk)
+        if chunk.endswith(b"\n"):
+            break
+    return b"".join(chunks).decode()
+
+
+def submit(request, socket_path=DEFAULT_SOCKET):
+    """Send one request dict to a running daemon and return its reply.
+    Blocks for the campaign duration on 'run' submissions."""
+    client = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    try:
+        client.connect(socket_path)
+        client.sendall((json.dumps(request) + "\n").encode())
+        return json.loads(_recv_line(client))
+    finally:
+        client.close()
+
+
+def main():
+    args = sys.argv[1:]
+    socket_path = DEFAULT_SOCKET
+    if "--socket" in args:
+        index = args.index("--socket")
+        socket_path = args[index + 1]
+        del args[index:index + 2]
+
+    command = args[0] if args else None
+    if command == "serve":
+        return ProfilerDaemon(socket_path).serve()
+    if command == "submit":
+        with open(args[1]) as f:
+            request = json.load(f)
+        request["command"] = "run"
+        reply = submit(request, socket_path)
+        print(json.dumps(reply, indent=4))
+        return 0 if reply.get("status") in ("ok", "partial") else 1
+    if command in ("status", "shutdown"):
+        print(json.dumps(submit({"command": command}, socket_path), indent=4))
+        return 0
+
+    print("usage: python3 -m <package>.daemon serve|submit <spec.json>|status|shutdown [--socket PATH]")
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,91 @@
+"""
+Campaign-level error budget governor.
+
+Retry handling in CSProfiler.test_position is purely local: three
+retries per execution, then skip the position. A dying ChipShouter
+therefore degrades into three full recovery cycles per position and the
+campaign grinds on for days at a fraction of its rate without ever
+failing outright. The governor watches the failure stream globally -
+error counts per exception type over a sliding time window - and
+escalates when a type exceeds its budget:
+
+    over budget      pause the campaign briefly (backoff) and raise an
+                     alert through the metrics endpoint
+    over 2x budget   stop retrying that incident; skip and continue
+    over 4x budget   abort the campaign (the standard partial-save path
+                     writes the checkpoint, so it resumes cleanly)
+
+Enable with profiler.enable_error_governor() before the campaign;
+budgets default to DEFAULT_BUDGET per type and can be tuned per
+exception type name.
+"""
+
+import time
+from collections import deque
+
+# Errors of one type tolerated inside the window before escalation
+DEFAULT_BUDGET = 10
+DEFAULT_WINDOW_S = 600.0
+DEFAULT_PAUSE_S = 30.0
+
+
+class ErrorBudgetGovernor:
+    def __init__(self, window_s=DEFAULT_WINDOW_S, default_budget=DEFAULT_BUDGET,
+                 budgets=None, pause_s=DEFAULT_PAUSE_S):
+        """
+        Parameters
+        ----------
+        window_s : float, optional
+            Sliding window length in seconds.
+        default_budget : int, optional
+            Per-type error budget inside the window.
+        budgets : dict, optional
+            Per-type overrides, keyed by exception type name
+            (e.g. {"ShouterCommError": 5}).
+        pause_s : float, optional
+            Backoff applied when a budget is first exceeded.
+        """
+        self.window_s = window_s
+        self.default_budget = default_budget
+        self.budgets = dict(budgets or {})
+        self.pause_s = pause_s
+        self._events = deque()  # (monotonic timestamp, type name)
+        # Scraped by the metrics endpoint as the alert signal
+        self.last_action = "none"
+        self.actions_taken = {"pause": 0, "skip": 0, "abort": 0}
+
+    def _prune(self, now):
+        while self._events and now - self._events[0][0] > self.window_s:
+            self._events.popleft()
+
+    def record(self, exc):
+        """
+        Book one caught error and return the escalation it triggers:
+        None (within budget), "pause", "skip" or "abort".
+        """
+        name = type(exc).__name__
+        now = time.monotonic()
+        self._events.append((now, name))
+        self._prune(now)
+
+        count = sum(1 for _, event_name in self._events if event_name == name)
+        budget = self.budgets.get(name, self.default_budget)
+        if count <= budget:
+            return None
+        if count > 4 * budget:
+            action = "abort"
+        elif count > 2 * budget:
+            action = "skip"
+        else:
+            action = "pause"
+        self.last_action = action
+        self.actions_taken[action] += 1
+        return action
+
+    def window_counts(self):
+        """{type name: errors inside the current window}, for metrics."""
+        self._prune(time.monotonic())
+        counts = {}
+        for _, name in self._events:
+            counts[name] = counts.get(name, 0) + 1
+        return counts
@@ -0,0 +1,200 @@
+"""
+Typed exception taxonomy shared by the hardware utilities and the profiler.
+
+Recovery in CSProfiler.test_position used to classify failures by
+comparing str(e) against literal messages, which silently broke whenever
+a message gained detail. Raising these types at the source lets the
+profiler pick a recovery strategy from a dispatch table keyed by
+exception type (see CSProfiler.register_error_handler) instead of
+walking string comparisons.
+"""
+
+import gzip
+import json
+from collections import deque
+
+
+class ProfilerError(Exception):
+    """Base class for all profiler-raised errors."""
+
+
+class ShouterError(ProfilerError):
+    """Base class for ChipShouter problems; register a handler for this
+    type to cover communication and fault errors alike."""
+
+
+class ShouterCommError(ShouterError):
+    """The ChipShouter serial link stopped responding."""
+
+
+class ShouterFaultError(ShouterError):
+    """The ChipShouter reports faults that could not be cleared."""
+
+
+class ArmFault(ShouterFaultError):
+    """Arming was refused because the ChipShouter is in fault state."""
+
+
+class ArmingTimeoutError(ShouterError, TimeoutError):
+    def __init__(self, message="ChipShouter: Arming failed due to timeout!"):
+        super().__init__(message)
+
+
+class ScopeError(ProfilerError):
+    """The measurement oscilloscope refused a command or captured no
+    measurable pulse (see ScopeUtils.Oscilloscope)."""
+
+
+class TargetError(ProfilerError):
+    """Base class for target-side problems."""
+
+
+class TargetResetTimeout(TargetError, TimeoutError):
+    """The target did not announce itself after a reset attempt."""
+
+
+class DeviceLostError(ProfilerError):
+    """A watched USB device dropped off the bus (udev monitor, see
+    USBUtils.UdevMonitor); carries the lost logical device names so the
+    recovery dispatch can power-cycle exactly those."""
+
+    def __init__(self, devices):
+        super().__init__(f"USB devices lost: {', '.join(sorted(devices))}")
+        self.devices = set(devices)
+
+
+class DeviceRecoveryError(ProfilerError):
+    """A concurrent device recovery pass left at least one device dead."""
+
+
+class ErrorBudgetExceeded(ProfilerError):
+    """The campaign-level error governor ordered an abort (see
+    error_budget.py); raised out of test_position so the standard
+    partial-save path checkpoints the campaign."""
+
+
+class CampaignInterrupted(ProfilerError):
+    """An operator interrupt (Ctrl+C) consumed at an execution
+    boundary; raised out of test_position so the campaign runners take
+    the fast exit path (checkpoint only, no full results
+    serialization - see CSProfiler.ctrl_c_signal_handler)."""
+
+
+# Messages of third-party exceptions (chipshouter library) that indicate
+# a dead serial link; the library raises plain exceptions so the message
+# is the only classification signal available.
+_SHOUTER_COMM_MESSAGES = (
+    "No response from shouter",
+)
+
+
+def classify(exc):
+    """
+    Map a third-party exception onto the taxonomy where recognized.
+
+    Returns a ProfilerError chained to the original (so the traceback
+    keeps the source), or the exception unchanged when it is already
+    typed or not recognized.
+    """
+    if isinstance(exc, ProfilerError):
+        return exc
+    message = str(exc)
+    if any(fragment in message for fragment in _SHOUTER_COMM_MESSAGES):
+        wrapped = ShouterCommError(message)
+        wrapped.__cause__ = exc
+        return wrapped
+    return exc
+
+
+class ErrorLog:
+    """
+    Bounded store for the profiler's handled-error stream.
+
+    CSProfiler.catched_errors used to be a plain list serialized
+    wholesale into the results JSON; a flaky ChipShouter over a
+    week-long campaign turns that into hundreds of thousands of
+    stringified exceptions that dominate the file and every load of it.
+    The log keeps a ring of the most recent entries plus per-type totals
+    in memory, and writes every entry through to a gzip-compressed JSONL
+    sidecar once open_spill is called, so nothing is lost - the results
+    JSON carries summary() and the sidecar path.
+
+    The list surface the append sites and metrics.py rely on is kept:
+    append(dict), extend, len() (the running total, not the ring
+    length), iteration (over the recent ring).
+    """
+
+    RECENT_LIMIT = 200
+
+    def __init__(self, recent_limit=RECENT_LIMIT):
+        self.recent = deque(maxlen=recent_limit)
+        self.counts = {}
+        self.total = 0
+        self.spill_path = None
+        self._spill_file = None
+
+    def open_spill(self, path):
+        """Start (or, on resume, continue) the compressed sidecar;
+        entries appended from here on are written through. Appending to
+        an existing file adds a gzip member, which readers concatenate
+        transparently."""
+        self.spill_path = path
+        self._spill_file = gzip.open(path, "at")
+
+    def append(self, entry):
+        key = entry.get("type", "unknown") if isinstance(entry, dict) \
+            else "unknown"
+        self.counts[key] = self.counts.get(key, 0) + 1
+        self.total += 1
+        self.recent.append(entry)
+        if self._spill_file is not None:
+            self._spill_file.write(json.dumps(entry, default=str) + "\n")
+            # Per-entry flush: errors are rare next to shots, and a
+            # crash right after one is exactly when the log matters
+            self._spill_file.flush()
+
+    def extend(self, entries):
+        for entry in entries:
+            self.append(entry)
+
+    def __len__(self):
+        return self.total
+
+    def __bool__(self):
+        return self.total > 0
+
+    def __iter__(self):
+        return iter(self.recent)
+
+    def summary(self):
+        """The bounded form stored in results and checkpoints: running
+        totals, per-type counts, the recent ring, and the sidecar path
+        holding the full stream."""
+        out = {
+            "total": self.total,
+            "by_type": dict(self.counts),
+            "recent": list(self.recent),
+        }
+        if self.spill_path:
+            out["log"] = self.spill_path
+        return out
+
+    @classmethod
+    def from_state(cls, state, recent_limit=RECENT_LIMIT):
+        """Rebuild from a checkpointed summary(); a legacy checkpoint
+        holding the raw list becomes the ring and counts (the caller
+        reopens the spill, if any, via open_spill)."""
+        log = cls(recent_limit)
+        if isinstance(state, list):
+            log.extend(state)
+            return log
+        log.total = state.get("total", 0)
+        log.counts = dict(state.get("by_type") or {})
+        log.recent.extend(state.get("recent") or [])
+        log.spill_path = state.get("log")
+        return log
+
+    def close(self):
+        if self._spill_file is not None:
+            self._spill_file.close()
+            self._spill_file = None
@@ -0,0 +1,79 @@
+"""
+Online ETA estimation for running campaigns.
+
+Naive extrapolation (elapsed / done * remaining) is wildly wrong here
+because fault-heavy regions run an order of magnitude slower than quiet
+ones: every fault costs a reset roundtrip, crashes cost dead timeouts.
+EtaEstimator instead keeps exponentially weighted means of the observed
+execution duration per result category, of the category mix, and of the
+table move time, and projects the campaign plan (remaining executions
+and moves) through them. Updates are a handful of float operations per
+execution; the estimate converges to local conditions as the scan moves
+across the die.
+"""
+
+
+class EtaEstimator:
+    # EWMA weight: ~1/ALPHA samples of memory, so the estimate tracks
+    # regional changes within a couple hundred executions
+    ALPHA = 0.02
+
+    def __init__(self):
+        self.executions_done = 0
+        # Per-category EWMA of the execution wall time (seconds)
+        self._duration = {}
+        # EWMA of the category mix (probabilities, sum ~1)
+        self._mix = {}
+        self._move_s = None
+
+    def record_execution(self, category, seconds):
+        """Book one finished execution (result category + wall time)."""
+        self.executions_done += 1
+
+        previous = self._duration.get(category)
+        self._duration[category] = seconds if previous is None else \
+            previous + self.ALPHA * (seconds - previous)
+
+        for key in self._mix:
+            self._mix[key] *= (1.0 - self.ALPHA)
+        self._mix[category] = self._mix.get(category, 0.0) + self.ALPHA
+
+    def record_move(self, seconds):
+        """Book one table move (seconds)."""
+        self._move_s = seconds if self._move_s is None else \
+            self._move_s + self.ALPHA * (seconds - self._move_s)
+
+    def expected_execution_s(self):
+        """Mix-weighted expected duration of one execution, or None
+        before the first sample."""
+        if not self._duration:
+            return None
+        total_weight = sum(self._mix.get(key, 0.0) for key in self._duration)
+        if total_weight <= 0:
+            return None
+        return sum(self._mix.get(key, 0.0) * duration
+                   for key, duration in self._duration.items()) / total_weight
+
+    def eta_seconds(self, remaining_executions, remaining_moves):
+        """Projected seconds to completion, or None before any samples."""
+        per_execution = self.expected_execution_s()
+        if per_execution is None:
+            return None
+        eta = remaining_executions * per_execution
+        if self._move_s is not None:
+            eta += remaining_moves * self._move_s
+        return eta
+
+    @staticmethod
+    def format_eta(seconds):
+        """Compact human form ('2d03h', '3h12m', '45m03s', '32s')."""
+        if seconds is None:
+            return "?"
+        seconds = int(seconds)
+        if seconds >= 86400:
+            return f"{seconds // 86400}d{seconds % 86400 // 3600:02d}h"
+        if seconds >= 3600:
+            return f"{seconds // 3600}h{seconds % 3600 // 60:02d}m"
+        if seconds >= 60:
+            return f"{seconds // 60}m{seconds % 60:02d}s"
+        return f"{seconds}s"
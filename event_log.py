@@ -0,0 +1,202 @@
+"""
+Binary per-execution event log.
+
+The JSONL stream log costs JSON parse time proportional to the archive
+at every analysis pass. This module defines a compact binary record
+format for the same per-execution events: a file header with magic and
+version, then fixed-header records (wall-clock timestamp, position
+index, config index, category) followed by a variable extradata
+payload, each record closed by a CRC32 over its bytes so a torn write
+at the tail (power loss mid-append) is detected and cleanly ignored
+instead of corrupting the parse. Result categories are stored as one
+byte indexing a table built from in-band definition records, so the
+file stays self-describing when a campaign adds a category mid-run.
+
+The reader memory-maps the file and yields records lazily - iteration
+touches only the pages it walks, and the payload of a record is
+decoded only when yielded. CSProfiler writes this format when
+stream_format is set to "binary" (stream_<id>.bin); the JSONL-only
+consumers (visualize.py --follow, export_parquet.py) get a lossless
+conversion:
+
+    python3 -m <package>.event_log dump results/stream_3.bin
+    python3 -m <package>.event_log convert results/stream_3.bin [out.jsonl]
+"""
+
+import json
+import mmap
+import os
+import struct
+import sys
+import time
+import zlib
+
+MAGIC = b"CSEV"
+VERSION = 1
+
+_FILE_HEADER = struct.Struct("<4sH")
+# timestamp f64, position u32, config u32, category u8, payload length u32
+_RECORD_HEADER = struct.Struct("<dIIBI")
+_CRC = struct.Struct("<I")
+
+# Category byte of a definition record; its payload is the utf-8 name
+# being assigned the next free index
+_CATEGORY_DEF = 0xFF
+
+
+class EventLogWriter:
+    """
+    Append-only writer. Reopening an existing log continues it: the
+    header is verified and the category table is rebuilt from the
+    definition records already in the file (a header-skipping scan, no
+    payload decoding).
+    """
+
+    def __init__(self, path, categories=()):
+        self.path = path
+        self._categories = {}
+        if os.path.exists(path) and os.path.getsize(path):
+            for name, index in _scan_categories(path):
+                self._categories[name] = index
+            self._file = open(path, "ab")
+        else:
+            self._file = open(path, "ab")
+            self._file.write(_FILE_HEADER.pack(MAGIC, VERSION))
+        for name in categories:
+            self._category_index(name)
+
+    def _category_index(self, name):
+        index = self._categories.get(name)
+        if index is None:
+            index = len(self._categories)
+            if index >= _CATEGORY_DEF:
+                raise ValueError("category table full")
+            self._write_record(0.0, 0, 0, _CATEGORY_DEF,
+                              name.encode("utf-8"))
+            self._categories[name] = index
+        return index
+
+    def _write_record(self, timestamp, position_index, config_index,
+                      category_byte, payload):
+        header = _RECORD_HEADER.pack(timestamp, position_index,
+                                     config_index, category_byte,
+                                     len(payload))
+        self._file.write(header)
+        self._file.write(payload)
+        self._file.write(_CRC.pack(zlib.crc32(payload, zlib.crc32(header))))
+
+    def append(self, position_index, config_index, result_category,
+               data=None, timestamp=None):
+        """Append one execution event; `data` is the JSON-serializable
+        extradata (already blob-serialized by the caller, like the JSONL
+        records). Flushed per record, matching the JSONL writer's
+        crash-loses-at-most-one guarantee."""
+        payload = b"" if data is None else \
+            json.dumps(data, separators=(",", ":")).encode("utf-8")
+        self._write_record(
+            time.time() if timestamp is None else timestamp,
+            position_index, config_index,
+            self._category_index(result_category), payload,
+        )
+        self._file.flush()
+
+    def close(self):
+        self._file.close()
+
+
+def _iter_raw(path):
+    """(timestamp, position, config, category_byte, payload) per intact
+    record, memory-mapped. Stops at the first record whose CRC or length
+    does not check out - appends are sequential, so everything after a
+    torn record is unreliable."""
+    with open(path, "rb") as f:
+        size = os.path.getsize(path)
+        if size < _FILE_HEADER.size:
+            return
+        view = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        try:
+            magic, version = _FILE_HEADER.unpack_from(view, 0)
+            if magic != MAGIC:
+                raise ValueError(f"{path}: not an event log (bad magic)")
+            if version > VERSION:
+                raise ValueError(f"{path}: event log version {version}"
+                                 f" is newer than this reader")
+            offset = _FILE_HEADER.size
+            while offset + _RECORD_HEADER.size + _CRC.size <= size:
+                header = view[offset:offset + _RECORD_HEADER.size]
+                fields = _RECORD_HEADER.unpack(header)
+                payload_end = offset + _RECORD_HEADER.size + fields[4]
+                if payload_end + _CRC.size > size:
+                    break
+                payload = view[offset + _RECORD_HEADER.size:payload_end]
+                (crc,) = _CRC.unpack_from(view, payload_end)
+                if crc != zlib.crc32(payload, zlib.crc32(header)):
+                    break
+                yield fields[0], fields[1], fields[2], fields[3], payload
+                offset = payload_end + _CRC.size
+        finally:
+            view.close()
+
+
+def _scan_categories(path):
+    """(name, index) of every category definition record, in order."""
+    index = 0
+    for _, _, _, category_byte, payload in _iter_raw(path):
+        if category_byte == _CATEGORY_DEF:
+            yield payload.decode("utf-8"), index
+            index += 1
+
+
+def iter_records(path):
+    """
+    Lazily yield the log's events as dicts shaped like the JSONL stream
+    records - position_index, config_index, result_category, optional
+    data - plus the record timestamp. Torn tail records are skipped.
+    """
+    categories = []
+    for timestamp, position, config, category_byte, payload in \
+            _iter_raw(path):
+        if category_byte == _CATEGORY_DEF:
+            categories.append(payload.decode("utf-8"))
+            continue
+        record = {
+            "timestamp": timestamp,
+            "position_index": position,
+            "config_index": config,
+            "result_category": categories[category_byte],
+        }
+        if payload:
+            record["data"] = json.loads(payload)
+        yield record
+
+
+def convert(path, out_path=None):
+    """Write the log as a JSONL stream file (for the JSONL-only
+    consumers); returns the output path."""
+    if out_path is None:
+        out_path = (path[:-4] if path.endswith(".bin") else path) + ".jsonl"
+    with open(out_path, "w") as f:
+        for record in iter_records(path):
+            record.pop("timestamp", None)
+            f.write(json.dumps(record, separators=(",", ":")) + "\n")
+    return out_path
+
+
+def main():
+    if len(sys.argv) < 3 or sys.argv[1] not in ("dump", "convert"):
+        print("usage: python3 -m <package>.event_log dump <stream.bin>\n"
+              "       python3 -m <package>.event_log convert <stream.bin>"
+              " [out.jsonl]")
+        return 1
+    if sys.argv[1] == "dump":
+        for record in iter_records(sys.argv[2]):
+            print(json.dumps(record, separators=(",", ":")))
+    else:
+        out = convert(sys.argv[2],
+                      sys.argv[3] if len(sys.argv) > 3 else None)
+        print(f"Wrote {out}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,225 @@
+"""
+Standalone HTML export of a campaign's fault map.
+
+Colleagues without the Tk/matplotlib stack (or the multi-GB results
+JSON) get one self-contained .html: the fault map pre-rendered at
+several zoom levels per glitch config (base64-embedded PNGs, the page
+swaps in the sharpest one for the current zoom), a config selector, and
+a compact per-config counter table. All heavy work - classification,
+rasterization - happens once at export time, viewing is instant in any
+browser.
+
+    python3 export_html.py results/results_3.json [out.html]
+
+The point colors come from the same vectorized classification arrays
+(and sidecar heatmap cache) as the interactive viewer, so both always
+agree.
+"""
+
+import base64
+import io
+import json
+import os
+import sys
+
+import numpy as np
+import matplotlib
+matplotlib.use("Agg")  # headless: export runs on build/CI machines
+import matplotlib.pyplot as plt
+
+try:
+    from .visualize import load_results, compute_or_load_heatmaps, COUNTER_KEYS
+except ImportError:
+    from visualize import load_results, compute_or_load_heatmaps, COUNTER_KEYS
+
+# Rendered tile widths (px); the page picks the smallest one that is
+# still sharp at the current zoom
+TILE_WIDTHS = (256, 512, 1024, 2048)
+
+
+def _raster(xs, ys, rgba, width):
+    """Rasterize the point cloud into a mean-color RGBA image of the
+    given pixel width (height follows the data aspect ratio); empty
+    bins stay white."""
+    x_span = max(xs.max() - xs.min(), 1e-9)
+    y_span = max(ys.max() - ys.min(), 1e-9)
+    height = max(int(round(width * y_span / x_span)), 1)
+    value_range = [[xs.min(), xs.max()], [ys.min(), ys.max()]]
+
+    counts, _, _ = np.histogram2d(xs, ys, bins=(width, height), range=value_range)
+    image = np.ones((width, height, 4))
+    for channel in range(4):
+        sums, _, _ = np.histogram2d(
+            xs, ys, bins=(width, height), range=value_range,
+            weights=rgba[:, channel]
+        )
+        image[..., channel] = np.where(
+            counts > 0, sums / np.where(counts > 0, counts, 1),
+            image[..., channel]
+        )
+
+    # histogram2d indexes (x, y); rows must be y, with y increasing
+    # downwards like the viewer (inverted y axis)
+    return np.transpose(image, (1, 0, 2))
+
+
+def _png_base64(image):
+    buffer = io.BytesIO()
+    plt.imsave(buffer, image, format="png")
+    return base64.b64encode(buffer.getvalue()).decode("ascii")
+
+
+def _config_label(config):
+    parts = []
+    for key in ("probe", "voltage", "pulse_width"):
+        if key in config:
+            parts.append(f"{key}={config[key]}")
+    return ", ".join(parts)
+
+
+_PAGE_TEMPLATE = """<!DOCTYPE html>
+<html>
+<head>
+<meta charset="utf-8">
+<title>CS-Profiler fault map - %(title)s</title>
+<style>
+body { font-family: sans-serif; margin: 1em; }
+#map { width: 640px; height: 640px; border: 1px solid #888;
+       overflow: hidden; position: relative; cursor: grab; }
+#map img { position: absolute; transform-origin: 0 0;
+           image-rendering: pixelated; user-select: none; }
+table { border-collapse: collapse; margin-top: 1em; }
+td, th { border: 1px solid #aaa; padding: 2px 8px; text-align: right; }
+th { background: #eee; }
+.legend span { display: inline-block; width: 12px; height: 12px;
+               margin-right: 4px; border: 1px solid black; }
+</style>
+</head>
+<body>
+<h2>Fault Injection Point Matrix - %(title)s</h2>
+<p>Config: <select id="config"></select>
+   <span class="legend">
+     <span style="background:green"></span>Normal
+     <span style="background:#ff0000"></span>Faults
+     <span style="background:#0000ff"></span>Resets &amp; Crashes
+     <span style="background:gray"></span>No data
+   </span></p>
+<div id="map"><img id="tile" draggable="false"></div>
+<p>Scroll to zoom, drag to pan.</p>
+%(table)s
+<script>
+var TILES = %(tiles)s;  /* [config][level] = {w: px, src: dataURI} */
+var config = 0, scale = 1, panX = 0, panY = 0;
+var map = document.getElementById("map");
+var tile = document.getElementById("tile");
+var select = document.getElementById("config");
+TILES.forEach(function (_, i) {
+    var option = document.createElement("option");
+    option.value = i; option.textContent = "Config " + i;
+    select.appendChild(option);
+});
+function render() {
+    /* smallest pre-rendered tile still sharp at this zoom */
+    var levels = TILES[config];
+    var wanted = map.clientWidth * scale;
+    var level = levels[levels.length - 1];
+    for (var i = 0; i < levels.length; i++) {
+        if (levels[i].w >= wanted) { level = levels[i]; break; }
+    }
+    if (tile.src !== level.src) tile.src = level.src;
+    var shown = map.clientWidth * scale;
+    tile.style.transform = "translate(" + panX + "px," + panY + "px) " +
+                           "scale(" + (shown / level.w) + ")";
+}
+select.addEventListener("change", function () {
+    config = parseInt(select.value, 10); render();
+});
+map.addEventListener("wheel", function (event) {
+    event.preventDefault();
+    var factor = event.deltaY < 0 ? 1.25 : 0.8;
+    var next = Math.min(Math.max(scale * factor, 1), 64);
+    factor = next / scale;
+    /* zoom around the cursor */
+    var rect = map.getBoundingClientRect();
+    panX = (panX - (event.clientX - rect.left)) * factor + (event.clientX - rect.left);
+    panY = (panY - (event.clientY - rect.top)) * factor + (event.clientY - rect.top);
+    scale = next;
+    render();
+});
+var dragging = null;
+map.addEventListener("mousedown", function (event) {
+    dragging = {x: event.clientX - panX, y: event.clientY - panY};
+});
+window.addEventListener("mousemove", function (event) {
+    if (!dragging) return;
+    panX = event.clientX - dragging.x;
+    panY = event.clientY - dragging.y;
+    render();
+});
+window.addEventListener("mouseup", function () { dragging = null; });
+render();
+</script>
+</body>
+</html>
+"""
+
+
+def _counter_table(data):
+    """Compact per-config summary table: parameters and counter totals."""
+    header = "".join(f"<th>{key}</th>" for key in COUNTER_KEYS)
+    rows = []
+    for config_index, config in enumerate(data["glitch_configs"]):
+        results = config.get("results", {})
+        cells = []
+        for key in COUNTER_KEYS:
+            values = results.get(key, 0)
+            total = int(np.sum(values)) if isinstance(values, list) else int(values or 0)
+            cells.append(f"<td>{total}</td>")
+        rows.append(
+            f"<tr><td>{config_index}</td>"
+            f"<td style='text-align:left'>{_config_label(config)}</td>"
+            f"{''.join(cells)}</tr>"
+        )
+    return (
+        "<table><tr><th>#</th><th>config</th>" + header + "</tr>"
+        + "".join(rows) + "</table>"
+    )
+
+
+def export_html(json_path, out_path=None):
+    """Render one results file into a standalone HTML page."""
+    data, _ = load_results(json_path)
+    fill, _ = compute_or_load_heatmaps(json_path, data)
+
+    positions = np.asarray(data["positions"], dtype=float)
+    xs, ys = positions[:, 0], positions[:, 1]
+
+    tiles = []
+    for config_index in range(len(data["glitch_configs"])):
+        levels = []
+        for width in TILE_WIDTHS:
+            image = _raster(xs, ys, fill[config_index], width)
+            levels.append({
+                "w": width,
+                "src": "data:image/png;base64," + _png_base64(image),
+            })
+        tiles.append(levels)
+
+    page = _PAGE_TEMPLATE % {
+        "title": os.path.basename(json_path),
+        "tiles": json.dumps(tiles),
+        "table": _counter_table(data),
+    }
+    if out_path is None:
+        out_path = os.path.splitext(json_path.replace(".json.gz", ".json"))[0] + ".html"
+    with open(out_path, "w") as f:
+        f.write(page)
+    print(f"Wrote {out_path} ({os.path.getsize(out_path) >> 10} KiB)")
+    return out_path
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("usage: python3 export_html.py <results_N.json[.gz]> [out.html]")
+        sys.exit(1)
+    export_html(sys.argv[1], sys.argv[2] if len(sys.argv) > 2 else None)
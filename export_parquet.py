@@ -0,0 +1,292 @@
+"""
+Parquet export of per-execution fault records for the analysis notebooks.
+
+The notebooks used to rebuild pandas frames from the results JSON by
+hand, re-parsing hex payloads and nested extradata on every load. This
+exporter flattens a campaign into one typed row per execution (campaign,
+config/position indices, coordinates, the GlitchConfig parameters,
+result category, fault payload bytes), so a load becomes
+
+    df = pandas.read_parquet("results/results_3.parquet")
+
+Input is either the per-execution stream log (stream_N.jsonl, exact one
+row per record) or a legacy results_N.json[.gz]; legacy counters without
+per-execution extradata are folded into aggregate rows carrying their
+count. Blob references are resolved against the campaign's sidecar
+store, so fault buffers come out as real bytes columns.
+
+Run directly to export one campaign:
+
+    python3 export_parquet.py results/stream_3.jsonl [out.parquet]
+    python3 export_parquet.py results/results_3.json [out.parquet]
+
+Requires pyarrow (not part of the profiler's runtime dependencies).
+"""
+
+import os
+import re
+import sys
+import json
+import gzip
+
+# GlitchConfig parameters carried on every row, in column order
+CONFIG_FIELDS = ("probe", "voltage", "pulse_width", "pulse_spacing",
+                 "pulse_repeats", "pulse_offset")
+
+_HEX_PAYLOAD = re.compile(r"^(?:[0-9A-F]{2})+$")
+
+
+def _pyarrow():
+    """Import pyarrow on first use so the profiler itself never needs it."""
+    try:
+        import pyarrow as pa
+        import pyarrow.parquet as pq
+    except ImportError as e:
+        raise ImportError(
+            "Parquet export requires pyarrow (pip install pyarrow)"
+        ) from e
+    return pa, pq
+
+
+def _schema(pa):
+    category = pa.dictionary(pa.int32(), pa.string())
+    return pa.schema([
+        ("campaign", pa.int32()),
+        ("config_index", pa.int32()),
+        ("position_index", pa.int32()),
+        ("x", pa.float64()),
+        ("y", pa.float64()),
+        ("z", pa.float64()),
+        ("probe", category),
+        ("voltage", pa.float64()),
+        ("pulse_width", pa.float64()),
+        ("pulse_spacing", pa.float64()),
+        ("pulse_repeats", pa.int32()),
+        ("pulse_offset", pa.float64()),
+        ("result_category", category),
+        # 1 for per-execution records; legacy counter remainders without
+        # extradata are folded into one aggregate row carrying the count
+        ("count", pa.int32()),
+        ("fault_bytes", pa.binary()),
+        # Structured extradata that is not a plain byte payload (e.g. the
+        # delta-decoded memcpy dicts), kept as compact JSON
+        ("extradata_json", pa.string()),
+    ])
+
+
+def _resolve_payload(data, blob_path):
+    """
+    Flatten one record's extradata into (fault_bytes, extradata_json).
+
+    Blob references are fetched from the sidecar store and inline hex
+    payloads (make_json_serializable's bytes encoding) are decoded, so
+    byte buffers land in the binary column; anything structured is kept
+    as compact JSON with nested payloads resolved to hex.
+    """
+    def resolve(obj):
+        if isinstance(obj, dict):
+            if set(obj) == {"blob_offset", "blob_length"} and blob_path:
+                with open(blob_path, "rb") as f:
+                    f.seek(obj["blob_offset"])
+                    return f.read(obj["blob_length"])
+            return {k: resolve(v) for k, v in obj.items()}
+        if isinstance(obj, list):
+            return [resolve(v) for v in obj]
+        if isinstance(obj, str) and _HEX_PAYLOAD.match(obj):
+            return bytes.fromhex(obj)
+        return obj
+
+    resolved = resolve(data)
+    if resolved is None:
+        return None, None
+    if isinstance(resolved, (bytes, bytearray)):
+        return bytes(resolved), None
+
+    def rehex(obj):
+        if isinstance(obj, (bytes, bytearray)):
+            return bytes(obj).hex().upper()
+        if isinstance(obj, dict):
+            return {k: rehex(v) for k, v in obj.items()}
+        if isinstance(obj, list):
+            return [rehex(v) for v in obj]
+        return obj
+
+    return None, json.dumps(rehex(resolved), separators=(",", ":"))
+
+
+def _campaign_id_from_path(path):
+    match = re.search(r"(?:results|stream)_(\d+)", os.path.basename(path))
+    return int(match.group(1)) if match else -1
+
+
+def _load_json(path):
+    opener = gzip.open if path.endswith(".gz") else open
+    with opener(path, "rt") as f:
+        return json.load(f)
+
+
+def _find_results_file(stream_path, campaign_id):
+    """Sibling results_N[_partial].json[.gz] of a stream log, for the
+    positions and GlitchConfig parameters the stream records reference."""
+    directory = os.path.dirname(stream_path) or "."
+    for suffix in ("", "_partial"):
+        for ext in (".json", ".json.gz"):
+            candidate = os.path.join(
+                directory, f"results_{campaign_id}{suffix}{ext}"
+            )
+            if os.path.exists(candidate):
+                return candidate
+    return None
+
+
+def _row(campaign_id, config, position_index, position, config_index,
+         category, count, fault_bytes, extradata_json):
+    x, y, z = (list(position) + [None, None, None])[:3]
+    row = {
+        "campaign": campaign_id,
+        "config_index": config_index,
+        "position_index": position_index,
+        "x": x, "y": y, "z": z,
+        "result_category": category,
+        "count": count,
+        "fault_bytes": fault_bytes,
+        "extradata_json": extradata_json,
+    }
+    for field in CONFIG_FIELDS:
+        row[field] = config.get(field) if config else None
+    return row
+
+
+def _write_table(rows, out_path):
+    pa, pq = _pyarrow()
+    schema = _schema(pa)
+    columns = {
+        field.name: pa.array([row[field.name] for row in rows],
+                             type=field.type)
+        for field in schema
+    }
+    pq.write_table(pa.table(columns, schema=schema), out_path)
+    print(f"Wrote {len(rows)} rows -> {out_path}")
+
+
+def export_stream(stream_path, out_path=None, results_file=None):
+    """
+    Export a stream log (stream_N.jsonl): exactly one row per recorded
+    execution, in execution order. Positions and config parameters come
+    from the campaign's results JSON (located automatically next to the
+    stream unless `results_file` is given); without one the coordinate
+    and config columns are null.
+    """
+    campaign_id = _campaign_id_from_path(stream_path)
+    if results_file is None:
+        results_file = _find_results_file(stream_path, campaign_id)
+
+    positions, configs, blob_path = [], [], None
+    if results_file:
+        log_json = _load_json(results_file)
+        positions = log_json.get("positions", [])
+        configs = log_json.get("glitch_configs", [])
+        blob_path = log_json.get("fault_blobs")
+    if blob_path is None:
+        candidate = os.path.join(
+            os.path.dirname(stream_path) or ".", f"blobs_{campaign_id}.bin"
+        )
+        blob_path = candidate if os.path.exists(candidate) else None
+
+    rows = []
+    with open(stream_path) as f:
+        for line in f:
+            try:
+                record = json.loads(line)
+            except ValueError:
+                continue  # partial trailing line of an aborted campaign
+            position_index = record["position_index"]
+            config_index = record["config_index"]
+            position = (positions[position_index]
+                        if position_index < len(positions) else [])
+            config = configs[config_index] if config_index < len(configs) else None
+            fault_bytes, extradata_json = _resolve_payload(
+                record.get("data"), blob_path
+            )
+            rows.append(_row(
+                campaign_id, config, position_index, position, config_index,
+                record["result_category"], 1, fault_bytes, extradata_json,
+            ))
+
+    if out_path is None:
+        out_path = re.sub(r"\.jsonl$", "", stream_path) + ".parquet"
+    _write_table(rows, out_path)
+    return out_path
+
+
+def export_results(results_path, out_path=None):
+    """
+    Export a legacy results_N[_partial].json[.gz]. When the JSON records
+    a stream log that still exists, the per-execution rows come from it;
+    otherwise each extradata entry becomes one row and the counter
+    remainder per (config, position, category) becomes one aggregate row
+    with its count.
+    """
+    campaign_id = _campaign_id_from_path(results_path)
+    if out_path is None:
+        out_path = re.sub(r"\.json(\.gz)?$", "", results_path) + ".parquet"
+
+    log_json = _load_json(results_path)
+    stream_path = log_json.get("results_stream")
+    if stream_path and os.path.exists(stream_path):
+        return export_stream(stream_path, out_path, results_file=results_path)
+
+    positions = log_json.get("positions", [])
+    blob_path = log_json.get("fault_blobs")
+
+    rows = []
+    for config_index, config in enumerate(log_json.get("glitch_configs", [])):
+        config_results = config.get("results", {})
+        categories = [key[len("num_"):] for key in config_results
+                      if key.startswith("num_")]
+        for category in categories:
+            # Per-execution rows for every recorded extradata entry
+            recorded = {}
+            entries = config_results.get(category)
+            for entry in entries if isinstance(entries, list) else []:
+                position_index = entry["position_index"]
+                data = entry["data"]
+                for item in data if isinstance(data, list) else [data]:
+                    fault_bytes, extradata_json = _resolve_payload(
+                        item, blob_path
+                    )
+                    rows.append(_row(
+                        campaign_id, config, position_index,
+                        positions[position_index], config_index,
+                        category, 1, fault_bytes, extradata_json,
+                    ))
+                    recorded[position_index] = recorded.get(position_index, 0) + 1
+            # Aggregate rows for the counter remainder (executions
+            # without extradata, e.g. all the nofaults)
+            counters = config_results.get(f"num_{category}")
+            if not isinstance(counters, list):
+                continue  # legacy scalar num_skipped
+            for position_index, count in enumerate(counters):
+                remainder = int(count) - recorded.get(position_index, 0)
+                if remainder > 0:
+                    rows.append(_row(
+                        campaign_id, config, position_index,
+                        positions[position_index], config_index,
+                        category, remainder, None, None,
+                    ))
+
+    _write_table(rows, out_path)
+    return out_path
+
+
+if __name__ == "__main__":
+    if len(sys.argv) < 2:
+        print("usage: python3 export_parquet.py "
+              "<stream_N.jsonl | results_N.json[.gz]> [out.parquet]")
+        sys.exit(1)
+    in_path = sys.argv[1]
+    out = sys.argv[2] if len(sys.argv) > 2 else None
+    if in_path.endswith(".jsonl"):
+        export_stream(in_path, out)
+    else:
+        export_results(in_path, out)
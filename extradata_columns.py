@@ -0,0 +1,129 @@
+"""
+Typed columnar storage for numeric per-execution extradata.
+
+Fault counters from the packet handlers land in the results as
+per-execution dicts - computing anything across a campaign means deep
+dict traversal over the stream log, and every numeric value is stored
+as JSON text. A ColumnStore instead appends registered numeric fields
+to typed growable arrays, one column per field plus (position, config,
+execution) index columns, so analysis gets direct ndarray access
+mid-campaign and the on-disk form (a plain .npz of the columns) is
+roughly a tenth of the JSON dicts it mirrors.
+
+Registration is per-campaign: CSProfiler.register_extradata_columns
+takes the (name, dtype) list - e.g. CSProfiler.LOOP_COLUMN_FIELDS for
+the loop payloads' cycle counters - and every execution whose extradata
+carries all registered fields as numbers is appended; everything else
+(crashes, payloads with different extradata) is simply not a row. The
+stream log remains the authoritative record; the columns are a
+derived, analysis-friendly view.
+"""
+
+import os
+import tempfile
+
+import numpy as np
+
+# Index columns present in every store, before the registered fields
+INDEX_FIELDS = (("position_index", "<u4"), ("config_index", "<u4"),
+                ("execution_index", "<u4"))
+
+_INITIAL_CAPACITY = 1024
+
+
+class ColumnStore:
+    """
+    Growable typed column arrays with amortized O(1) append (capacity
+    doubling, the same strategy Python lists use - but on contiguous
+    numpy storage so columns() hands out real ndarrays without a copy).
+    """
+
+    def __init__(self, fields):
+        self.fields = [(name, str(dtype)) for name, dtype in fields]
+        self._names = [name for name, _ in INDEX_FIELDS] + \
+            [name for name, _ in self.fields]
+        self._size = 0
+        self._capacity = _INITIAL_CAPACITY
+        self._arrays = {
+            name: np.empty(self._capacity, dtype=dtype)
+            for name, dtype in tuple(INDEX_FIELDS) + tuple(self.fields)
+        }
+
+    def __len__(self):
+        return self._size
+
+    def _grow(self):
+        self._capacity *= 2
+        for name, array in self._arrays.items():
+            grown = np.empty(self._capacity, dtype=array.dtype)
+            grown[:self._size] = array[:self._size]
+            self._arrays[name] = grown
+
+    def append(self, position_index, config_index, execution_index,
+               extradata):
+        """
+        Append one execution's registered fields. Returns False (and
+        books nothing) unless extradata is a dict carrying every
+        registered field as a plain number - partial rows would poison
+        the columns with fill values.
+        """
+        if not isinstance(extradata, dict):
+            return False
+        values = []
+        for name, _ in self.fields:
+            value = extradata.get(name)
+            if isinstance(value, bool) or not isinstance(value, (int, float)):
+                return False
+            values.append(value)
+
+        if self._size == self._capacity:
+            self._grow()
+        row = self._size
+        self._arrays["position_index"][row] = position_index
+        self._arrays["config_index"][row] = config_index
+        self._arrays["execution_index"][row] = execution_index
+        for (name, _), value in zip(self.fields, values):
+            self._arrays[name][row] = value
+        self._size += 1
+        return True
+
+    def columns(self):
+        """{name: ndarray} views trimmed to the appended rows, index
+        columns first. Views share storage with the store - copy before
+        appending more if holding on to them."""
+        return {name: self._arrays[name][:self._size]
+                for name in self._names}
+
+    def save(self, path):
+        """Write the columns as an uncompressed .npz, atomically (temp
+        file + rename), so checkpoint-time saves can never leave a torn
+        file behind."""
+        directory = os.path.dirname(path) or "."
+        fd, temp_path = tempfile.mkstemp(dir=directory, suffix=".tmp")
+        try:
+            with os.fdopen(fd, "wb") as f:
+                np.savez(f, **self.columns())
+            os.replace(temp_path, path)
+        except BaseException:
+            try:
+                os.remove(temp_path)
+            except OSError:
+                pass
+            raise
+
+    @classmethod
+    def load(cls, path, fields):
+        """Rebuild a store (e.g. on campaign resume) from a saved .npz;
+        appends continue after the loaded rows."""
+        store = cls(fields)
+        with np.load(path) as data:
+            size = len(data["position_index"])
+            while store._capacity < size:
+                store._capacity *= 2
+            for name in store._names:
+                array = np.empty(store._capacity,
+                                 dtype=store._arrays[name].dtype)
+                array[:size] = data[name]
+                store._arrays[name] = array
+            store._size = size
+        return store
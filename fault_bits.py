@@ -0,0 +1,176 @@
+"""
+Vectorized flip-pattern analysis over memcpy fault buffers.
+
+The memcpy payload (profile_memcpy.c) answers "which bits does a pulse
+flip" - but the corrupted target buffers land in the results as hex
+strings and blob references, and every look at them so far has been a
+hand-written loop over a notebook cell. This module loads all fault
+buffers of a campaign into one (N, buffer_len) uint8 array and computes
+the standard flip views with numpy bitwise ops: per-byte-offset and
+per-bit flip histograms against the 0xAA source pattern, the
+set-vs-cleared asymmetry (EMFI on this target overwhelmingly drives
+bits one direction), and the distribution of corrupted-byte burst
+lengths.
+
+    python3 -m <package>.fault_bits results/stream_3.jsonl \
+        [--blobs results/blobs_3.bin] [--reference 0xAA] [--csv]
+
+The blob sidecar defaults to the sibling blobs_<id>.bin; --csv emits
+the per-byte table instead of the human summary. load_fault_buffers /
+flip_stats are the code entry points.
+"""
+
+import argparse
+import json
+import os
+
+import numpy as np
+
+from .profile_target import CSProfiler
+
+
+def load_fault_buffers(stream_path, blob_path=None, field="target_buffer"):
+    """
+    All fault payload buffers of a campaign as one (N, buffer_len)
+    uint8 array, plus the matching position/config index arrays.
+
+    Reads the stream log's "faults" records; the `field` payload may be
+    an inline hex string or a {"blob_offset", "blob_length"} reference
+    into the blob sidecar (defaulting to the sibling blobs_<id>.bin).
+    Buffers whose length differs from the campaign's dominant one
+    (mixed buffer_len reconfigurations) are dropped with their indices.
+    """
+    if blob_path is None:
+        candidate = stream_path.replace("stream_", "blobs_")
+        if candidate.endswith(".jsonl"):
+            candidate = candidate[:-6] + ".bin"
+        blob_path = candidate if os.path.exists(candidate) else None
+
+    buffers = []
+    positions = []
+    configs = []
+    with open(stream_path) as f:
+        for line in f:
+            if not line.strip():
+                continue
+            entry = json.loads(line)
+            if entry.get("result_category") != "faults":
+                continue
+            data = entry.get("data")
+            if not isinstance(data, dict):
+                continue
+            payload = data.get(field)
+            if isinstance(payload, dict) and "blob_offset" in payload:
+                if blob_path is None:
+                    continue
+                raw = CSProfiler.read_blob(blob_path, payload)
+            elif isinstance(payload, str):
+                raw = bytes.fromhex(payload)
+            else:
+                continue
+            buffers.append(raw)
+            positions.append(entry["position_index"])
+            configs.append(entry["config_index"])
+
+    if not buffers:
+        return (np.zeros((0, 0), dtype=np.uint8),
+                np.zeros(0, dtype=np.int64), np.zeros(0, dtype=np.int64))
+
+    lengths = [len(b) for b in buffers]
+    dominant = max(set(lengths), key=lengths.count)
+    keep = [i for i, n in enumerate(lengths) if n == dominant]
+    data = b"".join(buffers[i] for i in keep)
+    array = np.frombuffer(data, dtype=np.uint8).reshape(len(keep), dominant)
+    return (array,
+            np.array([positions[i] for i in keep]),
+            np.array([configs[i] for i in keep]))
+
+
+def flip_stats(buffers, reference=0xAA):
+    """
+    Flip-pattern statistics over a (N, L) uint8 buffer array against
+    the expected source byte, all in numpy bitwise ops:
+
+        per_byte_flips  - (L,) buffers corrupted at each byte offset
+        per_bit_flips   - (L, 8) flip counts per offset and bit (bit 7
+                          first, np.unpackbits order)
+        bits_set        - total 0->1 flips (reference bit was clear)
+        bits_cleared    - total 1->0 flips (reference bit was set)
+        burst_histogram - (max_run+1,) counts of consecutive corrupted
+                          byte run lengths, index = run length
+    """
+    buffers = np.asarray(buffers, dtype=np.uint8)
+    flips = buffers ^ reference
+    corrupted = flips != 0
+
+    per_byte_flips = np.count_nonzero(corrupted, axis=0)
+    per_bit_flips = np.unpackbits(flips, axis=1) \
+        .reshape(buffers.shape[0], buffers.shape[1], 8).sum(axis=0)
+
+    # Direction of each flipped bit relative to the reference pattern
+    bits_set = int(np.unpackbits(buffers & np.uint8(~reference & 0xFF)).sum())
+    bits_cleared = int(np.unpackbits(np.uint8(reference) & ~buffers).sum())
+
+    # Run lengths of consecutive corrupted bytes: zero-pad each row,
+    # run starts/ends fall out of the difference of the padded mask
+    padded = np.zeros((corrupted.shape[0], corrupted.shape[1] + 2), dtype=np.int8)
+    padded[:, 1:-1] = corrupted
+    edges = np.diff(padded, axis=1)
+    _, start_cols = np.nonzero(edges == 1)
+    _, end_cols = np.nonzero(edges == -1)
+    run_lengths = end_cols - start_cols
+    burst_histogram = np.bincount(run_lengths) if len(run_lengths) else \
+        np.zeros(1, dtype=np.int64)
+
+    return {
+        "per_byte_flips": per_byte_flips,
+        "per_bit_flips": per_bit_flips,
+        "bits_set": bits_set,
+        "bits_cleared": bits_cleared,
+        "burst_histogram": burst_histogram,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Flip-pattern statistics over memcpy fault buffers"
+    )
+    parser.add_argument("stream", help="stream_<id>.jsonl result log")
+    parser.add_argument("--blobs", default=None,
+                        help="blobs_<id>.bin sidecar (default: sibling of"
+                             " the stream log)")
+    parser.add_argument("--reference", type=lambda v: int(v, 0), default=0xAA,
+                        help="expected source byte (default 0xAA)")
+    parser.add_argument("--csv", action="store_true",
+                        help="emit the per-byte table as CSV")
+    args = parser.parse_args()
+
+    buffers, positions, configs = load_fault_buffers(args.stream, args.blobs)
+    if not len(buffers):
+        print("No fault buffers in the stream log")
+        return
+    stats = flip_stats(buffers, args.reference)
+
+    if args.csv:
+        print("byte_offset,flips," + ",".join(f"bit{7 - b}" for b in range(8)))
+        for offset in range(buffers.shape[1]):
+            bits = ",".join(str(int(v)) for v in stats["per_bit_flips"][offset])
+            print(f"{offset},{int(stats['per_byte_flips'][offset])},{bits}")
+        return
+
+    total_bits = stats["bits_set"] + stats["bits_cleared"]
+    print(f"{len(buffers)} fault buffers x {buffers.shape[1]} bytes "
+          f"({len(np.unique(positions))} positions, "
+          f"{len(np.unique(configs))} configs)")
+    print(f"bit flips: {total_bits} total, {stats['bits_set']} set / "
+          f"{stats['bits_cleared']} cleared "
+          f"({stats['bits_set'] / max(total_bits, 1):.0%} toward set)")
+    hottest = np.argsort(stats["per_byte_flips"])[::-1][:8]
+    print("hottest byte offsets: " + ", ".join(
+        f"{int(o)} ({int(stats['per_byte_flips'][o])})" for o in hottest))
+    print("burst lengths: " + ", ".join(
+        f"{n}x{int(c)}" for n, c in enumerate(stats["burst_histogram"]) if c))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,94 @@
+"""
+Plugin hook registry with fixed extension points.
+
+Extending the profiler used to mean overwrite_test_execution (which
+re-validated the return tuple on every shot) or monkeypatching handler
+methods; both pay per-shot introspection and compose badly - two
+extensions fight over the same attribute. The registry defines named
+extension points instead:
+
+    pre_shot(profiler, position_index, config_index, execution_index)
+    post_shot(profiler, position_index, config_index, execution_index,
+              result_category, extradata)
+    on_result(profiler, position_index, config_index, result_category,
+              extradata)
+    on_position_done(profiler, position_index)
+    on_error(profiler, position_index, config_index, error)
+
+Hooks are plain callables with exactly that signature; return values
+are ignored. The contract is checked once at registration (unknown
+point, wrong arity - the per-call checks overwrite_test_execution
+does per shot), and each point's chain is compiled to a flat callable
+then: None for an empty point, the function itself for one hook, a
+tuple-walking closure for several. The hot loop pays a single falsy
+check per point and nothing else:
+
+    profiler.register_hook("post_shot", my_logger)
+
+    @profiler.register_hook("on_error")
+    def bail_on_brick(profiler, position_index, config_index, error): ...
+"""
+
+# Extension point name -> expected parameter names (arity contract)
+HOOK_POINTS = {
+    "pre_shot": ("profiler", "position_index", "config_index",
+                 "execution_index"),
+    "post_shot": ("profiler", "position_index", "config_index",
+                  "execution_index", "result_category", "extradata"),
+    "on_result": ("profiler", "position_index", "config_index",
+                  "result_category", "extradata"),
+    "on_position_done": ("profiler", "position_index"),
+    "on_error": ("profiler", "position_index", "config_index", "error"),
+}
+
+
+class HookRegistry:
+    """Per-profiler hook store; compile() hands the hot loop its flat
+    call target so the registry itself is never touched per shot."""
+
+    def __init__(self):
+        self._hooks = {point: [] for point in HOOK_POINTS}
+
+    def register(self, point, func):
+        """Validate and add one hook; raises on an unknown point or a
+        signature that cannot take the point's arguments."""
+        params = HOOK_POINTS.get(point)
+        if params is None:
+            raise ValueError(
+                f"unknown hook point '{point}' (have {', '.join(HOOK_POINTS)})"
+            )
+        if not callable(func):
+            raise TypeError(f"{point} hook must be callable, got {type(func)}")
+        code = getattr(func, "__code__", None)
+        if code is not None and not (code.co_flags & 0x04):  # no *args
+            defaults = len(getattr(func, "__defaults__", None) or ())
+            bound = int(hasattr(func, "__self__"))
+            required = code.co_argcount - defaults - bound
+            available = code.co_argcount - bound
+            if not required <= len(params) <= available:
+                raise TypeError(
+                    f"{point} hook {getattr(func, '__name__', func)} takes "
+                    f"{available} arguments, point passes "
+                    f"({', '.join(params)})"
+                )
+        self._hooks[point].append(func)
+        return func
+
+    def compile(self, point):
+        """The flat call target for one point: None when empty, the
+        hook itself for one, a chain closure for several."""
+        hooks = self._hooks[point]
+        if not hooks:
+            return None
+        if len(hooks) == 1:
+            return hooks[0]
+        chain = tuple(hooks)
+
+        def call_chain(*args):
+            for hook in chain:
+                hook(*args)
+        return call_chain
+
+    def hooks(self, point):
+        """Registered hooks of one point, in registration order."""
+        return list(self._hooks[point])
@@ -0,0 +1,205 @@
+"""
+Opt-in metrics endpoint for long-running campaigns.
+
+Week-long campaigns are otherwise only observable by tailing the
+console. MetricsServer exposes the profiler's state in the Prometheus
+text format on a plain HTTP port, so any scraper (or `curl :9100`)
+gets executions/sec, per-result-type totals, scan progress, ChipShouter
+temperatures/armed state and error counts.
+
+Everything is read at scrape time from counters the campaign already
+maintains (the numpy counter block, the ChipShouter state mirror, the
+catched_errors list), so monitoring adds no per-shot cost whatsoever -
+the hot path is never touched. Enable with:
+
+    profiler.start_metrics_server(port=9100)   # before run_campaign()
+"""
+
+import threading
+import time
+from http.server import BaseHTTPRequestHandler, ThreadingHTTPServer
+
+
+class MetricsServer:
+    def __init__(self, profiler, host="0.0.0.0", port=9100):
+        self.profiler = profiler
+        self.host = host
+        self.port = port
+        self._httpd = None
+        self._thread = None
+        self._started = time.monotonic()
+        # Previous scrape snapshot for the executions/sec gauge
+        self._last_total = 0
+        self._last_time = self._started
+
+    def start(self):
+        server = self
+
+        class Handler(BaseHTTPRequestHandler):
+            def do_GET(self):
+                if self.path not in ("/", "/metrics"):
+                    self.send_error(404)
+                    return
+                body = server.render().encode()
+                self.send_response(200)
+                self.send_header("Content-Type",
+                                 "text/plain; version=0.0.4; charset=utf-8")
+                self.send_header("Content-Length", str(len(body)))
+                self.end_headers()
+                self.wfile.write(body)
+
+            def log_message(self, format, *args):
+                pass  # scrapes every few seconds would spam the console
+
+        self._httpd = ThreadingHTTPServer((self.host, self.port), Handler)
+        self._thread = threading.Thread(target=self._httpd.serve_forever,
+                                        name="MetricsServer", daemon=True)
+        self._thread.start()
+        print(f"Metrics endpoint on http://{self.host}:{self.port}/metrics")
+
+    def stop(self):
+        if self._httpd is not None:
+            self._httpd.shutdown()
+            self._httpd = None
+            self._thread = None
+
+    @staticmethod
+    def _line(lines, name, value, labels=None, help_text=None, kind="gauge"):
+        if help_text is not None:
+            lines.append(f"# HELP {name} {help_text}")
+            lines.append(f"# TYPE {name} {kind}")
+        label_str = ""
+        if labels:
+            inner = ",".join(f'{k}="{v}"' for k, v in labels.items())
+            label_str = "{" + inner + "}"
+        lines.append(f"{name}{label_str} {value}")
+
+    def render(self):
+        """Snapshot the profiler state into Prometheus text exposition
+        format. Runs entirely on the scraper's thread."""
+        profiler = self.profiler
+        lines = []
+
+        # Per-result-type totals straight from the counter block
+        type_totals = profiler._counters.sum(axis=(0, 1))
+        first = True
+        for type_index, category in enumerate(profiler.result_types):
+            self._line(
+                lines, "csprofiler_results_total", int(type_totals[type_index]),
+                labels={"category": category},
+                help_text="Executions per result category" if first else None,
+                kind="counter",
+            )
+            first = False
+
+        total = int(type_totals.sum())
+        self._line(lines, "csprofiler_executions_total", total,
+                   help_text="Total executions booked", kind="counter")
+
+        # Rate over the scrape interval (uptime-based on the first scrape)
+        now = time.monotonic()
+        interval = max(now - self._last_time, 1e-9)
+        rate = (total - self._last_total) / interval
+        self._last_total, self._last_time = total, now
+        self._line(lines, "csprofiler_executions_per_second", round(rate, 2),
+                   help_text="Execution rate since the previous scrape")
+
+        self._line(lines, "csprofiler_position_index",
+                   getattr(profiler, "_scan_cursor", 0),
+                   help_text="Positions scanned in the current plan")
+        self._line(lines, "csprofiler_positions_total", profiler.num_positions,
+                   help_text="Positions in the campaign plan")
+        self._line(lines, "csprofiler_configs_total",
+                   len(profiler.glitch_configs),
+                   help_text="Glitch configs in the campaign plan")
+
+        # Probe-swap pause (see CSProfiler._await_probe_swap): dashboards
+        # get the why when the shot rate drops to zero mid-campaign
+        awaiting = getattr(profiler, "awaiting_probe", None)
+        self._line(lines, "csprofiler_awaiting_probe_swap",
+                   int(awaiting is not None),
+                   labels={"probe": awaiting} if awaiting else None,
+                   help_text="1 while the campaign is paused for a coil swap")
+
+        # None until the first execution has been booked
+        eta = None
+        if hasattr(profiler, "campaign_eta_seconds"):
+            try:
+                eta = profiler.campaign_eta_seconds()
+            except Exception:
+                pass
+        if eta is not None:
+            self._line(lines, "csprofiler_eta_seconds", round(eta, 1),
+                       help_text="Projected seconds to campaign completion")
+
+        # Error budget governor (error_budget.py): windowed per-type
+        # counts plus the alert signal scrapers page on
+        governor = getattr(profiler, "error_governor", None)
+        if governor is not None:
+            first = True
+            for name, count in sorted(governor.window_counts().items()):
+                self._line(
+                    lines, "csprofiler_error_window", count,
+                    labels={"type": name},
+                    help_text="Errors per type inside the governor window"
+                    if first else None,
+                )
+                first = False
+            first = True
+            for action, count in sorted(governor.actions_taken.items()):
+                self._line(
+                    lines, "csprofiler_error_budget_actions_total", count,
+                    labels={"action": action},
+                    help_text="Governor escalations taken" if first else None,
+                    kind="counter",
+                )
+                first = False
+            self._line(lines, "csprofiler_error_budget_exceeded",
+                       int(governor.last_action != "none"),
+                       help_text="1 once any error budget has been exceeded")
+
+        self._line(lines, "csprofiler_recovered_errors_total",
+                   len(getattr(profiler, "catched_errors", None) or []),
+                   help_text="Errors caught and recovered during scanning",
+                   kind="counter")
+
+        target_serial = getattr(profiler, "target_serial", None)
+        if target_serial is not None:
+            self._line(lines, "targetserial_crc_errors_total",
+                       getattr(target_serial, "_crc_errors_total", 0),
+                       help_text="CRC failures in read_packet",
+                       kind="counter")
+            first = True
+            for name, value in sorted(target_serial.stats.items()):
+                self._line(
+                    lines, "targetserial_link_total", value,
+                    labels={"counter": name},
+                    help_text="Serial link-health counters (TargetSerial.stats)"
+                    if first else None,
+                    kind="counter",
+                )
+                first = False
+
+        # ChipShouter state from the mirror/thermal-monitor caches; a
+        # serial hiccup on scrape must never disturb the campaign
+        cs = getattr(profiler, "cs", None)
+        if cs is not None:
+            try:
+                temps = cs.read_temps()
+                for sensor, value in zip(("diode", "mosfet", "xformer"), temps):
+                    self._line(
+                        lines, "chipshouter_temperature_celsius", value,
+                        labels={"sensor": sensor},
+                        help_text="ChipShouter temperatures (mirrored)"
+                        if sensor == "diode" else None,
+                    )
+            except Exception:
+                pass
+            self._line(lines, "chipshouter_armed",
+                       int(bool(getattr(cs, "_armed_cached", False))),
+                       help_text="Cached armed state")
+
+        self._line(lines, "csprofiler_uptime_seconds",
+                   round(now - self._started, 1),
+                   help_text="Seconds since the metrics server started")
+        return "\n".join(lines) + "\n"
@@ -0,0 +1,180 @@
+"""
+Results schema version and the migration tool for legacy files.
+
+The archive holds three generations of results layouts:
+
+  1 - xy_map.npy + extradata.json pair: counters in a (config, x, y, 4)
+      array with the positions implied by the grid indices, extradata
+      in a separate JSON (the README-era format)
+  2 - single results JSON without the soft/hard_bricked counters
+  3 - current: schema_version stamp, the full counter set per config,
+      sidecar pointers (stream/blobs/traces/columns)
+
+Every analysis tool grew its own shims for the missing counters and
+the unstamped files; migrating the archive once lets those branches
+(and their per-load probing) go. The command upgrades files in place -
+atomic replace, original kept as .bak - and runs the per-file work in
+a multiprocessing pool, so memory stays bounded by the largest single
+file regardless of archive size:
+
+    python3 -m <package>.migrate_results results/results_*.json[.gz]
+    python3 -m <package>.migrate_results --xy-map xy_map.npy extradata.json
+
+store_results stamps RESULTS_SCHEMA_VERSION into every new file;
+detect_version classifies unstamped ones by their counter set.
+"""
+
+import argparse
+import gzip
+import json
+import os
+import sys
+from multiprocessing import Pool
+
+RESULTS_SCHEMA_VERSION = 3
+
+# Counters generation 2 lacks; migration zero-fills them so consumers
+# can index the full set unconditionally
+_ADDED_COUNTERS = ("num_soft_bricked", "num_hard_bricked")
+
+
+def detect_version(data):
+    """Schema version of a loaded results dict; unstamped files are
+    classified by whether the bricked counters exist."""
+    if "schema_version" in data:
+        return data["schema_version"]
+    for cfg in data.get("glitch_configs") or []:
+        if any(key in (cfg.get("results") or {}) for key in _ADDED_COUNTERS):
+            return 3  # current layout from before the stamp
+    return 2
+
+
+def migrate_data(data):
+    """
+    Upgrade a loaded results dict to the current schema in place.
+    Returns the version the file was at (== RESULTS_SCHEMA_VERSION when
+    nothing needed doing); raises on files newer than this tool.
+    """
+    version = detect_version(data)
+    if version > RESULTS_SCHEMA_VERSION:
+        raise ValueError(
+            f"schema version {version} is newer than this tool "
+            f"({RESULTS_SCHEMA_VERSION})"
+        )
+    # Zero-fill unconditionally (idempotent): files written mid-way
+    # through generation 3 sometimes carry one bricked counter but not
+    # the other
+    num_positions = len(data.get("positions") or [])
+    for cfg in data.get("glitch_configs") or []:
+        results = cfg.setdefault("results", {})
+        for key in _ADDED_COUNTERS:
+            if key not in results:
+                results[key] = [0] * num_positions
+    data["schema_version"] = RESULTS_SCHEMA_VERSION
+    return version
+
+
+def migrate_file(path):
+    """
+    Upgrade one results file in place (atomic temp-file replace, the
+    original kept beside it as .bak). Compression is preserved. Returns
+    a one-line status string for the caller to print.
+    """
+    opener = gzip.open if path.endswith(".gz") else open
+    with opener(path, "rt") as f:
+        data = json.load(f)
+    stamped = "schema_version" in data
+    version = migrate_data(data)
+    if stamped and version == RESULTS_SCHEMA_VERSION:
+        return f"{path}: already at schema {version}"
+    # schema_version first, so a head of the file answers the question
+    ordered = {"schema_version": data.pop("schema_version")}
+    ordered.update(data)
+    tmp_path = path + ".tmp"
+    with opener(tmp_path, "wt") as f:
+        json.dump(ordered, f)
+    os.replace(path, path + ".bak")
+    os.replace(tmp_path, path)
+    return f"{path}: schema {version} -> {RESULTS_SCHEMA_VERSION}"
+
+
+def migrate_xy_map(npy_path, extradata_path, out_path=None):
+    """
+    Build a current-schema results JSON from a generation-1 pair. The
+    grid indices become the positions ([x, y] - the original absolute
+    coordinates were never stored), the counter planes become the
+    per-config counter lists, and the extradata JSON's glitch configs
+    are carried over as-is. Returns the output path.
+    """
+    import numpy as np
+
+    xy_map = np.load(npy_path)
+    if xy_map.ndim != 4 or xy_map.shape[3] != 4:
+        raise ValueError(
+            f"{npy_path}: expected shape (configs, x, y, 4), got {xy_map.shape}"
+        )
+    with open(extradata_path) as f:
+        extradata = json.load(f)
+    configs = extradata.get("glitch_configs", extradata)
+    if not isinstance(configs, list):
+        raise ValueError(f"{extradata_path}: no glitch config list found")
+
+    num_configs, size_x, size_y, _ = xy_map.shape
+    positions = [[x, y] for x in range(size_x) for y in range(size_y)]
+    counter_keys = ("num_nofaults", "num_faults", "num_crashes", "num_resets")
+    glitch_configs = []
+    for config_index in range(num_configs):
+        cfg = dict(configs[config_index]) if config_index < len(configs) else {}
+        results = dict(cfg.get("results") or {})
+        planes = xy_map[config_index].reshape(-1, 4)
+        for counter_index, key in enumerate(counter_keys):
+            results[key] = planes[:, counter_index].astype(int).tolist()
+        for key in _ADDED_COUNTERS:
+            results.setdefault(key, [0] * len(positions))
+        cfg["results"] = results
+        glitch_configs.append(cfg)
+
+    out = {
+        "schema_version": RESULTS_SCHEMA_VERSION,
+        "Info: migrated": f"from {npy_path} + {extradata_path}; positions "
+                          "are the xy_map grid indices, not coordinates",
+        "positions": positions,
+        "glitch_configs": glitch_configs,
+    }
+    if out_path is None:
+        out_path = (npy_path[:-4] if npy_path.endswith(".npy") else npy_path) \
+            + ".results.json"
+    with open(out_path, "w") as f:
+        json.dump(out, f)
+    return out_path
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Upgrade legacy results files to the current schema"
+    )
+    parser.add_argument("files", nargs="*",
+                        help="results JSON files (.json or .json.gz)")
+    parser.add_argument("--xy-map", nargs=2,
+                        metavar=("XY_MAP.NPY", "EXTRADATA.JSON"),
+                        help="convert a generation-1 pair instead")
+    parser.add_argument("-j", "--jobs", type=int, default=None,
+                        help="worker processes (default: cpu count)")
+    args = parser.parse_args()
+
+    if args.xy_map:
+        print(f"Wrote {migrate_xy_map(*args.xy_map)}")
+        return 0
+    if not args.files:
+        parser.error("no files given")
+    if len(args.files) == 1:
+        print(migrate_file(args.files[0]))
+        return 0
+    with Pool(args.jobs) as pool:
+        for status in pool.imap_unordered(migrate_file, args.files):
+            print(status)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -1,35 +1,143 @@
+import asyncio
+import ctypes
+import functools
+import itertools
 import os
 import re
 import sys
+import gzip
+import hashlib
+import fcntl
+import math
+import inspect
 import glob
 import signal
 import subprocess
 import traceback
+import threading
 import time
 from dataclasses import dataclass, asdict
+from datetime import datetime, timezone
+from collections import deque
 import json
-import copy
+
+import numpy as np
 
 from tenacity import RetryError
 
 # local imports
 from .CWUtils import ChipWhisperer
 from .CSUtils import ChipShouter
-from .config_classes import GlitchConfig, SimpleSerialPacket
+from .config_classes import ClearanceMap, GlitchConfig, SimpleSerialPacket
+from .errors import (
+    CampaignInterrupted,
+    classify,
+    DeviceLostError,
+    DeviceRecoveryError,
+    ErrorBudgetExceeded,
+    ErrorLog,
+    ScopeError,
+    ShouterError,
+    ShouterFaultError,
+    TargetError,
+    TargetResetTimeout,
+)
+
+from .error_budget import ErrorBudgetGovernor
+from .hooks import HookRegistry
+from .migrate_results import RESULTS_SCHEMA_VERSION
+from .trace_capture import TraceCapture, CAPTURE_PROFILES, window_profile
+from .USBUtils import UdevMonitor
+
+from .eta import EtaEstimator
+from .event_log import EventLogWriter, iter_records as iter_event_records
+from .extradata_columns import ColumnStore
+from .metrics import MetricsServer
+from .progress import ProgressReporter
+from .results_index import index_results
+from .scheduler import PriorityScheduler
+from .timing import PhaseTimer
 
 from .simpleserial.simpleserial import TargetSerial
+from .simpleserial.deadline import Deadline
 from .simpleserial.simpleserial_readers.cwlite import SimpleSerial_ChipWhispererLite
 
 from .lib.pico_pulsegen.delay_control import DelayController
 from .lib.emf_table.table import xyzTable
 
 # TODO:
-# - Add start and end timestamp to log file
 # - Documentation
 
-class ResetTimeoutError(TimeoutError):
-    def __init__(self, message="Failed to reset target!"):
-        super().__init__(message)
+# Backwards-compatible name for the typed taxonomy class (errors.py)
+ResetTimeoutError = TargetResetTimeout
+
+
+def allocate_campaign_id(results_path="results/"):
+    """
+    Atomically allocate the next campaign id from the results manifest.
+
+    The manifest (results/manifest.json) holds the next free id and is
+    updated under an exclusive flock, so two profiler instances sharing a
+    results directory cannot allocate the same id - replacing the old
+    stat-until-free filename loops that went quadratic over a directory
+    of thousands of campaigns. A directory predating the manifest is
+    scanned once to seed the counter past the existing files.
+    """
+    os.makedirs(results_path, exist_ok=True)
+    manifest_path = os.path.join(results_path, "manifest.json")
+    with open(manifest_path, "a+") as f:
+        fcntl.flock(f, fcntl.LOCK_EX)
+        f.seek(0)
+        try:
+            manifest = json.load(f)
+        except ValueError:
+            # First run with this manifest: seed past any legacy files
+            next_id = -1
+            for name in os.listdir(results_path):
+                match = re.match(r"(?:results|stream|checkpoint|blobs)_(\d+)", name)
+                if match:
+                    next_id = max(next_id, int(match.group(1)))
+            manifest = {"next_id": next_id + 1}
+        campaign_id = manifest["next_id"]
+        f.seek(0)
+        f.truncate()
+        json.dump({"next_id": campaign_id + 1}, f)
+        return campaign_id
+
+class AdaptiveTimeout:
+    """
+    Learns the response-time distribution of a wait and derives a
+    tighter timeout than the static configured one.
+
+    Static ack/dead timeouts are sized for the worst case, so every
+    genuine crash costs the full wait even when the target normally
+    answers in single-digit milliseconds. This tracks a sliding window
+    of observed latencies and serves quantile * margin as the timeout,
+    clamped to the configured value (never looser) — and keeps serving
+    the configured value until enough samples exist. The margin covers
+    legitimate stragglers: a wrongly shortened wait only books a crash
+    and costs one target reset, it cannot corrupt results.
+    """
+
+    def __init__(self, configured_ms, min_samples=30, quantile=0.999, margin=2.0, window=512):
+        self.configured_ms = configured_ms
+        self.min_samples = min_samples
+        self.quantile = quantile
+        self.margin = margin
+        self._samples = deque(maxlen=window)
+
+    def record(self, latency_ms):
+        """Record the latency of a successful wait (ms)."""
+        self._samples.append(latency_ms)
+
+    def timeout_ms(self):
+        """Current timeout: quantile * margin of the observed window,
+        clamped to [1, configured_ms]."""
+        if len(self._samples) < self.min_samples:
+            return self.configured_ms
+        ordered = sorted(self._samples)
+        index = min(len(ordered) - 1, int(len(ordered) * self.quantile))
+        return min(self.configured_ms, max(1.0, ordered[index] * self.margin))
 
 class CSProfiler:
     # glitch_configs = None
@@ -57,9 +165,13 @@ class CSProfiler:
         else:
             self.simpleserial_config = [
                 SimpleSerialPacket("s", "Start signal for target (acknowleged by target)"),
+                SimpleSerialPacket("B", "Batch execution command (aggregate result bitmap)"),
+                SimpleSerialPacket("c", "Runtime payload configuration (echoed by target)"),
+                SimpleSerialPacket("p", "Payload selection for unified firmware image"),
                 SimpleSerialPacket("e", "End signal from target (nofault)", self.nofaultPacketHandler),
                 SimpleSerialPacket("r", "Reset signal from target (reset)", self.resetPacketHandler),
-                SimpleSerialPacket("f", "Fault occured on target", self.faultPacketHandler)
+                SimpleSerialPacket("f", "Fault occured on target", self.faultPacketHandler),
+                SimpleSerialPacket("d", "Delta-encoded fault from target", self.deltaFaultPacketHandler)
             ]
         # Default result_types (Identifier: Description)
         self.result_types = {
@@ -71,15 +183,371 @@ class CSProfiler:
             "hard_bricked": "Hard reset failed",
             "skipped": "Skipped"
         }
-        self._results = [
-            {
-                f"num_{key}": [0] * self.num_positions
-                for key in self.result_types
-            } for _ in self.glitch_configs
-        ]
+        # Counters live in one (num_configs, num_positions, num_result_types)
+        # uint32 block (plus one for effective_executions); self._results /
+        # self.results expose per-config dict-style views over it so the
+        # `config_results[f"num_{key}"][position_index] += 1` accessors are
+        # unchanged while increments hit the array directly
+        self._counters, self._effective = self._build_counter_arrays()
+        self._results = self._bind_result_views(self._counters, self._effective)
+
+        # Online counter-deviation statistics for the loop payloads:
+        # compact (num_configs, num_positions) Welford planes beside the
+        # counter block (see _record_counter_deviation)
+        self._dev_count, self._dev_mean, self._dev_m2 = \
+            self._build_deviation_arrays()
 
         self.valid_commands = [ss_packet.command for ss_packet in self.simpleserial_config]
 
+        # Precompiled dispatch table {command_byte: SimpleSerialPacket}.
+        # Built once here and kept in sync by addSimpleSerialCommand so
+        # handlePacket is a single dict lookup instead of a config scan.
+        self._packet_dispatch = {}
+        for ss_packet in self.simpleserial_config:
+            self._register_packet_handler(ss_packet)
+
+        # Expected memcpy buffer parameters, used to reconstruct the full
+        # target buffer from delta-encoded 'd' fault packets. Kept in sync
+        # by configure_target(); defaults match the firmware defaults.
+        self.memcpy_buffer_len = 68
+        self.memcpy_src_init_byte = 0xAA
+
+        # Visiting order over self.positions (permutation of indices),
+        # recomputed by run_campaign via plan_position_order(). Results
+        # stay indexed by the original position_index regardless.
+        self.position_order = list(range(self.num_positions))
+
+        # Order glitch configs are run in at each position (indices into
+        # self.glitch_configs), recomputed by _campaign_setup via
+        # plan_config_order(). Results stay indexed by config_index.
+        self.config_order = list(range(len(self.glitch_configs)))
+
+        # Refinement depth per position: 0 for the initial grid, +1 for
+        # every coarse-to-fine level added by run_adaptive_campaign()
+        self.position_depths = [0] * self.num_positions
+
+        # Adaptive timeout trackers keyed by (kind, config_index); see
+        # AdaptiveTimeout. Crash-heavy regions stall on static timeouts,
+        # so ack/dead waits shrink toward the measured distribution.
+        self._adaptive_timeouts = {}
+
+        # Per-phase timing histograms (arm, serial waits, handlers, table
+        # moves, ...); dumped into the results JSON and printed at
+        # campaign end
+        self.timing = PhaseTimer()
+
+        # Rate-limited status line + optional structured log; replace
+        # with ProgressReporter(structured_path=...) for machine-readable
+        # progress records
+        self.progress = ProgressReporter()
+
+        # Running ETA from EWMA per-category execution durations and
+        # move times (campaign_eta_seconds); unlike campaign_estimate
+        # this tracks the rates actually being measured
+        self.eta = EtaEstimator()
+
+        # Campaign-level error budget governor (see error_budget.py);
+        # None until enable_error_governor() opts in
+        self.error_governor = None
+
+        # Provenance of a replay campaign (replay.replay_campaign):
+        # source results file + point mapping, embedded in store_results
+        self.replay_provenance = None
+
+        # Campaign provenance block (see _collect_provenance): captured
+        # at campaign start, finished_at and the target payload state
+        # filled in at store_results
+        self._provenance = None
+        self._selected_payload = None
+        self._runtime_config = {}
+
+        # Live work-queue scheduler when run_campaign_prioritized is
+        # driving the campaign; its queue state rides in the checkpoint
+        self._scheduler = None
+
+        # Probe the campaign is currently paused for (None while
+        # scanning); set by _await_probe_swap, read by the metrics
+        # endpoint so dashboards show the pending coil swap
+        self.awaiting_probe = None
+
+        # Persistent event loop thread for the async execution pipeline
+        # (started lazily by enable_async_pipeline / test_execution_pipelined)
+        self._async_loop = None
+
+        # Recovery dispatch: exception type -> handler returning the set
+        # of devices to power cycle (see register_error_handler)
+        self._error_handlers = {}
+        self.register_error_handler(ShouterError, lambda error: {"chipshouter"})
+        self.register_error_handler(TargetError, lambda error: {"target"})
+        self.register_error_handler(DeviceLostError, lambda error: error.devices)
+
+        # Proactive USB loss detection (see start_usb_monitor); None
+        # until prepare_hardware knows the connected devices
+        self.usb_monitor = None
+
+        # Persistent Pico pulse-generator session, opened by
+        # prepare_hardware (or lazily) and held for the campaign
+        # lifetime; _last_pulse_parameters suppresses redundant
+        # set_parameters roundtrips between configs
+        self.delay_controller = None
+        self._last_pulse_parameters = None
+
+        # Optional SCPI measurement scope (ScopeUtils.Oscilloscope) on
+        # the ChipShouter's 20:1 monitor output; when set, the first
+        # execution of each config is captured and its osc_measured_*
+        # fields filled automatically (see _scope_arm_for_config)
+        self.scope = None
+        self._scope_measured = set()
+
+        # Plugin hook registry (see hooks.py / register_hook). The
+        # compiled per-point call targets live in these flat attributes
+        # so an empty point costs one falsy check in the hot loop.
+        self.hooks = HookRegistry()
+        self._hook_pre_shot = None
+        self._hook_post_shot = None
+        self._hook_on_result = None
+        self._hook_on_position_done = None
+        self._hook_on_error = None
+
+        # Saturation skip rules (see skip_rules.py / add_skip_rule):
+        # evaluated against the live counters before each (position,
+        # config) batch in test_position
+        self._skip_rules = []
+
+        # Bounded handled-error log (errors.ErrorLog): ring of recent
+        # entries + per-type totals; the compressed full-stream sidecar
+        # opens together with the result stream
+        self.catched_errors = ErrorLog()
+
+        # Append-only per-execution result log (see _open_result_stream);
+        # opened by _campaign_setup, None for standalone use
+        self._stream_file = None
+        self._stream_path = None
+        # "jsonl" (default) or "binary" (event_log.py records, ~5x
+        # smaller and parse-free to read; convert to jsonl for
+        # visualize --follow / export_parquet). Set before the campaign.
+        self.stream_format = "jsonl"
+
+        # Sidecar payload blob store (see _blob_serialize); opened and
+        # closed together with the stream log
+        self._blob_file = None
+        self._blob_path = None
+
+        # Typed columnar extradata sidecar (see
+        # register_extradata_columns / extradata_columns.py)
+        self._column_store = None
+        self._columns_path = None
+
+        # Optional per-execution power-trace recording (see
+        # enable_trace_capture / trace_capture.py)
+        self.trace_capture = None
+        self._trace_capture_config = None
+        self._trace_path = None
+
+        # Scope trigger source override (see route_capture_trigger);
+        # None keeps default_setup's tio4, the target's trigger GPIO
+        self._capture_trigger = None
+
+        # Pico sweep-completion line routed to a ChipWhisperer IO pin
+        # (see enable_sweep_feedback): tio_states index, last observed
+        # level and the toggle-counted applied sweep index
+        self._sweep_feedback_pin = None
+        self._sweep_feedback_level = None
+        self._sweep_feedback_index = -1
+
+        # Per-shot hardware trigger-width measurement (see
+        # _arm_trigger_counter); set True before run_campaign to attach
+        # the firmware's set_trigger/clear_trigger duration to every
+        # response-bearing execution record
+        self.measure_trigger_width = False
+        self._trigger_counter_ok = True
+
+        # Campaign id allocated from the results manifest (see
+        # allocate_campaign_id); names all of this campaign's files.
+        # Set compress_results to gzip the results JSON on store.
+        self._campaign_id = None
+        self.compress_results = False
+
+        # Control file polled at position boundaries for whitelisted
+        # mid-campaign changes (see _poll_control); set per campaign
+        self._control_path = None
+
+        # Shard metadata when this profiler runs one shard of a split
+        # campaign (sharding.apply_shard); embedded into the results so
+        # the merge tool can validate and remap them
+        self._shard_spec = None
+
+        # Memory-mapped aggregate counter file for the campaign
+        # (results/xy_map_N.npy); None outside campaigns
+        self._xy_map_path = None
+
+        # Campaign checkpointing (see _write_checkpoint / run_campaign's
+        # resume_from): number of completed position scans, scans still
+        # to fast-forward after a resume, and the time-gated writer state
+        self.checkpoint_interval = 60.0
+        self._scan_cursor = 0
+        # Set by ctrl_c_signal_handler, consumed at the next execution
+        # boundary in test_position (raises CampaignInterrupted)
+        self._interrupt_requested = False
+        self._resume_skip = 0
+        self._checkpoint_path = None
+        self._last_checkpoint = 0.0
+
+        # Set to True when the target runs an SS_BOOT_GPIO firmware
+        # build: reset_target() then confirms reboots via the boot-ready
+        # line (IO3) before the serial consume, so a dead target is
+        # detected in ~1s instead of the full serial-scan timeout.
+        self.gpio_reset_detect = False
+
+        # Set to True when the target runs a fast-boot firmware build
+        # (SS_FAST_BOOT=1): reset_target() then consumes the boot-time
+        # packet and stores the cycle count in last_boot_cycles.
+        self.expect_boot_report = False
+        self.last_boot_cycles = None
+
+        # Set to True when the target runs an SS_RESULT_GPIO firmware
+        # build: test_execution then polls the result line (IO3)
+        # instead of reading an 'e' packet in the nofault common case;
+        # serial is only touched when a fault packet actually arrives.
+        self.gpio_result_mode = False
+
+        # Set to True by enable_merged_ack(): start packets are not
+        # acked by the target, the response packet itself acknowledges
+        # the start, saving one serial roundtrip per execution. Crashes
+        # are localized from the response/timeout pattern instead.
+        self.merged_ack_mode = False
+
+        # Per-position deltas of the serial link-health counters
+        # (TargetSerial.stats), snapshotted at the end of each
+        # test_position and written into the results JSON
+        self.serial_stats_per_position = []
+        self._serial_stats_last = None
+
+        # Last position commanded through move_table(), so unchanged
+        # axes (typically Z) are not re-commanded. None = unknown, e.g.
+        # before the first move or after homing.
+        self._table_position = None
+        # Motion profile currently applied to the table controller
+        # (None = unknown, see _apply_motion_profile)
+        self._motion_profile = None
+        # Optional ClearanceMap enabling Z-hop travel moves (assign a
+        # user-supplied map or call build_clearance_map)
+        self.clearance_map = None
+        # Optional stage travel limits for validate_positions: dict
+        # mapping "x"/"y"/"z" to an inclusive (min, max) range in stage
+        # units. The emf_table wrapper has no limit query, so values
+        # come from the bench setup; None skips the limit check.
+        self.table_travel_limits = None
+        # Optional (x, y) of a fixed mechanical touch point on the
+        # bench plate (not the DUT), enabling home_table()'s persisted
+        # calibration; None always falls back to a full home_all()
+        self.home_reference = None
+
+    def _build_counter_arrays(self, num_positions=None, mmap_path=None):
+        """
+        Allocate zeroed counter arrays: the main
+        (num_configs, num_positions, num_result_types) block and the
+        (num_configs, num_positions) effective-executions plane.
+
+        With mmap_path the main block is a memory-mapped .npy
+        (results/xy_map_N.npy during campaigns), so every increment lands
+        in the file and downstream tools can np.load(..., mmap_mode="r")
+        and slice the aggregate - even mid-campaign - without parsing the
+        results JSON.
+        """
+        if num_positions is None:
+            num_positions = self.num_positions
+        shape = (len(self.glitch_configs), num_positions, len(self.result_types))
+        if mmap_path:
+            counters = np.lib.format.open_memmap(
+                mmap_path, mode="w+", dtype=np.uint32, shape=shape
+            )
+        else:
+            counters = np.zeros(shape, dtype=np.uint32)
+        return counters, np.zeros(shape[:2], dtype=np.uint32)
+
+    def _flush_counters(self):
+        """Push memory-mapped counter increments out to the .npy file."""
+        if isinstance(self._counters, np.memmap):
+            self._counters.flush()
+
+    # Fault-free final counter of the loop payloads (profile_loop.c,
+    # OUTER_COUNT * INNER_COUNT); override before the campaign when
+    # profiling a firmware rebuilt with different loop bounds.
+    LOOP_TOTAL_COUNT = 250_000
+
+    def _build_deviation_arrays(self, num_positions=None):
+        """Zeroed Welford planes for the per-(config, position) counter
+        deviation: sample count, running mean and M2 (sum of squared
+        distances from the mean)."""
+        if num_positions is None:
+            num_positions = self.num_positions
+        shape = (len(self.glitch_configs), num_positions)
+        return (np.zeros(shape, dtype=np.uint32),
+                np.zeros(shape, dtype=np.float64),
+                np.zeros(shape, dtype=np.float64))
+
+    def _record_counter_deviation(self, position_index, config_index,
+                                  result_category, extradata):
+        """
+        Welford update of the counter-deviation statistics with one
+        fault's counter value. The faulty counter's distance from
+        LOOP_TOTAL_COUNT is how many loop iterations the pulse skipped
+        (negative) or repeated (positive) - aggregated online here so
+        deviation maps need no pass over the raw extradata, and the
+        running mean is available mid-campaign as a priority signal.
+        Non-loop payloads (no "counter" in the extradata) book nothing.
+        """
+        if result_category != "faults" or not isinstance(extradata, dict):
+            return
+        counter = extradata.get("counter")
+        if counter is None:
+            return
+        deviation = float(int(counter) - self.LOOP_TOTAL_COUNT)
+        count = int(self._dev_count[config_index, position_index]) + 1
+        delta = deviation - self._dev_mean[config_index, position_index]
+        mean = self._dev_mean[config_index, position_index] + delta / count
+        self._dev_count[config_index, position_index] = count
+        self._dev_mean[config_index, position_index] = mean
+        self._dev_m2[config_index, position_index] += delta * (deviation - mean)
+
+    def deviation_stats(self):
+        """
+        Counter-deviation statistics as (num_configs, num_positions)
+        arrays: {"count", "mean", "std"} with zeros where no loop fault
+        has been booked. std is the population deviation (M2 / count).
+        """
+        count = self._dev_count
+        safe = np.maximum(count, 1)
+        return {
+            "count": count,
+            "mean": np.where(count > 0, self._dev_mean, 0.0),
+            "std": np.sqrt(np.where(count > 0, self._dev_m2 / safe, 0.0)),
+        }
+
+    def _bind_result_views(self, counters, effective):
+        """Per-config dicts of views into the counter arrays, matching the
+        old list-of-dicts-of-lists accessors (result-type order follows
+        self.result_types insertion order)."""
+        results = []
+        for config_index in range(len(self.glitch_configs)):
+            config_results = {
+                f"num_{key}": counters[config_index, :, type_index]
+                for type_index, key in enumerate(self.result_types)
+            }
+            config_results["effective_executions"] = effective[config_index]
+            results.append(config_results)
+        return results
+
+    def counters_array(self):
+        """
+        The uint32 counter block backing self.results, shaped
+        (num_configs, num_positions, num_result_types) with the result
+        types in self.result_types order. Directly np.save()-able for the
+        xy-map export described in the README.
+        """
+        return self._counters
+
     def addResultType(self, key: str, label: str):
         """
         Add a new result type to the configuration.
@@ -115,9 +583,45 @@ class CSProfiler:
         # Add to result_types mapping
         self.result_types[key] = label
 
-        # Add corresponding counters to existing results
-        for res in self._results:
-            res[f"num_{key}"] = [0] * self.num_positions
+        # Rebuild the (all-zero) template with the new type included; a
+        # campaign's live self.results is unaffected, as before
+        template_counters, template_effective = self._build_counter_arrays()
+        self._results = self._bind_result_views(template_counters, template_effective)
+        if not hasattr(self, "results"):
+            # No campaign arrays allocated yet: keep backing the template
+            self._counters, self._effective = template_counters, template_effective
+
+    def _register_packet_handler(self, packet):
+        """
+        Validate a SimpleSerialPacket handler once and add the packet to the
+        dispatch table under its command byte.
+
+        Raises
+        ------
+        TypeError
+            If the handler is neither None nor callable, or cannot accept
+            the (profiler, packet, data) call made by handlePacket.
+        """
+        command_byte = (
+            ord(packet.command[0]) if isinstance(packet.command, str) else packet.command
+        )
+
+        if packet.handler is not None:
+            if not callable(packet.handler):
+                raise TypeError(
+                    f"Handler of SimpleSerialPacket {packet.command} is not callable"
+                )
+            # Signature check at registration time instead of per packet:
+            # must accept the (profiler, packet, data) positional call
+            try:
+                inspect.signature(packet.handler).bind(self, packet, None)
+            except TypeError as e:
+                raise TypeError(
+                    f"Handler of SimpleSerialPacket {packet.command} must accept "
+                    f"(profiler, packet, data): {e}"
+                ) from e
+
+        self._packet_dispatch[command_byte] = packet
 
     def addSimpleSerialCommand(self, packet, overwrite=False):
         """
@@ -159,9 +663,10 @@ class CSProfiler:
             ]
             self.valid_commands.remove(packet.command)
 
-        # Append to configuration and update valid commands
+        # Append to configuration, update valid commands and dispatch table
         self.simpleserial_config.append(packet)
         self.valid_commands.append(packet.command)
+        self._register_packet_handler(packet)
 
     def send_packet(self, cmd, data=None):
         cmd = TargetSerial.type_convert_cmd(cmd)
@@ -171,10 +676,42 @@ class CSProfiler:
         self.target_serial.send_packet(cmd, data)
 
     def ctrl_c_signal_handler(self, sig, frame):
-        print("STORING RESULTS BEFORE EXIT")
-        self.store_results(self.results, partial=True)
-        self.cs.disarm()
-        sys.exit(0)
+        """
+        First Ctrl+C: disarm the ChipShouter right here (safety first,
+        and it is fast), then set the flag test_position consumes at
+        the next execution boundary. The handler used to run the full
+        store_results serialization - minutes of freeze on a big
+        campaign, during which a second Ctrl+C killed the process with
+        the coil still armed. Second Ctrl+C: exit immediately; the
+        per-record-flushed stream log and the last checkpoint are
+        already on disk.
+        """
+        if self._interrupt_requested:
+            print("Second interrupt, exiting now (stream log and last "
+                  "checkpoint are on disk)")
+            sys.exit(1)
+        self._interrupt_requested = True
+        try:
+            self.cs.disarm()
+        except Exception as e:
+            print(f"Interrupt: disarm failed ({e})")
+        print("Interrupt: ChipShouter disarmed, stopping at the next "
+              "execution boundary (Ctrl+C again to exit immediately)")
+
+    def _interrupt_exit(self):
+        """
+        Fast exit path for an operator interrupt, taken by the campaign
+        runners on CampaignInterrupted. The stream log is flushed per
+        record, so only the checkpoint needs writing - milliseconds
+        regardless of campaign size; the results JSON comes from
+        resuming the checkpoint or a later store_results pass.
+        """
+        self._write_checkpoint()
+        self._close_result_stream()
+        self._disconnect_delay_controller()
+        print(f"Interrupted: checkpoint written to {self._checkpoint_path}, "
+              f"resume with resume_from= to finish the campaign")
+        return 130
 
     @staticmethod
     def make_json_serializable(obj):
@@ -184,6 +721,7 @@ class CSProfiler:
         - dict: process keys/values recursively
         - list/tuple: process elements recursively
         - bytes/bytearray: convert to uppercase hex string
+        - numpy arrays/scalars: convert to lists / Python scalars
         - other types: returned as-is
         """
         if isinstance(obj, dict):
@@ -192,244 +730,2352 @@ class CSProfiler:
             return [CSProfiler.make_json_serializable(v) for v in obj]
         elif isinstance(obj, (bytes, bytearray)):
             return bytes(obj).hex().upper()
+        elif isinstance(obj, np.ndarray):
+            return obj.tolist()
+        elif isinstance(obj, np.generic):
+            return obj.item()
         else:
             return obj
 
-    def store_results(self, results, partial=False):
-        # Find a unique filename
-        counter = 0
-        results_path = "results/"
-        os.makedirs(results_path, exist_ok=True)
-        while os.path.exists(f"{results_path}results_{counter}.json") or os.path.exists(f"{results_path}results_{counter}_partial.json"):
-            counter += 1
-
-        # Add info strings to the top of the results JSON
-        log_json = dict()
-        log_json.update({"Info: glitch_config results structure": "num_nofaults specifies the number of faults for every position from the positions array (equivalent for num_nofaults, num_resets, num_crashes)"})
-        # log_json.update({"Info: positions structure": "All positions [x,y,z] from the positions array are relative to the origin"}) # TODO: maybe make positions relative to origin?
+    def _open_result_stream(self):
+        """
+        Open the append-only per-execution result log for this campaign.
 
-        # Convert glitch_configs to dicts
-        glitch_config_dicts = [asdict(cfg) for cfg in self.glitch_configs]
+        One compact JSON line per execution (position_index, config_index,
+        result_category, serialized extradata) is appended and flushed as
+        results arrive, so a crash at any point loses at most the
+        execution in flight and extradata never accumulates in memory.
+        store_results rebuilds the summary's extradata sections from this
+        log at the end, which also removes the end-of-run serialization
+        stall of the old all-in-memory dump.
+        """
+        results_path = "results/"
+        if self._campaign_id is None:
+            # sharding.apply_shard may have pinned a deterministic id;
+            # only unsharded campaigns draw from the manifest
+            self._campaign_id = allocate_campaign_id(results_path)
+        if self.stream_format == "binary":
+            self._stream_path = f"{results_path}stream_{self._campaign_id}.bin"
+            self._stream_file = EventLogWriter(self._stream_path,
+                                               list(self.result_types))
+        else:
+            self._stream_path = f"{results_path}stream_{self._campaign_id}.jsonl"
+            self._stream_file = open(self._stream_path, "a")
+        self._checkpoint_path = f"{results_path}checkpoint_{self._campaign_id}.json"
+        self._control_path = f"{results_path}control_{self._campaign_id}.json"
 
-        # Add results to glitch_config dicts
-        for config_index, config_result in enumerate(results):
-            glitch_config_dicts[config_index].update({"results": config_result})
+        # Sidecar store for large fault payloads: raw bytes appended to a
+        # flat binary file, referenced from the stream/results JSON by
+        # (blob_offset, blob_length). Keeps the JSON small enough for
+        # visualize.py to stay interactive on big campaigns.
+        self._blob_path = f"{results_path}blobs_{self._campaign_id}.bin"
+        self._blob_file = open(self._blob_path, "ab")
 
-        log_json.update({"catched_errors": self.catched_errors})
-        log_json.update({"positions": self.positions})
-        log_json.update({"glitch_configs": glitch_config_dicts})
+        # Full handled-error stream; the results JSON keeps only the
+        # bounded summary plus this path (see errors.ErrorLog)
+        self.catched_errors.open_spill(
+            f"{results_path}errors_{self._campaign_id}.jsonl.gz"
+        )
 
-        # Make log_json serializable
-        log_json = self.make_json_serializable(log_json)
+        if self._column_store is not None:
+            self._columns_path = f"{results_path}columns_{self._campaign_id}.npz"
 
-        # Save log_json as file
-        def default_serializer(obj):
-            print(f"ERROR: Serialization failed for: {obj}")
-            return "SERIALIZATION_FAILED"
+        # Trace sidecar when enable_trace_capture was called; the scope
+        # exists by now (prepare_hardware runs before the stream opens),
+        # which is also what lets the "window" profile resolve against
+        # the real ADC sample rate
+        if self._trace_capture_config is not None and self.trace_capture is None:
+            self._trace_path = f"{results_path}traces_{self._campaign_id}.bin"
+            resolved = self._resolve_capture_profile()
+            self.progress.event(
+                f"Trace capture: {self._trace_capture_config['profile']} "
+                f"profile, {resolved['samples']} samples/shot"
+            )
+            configure = getattr(self.cw, "configure_scope", None)
+            if configure is not None and self._capture_trigger is not None:
+                # Glitch-synchronous gating: trigger from the routed
+                # pulse line (route_capture_trigger)
+                configure = functools.partial(
+                    configure, trigger=self._capture_trigger
+                )
+            self.trace_capture = TraceCapture(
+                self.cw.scope, self._trace_path, configure=configure,
+                **resolved,
+            )
 
-        with open(f"{results_path}results_{counter}{'_partial' if partial else ''}.json", "w") as f:
-            json.dump(log_json, f, indent=4, default=default_serializer)
+    def enable_trace_capture(self, profile="full", samples=None, offset=None,
+                             decimate=None, compress=True,
+                             defer_readback=False):
+        """
+        Record one power trace per execution into a binary sidecar.
 
-    def configure_chipshouter(self, glitch_config:GlitchConfig):
-        # Configure voltage
-        self.cs.voltage = glitch_config.voltage
+        Call before run_campaign(); the capture file
+        (results/traces_<campaign_id>.bin) opens together with the
+        result stream and its path and record format land in the results
+        JSON header. The shot loop only arms the scope - pulling the
+        samples and writing them to disk happen on a collector thread
+        that overlaps the next shot (see trace_capture.py), so capture
+        costs the loop one re-arm wait, not a USB transfer.
 
-        # Using Pi Pico as pulse generator
-        with DelayController(port="/dev/ttyACM1") as dc:
-            dc.set_parameters({"offset": glitch_config.pulse_offset, "length": glitch_config.pulse_width, "spacing": glitch_config.pulse_spacing, "repeats": glitch_config.pulse_repeats})
+        `profile` names a capture preset (trace_capture.CAPTURE_PROFILES):
+        "full" is the whole post-trigger buffer, "overview" a decimated
+        view of the execution, and "window" just the injection window,
+        derived from the campaign's pulse timing and the measured pulse
+        width once the scope is up - an order of magnitude less USB per
+        capture, which is what makes capture-per-shot viable at full
+        shot rate. Any of samples/offset/decimate overrides the preset.
 
-        # Configure internal pulse generator
-        # cs.configure_pulsegen(
-        #     glitch_config.pulse_spacing // 1000000, # convert from ns to ms
-        #     glitch_config.pulse_repeats,
-        #     glitch_config.pulse_width
-        # )
+        Traces go through the chunked compressed container by default
+        (trace_capture module docstring) - float32 traces of 10-bit
+        samples compress several-fold, which is what keeps week-long
+        capture campaigns on the bench SSD; compress=False writes the
+        flat raw sidecar instead.
 
+        defer_readback batches window captures in the scope's segment
+        buffer and pulls them between positions, during the table move
+        - per-shot USB drops to the batch arm. Needs a segmented scope
+        (Husky); on the CW-Lite it quietly stays in per-shot mode, and
+        partial batches (early stop, crash retries) salvage whatever
+        segments the scope holds and book the rest as failed captures.
+        """
+        if profile not in CAPTURE_PROFILES:
+            raise ValueError(
+                f"Unknown capture profile '{profile}' "
+                f"(have: {', '.join(CAPTURE_PROFILES)})"
+            )
+        self._trace_capture_config = {"profile": profile, "samples": samples,
+                                      "offset": offset, "decimate": decimate,
+                                      "compress": compress,
+                                      "defer_readback": defer_readback}
 
-    def reset_target(self, timeout=5000, retries=3):
-        reset_seq = self.target_serial._reset_sequence
-        for _ in range(retries):
-            self.cw.reset_target()
-            if self.target_serial.read_until(reset_seq, timeout).endswith(reset_seq):
-                return 0
+    def _resolve_capture_profile(self):
+        """Turn the stored profile name plus overrides into concrete
+        TraceCapture settings; "window" needs the live scope for the
+        ADC sample rate, so this runs at stream-open time."""
+        spec = dict(self._trace_capture_config)
+        profile = spec.pop("profile")
+        if profile == "window":
+            clock = self.cw.scope.clock
+            resolved = window_profile(
+                clock.adc_freq * clock.adc_mul, self.glitch_configs,
+                pulse_triggered=self._capture_trigger is not None,
+            )
+        else:
+            resolved = dict(CAPTURE_PROFILES[profile])
+        resolved.update({k: v for k, v in spec.items() if v is not None})
+        return resolved
 
-        raise ResetTimeoutError(f"Failed to reset target after {retries} tries!")
+    def route_capture_trigger(self, line="tio1"):
+        """
+        Trigger the capture scope from the pulse-generator output
+        instead of the target's trigger GPIO.
 
-    def power_cycle_target(self):
-        self.cw.power_cycle_usb() # Power cycle chipwhisperer USB port
+        With the Pico generating the offset, triggering from the target
+        GPIO forces wide capture windows just to be sure of catching
+        the pulse. Loop the Pico's delayed pulse output back into a
+        spare ChipWhisperer trigger line (tio1 by default) and call
+        this before run_campaign(): captures then start at the actual
+        injection instant, the "window" profile's offset becomes
+        exactly zero instead of a pulse_offset heuristic, and per-shot
+        capture shrinks to a few hundred samples.
 
-    def handlePacket(self, cmd, data=None) -> tuple[str, dict]:
-        # Find packet object in simpleserial_config that matches the command
-        for packet in self.simpleserial_config:
-            # Convert string commands to int if needed
-            command_byte = (
-                ord(packet.command[0]) if isinstance(packet.command, str) else packet.command
-            )
+        Not to be combined with measure_trigger_width - with the
+        trigger source moved to the pulse path, adc.trig_count measures
+        the pulse width, not the execution duration.
+        """
+        self._capture_trigger = line
 
-            if command_byte == cmd:
-                matched_packet = packet
-                break
-        if matched_packet is None:
-            raise ValueError(f"No matching packet definition found for command: `{cmd}`")
+    def register_extradata_columns(self, fields):
+        """
+        Record the given numeric extradata fields in typed column
+        arrays alongside the stream log.
 
-        # Calls handler function of packet if it is defined
-        if callable(matched_packet.handler):
-            result = matched_packet.handler(self, matched_packet, data)
-            if isinstance(result, tuple) and len(result) == 2:
-                result_category, extradata = result
-            elif isinstance(result, str):
-                result_category, extradata = result, None
-            else:
-                raise ValueError(f"Handler of SimpleSerialPacket {matched_packet.command} must return either a string or a (string, extradata) tuple!")
+        `fields` is a list of (name, numpy dtype) - LOOP_COLUMN_FIELDS
+        covers the loop payloads' cycle counters. Every execution whose
+        extradata carries all the fields as numbers becomes one row of
+        (position, config, execution) indices plus the field values;
+        other executions are simply absent. The columns are saved as
+        columns_<id>.npz next to the results (at checkpoints and at
+        store_results), giving analysis direct ndarray access with no
+        stream-log traversal; self._column_store.columns() exposes the
+        live arrays mid-campaign. Call before the campaign starts.
+        """
+        self._column_store = ColumnStore(fields)
 
-            # Verify that returned result_category is valid
-            if result_category not in self.result_types:
-                raise ValueError(f"PacketHandler of command: `{matched_packet.command}` returned invalid result_category: `{result_category}`")
+    def _close_result_stream(self):
+        if self.trace_capture is not None:
+            try:
+                self.trace_capture.close()
+            except Exception:
+                pass
+            self.trace_capture = None
+        if self._stream_file is not None:
+            try:
+                self._stream_file.close()
+            except OSError:
+                pass
+            self._stream_file = None
+        if self._blob_file is not None:
+            try:
+                self._blob_file.close()
+            except OSError:
+                pass
+            self._blob_file = None
 
-            # Verify that returned extradata is of type dict
-            if extradata is not None and not isinstance(extradata, (dict, str, int, list)):
-                raise ValueError(f"PacketHandler of command: `{matched_packet.command}` returned invalid extradata type (has to be dict, str, int, list)")
+    def _stream_result(self, position_index, config_index, result_category, extradata=None):
+        """Append one execution record to the stream log. No-op when no
+        stream is open (test_position called outside a campaign)."""
+        if self._stream_file is None:
+            return False
+        data = None
+        if extradata:
+            data = self._blob_serialize(extradata)
+            if self._blob_file is not None:
+                # Flush payload bytes before the record referencing them
+                self._blob_file.flush()
+        if isinstance(self._stream_file, EventLogWriter):
+            self._stream_file.append(position_index, config_index,
+                                     result_category, data)
+            return True
+        record = {
+            "position_index": position_index,
+            "config_index": config_index,
+            "result_category": result_category,
+        }
+        if data:
+            record["data"] = data
+        self._stream_file.write(json.dumps(record, separators=(",", ":")) + "\n")
+        self._stream_file.flush()
+        return True
 
-        return result_category, extradata
+    # Byte buffers up to this size stay inline as hex; longer ones (e.g.
+    # the 68-byte memcpy fault buffers) go to the sidecar blob store
+    BLOB_INLINE_MAX = 16
 
-    def resetPacketHandler(_, profilerSelf, packetSelf, data=None) -> tuple[str, dict]:
-        return "resets"
+    def _blob_serialize(self, obj):
+        """
+        Serializable form of extradata with large byte buffers swapped
+        for {"blob_offset", "blob_length"} references into the sidecar
+        store. Falls back to plain hex when no blob file is open.
+        """
+        if isinstance(obj, dict):
+            return {k: self._blob_serialize(v) for k, v in obj.items()}
+        if isinstance(obj, (list, tuple)):
+            return [self._blob_serialize(v) for v in obj]
+        if (isinstance(obj, (bytes, bytearray))
+                and len(obj) > self.BLOB_INLINE_MAX
+                and self._blob_file is not None):
+            offset = self._blob_file.tell()
+            self._blob_file.write(bytes(obj))
+            return {"blob_offset": offset, "blob_length": len(obj)}
+        return self.make_json_serializable(obj)
 
-    def nofaultPacketHandler(_, profilerSelf, packetSelf, data=None) -> tuple[str, dict]:
-        return "nofaults"
+    @staticmethod
+    def read_blob(blob_path, ref):
+        """
+        Fetch one payload out of the sidecar blob store.
 
-    def faultPacketHandler(_, profilerSelf, packetSelf, data=None) -> tuple[str, dict]:
-        profilerSelf.reset_target() # TODO when resetting fails, will faults or bricked be written??
-        # When resetting fails, error will be thrown here...
-        return "faults"
+        Parameters
+        ----------
+        blob_path : str
+            The blob file recorded as "fault_blobs" in the results JSON.
+        ref : dict
+            A {"blob_offset", "blob_length"} reference as found in place
+            of the hex payload in the results/stream records.
 
-    def crashHandler(self) -> tuple[str, dict]:
+        Returns
+        -------
+        bytes
+            The raw payload.
         """
-        Handler for when target crashed (is unresponsive).
+        with open(blob_path, "rb") as f:
+            f.seek(ref["blob_offset"])
+            return f.read(ref["blob_length"])
 
-        Returns:
-            tuple[str, dict]: result_category, extradata
+    def _merge_stream_extradata(self, results):
         """
-        self.reset_target()
+        Rebuild the per-category extradata stores of `results` from the
+        stream log: dicts keyed by position_index, so merging is O(1) per
+        record independent of visit order (resume appends to an earlier
+        log; the path planner reorders positions).
+        """
+        if not self._stream_path or not os.path.exists(self._stream_path):
+            return
+        for record in self._iter_stream_records():
+            data = record.get("data")
+            if not data:
+                continue
+            config_result = results[record["config_index"]]
+            by_position = config_result.setdefault(record["result_category"], {})
+            by_position.setdefault(record["position_index"], []).append(data)
 
-        return "crashes", None
+    def _iter_stream_records(self):
+        """Yield the stream log's records regardless of format: binary
+        event logs through their mmap reader, JSONL line by line
+        (skipping a partial trailing line after a crash)."""
+        if self._stream_path.endswith(".bin"):
+            yield from iter_event_records(self._stream_path)
+            return
+        with open(self._stream_path) as f:
+            for line in f:
+                try:
+                    yield json.loads(line)
+                except ValueError:
+                    continue
 
-    def test_execution(self, position_index: int, config_index: int, execution_index: int) -> tuple[int, str, dict | None]:
+    def _write_checkpoint(self):
         """
-        Execute a single fault injection. Called by test_position.
-
-        This function can be overwritten with overwrite_test_exeuction(newFunction) which allows
-        for completely custom control flow for the fault injection.
-        By default it does the following steps:
-            - Arm ChipShouter
-            - Check ChipShouter temperature (wait till cooled off if necessary)
-            - Validate if ChipShouter is ready for trigger (trigger_safe)
-            - Send start packet to target
-            - Wait for target to acknowledge the start packet
-            - Wait for target response packet
-                - If received: call self.handlePacket(cmd, raw_data) to handle the command and parse data from it
-                - If not received in time: call self.crashHandler()
-            - Return incremented execution_index, result_category, extradata (optional)
+        Persist the campaign cursor and counters for resume.
 
-        If self._test_execution is defined (by self.overwrite_test_execution()), call that function instead.
+        Written atomically (tmp file + rename) so power loss during the
+        write leaves the previous checkpoint intact. Extradata is not
+        duplicated here - it lives in the stream log the checkpoint
+        references. The scheduler is deterministic given the planned
+        orders, so position_order/config_order plus the scan cursor are
+        the complete scheduler state (there is no RNG to record).
+        """
+        if self._checkpoint_path is None:
+            return
+        state = {
+            "campaign_id": self._campaign_id,
+            "num_glitch_configs": len(self.glitch_configs),
+            "positions": self.positions,
+            "position_order": self.position_order,
+            "config_order": self.config_order,
+            "position_depths": self.position_depths,
+            "scans_completed": self._scan_cursor,
+            # Config parameters are also the campaign header a live
+            # visualizer (visualize.py --follow) pairs with the stream log
+            "glitch_configs": [asdict(cfg) for cfg in self.glitch_configs],
+            "results": self.results,
+            "catched_errors": self.catched_errors.summary(),
+            "results_stream": self._stream_path,
+            "fault_blobs": self._blob_path,
+            "xy_map": self._xy_map_path,
+            "counter_deviation": {
+                "count": self._dev_count,
+                "mean": self._dev_mean,
+                "m2": self._dev_m2,
+            },
+            "provenance": self._provenance,
+        }
+        if self._scheduler is not None:
+            # Prioritized campaigns are result-driven, not plan-driven:
+            # the queue + interest map IS the scheduler state
+            state["scheduler"] = self._scheduler.to_state()
+        if self._column_store is not None and self._columns_path:
+            # The column sidecar is saved (atomically) alongside, so the
+            # checkpoint only needs the reference and the field schema
+            self._column_store.save(self._columns_path)
+            state["extradata_columns"] = {"path": self._columns_path,
+                                          "fields": self._column_store.fields}
+        self._flush_counters()
+        tmp_path = self._checkpoint_path + ".tmp"
+        with open(tmp_path, "w") as f:
+            json.dump(state, f, default=self._default_serializer)
+        os.replace(tmp_path, self._checkpoint_path)
+        self._last_checkpoint = time.monotonic()
 
-        Args:
-            position_index (int):
-            config_index (int):
-            execution_index (int):
+    def _maybe_checkpoint(self):
+        """Write a checkpoint at most every checkpoint_interval seconds."""
+        if time.monotonic() - self._last_checkpoint >= self.checkpoint_interval:
+            self._write_checkpoint()
 
-        Raises:
-            e: Unknown error from chipshouter arming
-            RuntimeError: ChipShouter is not ready for trigger (trigger_safe failed)
+    def _load_checkpoint(self, path):
+        """
+        Reload campaign state from a checkpoint written by
+        _write_checkpoint and arm the scan fast-forward.
 
-        Returns:
-            tuple[int, str, dict | none (optional)]: (next_execution_index, result_category, extradata)
-            tuple[int, str]: (next_execution_index, result_category)
+        The stream log referenced by the checkpoint is reopened in append
+        mode so the resumed campaign keeps extending the same log.
         """
+        with open(path) as f:
+            state = json.load(f)
 
-        # ------------------------------ If overwritten ------------------------------ #
+        if state["num_glitch_configs"] != len(self.glitch_configs):
+            raise ValueError(
+                f"Checkpoint was taken with {state['num_glitch_configs']} glitch "
+                f"configs, profiler has {len(self.glitch_configs)}"
+            )
 
-        if hasattr(self, "_test_execution") and self._test_execution:
-            # test_execution function was overwritten call self._test_execution() instead.
-            ret = self._test_execution(self, position_index, config_index, execution_index)
+        self.positions = state["positions"]
+        self.num_positions = len(self.positions)
+        self.position_order = state["position_order"]
+        self.config_order = state["config_order"]
+        self.position_depths = state["position_depths"]
+        self.catched_errors = ErrorLog.from_state(state["catched_errors"])
 
-            # Verify the return type
-            if (isinstance(ret, tuple)):
-                if len(ret) == 2:
-                    next_execution_index, result_category = ret
-                    data = None
-                elif len(ret) == 3:
-                    next_execution_index, result_category, data  = ret
+        # Reload the JSON lists back into fresh counter arrays (mapped to
+        # the checkpointed xy_map file when one was recorded); entries
+        # that are not per-position counters are carried over as plain
+        # dict values
+        self._xy_map_path = state.get("xy_map")
+        self._counters, self._effective = self._build_counter_arrays(
+            mmap_path=self._xy_map_path
+        )
+        self.results = self._bind_result_views(self._counters, self._effective)
+        for config_index, config_result in enumerate(state["results"]):
+            view = self.results[config_index]
+            for key, values in config_result.items():
+                if key in view and isinstance(values, list):
+                    view[key][:] = values
                 else:
-                    raise TypeError(f"test_execution must return a tuple (int, str, dict) or (int, str), got {type(ret)}")
+                    view[key] = values
+        self._dev_count, self._dev_mean, self._dev_m2 = \
+            self._build_deviation_arrays()
+        deviation = state.get("counter_deviation")
+        if deviation:
+            self._dev_count[:] = deviation["count"]
+            self._dev_mean[:] = deviation["mean"]
+            self._dev_m2[:] = deviation["m2"]
+        self._provenance = state.get("provenance")
+        columns = state.get("extradata_columns")
+        if columns:
+            self._columns_path = columns["path"]
+            try:
+                self._column_store = ColumnStore.load(
+                    self._columns_path, columns["fields"]
+                )
+            except OSError:
+                # Sidecar lost with its rows; restart the columns empty
+                # rather than failing the resume (the stream log still
+                # has every record)
+                self._column_store = ColumnStore(columns["fields"])
+        self._scan_cursor = state["scans_completed"]
+        self._resume_skip = state["scans_completed"]
+
+        self._campaign_id = state.get("campaign_id")
+        self._stream_path = state.get("results_stream")
+        if self._stream_path:
+            if self._stream_path.endswith(".bin"):
+                self._stream_file = EventLogWriter(self._stream_path,
+                                                   list(self.result_types))
             else:
-                raise TypeError(f"test_execution must return a tuple (int, str, dict) or (int, str), got {type(ret)}")
+                self._stream_file = open(self._stream_path, "a")
+            self._blob_path = state.get("fault_blobs")
+            if self._blob_path:
+                self._blob_file = open(self._blob_path, "ab")
+            if self.catched_errors.spill_path:
+                self.catched_errors.open_spill(self.catched_errors.spill_path)
+        else:
+            self._open_result_stream()
+        # Queue state of a prioritized campaign; picked up by
+        # run_campaign_prioritized when resuming one
+        self._checkpoint_scheduler_state = state.get("scheduler")
 
-            if not isinstance(next_execution_index, int):
-                raise TypeError(f"First element (next_execution_index) must be int, got {type(next_execution_index)}")
-            if not isinstance(result_category, str):
-                raise TypeError(f"Second element (result_category) must be str, got {type(result_category)}")
-            if not (isinstance(data, dict) or data is None):
-                raise TypeError(f"Third element (extradata) must be dict or None, got {type(data)}")
+        self._checkpoint_path = path
+        self._last_checkpoint = 0.0
+        self._control_path = f"results/control_{self._campaign_id}.json"
+        print(f"Resuming campaign from {path}: {self._scan_cursor} position scans already done")
 
-            return ret
+    # GlitchConfig fields a running campaign may change via hot-reload:
+    # timeout and early-stop knobs only. Pulse shape and voltage stay
+    # frozen - changing them mid-run would make the counters of one
+    # config describe two different experiments.
+    HOT_RELOAD_FIELDS = (
+        "dead_timeout", "ack_timeout",
+        "early_stop_p_low", "early_stop_p_high", "early_stop_confidence",
+    )
 
-        glitch_config = self.glitch_configs[config_index]
-        next_execution_index = execution_index + 1
+    def _append_glitch_configs(self, new_configs):
+        """
+        Append glitch configs mid-campaign and grow every per-config
+        result counter accordingly (the config-axis sibling of
+        _append_positions). Returns the indices assigned to the new
+        configs; they are also appended to config_order so the scan
+        picks them up at the next position.
+        """
+        start = len(self.glitch_configs)
+        self.glitch_configs = list(self.glitch_configs) + list(new_configs)
+        try:
+            # Same load-time pass fresh configs get in _campaign_setup;
+            # a rejected batch leaves the campaign untouched
+            self.validate_glitch_configs(range(start, len(self.glitch_configs)))
+        except ValueError:
+            self.glitch_configs = self.glitch_configs[:start]
+            raise
 
-        # -------------------------- Default Implementation -------------------------- #
+        pad_shape = (len(new_configs),) + np.asarray(self._counters).shape[1:]
+        grown = np.concatenate(
+            [np.asarray(self._counters), np.zeros(pad_shape, dtype=np.uint32)], axis=0
+        )
+        if self._xy_map_path and isinstance(self._counters, np.memmap):
+            self._counters = np.lib.format.open_memmap(
+                self._xy_map_path, mode="w+", dtype=np.uint32, shape=grown.shape
+            )
+            self._counters[:] = grown
+        else:
+            self._counters = grown
+        self._effective = np.concatenate(
+            [self._effective, np.zeros(pad_shape[:2], dtype=np.uint32)], axis=0
+        )
+        self._dev_count, self._dev_mean, self._dev_m2 = (
+            np.concatenate([plane, np.zeros(pad_shape[:2], dtype=plane.dtype)],
+                           axis=0)
+            for plane in (self._dev_count, self._dev_mean, self._dev_m2)
+        )
+        self.results = self._bind_result_views(self._counters, self._effective)
 
-        time.sleep(0.05) # Small delay required to prevent ChipShouter from disconnecting
+        indices = list(range(start, len(self.glitch_configs)))
+        self.config_order = list(self.config_order) + indices
+        return indices
 
-        # Arm ChipShouter. If it has faults, try to clear them.
-        try:
-            self.cs.arm()
-        except Exception as e:
-            # TODO: remove this separate handler and throw the fault into the main execution error handler
-            self.catched_errors.append({"position_index": position_index, "error": str(e)})
-            if str(e) == "ChipShouter has faults!":
-                self.cs.clear_faults()
-                return next_execution_index, "skipped", None
-            else:
-                print(e)
-                raise e
+    def apply_control_changes(self, changes):
+        """
+        Apply a whitelisted set of mid-campaign changes (see
+        _poll_control for the file format). Raises ValueError on
+        anything outside the whitelist; nothing is partially applied
+        before validation of that entry. Returns human-readable
+        descriptions of what was applied.
+        """
+        applied = []
 
-        # Check ChipShouter temps
-        while self.cs.temps_too_high():
-            print("Chipshouter Temp too high, waiting...")
-            time.sleep(10)
+        for key, fields_changed in (changes.get("glitch_configs") or {}).items():
+            config_index = int(key)
+            glitch_config = self.glitch_configs[config_index]
+            for field, value in fields_changed.items():
+                if field not in self.HOT_RELOAD_FIELDS:
+                    raise ValueError(f"GlitchConfig.{field} is not hot-reloadable")
+                if field == "dead_timeout" and hasattr(
+                        glitch_config, "faulting_duration_ns") and \
+                        glitch_config.faulting_duration_ns / 1e6 >= value:
+                    # The same train-vs-timeout constraint
+                    # validate_glitch_configs enforces at load time
+                    raise ValueError(
+                        f"glitch_configs[{config_index}].dead_timeout "
+                        f"{value} ms is shorter than the "
+                        f"{glitch_config.faulting_duration_ns / 1e6} ms "
+                        f"pulse train")
+                setattr(glitch_config, field, value)
+                applied.append(f"glitch_configs[{config_index}].{field}={value}")
+            # Drop the learned timeout trackers so the new configured
+            # values take effect instead of the old clamp
+            for kind in ("ack", "dead"):
+                self._adaptive_timeouts.pop((kind, config_index), None)
 
-        # Validate that ChipShouter is ready for trigger
-        if not self.cs.cs.trigger_safe:
-            raise RuntimeError("ChipShouter is not ready for trigger (trigger_safe failed)!")
+        appended = changes.get("append_glitch_configs") or []
+        if appended:
+            indices = self._append_glitch_configs(
+                [GlitchConfig(**cfg) for cfg in appended]
+            )
+            if self._scheduler is not None:
+                for config_index in indices:
+                    self._scheduler.add_config(config_index)
+            applied.append(f"appended glitch configs {indices}")
 
-        # TODO: check CS measured voltage (prevents too fast shooting where CS cant charge quick enough)
-        # print(f"Voltage_measured: {self.cs.voltage.measured}")
-        
-        # Send start signal to target
-        self.send_packet("s")
+        for name, value in (changes.get("scheduler") or {}).items():
+            if name not in ("movement_weight", "adjacency_boost", "dead_decay"):
+                raise ValueError(f"scheduler.{name} is not hot-reloadable")
+            if self._scheduler is not None:
+                setattr(self._scheduler, name, value)
+                applied.append(f"scheduler.{name}={value}")
 
-        # Wait for target to acknowlege start packet
-        if self.target_serial.wait_ack("s", glitch_config.ack_timeout) != 0:
-            # ack not received -> target bricked
-            result_category, extradata = self.crashHandler()
-        else:
-            # Read next packet from target
-            try:
-                cmd, raw_data = self.target_serial.read_packet(timeout=glitch_config.dead_timeout)
-            except Exception as e:
-                result_category, extradata = self.crashHandler()
-            else: # if no exception was raised
-                # Handle packet (according to simpleserial_config)
-                result_category, extradata = self.handlePacket(cmd, raw_data)
+        return applied
 
-        return next_execution_index, result_category, extradata
+    def _poll_control(self):
+        """
+        Hot-reload check at position boundaries: when the campaign's
+        control file (results/control_<id>.json) exists, apply its
+        whitelisted changes and rename it to .applied (.invalid on
+        rejection), so each drop is applied exactly once and leaves an
+        audit trail. The file is plain JSON:
+
+            {"glitch_configs": {"0": {"dead_timeout": 250}},
+             "append_glitch_configs": [{...full GlitchConfig...}],
+             "scheduler": {"movement_weight": 1.0}}
+        """
+        if not self._control_path or not os.path.exists(self._control_path):
+            return
+        try:
+            with open(self._control_path) as f:
+                changes = json.load(f)
+            applied = self.apply_control_changes(changes)
+            os.replace(self._control_path, self._control_path + ".applied")
+            self.progress.event(
+                f"Hot-reload applied: {'; '.join(applied) or 'nothing'}"
+            )
+        except Exception as e:
+            self.catched_errors.append(
+                {"position_index": "hot_reload", "error": str(e),
+                 "type": type(e).__name__})
+            try:
+                os.replace(self._control_path, self._control_path + ".invalid")
+            except OSError:
+                pass
+            self.progress.event(f"Hot-reload rejected: {str(e)}")
+
+    def store_results(self, results, partial=False):
+        # Campaign id from the manifest: reuse the one allocated with the
+        # stream log, allocate a fresh one for standalone stores
+        results_path = "results/"
+        counter = self._campaign_id
+        if counter is None:
+            counter = allocate_campaign_id(results_path)
+
+        # Schema stamp first, then the info strings, at the top of the
+        # results JSON (see migrate_results.py for the generations)
+        log_json = dict()
+        log_json.update({"schema_version": RESULTS_SCHEMA_VERSION})
+        log_json.update({"Info: glitch_config results structure": "num_nofaults specifies the number of faults for every position from the positions array (equivalent for num_nofaults, num_resets, num_crashes)"})
+        # log_json.update({"Info: positions structure": "All positions [x,y,z] from the positions array are relative to the origin"}) # TODO: maybe make positions relative to origin?
+
+        # Convert glitch_configs to dicts
+        glitch_config_dicts = [asdict(cfg) for cfg in self.glitch_configs]
+
+        # Fold the streamed extradata back in (shallow copies: the merge
+        # only creates new category stores, counters stay shared), then
+        # serialize the position-keyed stores to the documented JSON
+        # shape (list of {position_index, data} entries)
+        results = [dict(config_result) for config_result in results]
+        self._merge_stream_extradata(results)
+        for config_result in results:
+            for category in self.result_types:
+                by_position = config_result.get(category)
+                if isinstance(by_position, dict):
+                    config_result[category] = [
+                        {"position_index": position_index, "data": data}
+                        for position_index, data in sorted(by_position.items())
+                    ]
+
+        # Add results to glitch_config dicts
+        for config_index, config_result in enumerate(results):
+            glitch_config_dicts[config_index].update({"results": config_result})
+
+        # Fitted recharge model, so reproducibility audits can verify
+        # the shots were charge-gated (see CSUtils.ChargeModel)
+        charge_model = getattr(getattr(self, "cs", None), "charge_model", None)
+        if charge_model is not None:
+            log_json.update({"charge_model": charge_model.export()})
+        heating_model = getattr(getattr(self, "cs", None), "heating_model", None)
+        if heating_model is not None:
+            log_json.update({"heating_model": heating_model.export()})
+
+        if self._stream_path:
+            log_json.update({"results_stream": self._stream_path})
+            if self._stream_path.endswith(".bin"):
+                log_json.update({"Info: results_stream structure": "binary event log: CSEV header, then per record f64 timestamp, u32 position_index, u32 config_index, u8 category (in-band definition records), u32 payload_len, JSON payload, CRC32; see event_log.iter_records / `event_log convert` for jsonl"})
+        if self._blob_path:
+            log_json.update({"fault_blobs": self._blob_path})
+        if self._trace_path:
+            log_json.update({"traces": self._trace_path})
+            log_json.update({"Info: traces structure": "fixed records: u32 position_index, u32 config_index, u32 execution_index, u32 sample_count, float32[sample_count] samples (little endian), stored raw or in the CSTZ chunked compressed container (xor-delta + deflate, per-chunk index); see trace_capture.read_traces"})
+        if self._column_store is not None and self._columns_path \
+                and len(self._column_store):
+            self._column_store.save(self._columns_path)
+            log_json.update({"extradata_columns": self._columns_path})
+            log_json.update({"Info: extradata_columns structure": f"npz of equal-length typed columns: position_index/config_index/execution_index (u32) plus {[name for name, _ in self._column_store.fields]}; one row per execution that carried all fields, see extradata_columns.py"})
+        if self._dev_count.any():
+            stats = self.deviation_stats()
+            log_json.update({"counter_deviation": {
+                "count": stats["count"].tolist(),
+                "mean": stats["mean"].tolist(),
+                "std": stats["std"].tolist(),
+            }})
+            log_json.update({"Info: counter_deviation structure": "(num_configs, num_positions) Welford statistics of the faulty loop counter's distance from LOOP_TOTAL_COUNT (iterations skipped when negative, repeated when positive); count is the number of loop faults aggregated"})
+        if self._xy_map_path:
+            self._flush_counters()
+            log_json.update({"xy_map": self._xy_map_path})
+            log_json.update({"Info: xy_map structure": "uint32 array shaped (num_configs, num_positions, num_result_types); result types in result_types key order, positions index into the positions array"})
+        log_json.update({"timing": self.timing.summary()})
+        if self._shard_spec:
+            log_json.update({"shard": self._shard_spec})
+        provenance = dict(self._provenance or self._collect_provenance())
+        provenance["finished_at"] = datetime.now(timezone.utc).isoformat()
+        if self._selected_payload is not None:
+            provenance["payload"] = self._selected_payload
+        if self._runtime_config:
+            provenance["runtime_config"] = dict(self._runtime_config)
+        log_json.update({"provenance": provenance})
+        if self.replay_provenance:
+            log_json.update({"replay_of": self.replay_provenance})
+        log_json.update({"catched_errors": self.catched_errors.summary()})
+        if getattr(self, "target_serial", None) is not None:
+            log_json.update({"serial_stats": {
+                "totals": self.target_serial.stats,
+                "per_position": self.serial_stats_per_position,
+            }})
+        log_json.update({"positions": self.positions})
+        log_json.update({"position_order": self.position_order})
+        log_json.update({"position_depths": self.position_depths})
+        log_json.update({"glitch_configs": glitch_config_dicts})
+
+        # Save log_json as file. Extradata was converted to its
+        # serializable form at ingest (_stream_result / test_position),
+        # so no recursive rebuild of the whole tree is needed here - the
+        # few remaining non-JSON leaves (counter arrays, numpy scalars)
+        # are converted by the json encoder on the fly, which keeps the
+        # Ctrl+C save path near-instant
+        file_path = f"{results_path}results_{counter}{'_partial' if partial else ''}.json"
+        if self.compress_results:
+            # gzip from the stdlib rather than an extra compressor
+            # dependency; visualize.py reads .json.gz transparently
+            file_path += ".gz"
+            with gzip.open(file_path, "wt") as f:
+                json.dump(log_json, f, indent=4, default=self._default_serializer)
+        else:
+            with open(file_path, "w") as f:
+                json.dump(log_json, f, indent=4, default=self._default_serializer)
+
+        # Keep the cross-campaign SQL index in step (best effort: an
+        # index problem must never lose the results themselves)
+        try:
+            index_results(log_json, counter, results_file=file_path, partial=partial)
+        except Exception as e:
+            print(f"Results index update failed: {str(e)}")
+
+    @staticmethod
+    def _default_serializer(obj):
+        """json.dump fallback for the leaves that are cheaper to convert
+        in-place than to rebuild the tree for."""
+        if isinstance(obj, np.ndarray):
+            return obj.tolist()
+        if isinstance(obj, np.generic):
+            return obj.item()
+        if isinstance(obj, (bytes, bytearray)):
+            return bytes(obj).hex().upper()
+        print(f"ERROR: Serialization failed for: {obj}")
+        return "SERIALIZATION_FAILED"
+
+    def _connect_delay_controller(self):
+        # DelayController is written as a context manager; enter it
+        # manually so the serial open + Pico handshake happen once per
+        # campaign instead of once per config at every position
+        self.delay_controller = DelayController(port="/dev/ttyACM1")
+        self.delay_controller.__enter__()
+        self._last_pulse_parameters = None
+
+    def _disconnect_delay_controller(self):
+        if self.delay_controller is not None:
+            try:
+                self.delay_controller.__exit__(None, None, None)
+            except Exception:
+                pass
+            self.delay_controller = None
+        self._last_pulse_parameters = None
+
+    # Internal pulse-generator limits; ChipShouter.configure_pulsegen
+    # asserts the same ranges before writing them
+    INTERNAL_WIDTH_NS = range(80, 961)
+    INTERNAL_DEADTIME_MS = range(1, 1001)
+    INTERNAL_REPEAT = range(1, 10001)
+
+    def _internal_pulsegen_fits(self, glitch_config):
+        """Whether the ChipShouter's built-in generator can produce this
+        config's pulse train. The internal generator fires on the trigger
+        edge itself, so any offset needs the Pico; deadtime (millisecond
+        granularity) only matters for multi-pulse trains."""
+        if glitch_config.pulse_offset:
+            return False
+        if glitch_config.pulse_width not in self.INTERNAL_WIDTH_NS:
+            return False
+        repeat = max(1, glitch_config.pulse_repeats)
+        if repeat not in self.INTERNAL_REPEAT:
+            return False
+        if repeat > 1 and (glitch_config.pulse_spacing // 1000000
+                           not in self.INTERNAL_DEADTIME_MS):
+            return False
+        return True
+
+    def configure_chipshouter(self, glitch_config:GlitchConfig):
+        # Configure voltage (deduplicated and, while disarmed, folded
+        # into the next arm() ramp - see ChipShouter.set_voltage)
+        self.cs.set_voltage(glitch_config.voltage)
+
+        # Key the recharge model's buckets on this config's pulse shape
+        # (see CSUtils.ChargeModel)
+        self.cs.note_pulse_shape(glitch_config.pulse_width,
+                                 glitch_config.pulse_repeats)
+
+        # Precomputed by validate_glitch_configs; the fallback resolves
+        # "auto" and derives in place for standalone (non-campaign) use,
+        # so the config dict in the results still records the path that
+        # actually ran
+        keyed_parameters = getattr(glitch_config, "pulse_parameters", None)
+        if keyed_parameters is None:
+            if glitch_config.pulse_path == "auto":
+                glitch_config.pulse_path = (
+                    "internal" if self._internal_pulsegen_fits(glitch_config)
+                    else "pico")
+            keyed_parameters = glitch_config.derive().pulse_parameters
+        path, parameters = keyed_parameters
+
+        if path == "internal":
+            # ChipShouter's built-in generator: removes the Pico serial
+            # hop and its trigger-path latency for single-pulse configs
+            if keyed_parameters != self._last_pulse_parameters:
+                self.cs.configure_pulsegen(parameters["deadtime"],
+                                           parameters["repeat"],
+                                           parameters["width"])
+                self._last_pulse_parameters = keyed_parameters
+            return
+
+        # Using Pi Pico as pulse generator (persistent session)
+        if keyed_parameters != self._last_pulse_parameters:
+            if self.delay_controller is None:
+                self._connect_delay_controller()
+            try:
+                self.delay_controller.set_parameters(parameters)
+            except Exception:
+                # Pico dropped off USB: reconnect once and retry, like
+                # the ChipShouter power-cycle path
+                self._disconnect_delay_controller()
+                self._connect_delay_controller()
+                self.delay_controller.set_parameters(parameters)
+            self._last_pulse_parameters = keyed_parameters
+
+    def sweep_offsets(self, glitch_config, offset_start, offset_step, count):
+        """
+        Generator over (sweep_index, offset) for temporal profiling
+        campaigns that step pulse_offset across the target execution.
+
+        When the connected pico_pulsegen firmware provides the bulk
+        sweep-upload command (DelayController.set_sweep), the whole sweep
+        goes up in one roundtrip and the Pico steps the offset itself on
+        every trigger edge — the generator then only yields bookkeeping
+        values and never touches the serial link, so shot rate becomes
+        the limit instead of host-Pico chatter. Older firmware falls back
+        to one set_parameters roundtrip per offset.
+
+        Parameters
+        ----------
+        glitch_config : GlitchConfig
+            Supplies pulse width/spacing/repeats for the sweep.
+        offset_start, offset_step : int
+            First offset and per-trigger increment (ns).
+        count : int
+            Number of sweep steps.
+
+        Yields
+        ------
+        tuple[int, int]
+            (sweep_index, offset) per step, for per-execution logging.
+        """
+        if self.delay_controller is None:
+            self._connect_delay_controller()
+
+        base = {
+            "length": glitch_config.pulse_width,
+            "spacing": glitch_config.pulse_spacing,
+            "repeats": glitch_config.pulse_repeats,
+        }
+        autonomous = hasattr(self.delay_controller, "set_sweep")
+        if autonomous:
+            self.delay_controller.set_sweep(dict(
+                base, offset_start=offset_start,
+                offset_step=offset_step, count=count
+            ))
+            # Device state no longer matches the last static parameters
+            self._last_pulse_parameters = None
+            if self._sweep_feedback_pin is not None:
+                # Latch the line's idle level; every fired offset
+                # toggles it once from here on
+                self._sweep_feedback_level = self._read_sweep_feedback()
+                self._sweep_feedback_index = -1
+
+        for index in range(count):
+            offset = offset_start + index * offset_step
+            if not autonomous:
+                parameters = dict(base, offset=offset)
+                self.delay_controller.set_parameters(parameters)
+                self._last_pulse_parameters = ("pico", parameters)
+            yield index, offset
+
+    # scope.io.tio_states index per CW IO pin name
+    _TIO_INDEX = {"tio1": 0, "tio2": 1, "tio3": 2, "tio4": 3}
+
+    def enable_sweep_feedback(self, pin="tio3"):
+        """
+        Route the Pico's sweep-completion line to a ChipWhisperer IO
+        pin, so applied_sweep_index verifies pulse delivery with one
+        scope register read instead of a Pico serial query.
+
+        pico_pulsegen firmware with feedback support toggles a GPIO
+        once per fired offset; with that GPIO wired to the given CW IO
+        pin, the per-shot host path stays at exactly one device
+        conversation (the target's) - the scope read rides the USB
+        session that is already open. One read per shot pairs with the
+        one trigger per shot; get_sweep_index stays available for
+        auditing the count when in doubt. Note tio3 doubles as the
+        boot/result line of SS_BOOT_GPIO / SS_RESULT_GPIO firmware
+        builds - wire to a free pin for those.
+
+        Raises RuntimeError when the connected pico_pulsegen firmware
+        has no feedback-line support.
+        """
+        if pin not in self._TIO_INDEX:
+            raise ValueError(f"enable_sweep_feedback: unknown pin {pin!r} "
+                             f"(have {', '.join(self._TIO_INDEX)})")
+        if self.delay_controller is None:
+            self._connect_delay_controller()
+        if not hasattr(self.delay_controller, "set_sweep_feedback"):
+            raise RuntimeError(
+                "connected pico_pulsegen firmware has no sweep feedback "
+                "line support")
+        self.delay_controller.set_sweep_feedback(True)
+        self._sweep_feedback_pin = self._TIO_INDEX[pin]
+        self._sweep_feedback_level = self._read_sweep_feedback()
+        self._sweep_feedback_index = -1
+
+    def _read_sweep_feedback(self):
+        """Level of the completion line, or None when the scope does
+        not expose tio_states (caller falls back to serial)."""
+        try:
+            states = self.cw.scope.io.tio_states
+        except Exception:
+            return None
+        if not states:
+            return None
+        return bool(states[self._sweep_feedback_pin])
+
+    def applied_sweep_index(self):
+        """Sweep index of the last fired offset, for correlating
+        executions with offsets. Prefers the hardware completion line
+        (enable_sweep_feedback, a single register read); falls back to
+        the Pico's serial query, then None when the firmware lacks
+        sweep support and the host-stepped index is authoritative."""
+        if self._sweep_feedback_pin is not None:
+            level = self._read_sweep_feedback()
+            if level is not None:
+                if level != self._sweep_feedback_level:
+                    self._sweep_feedback_level = level
+                    self._sweep_feedback_index += 1
+                return self._sweep_feedback_index
+        if self.delay_controller is not None and hasattr(self.delay_controller, "get_sweep_index"):
+            return self.delay_controller.get_sweep_index()
+        return None
+
+    def _scope_arm_for_config(self, config_index):
+        """
+        Arm a single-shot scope capture before the first execution of a
+        config, when a measurement scope is attached (self.scope, see
+        ScopeUtils). Returns whether a capture is armed; verification is
+        best-effort and a dead scope only costs a progress event, never
+        shots.
+        """
+        if self.scope is None or config_index in self._scope_measured:
+            return False
+        try:
+            self.scope.arm_single()
+        except ScopeError as e:
+            self.progress.event(f"Scope arm failed: {e}")
+            self._scope_measured.add(config_index)
+            return False
+        return True
+
+    def _scope_record_measurement(self, config_index):
+        """Read back the capture armed by _scope_arm_for_config and fill
+        the config's osc_measured fields, replacing the README's manual
+        per-config bench measurement. Runs once per config; a failed
+        read leaves the fields at their configured values."""
+        glitch_config = self.glitch_configs[config_index]
+        self._scope_measured.add(config_index)
+        try:
+            voltage, width_ns = self.scope.read_pulse()
+        except ScopeError as e:
+            self.progress.event(f"Scope measurement failed: {e}")
+            return
+        glitch_config.osc_measured_pulse_voltage = round(voltage, 2)
+        glitch_config.osc_measured_pulse_width = round(width_ns, 2)
+        self.progress.event(
+            f"Config {config_index}: measured pulse "
+            f"{voltage:.1f}V / {width_ns:.1f}ns"
+        )
+
+    def _arm_trigger_counter(self):
+        """
+        Arm the ChipWhisperer purely for its trigger-length counter when
+        measure_trigger_width is set - a scalar per shot that catches
+        the timing anomalies of partial faults without the USB and disk
+        cost of trace capture. Trace capture arms the scope itself and
+        owns it from the collector thread, so the counter path stays off
+        while traces are being recorded (the width can be derived from
+        the trace there anyway). A failing scope disables the feature
+        for the rest of the campaign rather than costing shots.
+        """
+        if (not self.measure_trigger_width or not self._trigger_counter_ok
+                or self.trace_capture is not None):
+            return False
+        try:
+            self.cw.arm_trigger_counter()
+        except Exception as e:
+            self.progress.event(f"Trigger-width counter unavailable: {e}")
+            self._trigger_counter_ok = False
+            return False
+        return True
+
+    def _attach_trigger_width(self, result_category, extradata):
+        """
+        Read back the counter armed by _arm_trigger_counter and fold the
+        width into the execution's extradata. Only response-bearing
+        outcomes get a width: on a crash the trigger never cleared, so
+        the counter still holds the previous execution. Handlers that
+        return non-dict extradata keep their payload shape untouched.
+        """
+        if result_category not in ("faults", "nofaults"):
+            return extradata
+        try:
+            width_ns = self.cw.read_trigger_width_ns()
+        except Exception as e:
+            self.progress.event(f"Trigger-width read failed: {e}")
+            self._trigger_counter_ok = False
+            return extradata
+        if extradata is None:
+            extradata = {}
+        elif isinstance(extradata, dict):
+            extradata = dict(extradata)
+        else:
+            return extradata
+        extradata["trigger_width_ns"] = round(width_ns, 1)
+        return extradata
+
+    def _wait_boot_gpio(self, timeout):
+        """
+        Wait for the firmware's boot-ready line (PA11 / CW308 IO3, raised
+        by SS_BOOT_GPIO builds at announce time) via the scope IO state.
+
+        Requires a low-to-high transition so a floating pin that happens
+        to read high cannot fake a boot. Returns False on timeout or when
+        the scope does not expose tio_states, letting the caller fall
+        back to the serial scan.
+        """
+        deadline = Deadline(timeout)
+        saw_low = False
+        while not deadline.expired():
+            try:
+                states = self.cw.scope.io.tio_states
+            except Exception:
+                return False
+            level = states[2] if states else None
+            if not level:
+                saw_low = True
+            elif saw_low:
+                return True
+            time.sleep(0.001)
+        return False
+
+    def _read_result_gpio(self, timeout_ms):
+        """
+        Fast-path response wait for SS_RESULT_GPIO firmware builds: the
+        target reports the nofault common case by raising the result
+        line (PA11 / CW308 IO3, lowered again when it accepts the next
+        start), so >95% of executions finish without any response
+        bytes on the wire. Serial is only read when data actually
+        arrives - the 'f' fault packet - and handled normally.
+
+        Returns (result_category, extradata), or None on timeout so
+        the caller runs its crash handling.
+        """
+        deadline = Deadline(timeout_ms)
+        while not deadline.expired():
+            try:
+                states = self.cw.scope.io.tio_states
+            except Exception:
+                states = None
+            if states and states[2]:
+                return "nofaults", None
+            if self.target_serial.in_waiting():
+                cmd, raw_data = self.target_serial.read_packet(
+                    timeout=max(deadline.remaining_ms(), 1)
+                )
+                return self.handlePacket(cmd, raw_data)
+            time.sleep(0.0005)
+        return None
+
+    # Continuous trigger-high time after which the scope-side probe in
+    # _read_response_or_crash declares a crash. The profiling payloads
+    # hold the trigger only for the glitch window (microseconds), so 5ms
+    # of stuck-high is unambiguous; raise this attribute for custom
+    # payloads with longer trigger windows.
+    SCOPE_CRASH_TRIGGER_HIGH_MS = 5.0
+
+    def _read_response_or_crash(self, timeout_ms):
+        """
+        Serial response wait with a scope-side crash fast path.
+
+        A target that crashed mid-payload leaves the trigger line (TIO4,
+        tio_states[3]) stuck high, and waiting out the full dead_timeout
+        to discover that costs 400ms+ per crash in crash-dense regions.
+        While the response packet is pending, the trigger state is
+        polled alongside the serial buffer; once the line has stayed
+        high for SCOPE_CRASH_TRIGGER_HIGH_MS the wait is cut short. The
+        serial timeout stays as backstop for crash modes that drop the
+        line (hard-fault handlers, watchdog resets), and scopes without
+        tio_states fall back to the plain blocking read.
+
+        On SS_BOOT_GPIO builds (gpio_reset_detect) the boot line
+        (tio_states[2]) is watched too: a brownout reset pulls it low
+        and the rebooting firmware raises it again at announce time, so
+        a low-to-high transition classifies the reset in hardware. That
+        matters most when the brownout garbles the serial announce -
+        without it those shots exhaust dead_timeout and then pay
+        crashHandler's redundant reset cycle on an already-rebooted
+        target.
+
+        Returns (cmd, raw_data), the string "reset" for a
+        hardware-classified reset, or None on crash/timeout so the
+        caller runs its crash handling.
+        """
+        deadline = Deadline(timeout_ms)
+        try:
+            self.cw.scope.io.tio_states
+        except Exception:
+            # No IO state (mock scope, driver hiccup): plain serial wait
+            try:
+                return self.target_serial.read_packet(timeout=timeout_ms)
+            except Exception:
+                return None
+
+        high_since = None
+        boot_seen_low = False
+        while not deadline.expired():
+            if self.target_serial.in_waiting():
+                try:
+                    return self.target_serial.read_packet(
+                        timeout=max(deadline.remaining_ms(), 1)
+                    )
+                except Exception:
+                    return None
+            try:
+                states = self.cw.scope.io.tio_states
+            except Exception:
+                states = None
+            if states and states[3]:
+                now = time.monotonic()
+                if high_since is None:
+                    high_since = now
+                elif (now - high_since) * 1000.0 >= self.SCOPE_CRASH_TRIGGER_HIGH_MS:
+                    return None  # stuck-high trigger: crashed mid-payload
+            else:
+                high_since = None
+            if self.gpio_reset_detect and states:
+                if not states[2]:
+                    boot_seen_low = True
+                elif boot_seen_low:
+                    return "reset"  # boot line re-raised: brownout reset
+            time.sleep(0.0005)
+        return None
+
+    def reset_target(self, timeout=5000, retries=3):
+        reset_seq = self.target_serial._reset_sequence
+        for _ in range(retries):
+            self.cw.reset_target()
+
+            serial_timeout = timeout
+            if self.gpio_reset_detect and self._wait_boot_gpio(min(timeout, 1000)):
+                # Boot confirmed in hardware: the announce is already on
+                # the wire, so the serial consume below is just a quick
+                # sync instead of a long scan through UART garbage
+                serial_timeout = 100
+
+            if self.target_serial.read_until(reset_seq, serial_timeout).endswith(reset_seq):
+                if self.expect_boot_report:
+                    self._read_boot_report()
+                if self.merged_ack_mode:
+                    # The rebooted firmware is back to acked starts;
+                    # re-apply the mode before the next shot
+                    self._send_merged_ack_mode(True)
+                return 0
+
+        raise TargetResetTimeout(f"Failed to reset target after {retries} tries!")
+
+    def _read_boot_report(self):
+        """
+        Consume the 't' boot-time packet a fast-boot firmware build
+        (SS_FAST_BOOT=1) appends to its reset sequence.
+
+        Stores the reported reset-to-ready time (in CPU cycles) in
+        `self.last_boot_cycles`. Must run directly after the reset sequence,
+        otherwise the packet would be misread as the next payload response.
+        """
+        try:
+            cmd, data = self.target_serial.read_packet(timeout=250)
+        except Exception:
+            return  # firmware without boot report, nothing to consume
+
+        if cmd == TargetSerial.type_convert_cmd("t") and data and len(data) == 4:
+            self.last_boot_cycles = int.from_bytes(data, "little")
+
+    def power_cycle_target(self):
+        self.cw.power_cycle_usb() # Power cycle chipwhisperer USB port
+
+    def start_metrics_server(self, host="0.0.0.0", port=9100):
+        """
+        Start the opt-in Prometheus metrics endpoint (see metrics.py).
+
+        Call before run_campaign(); the server reads the campaign's
+        existing counters at scrape time, so it adds no per-shot cost.
+        Returns the MetricsServer (stop() to shut it down).
+        """
+        self._metrics_server = MetricsServer(self, host=host, port=port)
+        self._metrics_server.start()
+        return self._metrics_server
+
+    def enable_error_governor(self, window_s=600.0, default_budget=10,
+                              budgets=None, pause_s=30.0):
+        """
+        Enable the campaign-level error budget governor (error_budget.py):
+        per-error-type failure rates over a sliding window, escalating
+        from a backoff pause through skip-and-continue to a checkpointed
+        abort when budgets are exceeded. Local retries handle the
+        incident; the governor notices the pattern. Returns the governor.
+        """
+        self.error_governor = ErrorBudgetGovernor(
+            window_s=window_s, default_budget=default_budget,
+            budgets=budgets, pause_s=pause_s,
+        )
+        return self.error_governor
+
+    def register_error_handler(self, exception_type, handler):
+        """
+        Register a recovery handler for an exception type.
+
+        Parameters
+        ----------
+        exception_type : type
+            Exception class the handler covers; subclasses are covered
+            too unless they have a more specific registration.
+        handler : callable
+            Called as handler(error), returns the set of device names
+            ("chipshouter", "target") to power cycle, or an empty set
+            for a plain flush/reset retry without power cycling.
+
+        Campaigns can override the defaults or add handlers for their
+        own exception types before run_campaign().
+        """
+        self._error_handlers[exception_type] = handler
+
+    def _dispatch_error_handler(self, error):
+        """
+        Look up the registered handler for an error by walking the
+        exception's MRO (most specific class first), so dispatch cost is
+        bounded by the class hierarchy depth rather than the number of
+        registered handlers. Returns the handler's suspect-device set,
+        or None when no handler is registered (unknown error).
+        """
+        for cls in type(error).__mro__:
+            handler = self._error_handlers.get(cls)
+            if handler is not None:
+                return set(handler(error))
+        return None
+
+    def recover_devices(self, chipshouter=False, target=False):
+        """
+        Power cycle the implicated devices, concurrently when several
+        are suspect.
+
+        The ChipShouter recovery (uhubctl cycle, retry waits, full
+        re-init) and the ChipWhisperer target power cycle sit on
+        different hub ports, so running them in parallel makes a double
+        failure cost the slower of the two recoveries instead of their
+        sum. Failures are collected and re-raised after both finish.
+        """
+        jobs = []
+        if chipshouter:
+            jobs.append(("chipshouter", self.cs.power_cycle_usb))
+        if target:
+            jobs.append(("target", self.power_cycle_target))
+
+        if len(jobs) == 1:
+            jobs[0][1]()
+            return
+
+        errors = {}
+        def run(name, recovery):
+            try:
+                recovery()
+            except Exception as e:
+                errors[name] = e
+
+        threads = [
+            threading.Thread(target=run, args=job, name=f"recover-{job[0]}", daemon=True)
+            for job in jobs
+        ]
+        for thread in threads:
+            thread.start()
+        for thread in threads:
+            thread.join()
+
+        if errors:
+            raise DeviceRecoveryError(f"Device recovery failed: {errors}")
+
+    def handlePacket(self, cmd, data=None) -> tuple[str, dict]:
+        # Look up the packet object in the precompiled dispatch table
+        # (callability and signature were validated at registration)
+        matched_packet = self._packet_dispatch.get(cmd)
+        if matched_packet is None:
+            raise ValueError(f"No matching packet definition found for command: `{cmd}`")
+
+        # Calls handler function of packet if it is defined
+        if matched_packet.handler is not None:
+            result = matched_packet.handler(self, matched_packet, data)
+            if isinstance(result, tuple) and len(result) == 2:
+                result_category, extradata = result
+            elif isinstance(result, str):
+                result_category, extradata = result, None
+            else:
+                raise ValueError(f"Handler of SimpleSerialPacket {matched_packet.command} must return either a string or a (string, extradata) tuple!")
+
+            # Verify that returned result_category is valid
+            if result_category not in self.result_types:
+                raise ValueError(f"PacketHandler of command: `{matched_packet.command}` returned invalid result_category: `{result_category}`")
+
+            # Verify that returned extradata is of type dict
+            if extradata is not None and not isinstance(extradata, (dict, str, int, list)):
+                raise ValueError(f"PacketHandler of command: `{matched_packet.command}` returned invalid extradata type (has to be dict, str, int, list)")
+
+        return result_category, extradata
+
+    def resetPacketHandler(_, profilerSelf, packetSelf, data=None) -> tuple[str, dict]:
+        return "resets"
+
+    # 'f' payload of the loop payloads: counter value plus DWT->CYCCNT
+    # snapshots at trigger raise and at fault detection (profile_loop.c).
+    # Legacy 4-byte packets carry only the counter.
+    LOOP_FAULT_FIELDS = [
+        ("counter", ctypes.c_uint32),
+        ("trigger_cycles", ctypes.c_uint32),
+        ("detect_cycles", ctypes.c_uint32),
+    ]
+
+    # Ready-made register_extradata_columns field list for the loop
+    # payloads: the parsed 'f' packet fields plus the derived offset
+    LOOP_COLUMN_FIELDS = [
+        ("counter", "<u4"),
+        ("trigger_cycles", "<u4"),
+        ("detect_cycles", "<u4"),
+        ("fault_offset_cycles", "<u4"),
+    ]
+
+    # 'e' payload of the loop payloads: loop duration in DWT cycles
+    # (trigger raise to trigger clear). Empty on legacy firmware.
+    LOOP_END_FIELDS = [
+        ("loop_cycles", ctypes.c_uint32),
+    ]
+
+    @staticmethod
+    def _parse_pulse_slots(tail):
+        """
+        Parse the [slot_count (u8), slot_cycles (u32 LE) x stored]
+        appendix SS_PULSE_TAG firmware adds to loop responses: DWT
+        offsets of each delivered pulse relative to trigger raise.
+
+        Returns the pulse_slot_count / pulse_slots_cycles dict, or None
+        when the bytes do not form a plausible appendix - the count
+        must cover the stored timestamps (it only exceeds them when a
+        train outran the firmware's slot array) and the offsets must be
+        nondecreasing, which keeps payloads of coincidental length from
+        being misread as slot data.
+        """
+        stored = (len(tail) - 1) // 4
+        count = tail[0]
+        if count < stored or (count > stored and stored == 0):
+            return None
+        slots = [
+            int.from_bytes(tail[1 + 4 * i:5 + 4 * i], "little")
+            for i in range(stored)
+        ]
+        if any(a > b for a, b in zip(slots, slots[1:])):
+            return None
+        return {"pulse_slot_count": count, "pulse_slots_cycles": slots}
+
+    def nofaultPacketHandler(_, profilerSelf, packetSelf, data=None) -> tuple[str, dict]:
+        if data and len(data) == 4:
+            return "nofaults", TargetSerial.parse_packet_data_struct(
+                data, profilerSelf.LOOP_END_FIELDS
+            )
+        if data and len(data) >= 5 and (len(data) - 5) % 4 == 0:
+            # SS_PULSE_TAG build: loop_cycles plus per-pulse snapshots
+            slots = profilerSelf._parse_pulse_slots(data[4:])
+            if slots is not None:
+                parsed = TargetSerial.parse_packet_data_struct(
+                    data[:4], profilerSelf.LOOP_END_FIELDS
+                )
+                parsed.update(slots)
+                return "nofaults", parsed
+        return "nofaults"
+
+    def faultPacketHandler(_, profilerSelf, packetSelf, data=None) -> tuple[str, dict]:
+        profilerSelf.reset_target() # TODO when resetting fails, will faults or bricked be written??
+        # When resetting fails, error will be thrown here...
+        # Exact size keeps memcpy 'f' packets (the corrupted target
+        # buffer, buffer_len bytes) from being misread as timestamps
+        if data and len(data) == 12:
+            parsed = TargetSerial.parse_packet_data_struct(
+                data, profilerSelf.LOOP_FAULT_FIELDS
+            )
+            # Where within the loop window the disturbance landed, in
+            # core cycles (u32 subtraction is wraparound-safe)
+            parsed["fault_offset_cycles"] = (
+                parsed["detect_cycles"] - parsed["trigger_cycles"]
+            ) & 0xFFFFFFFF
+            return "faults", parsed
+        if data and len(data) >= 13 and (len(data) - 13) % 4 == 0:
+            # SS_PULSE_TAG build: the three loop timestamps plus the
+            # per-pulse snapshots (odd length, so the even-length AES
+            # and UOV payloads below can never land here)
+            slots = profilerSelf._parse_pulse_slots(data[12:])
+            if slots is not None:
+                parsed = TargetSerial.parse_packet_data_struct(
+                    data[:12], profilerSelf.LOOP_FAULT_FIELDS
+                )
+                parsed["fault_offset_cycles"] = (
+                    parsed["detect_cycles"] - parsed["trigger_cycles"]
+                ) & 0xFFFFFFFF
+                parsed.update(slots)
+                return "faults", parsed
+        if data and len(data) == 16:
+            # AES payload (profile_aes.c): the faulty ciphertext block,
+            # the per-shot input DFA key recovery works from
+            return "faults", {"ciphertext": data}
+        if data and len(data) == 28:
+            # UOV payload (profile_uov.c): the m-byte faulty result
+            # vector of the public-map evaluation
+            return "faults", {"result_vector": data}
+        return "faults"
+
+    def deltaFaultPacketHandler(_, profilerSelf, packetSelf, data=None) -> tuple[str, dict]:
+        """
+        Handler for delta-encoded memcpy fault packets ('d').
+
+        The firmware sends (offset, value) pairs for only the corrupted
+        bytes (enabled via the `fault_delta` config parameter). The full
+        target buffer is reconstructed from the expected source pattern so
+        the stored extradata is interchangeable with full 'f' packets.
+        """
+        profilerSelf.reset_target()
+
+        data = data or b""
+        delta = {data[i]: data[i + 1] for i in range(0, len(data) - 1, 2)}
+
+        buffer = bytearray(
+            [profilerSelf.memcpy_src_init_byte] * profilerSelf.memcpy_buffer_len
+        )
+        for offset, value in delta.items():
+            if offset < len(buffer):
+                buffer[offset] = value
+
+        return "faults", {"delta": data, "target_buffer": bytes(buffer)}
+
+    def crashHandler(self) -> tuple[str, dict]:
+        """
+        Handler for when target crashed (is unresponsive).
+
+        Returns:
+            tuple[str, dict]: result_category, extradata
+        """
+        self.reset_target()
+
+        return "crashes", None
+
+    def _adaptive_timeout(self, kind, config_index, configured_ms):
+        """Tracker for one wait kind ("ack"/"dead") of one glitch config,
+        created on first use. Re-created if the configured value changed
+        (e.g. after fit_time_budget edits)."""
+        key = (kind, config_index)
+        tracker = self._adaptive_timeouts.get(key)
+        if tracker is None or tracker.configured_ms != configured_ms:
+            tracker = AdaptiveTimeout(configured_ms)
+            self._adaptive_timeouts[key] = tracker
+        return tracker
+
+    def test_execution(self, position_index: int, config_index: int, execution_index: int) -> tuple[int, str, dict | None]:
+        """
+        Execute a single fault injection. Called by test_position.
+
+        This function can be overwritten with overwrite_test_exeuction(newFunction) which allows
+        for completely custom control flow for the fault injection.
+        By default it does the following steps:
+            - Arm ChipShouter
+            - Check ChipShouter temperature (wait till cooled off if necessary)
+            - Validate if ChipShouter is ready for trigger (trigger_safe)
+            - Send start packet to target
+            - Wait for target to acknowledge the start packet
+            - Wait for target response packet
+                - If received: call self.handlePacket(cmd, raw_data) to handle the command and parse data from it
+                - If not received in time: call self.crashHandler()
+            - Return incremented execution_index, result_category, extradata (optional)
+
+        If self._test_execution is defined (by self.overwrite_test_execution()), call that function instead.
+
+        Args:
+            position_index (int):
+            config_index (int):
+            execution_index (int):
+
+        Raises:
+            e: Unknown error from chipshouter arming
+            RuntimeError: ChipShouter is not ready for trigger (trigger_safe failed)
+
+        Returns:
+            tuple[int, str, dict | none (optional)]: (next_execution_index, result_category, extradata)
+            tuple[int, str]: (next_execution_index, result_category)
+        """
+
+        # ------------------------------ If overwritten ------------------------------ #
+
+        if hasattr(self, "_test_execution") and self._test_execution:
+            # test_execution function was overwritten call self._test_execution() instead.
+            ret = self._test_execution(self, position_index, config_index, execution_index)
+
+            # Verify the return type - on the first call only; paying
+            # this introspection per shot costs real loop time at speed
+            if self._test_execution_validated:
+                return ret
+            if (isinstance(ret, tuple)):
+                if len(ret) == 2:
+                    next_execution_index, result_category = ret
+                    data = None
+                elif len(ret) == 3:
+                    next_execution_index, result_category, data  = ret
+                else:
+                    raise TypeError(f"test_execution must return a tuple (int, str, dict) or (int, str), got {type(ret)}")
+            else:
+                raise TypeError(f"test_execution must return a tuple (int, str, dict) or (int, str), got {type(ret)}")
+
+            if not isinstance(next_execution_index, int):
+                raise TypeError(f"First element (next_execution_index) must be int, got {type(next_execution_index)}")
+            if not isinstance(result_category, str):
+                raise TypeError(f"Second element (result_category) must be str, got {type(result_category)}")
+            if not (isinstance(data, dict) or data is None):
+                raise TypeError(f"Third element (extradata) must be dict or None, got {type(data)}")
+
+            self._test_execution_validated = True
+            return ret
+
+        glitch_config = self.glitch_configs[config_index]
+        next_execution_index = execution_index + 1
+
+        # -------------------------- Default Implementation -------------------------- #
+
+        # Gate on actual capacitor recharge instead of a fixed 50ms sleep;
+        # the >=5ms poll spacing also keeps the ChipShouter serial link calm
+        with self.timing.phase("charge_wait"):
+            self.cs.wait_charge_ready()
+
+        # Keep ChipShouter armed (cached check, periodic re-assert).
+        # If it has faults, try to clear them.
+        with self.timing.phase("arm"):
+            try:
+                self.cs.ensure_armed()
+            except Exception as e:
+                # TODO: remove this separate handler and throw the fault into the main execution error handler
+                self.catched_errors.append(
+                    {"position_index": position_index, "error": str(e),
+                     "type": type(e).__name__})
+                if str(e) == "ChipShouter has faults!":
+                    # Non-blocking: the coil cools in the background
+                    # while the campaign keeps skipping cheaply
+                    self.cs.clear_faults_async()
+                    return next_execution_index, "skipped", None
+                else:
+                    print(e)
+                    raise e
+
+            # Check ChipShouter temps (cached flag from the thermal monitor)
+            while not self.cs.thermal_ready():
+                self.progress.event("Chipshouter Temp too high, waiting...")
+                time.sleep(1)
+
+            # Validate that ChipShouter is ready for trigger (status mirror:
+            # only hits serial when the cached value went stale)
+            if not self.cs.trigger_safe():
+                raise ShouterFaultError("ChipShouter is not ready for trigger (trigger_safe failed)!")
+
+        # TODO: check CS measured voltage (prevents too fast shooting where CS cant charge quick enough)
+        # print(f"Voltage_measured: {self.cs.voltage.measured}")
+        
+        # Adaptive timeouts: learned from this campaign's response
+        # times, clamped to the configured ack/dead values
+        ack_tracker = self._adaptive_timeout("ack", config_index, glitch_config.ack_timeout)
+        dead_tracker = self._adaptive_timeout("dead", config_index, glitch_config.dead_timeout)
+
+        # Send start signal to target and wait for the acknowledge
+        # (skipped in merged-ack mode, where the response packet itself
+        # acknowledges the start - see enable_merged_ack)
+        with self.timing.phase("send_ack"):
+            self.send_packet("s")
+            waited = time.monotonic()
+            ack_missing = (not self.merged_ack_mode
+                           and self.target_serial.wait_ack("s", ack_tracker.timeout_ms()) != 0)
+
+        if ack_missing:
+            # ack not received -> target bricked
+            result_category, extradata = self.crashHandler()
+        else:
+            if not self.merged_ack_mode:
+                ack_tracker.record((time.monotonic() - waited) * 1000.0)
+
+            # Read next packet from target (covers the payload execution
+            # on the target plus the response transfer). In GPIO result
+            # mode the nofault case is read off the IO line instead.
+            # Merged mode widens the timeout by the ack budget, since
+            # the wait now also covers the pre-payload span.
+            response_timeout = dead_tracker.timeout_ms()
+            if self.merged_ack_mode:
+                response_timeout += ack_tracker.timeout_ms()
+            with self.timing.phase("response_read"):
+                waited = time.monotonic()
+                if self.gpio_result_mode:
+                    gpio_result = self._read_result_gpio(response_timeout)
+                    response_ok = gpio_result is not None
+                else:
+                    # Scope-assisted: a stuck-high trigger classifies the
+                    # crash in ~5ms instead of the full dead_timeout, a
+                    # boot-line transition a brownout reset
+                    response = self._read_response_or_crash(response_timeout)
+                    response_ok = response is not None
+                    if response_ok and response != "reset":
+                        cmd, raw_data = response
+            if not response_ok:
+                if self.merged_ack_mode:
+                    # No separate ack to localize the crash: partial
+                    # response bytes mean the start was accepted and the
+                    # target died mid-payload or mid-transfer
+                    started = self.target_serial.in_waiting() > 0
+                    result_category, extradata = self.crashHandler()
+                    extradata = {"started": started}
+                else:
+                    result_category, extradata = self.crashHandler()
+            else:
+                dead_tracker.record((time.monotonic() - waited) * 1000.0)
+                if self.gpio_result_mode:
+                    result_category, extradata = gpio_result
+                elif response == "reset":
+                    # Hardware-classified reset: book it like the 'r'
+                    # packet would, skipping crashHandler's redundant
+                    # reset cycle; a short serial consume syncs past the
+                    # (possibly garbled) announce still on the wire
+                    self.target_serial.read_until(
+                        self.target_serial._reset_sequence, 200
+                    )
+                    result_category, extradata = "resets", None
+                else:
+                    # Handle packet (according to simpleserial_config)
+                    with self.timing.phase("handler"):
+                        result_category, extradata = self.handlePacket(cmd, raw_data)
+
+        return next_execution_index, result_category, extradata
+
+    async def test_execution_async(self, position_index: int, config_index: int, execution_index: int) -> tuple[int, str, dict | None]:
+        """
+        Async variant of test_execution: same legs, same results, but
+        blocking device calls run on worker threads (asyncio.to_thread)
+        and legs on independent devices overlap. Concretely: while the
+        host waits on the target's response packet - the target is busy
+        executing the payload and being glitched - the ChipShouter
+        status mirror for the next shot is refreshed concurrently, so
+        the following trigger_safe check never hits serial. The
+        ChipShouter readiness chain itself (charge, arm, thermal,
+        trigger_safe) stays sequential: it is one serial link.
+
+        The overwrite hook (_test_execution) belongs to the sync entry
+        point and is not consulted here. Use enable_async_pipeline() to
+        route the normal campaign flow through this coroutine.
+        """
+        glitch_config = self.glitch_configs[config_index]
+        next_execution_index = execution_index + 1
+
+        with self.timing.phase("charge_wait"):
+            await asyncio.to_thread(self.cs.wait_charge_ready)
+
+        with self.timing.phase("arm"):
+            try:
+                await asyncio.to_thread(self.cs.ensure_armed)
+            except Exception as e:
+                self.catched_errors.append(
+                    {"position_index": position_index, "error": str(e),
+                     "type": type(e).__name__})
+                if str(e) == "ChipShouter has faults!":
+                    self.cs.clear_faults_async()  # returns immediately
+                    return next_execution_index, "skipped", None
+                else:
+                    print(e)
+                    raise e
+
+            while not self.cs.thermal_ready():
+                self.progress.event("Chipshouter Temp too high, waiting...")
+                await asyncio.sleep(1)
+
+            if not await asyncio.to_thread(self.cs.trigger_safe):
+                raise ShouterFaultError("ChipShouter is not ready for trigger (trigger_safe failed)!")
+
+        ack_tracker = self._adaptive_timeout("ack", config_index, glitch_config.ack_timeout)
+        dead_tracker = self._adaptive_timeout("dead", config_index, glitch_config.dead_timeout)
+
+        with self.timing.phase("send_ack"):
+            await asyncio.to_thread(self.send_packet, "s")
+            waited = time.monotonic()
+            if self.merged_ack_mode:
+                ack_missing = False  # the response doubles as the ack
+            else:
+                ack_missing = await asyncio.to_thread(
+                    self.target_serial.wait_ack, "s", ack_tracker.timeout_ms()
+                ) != 0
+
+        if ack_missing:
+            result_category, extradata = await asyncio.to_thread(self.crashHandler)
+        else:
+            if not self.merged_ack_mode:
+                ack_tracker.record((time.monotonic() - waited) * 1000.0)
+
+            response_timeout = dead_tracker.timeout_ms()
+            if self.merged_ack_mode:
+                response_timeout += ack_tracker.timeout_ms()
+
+            # The overlap: target-side execution + response transfer on
+            # one task, ChipShouter status refresh for the next shot on
+            # the other
+            refresh = asyncio.create_task(asyncio.to_thread(self.cs.refresh_status))
+            with self.timing.phase("response_read"):
+                waited = time.monotonic()
+                # Same scope-assisted crash/reset fast paths as the
+                # sync leg
+                response = await asyncio.to_thread(
+                    self._read_response_or_crash, response_timeout
+                )
+                response_ok = response is not None
+                if response_ok and response != "reset":
+                    cmd, raw_data = response
+            if not response_ok:
+                started = (self.merged_ack_mode
+                           and self.target_serial.in_waiting() > 0)
+                result_category, extradata = await asyncio.to_thread(self.crashHandler)
+                if self.merged_ack_mode:
+                    extradata = {"started": started}
+            elif response == "reset":
+                dead_tracker.record((time.monotonic() - waited) * 1000.0)
+                await asyncio.to_thread(
+                    self.target_serial.read_until,
+                    self.target_serial._reset_sequence, 200,
+                )
+                result_category, extradata = "resets", None
+            else:
+                dead_tracker.record((time.monotonic() - waited) * 1000.0)
+                with self.timing.phase("handler"):
+                    result_category, extradata = self.handlePacket(cmd, raw_data)
+            await refresh
+
+        return next_execution_index, result_category, extradata
+
+    def _ensure_async_loop(self):
+        """Lazily start the persistent event loop thread for the async
+        pipeline, so the sync wrapper pays a cross-thread handoff per
+        shot instead of a loop start."""
+        if self._async_loop is None:
+            self._async_loop = asyncio.new_event_loop()
+            threading.Thread(
+                target=self._async_loop.run_forever,
+                name="async-pipeline", daemon=True,
+            ).start()
+        return self._async_loop
+
+    def test_execution_pipelined(self, position_index: int, config_index: int, execution_index: int) -> tuple[int, str, dict | None]:
+        """Sync facade over test_execution_async (same signature and
+        return as test_execution), run on the persistent pipeline loop."""
+        future = asyncio.run_coroutine_threadsafe(
+            self.test_execution_async(position_index, config_index, execution_index),
+            self._ensure_async_loop(),
+        )
+        return future.result()
+
+    def enable_async_pipeline(self):
+        """Route the campaign's executions through the async pipeline
+        via the existing overwrite hook; all calling code is unchanged."""
+        self.overwrite_test_execution(
+            lambda profiler, position_index, config_index, execution_index:
+                profiler.test_execution_pipelined(position_index, config_index, execution_index)
+        )
+
+    # Payload parameter IDs understood by the firmware 'c' config packet
+    # (see apply_config() in the respective profile_*.c payload)
+    TARGET_PARAM_IDS = {
+        "outer_count": 0x01,       # profile_loop.c
+        "inner_count": 0x02,       # profile_loop.c
+        "num_executions": 0x03,    # profile_unrolled_loop.c (10/100/1000/10000)
+        "pre_trigger_delay": 0x04, # profile_loop.c (DWT cycles, trigger raise to loop entry)
+        "art_config": 0x05,        # loop payloads (bit0 prefetch, bit1 icache, bit2 dcache)
+        "uov_seed": 0x06,          # profile_uov.c (re-expands key material on-device)
+        "buffer_len": 0x10,        # profile_memcpy.c (clamped to BUFFER_SIZE)
+        "src_init_byte": 0x11,     # profile_memcpy.c
+        "target_init_byte": 0x12,  # profile_memcpy.c
+        "fault_delta": 0x13,       # profile_memcpy.c (0/1, 'd' delta fault packets)
+    }
+
+    # Payload ids understood by the unified firmware image ('p' packet)
+    TARGET_PAYLOAD_IDS = {
+        "loop": 0,
+        "unrolled_loop": 1,
+        "memcpy": 2,
+    }
+
+    def _send_merged_ack_mode(self, enable, timeout=500):
+        """Send the 'a' control packet toggling merged-ack mode on the
+        target and wait for its confirmation ack."""
+        self.send_packet("a", bytes([1 if enable else 0]))
+        if self.target_serial.wait_ack("a", timeout) != 0:
+            raise RuntimeError("enable_merged_ack: target did not ack mode switch")
+
+    def enable_merged_ack(self, enable=True, timeout=500):
+        """
+        Toggle merged-ack mode on target and host.
+
+        Normally every execution spends a serial roundtrip on the start
+        ack, purely to distinguish "crashed before start" from "crashed
+        during payload" - both of which end in the same reset. In merged
+        mode the target runs the payload immediately on a validated 's'
+        and the response packet itself acknowledges the start; the host
+        skips wait_ack and widens the response timeout by the ack budget.
+        On a crash the extradata records whether partial response bytes
+        arrived, which is the remaining localization signal.
+
+        The firmware reverts to acked starts on every reset;
+        reset_target() re-applies the mode automatically, so crashes
+        mid-campaign do not silently reintroduce the roundtrip.
+
+        Parameters
+        ----------
+        enable : bool, optional
+            True to merge the ack into the response. Defaults to True.
+        timeout : int, optional
+            Timeout in ms for the mode-switch ack. Defaults to 500.
+
+        Raises
+        ------
+        RuntimeError
+            If the target does not acknowledge the mode switch.
+        """
+        self._send_merged_ack_mode(enable, timeout)
+        self.merged_ack_mode = bool(enable)
+
+    def select_payload(self, payload, timeout=500) -> int:
+        """
+        Select the active payload on the unified firmware image.
+
+        Sends a 'p' packet; the target echoes the payload id that is active
+        afterwards. Requires the `unified` firmware build (profile_unified.c);
+        single-payload images do not answer 'p' packets.
+
+        Parameters
+        ----------
+        payload : str or int
+            Payload name (see TARGET_PAYLOAD_IDS) or raw payload id.
+        timeout : int, optional
+            Timeout in ms for the echo response. Defaults to 500.
+
+        Raises
+        ------
+        KeyError
+            If the payload name is unknown.
+        ValueError
+            If the target echoed a different payload id (invalid selection).
+
+        Returns
+        -------
+        int
+            The payload id now active on the target.
+        """
+        payload_id = payload if isinstance(payload, int) else self.TARGET_PAYLOAD_IDS[payload]
+
+        self.send_packet("p", bytes([payload_id]))
+        cmd, data = self.target_serial.read_packet(timeout=timeout)
+
+        if cmd != TargetSerial.type_convert_cmd("p") or not data or len(data) != 1:
+            raise ValueError(f"select_payload: unexpected response cmd `{cmd}`")
+
+        if data[0] != payload_id:
+            raise ValueError(
+                f"select_payload: target kept payload {data[0]} (requested {payload_id})"
+            )
+
+        # Recorded in the campaign provenance block
+        names = {v: k for k, v in self.TARGET_PAYLOAD_IDS.items()}
+        self._selected_payload = names.get(payload_id, payload_id)
+
+        return data[0]
+
+    def configure_target(self, params: dict, timeout=500) -> dict:
+        """
+        Configure payload parameters at runtime via a 'c' config packet.
+
+        Replaces the rebuild+reflash cycle for parameter sweeps: the firmware
+        applies the values (bounds-checked) and echoes the applied (id, value)
+        pairs back, which are verified against the request.
+
+        Parameters
+        ----------
+        params : dict
+            Mapping of parameter name (see TARGET_PARAM_IDS) or raw int id
+            to integer value.
+        timeout : int, optional
+            Timeout in ms for the echo response. Defaults to 500.
+
+        Raises
+        ------
+        KeyError
+            If a parameter name is unknown.
+        ValueError
+            If the target rejected a parameter or echoed a different value
+            (e.g. out-of-range values that were clamped).
+
+        Returns
+        -------
+        dict
+            Mapping of parameter id to the value the target actually applied.
+        """
+        payload = bytearray()
+        requested = {}
+        for name, value in params.items():
+            param_id = name if isinstance(name, int) else self.TARGET_PARAM_IDS[name]
+            payload.append(param_id)
+            payload.extend(int(value).to_bytes(4, "little"))
+            requested[param_id] = int(value)
+
+        self.send_packet("c", bytes(payload))
+        cmd, data = self.target_serial.read_packet(timeout=timeout)
+
+        if cmd != TargetSerial.type_convert_cmd("c"):
+            raise ValueError(f"configure_target: unexpected response cmd `{cmd}`")
+
+        # Parse echoed (id, value) pairs
+        applied = {}
+        data = data or b""
+        for i in range(0, len(data) - 4, 5):
+            applied[data[i]] = int.from_bytes(data[i + 1:i + 5], "little")
+
+        # Verify everything was applied as requested
+        for param_id, value in requested.items():
+            if applied.get(param_id) != value:
+                raise ValueError(
+                    f"configure_target: parameter 0x{param_id:02X} not applied "
+                    f"(requested {value}, target echoed {applied.get(param_id)})"
+                )
+
+        # Track the memcpy buffer parameters for delta fault reconstruction
+        if self.TARGET_PARAM_IDS["buffer_len"] in applied:
+            self.memcpy_buffer_len = applied[self.TARGET_PARAM_IDS["buffer_len"]]
+        if self.TARGET_PARAM_IDS["src_init_byte"] in applied:
+            self.memcpy_src_init_byte = applied[self.TARGET_PARAM_IDS["src_init_byte"]]
+
+        # Accumulated runtime configuration for the provenance block,
+        # keyed by the names the caller used
+        self._runtime_config.update(
+            {str(name): int(value) for name, value in params.items()}
+        )
+
+        return applied
+
+    def run_batch_execution(self, position_index: int, config_index: int, num_iterations: int):
+        """
+        Run a batch of executions on the target with a single host roundtrip.
+
+        Sends a 'B' packet with the iteration count; the target runs that many
+        trigger-wrapped executions back-to-back (the pulse generator fires on
+        the trigger line for each) and responds with one aggregate packet:
+
+            [0..1]  number of iterations actually run (little endian)
+            [2..]   fault bitmap, one bit per iteration (bit set = fault)
+            [..]    faulty counter values (little endian uint32 each)
+
+        The bitmap is unpacked into the existing `num_faults`/`num_nofaults`
+        counters of the glitch config at `config_index`.
+
+        Parameters
+        ----------
+        position_index : int
+            Index into `self.positions` the results are booked under.
+        config_index : int
+            Index into `self.glitch_configs`.
+        num_iterations : int
+            Number of back-to-back executions to request (target clamps to
+            its compile-time maximum and reports the count actually run).
+
+        Returns
+        -------
+        tuple[int, int, list[int]]
+            (iterations_run, num_faults, faulty_counter_values)
+        """
+        glitch_config = self.glitch_configs[config_index]
+        config_results = self.results[config_index]
+
+        self.send_packet("B", int(num_iterations).to_bytes(2, "little"))
+
+        if self.target_serial.wait_ack("B", glitch_config.ack_timeout) != 0:
+            result_category, extradata = self.crashHandler()
+            config_results[f"num_{result_category}"][position_index] += 1
+            return 0, 0, []
+
+        # The whole batch runs within one response; scale the timeout accordingly
+        batch_timeout = glitch_config.dead_timeout * max(1, num_iterations)
+        try:
+            cmd, data = self.target_serial.read_packet(timeout=batch_timeout)
+        except Exception:
+            result_category, extradata = self.crashHandler()
+            config_results[f"num_{result_category}"][position_index] += 1
+            return 0, 0, []
+
+        if cmd != TargetSerial.type_convert_cmd("B") or not data or len(data) < 2:
+            raise ValueError(f"run_batch_execution: unexpected response cmd `{cmd}`")
+
+        iterations_run = int.from_bytes(data[0:2], "little")
+        bitmap_len = (iterations_run + 7) // 8
+        bitmap = data[2:2 + bitmap_len]
+        counter_bytes = data[2 + bitmap_len:]
+
+        num_faults = sum(
+            (bitmap[i // 8] >> (i % 8)) & 1 for i in range(iterations_run)
+        )
+        fault_values = [
+            int.from_bytes(counter_bytes[i * 4:(i + 1) * 4], "little")
+            for i in range(len(counter_bytes) // 4)
+        ]
+
+        # Book results into the existing per-position counters
+        config_results["num_faults"][position_index] += num_faults
+        config_results["num_nofaults"][position_index] += iterations_run - num_faults
+
+        return iterations_run, num_faults, fault_values
+
+    def run_accumulated_executions(self, position_index: int, config_index: int,
+                                   num_executions: int, summary_interval: int = 50):
+        """
+        Run executions in on-target accumulate mode.
+
+        Sends an 'A' packet with the summary interval; the target then runs
+        trigger-wrapped executions continuously (the pulse generator fires
+        on the trigger line for each), counts nofault/fault outcomes
+        on-target and sends one 'A' summary packet per interval:
+
+            [0..3]  executions since the previous summary (little endian)
+            [4..7]  faults since the previous summary
+            [8]     number of ring entries that follow
+            [9..]   most recent faulty counter values (little endian uint32)
+
+        Serial cost is thus one exchange per `summary_interval` shots
+        instead of three per shot. Unlike run_batch_execution the run
+        length is unbounded on the target: the host stops it by sending a
+        second 'A' packet once enough executions are in, which the target
+        answers with a final partial summary (a few extra executions may
+        run before the stop is noticed; they are booked normally).
+
+        The faulty counter ring only keeps the last 16 values per
+        interval, so keep `summary_interval` small when per-fault values
+        matter and large when only the aggregate counters do.
+
+        Parameters
+        ----------
+        position_index : int
+            Index into `self.positions` the results are booked under.
+        config_index : int
+            Index into `self.glitch_configs`.
+        num_executions : int
+            Target number of executions (lower bound, see above).
+        summary_interval : int, optional
+            Executions per summary packet. Defaults to 50.
+
+        Returns
+        -------
+        tuple[int, int, list[int]]
+            (executions_run, num_faults, faulty_counter_values)
+        """
+        glitch_config = self.glitch_configs[config_index]
+        config_results = self.results[config_index]
+
+        interval = max(1, min(int(summary_interval), int(num_executions)))
+        self.send_packet("A", interval.to_bytes(4, "little"))
+
+        if self.target_serial.wait_ack("A", glitch_config.ack_timeout) != 0:
+            result_category, extradata = self.crashHandler()
+            config_results[f"num_{result_category}"][position_index] += 1
+            return 0, 0, []
+
+        def parse_summary(data):
+            if not data or len(data) < 9:
+                raise ValueError(
+                    f"run_accumulated_executions: short summary packet `{data}`"
+                )
+            execs = int.from_bytes(data[0:4], "little")
+            faults = int.from_bytes(data[4:8], "little")
+            num_ring = data[8]
+            values = [
+                int.from_bytes(data[9 + i * 4:13 + i * 4], "little")
+                for i in range(num_ring)
+            ]
+            return execs, faults, values
+
+        total_execs = 0
+        total_faults = 0
+        fault_values = []
+        # One summary arrives per interval; scale the timeout accordingly
+        summary_timeout = glitch_config.dead_timeout * max(1, interval)
+
+        while total_execs < num_executions:
+            try:
+                cmd, data = self.target_serial.read_packet(timeout=summary_timeout)
+            except Exception:
+                result_category, extradata = self.crashHandler()
+                config_results[f"num_{result_category}"][position_index] += 1
+                return total_execs, total_faults, fault_values
+
+            if cmd != TargetSerial.type_convert_cmd("A"):
+                raise ValueError(
+                    f"run_accumulated_executions: unexpected response cmd `{cmd}`"
+                )
+            execs, faults, values = parse_summary(data)
+            total_execs += execs
+            total_faults += faults
+            fault_values.extend(values)
+
+        # Stop the run: the target answers with a final partial summary.
+        # The stop may cross an interval summary already in flight, so
+        # drain until the target goes quiet.
+        self.send_packet("A", (0).to_bytes(4, "little"))
+        try:
+            while True:
+                cmd, data = self.target_serial.read_packet(
+                    timeout=glitch_config.dead_timeout
+                )
+                if cmd != TargetSerial.type_convert_cmd("A"):
+                    continue
+                execs, faults, values = parse_summary(data)
+                total_execs += execs
+                total_faults += faults
+                fault_values.extend(values)
+        except Exception:
+            pass # quiet: the final summary has been read
+
+        # Book results into the existing per-position counters
+        config_results["num_faults"][position_index] += total_faults
+        config_results["num_nofaults"][position_index] += total_execs - total_faults
+
+        return total_execs, total_faults, fault_values
+
+    def run_pipelined_executions(self, position_index: int, config_index: int,
+                                 num_executions: int, window: int = 4):
+        """
+        Run executions in windowed pipelined mode.
+
+        Instead of the stop-and-wait 's'/ack/response exchange, start
+        commands carry a one-byte sequence tag and up to `window` of them
+        are kept in flight; the target answers each with a tagged 'e'/'f'
+        response (no per-start ack) that is matched by sequence. Host-side
+        bookkeeping thus overlaps fully with target execution.
+
+        Requires firmware with tagged-start support; build with
+        SS_UART_DMA=1 so start commands queued during an execution are
+        buffered on the target instead of overrunning its UART.
+
+        On a fault the target is reset (matching faultPacketHandler) and
+        the in-flight start commands are re-issued afterwards.
+
+        Parameters
+        ----------
+        position_index : int
+            Index into `self.positions` the results are booked under.
+        config_index : int
+            Index into `self.glitch_configs`.
+        num_executions : int
+            Total number of executions to run.
+        window : int, optional
+            Maximum number of outstanding start commands. Defaults to 4.
+
+        Returns
+        -------
+        tuple[int, int, list[bytes]]
+            (executions_completed, num_faults, fault_payloads)
+        """
+        glitch_config = self.glitch_configs[config_index]
+        config_results = self.results[config_index]
+
+        fault_cmd = TargetSerial.type_convert_cmd("f")
+        sent = completed = num_faults = 0
+        fault_payloads = []
+        outstanding = set()
+        next_seq = 0
+
+        while completed < num_executions:
+            # Keep up to `window` start commands in flight
+            while len(outstanding) < window and sent < num_executions:
+                seq = next_seq & 0xFF
+                self.send_packet("s", bytes([seq]))
+                outstanding.add(seq)
+                next_seq += 1
+                sent += 1
+
+            try:
+                cmd, seq, data = self.target_serial.read_packet_tagged(
+                    timeout=glitch_config.dead_timeout
+                )
+            except Exception:
+                # No response for any in-flight execution: target crashed
+                result_category, extradata = self.crashHandler()
+                config_results[f"num_{result_category}"][position_index] += 1
+                return completed, num_faults, fault_payloads
+
+            if seq not in outstanding:
+                continue  # stale or duplicate response
+            outstanding.discard(seq)
+            completed += 1
+
+            if cmd == fault_cmd:
+                num_faults += 1
+                if data:
+                    fault_payloads.append(data)
+                config_results["num_faults"][position_index] += 1
+
+                # Reset after a fault (as faultPacketHandler does); the
+                # other in-flight starts are lost and will be re-issued
+                self.reset_target()
+                self.target_serial.note_retransmissions(len(outstanding))
+                outstanding.clear()
+                sent = completed
+            else:
+                config_results["num_nofaults"][position_index] += 1
+
+        return completed, num_faults, fault_payloads
+
+    def run_line_sweep(self, position_indices, config_index, velocity=None):
+        """
+        Sweep a line of positions in continuous motion.
+
+        For dense 1D scans (e.g. 0.05mm steps across a die edge) the
+        move-settle-shoot cycle is dominated by mechanical settle time.
+        This mode moves to the first position, then commands a single
+        constant-velocity traverse to the last while test_execution()
+        runs back-to-back; each shot is booked under the position index
+        nearest the stage's estimated location, so the given indices act
+        as virtual bins in the existing counter arrays. The location
+        comes from xyzTable.get_position() (encoder readback) when the
+        wrapper provides it, from dead reckoning (motion start time
+        times commanded velocity) otherwise.
+
+        The caller configures the ChipShouter/DelayController for the
+        glitch config first (as with run_batch_execution); shots fire on
+        the target's trigger line exactly as in stop-and-wait mode, only
+        the stage never stops. Spatial accuracy is bounded by shot
+        period times velocity, so pick `velocity` such that one
+        execution roundtrip covers less than the bin spacing. Crash
+        recovery (reset and re-announce) runs mid-motion and simply
+        leaves the bins it traverses with fewer samples.
+
+        Parameters
+        ----------
+        position_indices : list[int]
+            Indices into self.positions forming the line, in traverse
+            order. First and last define the motion segment; shots are
+            binned by projection onto it, so the intermediate positions
+            should lie on the segment and Z must not change.
+        config_index : int
+            Index into self.glitch_configs.
+        velocity : float, optional
+            Traverse velocity in stage units (mm/s), pushed via
+            set_motion_profile when supported and used for dead
+            reckoning. Defaults to the precise profile velocity.
+
+        Returns
+        -------
+        tuple[int, dict[int, int]]
+            (total shots, shots booked per position index).
+
+        Raises
+        ------
+        ValueError
+            On fewer than two positions, a zero-length segment or a Z
+            change along the line.
+        """
+        if len(position_indices) < 2:
+            raise ValueError("run_line_sweep: need at least two positions")
+        x0, y0, z0 = self.positions[position_indices[0]]
+        x1, y1, z1 = self.positions[position_indices[-1]]
+        if z1 != z0:
+            raise ValueError("run_line_sweep: Z changes along the line")
+        length = math.hypot(x1 - x0, y1 - y0)
+        if length == 0:
+            raise ValueError("run_line_sweep: zero-length segment")
+
+        config_results = self.results[config_index]
+        velocity = velocity or self.MOTION_PROFILES["precise"]["velocity"]
+
+        # Reach the line start the normal way and settle there: the
+        # sweep wants a clean constant-velocity segment from the start
+        self.move_table(x0, y0, z0)
+        self._wait_table_settled()
+
+        setter = getattr(self.table, "set_motion_profile", None)
+        if callable(setter):
+            setter(velocity=velocity,
+                   acceleration=self.MOTION_PROFILES["precise"]["acceleration"])
+            self._motion_profile = None # custom profile, not a named one
+
+        # Command the traverse on a background thread; shots run on the
+        # calling thread until the wrapper reports the move complete
+        move_axis = getattr(self.table, "move_axis_absolute", None)
+        errors = []
+
+        def traverse():
+            try:
+                if callable(move_axis):
+                    axes = [axis for axis, new, old in
+                            (("x", x1, x0), ("y", y1, y0)) if new != old]
+                    self._move_axes(move_axis, axes, {"x": x1, "y": y1})
+                else:
+                    self.table.move_absolute(x1, y1, z1)
+            except Exception as e:
+                errors.append(e)
+
+        reader = getattr(self.table, "get_position", None)
+        mover = threading.Thread(target=traverse, name="line-sweep", daemon=True)
+        self._table_position = None # unknown while the traverse is in flight
+        sweep_start = time.monotonic()
+        mover.start()
+
+        num_bins = len(position_indices)
+        total_shots = 0
+        shots_per_bin = {}
+        execution_index = 0
+        while mover.is_alive():
+            # Stage location along the segment (mm from the start):
+            # encoder readback when available, dead reckoning otherwise
+            if callable(reader):
+                px, py = reader()[:2]
+                s = ((px - x0) * (x1 - x0) + (py - y0) * (y1 - y0)) / length
+            else:
+                s = velocity * (time.monotonic() - sweep_start)
+            s = min(max(s, 0.0), length)
+            bin_index = position_indices[min(num_bins - 1,
+                                             int(s / length * num_bins))]
+
+            execution_index, result_category, extradata = self.test_execution(
+                bin_index, config_index, execution_index
+            )
+            config_results[f"num_{result_category}"][bin_index] += 1
+            config_results["effective_executions"][bin_index] += 1
+            if not self._stream_result(bin_index, config_index,
+                                       result_category, extradata):
+                if extradata:
+                    by_position = config_results.setdefault(result_category, {})
+                    by_position.setdefault(bin_index, []).append(
+                        self.make_json_serializable(extradata)
+                    )
+            total_shots += 1
+            shots_per_bin[bin_index] = shots_per_bin.get(bin_index, 0) + 1
+
+        mover.join()
+        if errors:
+            raise errors[0] # cache stays unknown: the stage stopped mid-line
+        self._table_position = (x1, y1, z1)
+        self._wait_table_settled()
+        self.timing.record("line_sweep", time.monotonic() - sweep_start)
+        return total_shots, shots_per_bin
 
     def overwrite_test_execution(self, func):
         """
         Overwrite test_execution with a new function.
         The new function must have the same signature as CSProfiler.test_execution():
             test_execution(self, position_index, config_index, execution_index) -> (result_category, extradata, new_execution_index)
+
+        For observing or augmenting shots (rather than replacing the
+        whole injection flow), prefer register_hook: hooks compose,
+        replacements do not.
         """
         # Check if func has correct number of arguments
         orig_count = self.test_execution.__code__.co_argcount
@@ -440,60 +3086,1097 @@ class CSProfiler:
             )
 
         self._test_execution = func
+        # Return contract is checked on the first call only (see
+        # test_execution); a replacement that passed once will not
+        # change shape mid-campaign
+        self._test_execution_validated = False
 
-    def test_position(self, position_index):
-        self.reset_target() #TODO: usually not needed but make configurable
+    def register_hook(self, point, func=None):
+        """
+        Register a hook at one of the named extension points (pre_shot,
+        post_shot, on_result, on_position_done, on_error - signatures
+        in hooks.py). The contract is validated here, once; the chain
+        is compiled to a flat call target the hot loop guards with a
+        single falsy check. Usable directly or as a decorator:
+
+            @profiler.register_hook("on_error")
+            def watch(profiler, position_index, config_index, error): ...
+        """
+        if func is None:
+            return functools.partial(self.register_hook, point)
+        self.hooks.register(point, func)
+        setattr(self, f"_hook_{point}", self.hooks.compile(point))
+        return func
+
+    def add_skip_rule(self, rule):
+        """
+        Register a saturation skip rule (stock rules in skip_rules.py):
+        rule(profiler, position_index, config_index) returns a short
+        reason string to skip that batch, or None to run it. Rules run
+        in registration order at the top of test_position's config
+        loop, the first reason wins, and the skipped batch books its
+        num_executions under the num_skipped result type. Returns the
+        rule, so it works as a decorator.
+        """
+        if not callable(rule):
+            raise TypeError(f"skip rule must be callable, got {type(rule)}")
+        self._skip_rules.append(rule)
+        return rule
+
+    def _skip_decision(self, position_index, config_index):
+        """First registered rule's reason to skip this batch, or None."""
+        for rule in self._skip_rules:
+            reason = rule(self, position_index, config_index)
+            if reason:
+                return reason
+        return None
+
+    def plan_position_order(self, indices=None):
+        """
+        Compute a travel-minimizing visiting order over self.positions.
+
+        The grid generators emit raster order with a full-width return
+        move on every row, and arbitrary MovementConfig point sets come
+        in whatever order the caller built them — stage travel is our
+        second-largest time sink after serial waits.
+
+        Parameters
+        ----------
+        indices : list[int], optional
+            Position indices to plan over. Defaults to all positions.
+
+        Returns
+        -------
+        list[int]
+            Permutation of the given indices: serpentine (boustrophedon)
+            row order when the positions form a regular grid, otherwise
+            a nearest-neighbor tour improved by bounded 2-opt passes.
+            Only the visiting sequence changes; results remain indexed
+            by the original position_index.
+        """
+        indices = list(range(self.num_positions)) if indices is None else list(indices)
+        n = len(indices)
+        if n <= 2:
+            return indices
+
+        # Grid detection: rows of constant (y, z) that all cover the
+        # same x coordinates
+        rows = {}
+        for index in indices:
+            x, y, z = self.positions[index]
+            rows.setdefault((y, z), []).append(index)
+
+        x_sets = [
+            tuple(sorted(self.positions[i][0] for i in row))
+            for row in rows.values()
+        ]
+        if len(rows) > 1 and all(xs == x_sets[0] for xs in x_sets):
+            order = []
+            for row_num, key in enumerate(sorted(rows)):
+                order.extend(sorted(
+                    rows[key],
+                    key=lambda i: self.positions[i][0],
+                    reverse=row_num % 2 == 1
+                ))
+            return order
+
+        def dist(a, b):
+            ax, ay, az = self.positions[a]
+            bx, by, bz = self.positions[b]
+            return ((ax - bx) ** 2 + (ay - by) ** 2 + (az - bz) ** 2) ** 0.5
+
+        # Nearest-neighbor construction from the first position
+        remaining = set(indices[1:])
+        order = [indices[0]]
+        while remaining:
+            current = order[-1]
+            nearest = min(remaining, key=lambda i: dist(current, i))
+            remaining.discard(nearest)
+            order.append(nearest)
+
+        # 2-opt: uncross path segments. Passes are bounded since each
+        # is O(n^2); planning stays negligible next to campaign time.
+        max_passes = 5 if n <= 1500 else 1
+        for _ in range(max_passes):
+            improved = False
+            for i in range(n - 2):
+                for k in range(i + 2, n - 1):
+                    a, b = order[i], order[i + 1]
+                    c, d = order[k], order[k + 1]
+                    if dist(a, c) + dist(b, d) < dist(a, b) + dist(c, d) - 1e-12:
+                        order[i + 1:k + 1] = reversed(order[i + 1:k + 1])
+                        improved = True
+            if not improved:
+                break
+
+        return order
+
+    # Motion profiles applied before table moves when the wrapper
+    # supports tuning (set_motion_profile). Values are stage units
+    # (mm/s, mm/s^2), conservative for the Thorlabs stages in use;
+    # mutate the dict to tune for different hardware. Moves of at least
+    # TRAVEL_DISTANCE_MM on any axis use the travel profile, so
+    # cross-grid repositioning runs fast while 0.1mm scan steps keep
+    # the precise profile.
+    MOTION_PROFILES = {
+        "precise": {"velocity": 0.5, "acceleration": 1.0},
+        "travel": {"velocity": 2.0, "acceleration": 4.0},
+    }
+    TRAVEL_DISTANCE_MM = 2.0
+    # Commanded moves within this distance of the cached position are
+    # dropped (well below stage repeatability): replay campaigns,
+    # refinement passes and config-major scheduling all revisit
+    # positions, and each no-op move still costs controller roundtrips
+    # plus the settle wait.
+    POSITION_TOLERANCE_MM = 1e-3
+
+    def invalidate_table_position(self):
+        """
+        Forget the cached stage position, forcing the next move_table()
+        to command every axis (an explicit re-seek). Call after any
+        operation that may move the stage outside move_table - homing,
+        probing, manual jogs, or an errored/aborted move.
+        """
+        self._table_position = None
+
+    def _apply_motion_profile(self, name):
+        """
+        Push a named motion profile to the table controller.
+
+        No-op on wrappers without set_motion_profile(); the last applied
+        name is cached so consecutive scan steps cost no serial writes.
+        """
+        setter = getattr(self.table, "set_motion_profile", None)
+        if not callable(setter) or name == self._motion_profile:
+            return
+        setter(**self.MOTION_PROFILES[name])
+        self._motion_profile = name
+
+    def move_table(self, x, y, z):
+        """
+        Move the XYZ table to (x, y, z), coordinating axes when possible.
+
+        Before moving, the motion profile is selected by distance: the
+        travel profile for long repositioning moves (or when the current
+        position is unknown, e.g. after homing), the precise profile for
+        scan steps. See MOTION_PROFILES.
+
+        The emf_table wrapper's move_absolute() drives axes one after
+        another, so a diagonal step costs the sum of both axis times.
+        When the wrapper exposes per-axis moves (move_axis_absolute(axis,
+        value) with axis in "x"/"y"/"z"), the changed axes are commanded
+        concurrently and the wait ends with the slowest; axes already at
+        their commanded target - typically Z throughout a scan - are not
+        commanded at all. Wrappers without per-axis support fall back to
+        the sequential move_absolute().
+
+        With a clearance map assigned (see build_clearance_map), long
+        moves Z-hop: the probe rises to the map's safe altitude over the
+        traversed region, translates XY there, and descends to the shot
+        Z only at the target position. Short scan steps and wrappers
+        without per-axis moves are unaffected.
+
+        Moves within POSITION_TOLERANCE_MM of the cached position are
+        dropped entirely - revisits cost nothing. The cache is cleared
+        while a move is in flight and by invalidate_table_position(),
+        either of which forces the next call to command every axis.
+
+        Axis errors propagate: the first changed axis runs on the
+        calling thread, concurrent axis failures are re-raised after all
+        moves settled.
+        """
+        if self._table_position is None:
+            distance = None
+        else:
+            distance = max(abs(a - b) for a, b in zip((x, y, z), self._table_position))
+            if distance <= self.POSITION_TOLERANCE_MM:
+                return # already there (within stage repeatability)
+        self._apply_motion_profile(
+            "travel" if distance is None or distance >= self.TRAVEL_DISTANCE_MM
+            else "precise"
+        )
+
+        move_axis = getattr(self.table, "move_axis_absolute", None)
+        if not callable(move_axis):
+            # Cache goes unknown while a move is in flight, so an
+            # errored/aborted move forces a full re-seek next call
+            self._table_position = None
+            self.table.move_absolute(x, y, z)
+            self._table_position = (x, y, z)
+            return
+
+        target = {"x": x, "y": y, "z": z}
+
+        # Z-hop travel: with a clearance map, long moves raise the probe
+        # to a safe altitude over the traversed region, translate XY
+        # fast, and only descend to the shot Z at the target position.
+        if (self.clearance_map is not None and self._table_position is not None
+                and max(abs(x - self._table_position[0]),
+                        abs(y - self._table_position[1])) >= self.TRAVEL_DISTANCE_MM):
+            x0, y0, z0 = self._table_position
+            z_travel = self.clearance_map.travel_height(x0, y0, x, y)
+            self._table_position = None # unknown while moves are in flight
+            if z0 > z_travel: # larger Z = probe closer to the board
+                move_axis("z", z_travel)
+            xy_axes = [axis for axis, new, old in (("x", x, x0), ("y", y, y0))
+                       if new != old]
+            self._move_axes(move_axis, xy_axes, {"x": x, "y": y})
+            move_axis("z", z)
+            self._table_position = (x, y, z)
+            return
+
+        if self._table_position is None:
+            changed = list(target)
+        else:
+            last = dict(zip(("x", "y", "z"), self._table_position))
+            changed = [axis for axis, value in target.items()
+                       if abs(value - last[axis]) > self.POSITION_TOLERANCE_MM]
+
+        self._table_position = None # unknown while moves are in flight
+        self._move_axes(move_axis, changed, target)
+        self._table_position = (x, y, z)
+
+    @staticmethod
+    def _move_axes(move_axis, axes, target):
+        """
+        Command the given axes concurrently and wait on the slowest.
+
+        The first axis runs on the calling thread; failures of the
+        concurrent axes are re-raised after all moves settled.
+        """
+        errors = []
+
+        def drive(axis):
+            try:
+                move_axis(axis, target[axis])
+            except Exception as e:
+                errors.append(e)
+
+        movers = []
+        for axis in axes[1:]:
+            mover = threading.Thread(target=drive, args=(axis,),
+                                     name=f"table-move-{axis}", daemon=True)
+            mover.start()
+            movers.append(mover)
+        if axes:
+            move_axis(axes[0], target[axes[0]])
+        for mover in movers:
+            mover.join()
+        if errors:
+            raise errors[0]
+
+    def build_clearance_map(self, step=5.0, margin=1.0):
+        """
+        Build a ClearanceMap with a coarse pre-campaign Z-probe pass.
+
+        Probes a `step`-spaced grid over the XY extents of
+        self.positions using xyzTable.probe_z(x, y) (which lowers the
+        probe until contact/threshold and returns the touch Z), assigns
+        the result to self.clearance_map and returns it. Run once before
+        run_campaign; with a user-supplied height grid, assign a
+        ClearanceMap to self.clearance_map directly instead.
+
+        Raises
+        ------
+        ValueError
+            If there are no positions or the table wrapper has no
+            probe_z support.
+        """
+        probe = getattr(self.table, "probe_z", None)
+        if not callable(probe):
+            raise ValueError("build_clearance_map: xyzTable lacks probe_z support; "
+                             "supply a ClearanceMap with a user-measured height grid")
+        if not self.positions:
+            raise ValueError("build_clearance_map: no positions to cover")
+
+        xs = [p[0] for p in self.positions]
+        ys = [p[1] for p in self.positions]
+        x_min, x_max = min(xs), max(xs)
+        y_min, y_max = min(ys), max(ys)
+        cols = max(1, math.ceil((x_max - x_min) / step))
+        rows = max(1, math.ceil((y_max - y_min) / step))
+
+        heights = []
+        for row in range(rows):
+            y = y_min + (row + 0.5) * (y_max - y_min) / rows
+            heights.append([
+                probe(x_min + (col + 0.5) * (x_max - x_min) / cols, y)
+                for col in range(cols)
+            ])
+
+        self.clearance_map = ClearanceMap(x_min, y_min, x_max, y_max,
+                                          heights, margin=margin)
+        self.invalidate_table_position() # probing moved the stage
+        return self.clearance_map
+
+    # A reference probe within this of the recorded touch Z confirms
+    # the coordinate system; generous against probe repeatability but
+    # well under one scan step
+    HOME_VERIFY_TOLERANCE_MM = 0.05
+    _calibration_path = "results/table_calibration.json"
+
+    def home_table(self, force=False):
+        """
+        Establish the stage coordinate system, cheaply when possible.
+
+        A full home_all() is a multi-minute full-travel sequence, and
+        the README rule "always home or coordinates shift" made it a
+        per-campaign tax. With self.home_reference set to a fixed
+        mechanical touch point on the bench plate and a wrapper with
+        probe_z support, the homed state is persisted instead: after a
+        full home the reference is probed and its touch Z recorded
+        (results/table_calibration.json); later runs re-probe the
+        reference and skip homing when the touch Z matches within
+        HOME_VERIFY_TOLERANCE_MM. Any mismatch - drifted coordinates, a
+        moved reference, a different bench - falls back to full homing
+        and re-records.
+
+        Parameters
+        ----------
+        force : bool, optional
+            Skip verification and run the full home_all() (the probe
+            pass still re-records the calibration).
+
+        Returns
+        -------
+        bool
+            True if the full home_all() ran, False if the persisted
+            calibration verified.
+        """
+        probe = getattr(self.table, "probe_z", None)
+        calibration = None
+        if not force and self.home_reference is not None and callable(probe):
+            try:
+                with open(self._calibration_path) as f:
+                    calibration = json.load(f)
+            except (OSError, ValueError):
+                calibration = None
+
+        if calibration is not None:
+            x, y = self.home_reference
+            if calibration.get("reference") == [x, y]:
+                touch_z = probe(x, y)
+                self.invalidate_table_position()
+                if abs(touch_z - calibration["touch_z"]) <= self.HOME_VERIFY_TOLERANCE_MM:
+                    return False
+                self.progress.event(
+                    f"Home verification mismatch ({touch_z:.3f} vs "
+                    f"{calibration['touch_z']:.3f}), re-homing"
+                )
+
+        self.table.home_all()
+        self.invalidate_table_position()
+        self._motion_profile = None # homing may reset controller tuning
+
+        if self.home_reference is not None and callable(probe):
+            x, y = self.home_reference
+            touch_z = probe(x, y)
+            self.invalidate_table_position()
+            os.makedirs(os.path.dirname(self._calibration_path), exist_ok=True)
+            with open(self._calibration_path, "w") as f:
+                json.dump({"reference": [x, y], "touch_z": touch_z}, f)
+        return True
+
+    def validate_positions(self):
+        """
+        Fail-fast sanity pass over self.positions before hardware arms.
+
+        Every position is checked for shape (three finite coordinates),
+        against self.table_travel_limits when set, and against
+        self.clearance_map when set: the position must lie inside the
+        map extents and its shot Z must not exceed the touch height of
+        its cell (larger Z = probe closer to the board). When both the
+        map and a Z limit are set, the planned visiting order is walked
+        and every Z-hop altitude move_table would command is checked
+        too. Runs at the top of _campaign_setup before
+        prepare_hardware(), so a bad grid dies in milliseconds instead
+        of hours into a campaign.
+
+        Raises
+        ------
+        ValueError
+            Listing the first offending positions (index, coordinates,
+            reason) and the total violation count.
+        """
+        problems = []
+        limits = self.table_travel_limits or {}
+        cmap = self.clearance_map
+
+        for index, position in enumerate(self.positions):
+            try:
+                x, y, z = (float(value) for value in position)
+            except (TypeError, ValueError):
+                problems.append(f"position {index} {position!r}: "
+                                "not three numeric coordinates")
+                continue
+            if not all(math.isfinite(value) for value in (x, y, z)):
+                problems.append(f"position {index} {position!r}: "
+                                "non-finite coordinate")
+                continue
+            for axis, value in (("x", x), ("y", y), ("z", z)):
+                lo_hi = limits.get(axis)
+                if lo_hi is not None and not lo_hi[0] <= value <= lo_hi[1]:
+                    problems.append(
+                        f"position {index} ({x}, {y}, {z}): {axis}={value} "
+                        f"outside travel limit [{lo_hi[0]}, {lo_hi[1]}]")
+            if cmap is not None:
+                if not (cmap.x_min <= x <= cmap.x_max
+                        and cmap.y_min <= y <= cmap.y_max):
+                    problems.append(f"position {index} ({x}, {y}, {z}): "
+                                    "outside clearance map extents")
+                elif z > cmap.height_at(x, y):
+                    problems.append(
+                        f"position {index} ({x}, {y}, {z}): z={z} beyond "
+                        f"cell touch height {cmap.height_at(x, y)}")
+
+        # Path simulation: the Z-hop altitudes move_table would command
+        # over the planned order must themselves be reachable
+        z_limit = limits.get("z")
+        if not problems and cmap is not None and z_limit is not None:
+            order = self.plan_position_order()
+            for a, b in zip(order, order[1:]):
+                x0, y0, _ = self.positions[a]
+                x1, y1, _ = self.positions[b]
+                if max(abs(x1 - x0), abs(y1 - y0)) < self.TRAVEL_DISTANCE_MM:
+                    continue
+                z_travel = cmap.travel_height(x0, y0, x1, y1)
+                if not z_limit[0] <= z_travel <= z_limit[1]:
+                    problems.append(
+                        f"travel {a}->{b}: Z-hop altitude {z_travel} outside "
+                        f"travel limit [{z_limit[0]}, {z_limit[1]}]")
+
+        if problems:
+            shown = problems[:8]
+            if len(problems) > len(shown):
+                shown.append(f"... and {len(problems) - len(shown)} more")
+            raise ValueError(
+                f"validate_positions: {len(problems)} violation(s):\n  "
+                + "\n  ".join(shown))
+
+    def validate_glitch_configs(self, indices=None):
+        """
+        Load-time validation and finalization pass over glitch configs
+        (the config-axis sibling of validate_positions).
+
+        test_position used to recompute the pulse-train duration and
+        assert it against dead_timeout on every position visit, and a
+        pulse_width outside the internal generator's range only hit
+        ChipShouter.configure_pulsegen's assertion mid-campaign. This
+        pass resolves pulse_path "auto" in place, checks the field
+        ranges against the selected pulse path and the train duration
+        against dead_timeout, and precomputes the derived values
+        (GlitchConfig.derive) the hot loop reads without recomputation.
+        Runs from _campaign_setup and over every config appended
+        mid-campaign.
+
+        Raises
+        ------
+        ValueError
+            Listing the offending configs (index, field, reason) and
+            the total violation count.
+        """
+        if indices is None:
+            indices = range(len(self.glitch_configs))
+        problems = []
+        for config_index in indices:
+            cfg = self.glitch_configs[config_index]
+            if cfg.pulse_path == "auto":
+                cfg.pulse_path = (
+                    "internal" if self._internal_pulsegen_fits(cfg)
+                    else "pico")
+            if cfg.pulse_path == "internal":
+                if cfg.pulse_width not in self.INTERNAL_WIDTH_NS:
+                    problems.append(
+                        f"config {config_index}: pulse_width "
+                        f"{cfg.pulse_width}ns outside the internal "
+                        f"generator's {self.INTERNAL_WIDTH_NS.start}-"
+                        f"{self.INTERNAL_WIDTH_NS.stop - 1}ns")
+                if cfg.pulse_offset:
+                    problems.append(
+                        f"config {config_index}: the internal generator "
+                        f"cannot apply pulse_offset {cfg.pulse_offset}")
+                repeat = max(1, cfg.pulse_repeats)
+                if repeat not in self.INTERNAL_REPEAT:
+                    problems.append(
+                        f"config {config_index}: pulse_repeats {repeat} "
+                        f"outside the internal generator's "
+                        f"{self.INTERNAL_REPEAT.start}-"
+                        f"{self.INTERNAL_REPEAT.stop - 1}")
+                elif repeat > 1 and (cfg.pulse_spacing // 1000000
+                                     not in self.INTERNAL_DEADTIME_MS):
+                    problems.append(
+                        f"config {config_index}: pulse_spacing "
+                        f"{cfg.pulse_spacing}ns maps outside the internal "
+                        f"generator's deadtime range")
+            elif cfg.pulse_path != "pico":
+                problems.append(
+                    f"config {config_index}: pulse_path "
+                    f"{cfg.pulse_path!r} (expected 'auto', 'internal' or "
+                    f"'pico')")
+                continue
+            if cfg.num_executions < 1:
+                problems.append(
+                    f"config {config_index}: num_executions "
+                    f"{cfg.num_executions} < 1")
+            cfg.derive()
+            if cfg.faulting_duration_ns / 1e6 >= cfg.dead_timeout:
+                problems.append(
+                    f"config {config_index}: pulse train lasts "
+                    f"{cfg.faulting_duration_ns / 1e6} ms but dead_timeout "
+                    f"is only {cfg.dead_timeout} ms")
+        if problems:
+            shown = problems[:8]
+            if len(problems) > len(shown):
+                shown.append(f"... and {len(problems) - len(shown)} more")
+            raise ValueError(
+                f"validate_glitch_configs: {len(problems)} violation(s):\n  "
+                + "\n  ".join(shown))
+
+    def _wait_table_settled(self, row_changed=False, timeout_s=5.0, poll_s=0.05):
+        """
+        Block until the stage reports settled after a move.
+
+        Uses xyzTable.is_settled() (True once every axis is within its
+        position-error band and no longer in motion) when the wrapper
+        provides it, returning as soon as the stage settles; `timeout_s`
+        is only the safety bound for a stage that never reports settled.
+        Wrappers without status reporting fall back to the historical
+        fixed 5s sleep, and only on row changes - the one move class
+        where move_absolute() was observed to return early.
+        """
+        is_settled = getattr(self.table, "is_settled", None)
+        if not callable(is_settled):
+            if row_changed:
+                time.sleep(5)
+            return
+
+        settle_start = time.monotonic()
+        deadline = settle_start + timeout_s
+        while time.monotonic() < deadline:
+            try:
+                if is_settled():
+                    break
+            except Exception:
+                break # status query failed: the timeout bound is moot
+            time.sleep(poll_s)
+        self.timing.record("table_settle", time.monotonic() - settle_start)
+
+    def _start_position_move(self, position):
+        """
+        Command the table move to `position` on a background thread.
+
+        Returns the (thread, start time) pair _advance_position joins
+        on; issuing the move early - right after the previous position's
+        last shot - lets its bookkeeping tail run during stage travel
+        (see _scan_positions).
+        """
+        x, y, z = position
+        mover = threading.Thread(
+            target=self.move_table, args=(x, y, z),
+            name="table-move", daemon=True
+        )
+        mover.start()
+        return mover, time.monotonic()
+
+    def _advance_position(self, position_index, position, first_glitch_config=None,
+                          move=None):
+        """
+        Move the XYZ table to `position` while concurrently preparing the
+        ChipShouter for the first glitch config.
+
+        Table travel, the ChipShouter and the DelayController sit on
+        independent serial links, so the multi-second move overlaps with
+        pushing the pulse parameters, the temperature check and arming
+        instead of running strictly after them.
+
+        Parameters
+        ----------
+        position_index : int
+            Index of the position (for error logging).
+        position : tuple
+            (x, y, z) target coordinates.
+        move : tuple, optional
+            Already-issued move from _start_position_move; when given,
+            `position` is only descriptive and no new move is commanded.
+
+        Returns
+        -------
+        bool
+            True if the ChipShouter preparation succeeded; test_position
+            can then skip configuring the first glitch config again.
+            False if it failed, in which case test_position keeps its
+            sequential path. Table movement errors propagate.
+        """
+        if move is None:
+            move = self._start_position_move(position)
+        mover, move_start = move
+
+        if first_glitch_config is None:
+            first_glitch_config = self.glitch_configs[self.config_order[0]]
+
+        prepared = False
+        try:
+            self.configure_chipshouter(first_glitch_config)
+            # Cached flag from the thermal monitor: cooldown overlaps
+            # the stage travel instead of blocking on serial reads
+            while not self.cs.thermal_ready():
+                time.sleep(1)
+            self.cs.ensure_armed()
+            prepared = True
+        except Exception as e:
+            # The overlap is an optimization: on failure fall back to the
+            # sequential path in test_position instead of failing the position
+            self.catched_errors.append(
+                {"position_index": position_index, "error": str(e),
+                 "type": type(e).__name__})
+
+        mover.join()
+        # Wall time of the move thread, including the part overlapped
+        # with the ChipShouter preparation above
+        move_seconds = time.monotonic() - move_start
+        self.timing.record("table_move", move_seconds)
+        self.eta.record_move(move_seconds)
+        return prepared
+
+    def config_schedule_cost(self, order, probe_swap_cost=30.0, voltage_cost=0.05):
+        """
+        Reconfiguration cost (seconds) of running the glitch configs once
+        in the given order.
+
+        Parameters
+        ----------
+        order : list[int]
+            Config indices in execution order.
+        probe_swap_cost : float, optional
+            Seconds per manual probe change between consecutive configs.
+        voltage_cost : float, optional
+            Seconds per volt of setpoint change (capacitor charge or
+            discharge between consecutive configs).
+
+        Returns
+        -------
+        float
+            Estimated reconfiguration seconds for one pass over `order`.
+        """
+        cost = 0.0
+        for a, b in zip(order, order[1:]):
+            config_a = self.glitch_configs[a]
+            config_b = self.glitch_configs[b]
+            if config_a.probe != config_b.probe:
+                cost += probe_swap_cost
+            cost += abs(config_b.voltage - config_a.voltage) * voltage_cost
+        return cost
+
+    def probe_groups(self):
+        """
+        Config indices of config_order grouped by probe.
+
+        Groups follow first appearance in config_order, and every config
+        of a probe lands in that probe's single group even when the
+        user-supplied config list interleaves probes - so each coil is
+        mounted exactly once per campaign.
+
+        Returns
+        -------
+        list[tuple[str, list[int]]]
+            (probe, config indices) per group, in execution order.
+        """
+        groups = {}
+        for config_index in self.config_order:
+            probe = self.glitch_configs[config_index].probe
+            groups.setdefault(probe, []).append(config_index)
+        return list(groups.items())
+
+    def _await_probe_swap(self, probe):
+        """
+        Pause the campaign at a probe-group boundary until the operator
+        confirms the coil is mounted.
+
+        The ChipShouter is disarmed first (nobody swaps a coil on an
+        armed shouter), the pending swap is published on the metrics
+        endpoint (csprofiler_awaiting_probe_swap) so remote dashboards
+        show why the shot rate dropped to zero, and the prompt blocks on
+        Enter. Non-interactive runs (no tty: CI, daemonized campaigns)
+        print the banner and continue - blocking forever there would
+        trade a wrong coil for a dead campaign.
+        """
+        try:
+            self.cs.disarm()
+        except Exception:
+            pass
+        self.awaiting_probe = probe
+        self.progress.event(f"Probe swap required: mount '{probe}'")
+        banner = f"=== PROBE SWAP: mount '{probe}', then press Enter ==="
+        try:
+            if sys.stdin is not None and sys.stdin.isatty():
+                input(f"\n{banner}\n")
+            else:
+                print(f"\n{banner} (non-interactive: continuing)\n")
+        finally:
+            self.awaiting_probe = None
+
+    def plan_config_order(self, probe_swap_cost=30.0, voltage_cost=0.05):
+        """
+        Order the glitch configs to amortize reconfiguration cost.
+
+        Groups configs by probe (first-appearance order, so manual probe
+        swaps happen once per probe instead of interleaved) and sorts each
+        group by voltage, alternating the sweep direction between groups
+        so the capacitor setpoint moves monotonically instead of cycling
+        between extremes at every position.
+
+        Returns
+        -------
+        list[int]
+            Permutation of config indices. Results stay indexed by the
+            original config_index; only the execution order changes.
+        """
+        groups = {}
+        for index, config in enumerate(self.glitch_configs):
+            groups.setdefault(config.probe, []).append(index)
+
+        order = []
+        ascending = True
+        for probe_indices in groups.values():
+            probe_indices.sort(
+                key=lambda i: self.glitch_configs[i].voltage, reverse=not ascending
+            )
+            order.extend(probe_indices)
+            ascending = not ascending
+
+        return order
+
+    def estimate_traversal_cost(self, order=None, config_major=False,
+                                move_seconds=2.0, probe_swap_cost=30.0, voltage_cost=0.05):
+        """
+        Estimated reconfiguration + travel seconds for a whole campaign,
+        for comparing position-major against config-major iteration.
+
+        Position-major pays the full config schedule at every position;
+        config-major pays it once but travels the grid once per config.
+        Execution time itself is identical either way and not included.
+        """
+        order = self.config_order if order is None else order
+        reconfiguration = self.config_schedule_cost(order, probe_swap_cost, voltage_cost)
+        if config_major:
+            return reconfiguration + len(order) * self.num_positions * move_seconds
+        return self.num_positions * reconfiguration + self.num_positions * move_seconds
+
+    # Fallback per-phase costs (seconds / mm/s) for campaign planning.
+    # Meant to be overridden with measured values — pass a costs dict
+    # filled from instrumentation or bench measurements, not guesses.
+    DEFAULT_CAMPAIGN_COSTS = {
+        "movement_speed": 2.0,   # stage travel speed (mm/s)
+        "arm_seconds": 2.0,      # per-position arming/temperature overhead
+        "shot_seconds": 0.15,    # charge gate + trigger + ack per execution
+        "reset_seconds": 1.5,    # target reset after a fault outcome
+        "probe_swap_cost": 30.0, # manual probe change between configs
+        "voltage_cost": 0.05,    # capacitor setpoint change per volt
+        "fault_rate": 0.05,      # assumed fault probability per execution
+    }
+
+    @staticmethod
+    def fault_rates_from_results(results_json):
+        """
+        Observed per-config fault rates from a (possibly partial) results
+        JSON, for feeding realistic rates into campaign planning.
+
+        Parameters
+        ----------
+        results_json : dict
+            Parsed results file as written by store_results.
+
+        Returns
+        -------
+        list[float | None]
+            Fault probability per glitch config; None where the prior
+            run produced no fault/nofault trials for that config.
+        """
+        rates = []
+        for config in results_json.get("glitch_configs", []):
+            res = config.get("results", {})
+            faults = sum(res.get("num_faults", []))
+            trials = faults + sum(res.get("num_nofaults", []))
+            rates.append(faults / trials if trials else None)
+        return rates
+
+    def estimate_campaign_duration(self, costs=None, fault_rates=None):
+        """
+        Estimate total campaign duration in seconds before starting it.
+
+        Covers stage travel along the planned position order, the
+        reconfiguration schedule at every position, arming overhead and
+        the executions themselves — including the expected dead_timeout
+        wait plus target reset on the fault path, which is what usually
+        turns a "4 hour" grid into a 30 hour one.
+
+        Parameters
+        ----------
+        costs : dict, optional
+            Overrides for DEFAULT_CAMPAIGN_COSTS entries; should come
+            from measured per-operation timings.
+        fault_rates : list[float | None], optional
+            Per-config fault probabilities, e.g. from
+            fault_rates_from_results() on a prior partial result.
+
+        Returns
+        -------
+        float
+            Estimated seconds.
+        """
+        c = dict(self.DEFAULT_CAMPAIGN_COSTS)
+        c.update(costs or {})
+
+        position_order = self.plan_position_order()
+        travel = sum(
+            math.dist(self.positions[a], self.positions[b]) / c["movement_speed"]
+            for a, b in zip(position_order, position_order[1:])
+        )
+
+        config_order = self.plan_config_order(c["probe_swap_cost"], c["voltage_cost"])
+        reconfiguration = self.num_positions * self.config_schedule_cost(
+            config_order, c["probe_swap_cost"], c["voltage_cost"]
+        )
+
+        executions = 0.0
         for config_index, glitch_config in enumerate(self.glitch_configs):
-            # Verify that sequence of faults is not longer than dead_timeout
-            pulse_spacing_ns = glitch_config.pulse_spacing
-            faulting_duration_ns = (glitch_config.pulse_width + pulse_spacing_ns) * glitch_config.pulse_repeats
-            faulting_duation_ms = faulting_duration_ns / 1e6
-            assert faulting_duation_ms < glitch_config.dead_timeout, f"""
-                Faulting for {faulting_duation_ms} ms
-                but dead_timeout is only {glitch_config.dead_timeout} ms.
-            """
-
-            self.configure_chipshouter(glitch_config)
+            rate = c["fault_rate"]
+            if fault_rates and config_index < len(fault_rates) and fault_rates[config_index] is not None:
+                rate = fault_rates[config_index]
+            per_execution = c["shot_seconds"] + rate * (
+                glitch_config.dead_timeout / 1000.0 + c["reset_seconds"]
+            )
+            executions += self.num_positions * glitch_config.num_executions * per_execution
+
+        return travel + reconfiguration + executions + self.num_positions * c["arm_seconds"]
+
+    def campaign_eta_seconds(self):
+        """
+        Seconds remaining in the running campaign, projected from the
+        EWMA rates in self.eta.
+
+        Complements campaign_estimate(): that one plans ahead from
+        assumed costs, this one extrapolates the measured per-category
+        execution times and table moves over the planned executions
+        still outstanding. Returns None before the first execution.
+        """
+        planned = self.num_positions * sum(
+            glitch_config.num_executions for glitch_config in self.glitch_configs
+        )
+        remaining_executions = max(planned - self.eta.executions_done, 0)
+        remaining_moves = max(self.num_positions - self._scan_cursor, 0)
+        return self.eta.eta_seconds(remaining_executions, remaining_moves)
+
+    def fit_time_budget(self, budget_seconds, costs=None, fault_rates=None):
+        """
+        Prune executions until the campaign estimate fits the budget.
+
+        Samples are removed fewest-information-first: the marginal value
+        of another Bernoulli trial shrinks roughly with 1/sqrt(n), so
+        executions come off the glitch config that currently has the
+        most, in 10% steps, never below one execution per config. The
+        glitch configs are modified in place.
+
+        Returns
+        -------
+        tuple[float, dict[int, int]]
+            (final estimated seconds, executions pruned per config
+            index). The estimate may still exceed the budget if every
+            config is already at one execution.
+        """
+        estimate = self.estimate_campaign_duration(costs, fault_rates)
+        pruned = {}
+
+        while estimate > budget_seconds:
+            prunable = [
+                i for i, gc in enumerate(self.glitch_configs) if gc.num_executions > 1
+            ]
+            if not prunable:
+                print(f"fit_time_budget: cannot fit {budget_seconds}s, floor reached at {estimate:.0f}s")
+                break
+            target = max(prunable, key=lambda i: self.glitch_configs[i].num_executions)
+            glitch_config = self.glitch_configs[target]
+            step = max(1, glitch_config.num_executions // 10)
+            step = min(step, glitch_config.num_executions - 1)
+            glitch_config.num_executions -= step
+            pruned[target] = pruned.get(target, 0) + step
+            estimate = self.estimate_campaign_duration(costs, fault_rates)
+
+        if pruned:
+            print(f"fit_time_budget: pruned {pruned} executions, estimate now {estimate:.0f}s")
+        return estimate, pruned
+
+    def _early_stop_decision(self, faults, trials, glitch_config):
+        """
+        Sequential probability ratio test (Wald SPRT) between
+        H0: fault probability <= early_stop_p_low and
+        H1: fault probability >= early_stop_p_high.
+
+        Returns
+        -------
+        str | None
+            "low" / "high" once the corresponding hypothesis is accepted
+            at the configured confidence, None while undecided or when
+            early stopping is not enabled for this glitch config.
+        """
+        p0 = glitch_config.early_stop_p_low
+        p1 = glitch_config.early_stop_p_high
+        if p0 is None or p1 is None or trials == 0:
+            return None
+
+        alpha = 1.0 - glitch_config.early_stop_confidence
+        llr = (
+            faults * math.log(p1 / p0)
+            + (trials - faults) * math.log((1 - p1) / (1 - p0))
+        )
+        if llr >= math.log((1 - alpha) / alpha):
+            return "high"
+        if llr <= math.log(alpha / (1 - alpha)):
+            return "low"
+        return None
+
+    def test_position(self, position_index, first_config_prepared=False, config_indices=None):
+        self.reset_target() #TODO: usually not needed but make configurable
+        config_sequence = list(config_indices) if config_indices is not None else self.config_order
+        for sequence_pos, config_index in enumerate(config_sequence):
+            glitch_config = self.glitch_configs[config_index]
+            if self._skip_rules:
+                reason = self._skip_decision(position_index, config_index)
+                if reason:
+                    # Book the pruned batch under the skipped result
+                    # type, so the pruning stays auditable
+                    self.results[config_index]["num_skipped"][position_index] \
+                        += glitch_config.num_executions
+                    self.progress.event(
+                        f"Glitch config {config_index} skipped: {reason}",
+                        position_index=position_index,
+                        config_index=config_index,
+                        skipped=glitch_config.num_executions,
+                    )
+                    continue
+            if not hasattr(glitch_config, "faulting_duration_ns"):
+                # Standalone test_position use: campaigns get this pass
+                # (range checks, duration vs dead_timeout, derived
+                # fields) once in _campaign_setup, not per visit
+                self.validate_glitch_configs((config_index,))
+
+            # Skip the redundant roundtrips if _advance_position already
+            # configured the ChipShouter for this config during travel
+            if sequence_pos > 0 or not first_config_prepared:
+                self.configure_chipshouter(glitch_config)
             config_results = self.results[config_index]
 
-            self.target_serial.flush()
+            # Realign with the stream instead of dumping it: in-flight
+            # response bytes and reset announces survive (see resync)
+            self.target_serial.resync()
 
             execution_index = 0
             retry_count = 0
+            suspect_devices = set()
+            es_trials = 0
+            es_faults = 0
             while execution_index < glitch_config.num_executions:
+                if self._interrupt_requested:
+                    raise CampaignInterrupted(
+                        "operator interrupt at execution boundary")
 
                 try: # Main try block, allowing 3 retries
-                    # Run a single fault injection execution
+                    # A udev-flagged loss goes straight into the recovery
+                    # ladder instead of timing out against a dead device
+                    if self.usb_monitor is not None:
+                        lost_devices = self.usb_monitor.lost_devices()
+                        if lost_devices:
+                            raise DeviceLostError(lost_devices)
+
+                    # Run a single fault injection execution (with a
+                    # one-shot scope capture on each config's first one)
+                    measure_pulse = self._scope_arm_for_config(config_index)
+                    count_trigger = self._arm_trigger_counter()
+                    if self.trace_capture is not None:
+                        self.trace_capture.arm(position_index, config_index,
+                                               execution_index)
+                    if self._hook_pre_shot:
+                        self._hook_pre_shot(self, position_index, config_index,
+                                            execution_index)
+                    execution_start = time.monotonic()
                     execution_index, result_category, extradata = self.test_execution(position_index, config_index, execution_index)
+                    self.eta.record_execution(result_category, time.monotonic() - execution_start)
+                    if count_trigger:
+                        extradata = self._attach_trigger_width(result_category,
+                                                               extradata)
+                    if self.trace_capture is not None:
+                        # Pull + disk write overlap the next iteration
+                        self.trace_capture.collect()
+                    if measure_pulse:
+                        self._scope_record_measurement(config_index)
+
+                    if self._hook_post_shot:
+                        # execution_index already advanced; hand hooks
+                        # the index of the shot that just completed
+                        self._hook_post_shot(self, position_index,
+                                             config_index,
+                                             execution_index - 1,
+                                             result_category, extradata)
 
-                    # Print info string
-                    print(f"pos: {position_index+1}/{self.num_positions} ; config: {config_index+1}/{len(self.glitch_configs)} ; execution {execution_index}/{glitch_config.num_executions}: {self.result_types[result_category]}]")
+                    # Aggregated status line (redrawn at most ~5 Hz; a
+                    # print per execution costs real loop time at speed)
+                    self.progress.update(
+                        counts={result_category: 1},
+                        pos=f"{position_index+1}/{self.num_positions}",
+                        config=f"{config_index+1}/{len(self.glitch_configs)}",
+                        exec=f"{execution_index}/{glitch_config.num_executions}",
+                        eta=EtaEstimator.format_eta(self.campaign_eta_seconds()),
+                    )
 
                     # Increment result_category in log
+                    bookkeeping_start = time.monotonic()
                     config_results[f"num_{result_category}"][position_index] += 1
+                    self._record_counter_deviation(position_index, config_index,
+                                                   result_category, extradata)
+                    if self._column_store is not None:
+                        # execution_index is already the next one here;
+                        # book the shot that just completed
+                        self._column_store.append(position_index, config_index,
+                                                  execution_index - 1, extradata)
+
+                    # Early stopping: only fault/nofault outcomes count as
+                    # Bernoulli trials for the fault-probability estimate
+                    es_decision = None
+                    if result_category in ("faults", "nofaults"):
+                        es_trials += 1
+                        if result_category == "faults":
+                            es_faults += 1
+                        es_decision = self._early_stop_decision(es_faults, es_trials, glitch_config)
+
+                    # Stream the record to the on-disk log (campaigns);
+                    # the in-memory booking below remains for standalone
+                    # test_position use without an open stream
+                    if not self._stream_result(position_index, config_index, result_category, extradata):
+                        # Add extradata to results, keyed by position so
+                        # insertion stays O(1) regardless of visit order
+                        # (store_results serializes to the list shape)
+                        if extradata:
+                            by_position = config_results.setdefault(result_category, {})
+                            by_position.setdefault(position_index, []).append(
+                                self.make_json_serializable(extradata)
+                            )
+                    if self._hook_on_result:
+                        self._hook_on_result(self, position_index,
+                                             config_index, result_category,
+                                             extradata)
+                    self.timing.record("bookkeeping", time.monotonic() - bookkeeping_start)
 
-                    # Add extradata to results
-                    if extradata:
-                        # Ensure the category exists
-                        if result_category not in config_results:
-                            config_results[result_category] = []
-                        # Check if there is a already a data object for the current position and config_result
-                        try:
-                            if config_results[result_category][-1]["position_index"] == position_index:
-                                data_array = config_results[result_category][-1]["data"]
-                            else:
-                                raise Exception("")
-                        except: # If not, create one
-                            config_results[result_category].append({
-                                "position_index": position_index,
-                                "data": []
-                            })
-                            data_array = config_results[result_category][-1]["data"]
-
-                        data_array.append(extradata)
-
-                # Handle all kinds of errors that can occur
-                # TODO: allow adding error handlers
+                    if es_decision:
+                        self.progress.event(
+                            f"Early stop after {es_trials} executions: fault probability confidently {'above' if es_decision == 'high' else 'below'} threshold",
+                            position_index=position_index, config_index=config_index,
+                            decision=es_decision, trials=es_trials,
+                        )
+                        break
+
+                # Handle all kinds of errors that can occur; recovery is
+                # selected by the typed dispatch table (errors.py,
+                # register_error_handler) instead of str(e) comparisons
                 except Exception as e:
                     # If e is a retry error, extract the underlying exception that caused it
                     if type(e) == RetryError:
@@ -501,110 +4184,1181 @@ class CSProfiler:
                         if last_exc:
                             e = last_exc
 
+                    # Wrap recognized third-party exceptions (chipshouter
+                    # library raises untyped ones) into the taxonomy
+                    e = classify(e)
+
                     # Add error to catched_errors (for logging purposes)
-                    self.catched_errors.append({"position_index": position_index, "error": str(e)})
+                    self.catched_errors.append(
+                        {"position_index": position_index, "error": str(e),
+                         "type": type(e).__name__})
+
+                    if self._hook_on_error:
+                        self._hook_on_error(self, position_index,
+                                            config_index, e)
+
+                    # Campaign-level error budget: a type whose windowed
+                    # failure rate blows its budget escalates past the
+                    # local retry ladder below
+                    governor_action = None
+                    if self.error_governor is not None:
+                        governor_action = self.error_governor.record(e)
+                        if governor_action == "abort":
+                            raise ErrorBudgetExceeded(
+                                f"Error budget exceeded for {type(e).__name__} "
+                                f"(window counts: {self.error_governor.window_counts()})"
+                            ) from e
+                        if governor_action == "pause":
+                            self.progress.event(
+                                f"Error budget exceeded for {type(e).__name__}, "
+                                f"pausing {self.error_governor.pause_s:.0f}s",
+                                position_index=position_index,
+                            )
+                            time.sleep(self.error_governor.pause_s)
+
+                    # Allow a maximum of 3 retries per execution
+                    if retry_count < 3 and governor_action != "skip":
+                        retry_count += 1
+                        suspects = self._dispatch_error_handler(e)
+                        if suspects is None: # unknown error, no handler registered
+                            raise e
+
+                        # A device stays suspect across retries of this
+                        # config, so a shouter failure followed by a
+                        # target failure recovers both in parallel
+                        suspect_devices |= suspects
+                        if "pico" in suspect_devices:
+                            # Pico recovery is just a session reopen;
+                            # configure_chipshouter below reconnects
+                            self._disconnect_delay_controller()
+                            suspect_devices.discard("pico")
+                        recover_target = "target" in suspect_devices
+
+                        if recover_target:
+                            try:
+                                self.cs.disarm() # Disarm shouter to prevent glitching while flashing
+                            except Exception:
+                                pass # unresponsive shouter gets power cycled below anyway
 
-                    # Allow a maximum of 3 retries per execution
-                    if retry_count < 3:
-                        retry_count += 1
-                        if str(e) in {"No response from shouter.", "Failed to clear ChipSHOUTER faults!"}:
-                            self.cs.power_cycle_usb()
-                            self.target_serial.flush()
-                            self.reset_target() # TODO: potential errors unhandled
-                            self.configure_chipshouter(glitch_config)
+                        # Power cycle the suspects concurrently
+                        self.recover_devices(
+                            chipshouter="chipshouter" in suspect_devices,
+                            target=recover_target
+                        )
 
-                        elif str(e) in {"ChipWhisperer: reset_target timed out"}: # TODO: custom error type
+                        if recover_target:
                             # Try to power cycle and if not enough, reflash target
-                            # Increment config_results["soft_bricked"] or config_results["hard_bricked"] accordingly and go to next execution index
-                            self.cs.disarm() # Disarm shouter to prevent glitching while flashing
-                            self.power_cycle_target() # Power cycle chipwhisperer USB port
+                            # Increment num_soft_bricked or num_hard_bricked accordingly and go to next execution index
+                            self.target_serial.close() # Stop the old RX reader thread
                             self.target_serial = TargetSerial(SimpleSerial_ChipWhispererLite, self.cw.scope)
 
                             try:
                                 # Try to reset target after power cycling
                                 self.reset_target()
-                                config_results["soft_bricked"] += 1
+                                config_results["num_soft_bricked"][position_index] += 1
                                 execution_index += 1
                             except Exception as e:
                                 # If resetting still fails, reflash target and try again (hard_bricked)
-                                print("Resetting, target failed even after power cycling, reflashing target firmware")
+                                self.progress.event("Resetting, target failed even after power cycling, reflashing target firmware",
+                                                    position_index=position_index)
                                 self.cw.flash("./target-firmware/build/emfi-profiler-CW308_STM32F4.hex") # Reprogram chipwhisperer
                                 self.reset_target() # TODO: potential errors unhandled
-                                config_results["hard_bricked"] += 1
+                                config_results["num_hard_bricked"][position_index] += 1
                                 execution_index += 1
-
-                        else: # unknown error
-                            raise e
-                    else: # Limit number of errors per glitch_config and position to 3
+                            self.configure_chipshouter(glitch_config)
+                        else:
+                            # resync instead of flush: an already-arrived
+                            # reset announce would otherwise be discarded
+                            # right before reset_target scans for it
+                            self.target_serial.resync()
+                            self.reset_target() # TODO: potential errors unhandled
+                            self.configure_chipshouter(glitch_config)
+                    else: # Limit number of errors per glitch_config and position to 3 (or governor-ordered skip)
                         # Skip the rest of the executions of current glitch_config at current position
                         num_skipped = glitch_config.num_executions - execution_index
-                        config_results["num_skipped"] = num_skipped
-                        print(f"Glitch config {config_index} retries exceeded, skipping {num_skipped}")
+                        config_results["num_skipped"][position_index] += num_skipped
+                        reason = "error budget" if governor_action == "skip" else "retries exceeded"
+                        self.progress.event(
+                            f"Glitch config {config_index} {reason}, skipping {num_skipped}",
+                            position_index=position_index, config_index=config_index,
+                            skipped=num_skipped,
+                        )
                         break
 
+            config_results["effective_executions"][position_index] = execution_index
+
+        if self.trace_capture is not None:
+            # Deferred-readback batches drain during the upcoming table
+            # move (no-op in per-shot capture mode)
+            self.trace_capture.position_done()
+        self._snapshot_serial_stats(position_index)
+        if self._hook_on_position_done:
+            self._hook_on_position_done(self, position_index)
+
+    def _snapshot_serial_stats(self, position_index):
+        """
+        Record the per-position delta of the serial link-health counters
+        (TargetSerial.stats) into serial_stats_per_position, so link
+        degradation in the results JSON is attributable to positions
+        instead of vanishing into generic retry handling.
+        """
+        if getattr(self, "target_serial", None) is None:
+            return
+        stats = self.target_serial.stats
+        last = self._serial_stats_last or {}
+        delta = {key: value - last.get(key, 0) for key, value in stats.items()}
+        self._serial_stats_last = stats
+        self.serial_stats_per_position.append(
+            {"position_index": position_index, **delta})
+
     def prepare_hardware(self):
-        self.cw = ChipWhisperer()
-        self.target_serial = TargetSerial(SimpleSerial_ChipWhispererLite, self.cw.scope)
+        """
+        Bring up the bench: ChipWhisperer + target serial, ChipShouter
+        (thermal monitor started, disarmed), Pico pulse generator and
+        XYZ table. The four stacks sit on independent USB devices, so
+        their startup (USB enumeration, default_setup, the shouter's
+        ~5s reset) runs concurrently and total startup approaches the
+        slowest single device instead of the sum. _campaign_setup
+        stages the joins itself to overlap build/flash/home with
+        whatever has not finished yet.
+        """
+        self._start_hardware_init()
+        self._join_hardware_init()
+        self.start_usb_monitor()
+
+    def _start_hardware_init(self):
+        """Launch the per-stack bringup threads; _join_hardware_init
+        collects them (and re-raises their failures)."""
+        def bring_up_target():
+            self.cw = ChipWhisperer()
+            self.target_serial = TargetSerial(SimpleSerial_ChipWhispererLite, self.cw.scope)
+
+        def bring_up_shouter():
+            self.cs = ChipShouter()
+            self.cs.disarm()
+            self.cs.start_thermal_monitor()
+
+        def bring_up_pico():
+            # Pico pulse generator (held open for the campaign)
+            self._connect_delay_controller()
+
+        def bring_up_table():
+            self.table = xyzTable(debug=False)
+
+        self._hw_init = {}
+        for name, bring_up in (("target", bring_up_target),
+                               ("shouter", bring_up_shouter),
+                               ("pico", bring_up_pico),
+                               ("table", bring_up_table)):
+            failure = []
+
+            def run(bring_up=bring_up, failure=failure):
+                try:
+                    bring_up()
+                except BaseException as e:
+                    failure.append(e)
+
+            thread = threading.Thread(target=run, name=f"hw-init-{name}",
+                                      daemon=True)
+            thread.start()
+            self._hw_init[name] = (thread, failure)
+
+    def _join_hardware_init(self, names=None):
+        """Wait for the named bringup threads (all outstanding ones by
+        default) and re-raise the first failure among them."""
+        pending = getattr(self, "_hw_init", None)
+        if not pending:
+            return
+        for name in list(pending) if names is None else names:
+            entry = pending.pop(name, None)
+            if entry is None:
+                continue
+            thread, failure = entry
+            thread.join()
+            if failure:
+                raise failure[0]
+
+    # ChipWhisperer-Lite USB ids, for udev product matching (the CW is
+    # not a tty, so DEVNAME matching does not apply)
+    CWLITE_USB_ID = (0x2b3e, 0xace2)
+
+    def start_usb_monitor(self):
+        """
+        Start the udev loss monitor over the connected bench devices.
+
+        A flagged device raises DeviceLostError at the top of the next
+        execution, sending the retry ladder straight into power-cycle
+        recovery instead of burning ~30s of cascaded serial timeouts
+        first. Best-effort: without netlink access the campaign simply
+        keeps the timeout-based detection.
+        """
+        try:
+            monitor = UdevMonitor()
+            if getattr(self.cs, "_tty", None):
+                monitor.watch_tty("chipshouter", self.cs._tty)
+            monitor.watch_product("target", *self.CWLITE_USB_ID)
+            # Same fixed port _connect_delay_controller opens
+            monitor.watch_tty("pico", "/dev/ttyACM1")
+            monitor.start()
+            self.usb_monitor = monitor
+        except Exception as e:
+            print(f"USB monitor unavailable ({e}), keeping timeout-based detection")
+            self.usb_monitor = None
+
+    def prepare_benches(self, bench_configs):
+        """
+        Multi-bench variant of prepare_hardware: one ChipWhisperer +
+        TargetSerial per BenchConfig (addressed by serial number), all
+        sharing the single ChipShouter, pulse generator and table.
+
+        self.cw / self.target_serial always point at the active bench
+        (bench 0 initially, switched with activate_bench), so the rest
+        of the machinery stays bench-agnostic.
+        """
+        self.benches = []
+        for bench_config in bench_configs:
+            cw_device = ChipWhisperer(sn=bench_config.cw_serial_number)
+            self.benches.append({
+                "config": bench_config,
+                "cw": cw_device,
+                "target_serial": TargetSerial(SimpleSerial_ChipWhispererLite, cw_device.scope),
+            })
+        self._active_bench_index = 0
+        self.cw = self.benches[0]["cw"]
+        self.target_serial = self.benches[0]["target_serial"]
 
         self.cs = ChipShouter()
         self.cs.disarm()
-
-        # Setup XYZ Table
+        self.cs.start_thermal_monitor()
+        self._connect_delay_controller()
         self.table = xyzTable(debug=False)
 
-    def run_campaign(self, build=False, flash=False, home=False):
-        self.prepare_hardware()
+    def activate_bench(self, bench_index):
+        """Point self.cw / self.target_serial at the given bench."""
+        self._active_bench_index = bench_index
+        self.cw = self.benches[bench_index]["cw"]
+        self.target_serial = self.benches[bench_index]["target_serial"]
 
-        if build:
-            subprocess.run(
-                self.target_config.firmware_build_command,
-                cwd=self.target_config.firmware_build_dir,
-                check=True
-                # stdout=subprocess.DEVNULL
+    def _prepare_bench_target(self, bench, flash_path=None):
+        """
+        Reset (and optionally flash) a bench's target using only that
+        bench's own devices, never self.cw/self.target_serial — safe to
+        run on a worker thread while another bench is being shot.
+        Returns True when the target announced a reset.
+        """
+        try:
+            if flash_path:
+                # Read-back verify inside flash() skips the write when
+                # the image already matches
+                bench["cw"].flash(flash_path)
+            reset_seq = bench["target_serial"]._reset_sequence
+            for _ in range(3):
+                bench["cw"].reset_target()
+                if bench["target_serial"].read_until(reset_seq, 5000).endswith(reset_seq):
+                    return True
+            return False
+        except Exception as e:
+            self.catched_errors.append(
+                {"position_index": "bench_prep", "error": str(e),
+                 "type": type(e).__name__})
+            return False
+
+    # Marker prefix of the build tag compiled into every firmware image
+    # (ss_build_tag in simpleserial.c), answered by the 'v' control packet
+    FIRMWARE_TAG_MARKER = b"SSBUILDTAG:"
+
+    def _firmware_source_hash(self):
+        """
+        Content hash of everything that determines the firmware image.
+
+        Covers the build command (flags like AES_HW or SS_* live there)
+        and all firmware sources under the target-firmware tree -
+        payloads, simpleserial, HAL, cw-deps and the Makefiles. Runtime
+        configuration defaults are #defines in the payload sources, so
+        they are covered by the file contents.
+        """
+        source_root = os.path.dirname(
+            os.path.abspath(self.target_config.firmware_build_dir)
+        )
+        digest = hashlib.sha256()
+        digest.update(" ".join(self.target_config.firmware_build_command).encode())
+
+        paths = []
+        for dirpath, dirnames, filenames in os.walk(source_root):
+            # Object dirs only hold build outputs
+            dirnames[:] = [d for d in dirnames if not d.startswith("objdir")]
+            for name in filenames:
+                if name.endswith((".c", ".h", ".S", ".ld")) or "Makefile" in name:
+                    paths.append(os.path.join(dirpath, name))
+
+        for path in sorted(paths):
+            digest.update(os.path.relpath(path, source_root).encode())
+            with open(path, "rb") as f:
+                digest.update(f.read())
+
+        return digest.hexdigest()
+
+    def _build_firmware(self):
+        """
+        Run the firmware build unless the cached artifact is current.
+
+        The hash of the build inputs is stamped next to the image after
+        every successful build; when the stamp matches and the image
+        exists, the build (and its fixed ~45s of make/cw-deps churn) is
+        skipped entirely.
+        """
+        stamp_path = self.target_config.firmware_path + ".buildstamp"
+        source_hash = self._firmware_source_hash()
+
+        if os.path.exists(self.target_config.firmware_path):
+            try:
+                with open(stamp_path) as f:
+                    stamped = f.read().strip()
+            except OSError:
+                stamped = None
+            if stamped == source_hash:
+                print("Firmware build inputs unchanged, skipping build")
+                return
+
+        subprocess.run(
+            self.target_config.firmware_build_command,
+            cwd=self.target_config.firmware_build_dir,
+            check=True
+            # stdout=subprocess.DEVNULL
+        )
+        with open(stamp_path, "w") as f:
+            f.write(source_hash + "\n")
+
+    @staticmethod
+    def _image_build_tag(path):
+        """
+        Extract the build tag from a firmware image on disk.
+
+        Intel HEX images are decoded record by record (type 00 data
+        records are laid out sequentially by the toolchain, so simple
+        concatenation reconstructs the tag string); anything else is
+        searched as raw binary. Returns None when no tag is found.
+        """
+        try:
+            with open(path, "rb") as f:
+                raw = f.read()
+        except OSError:
+            return None
+
+        if raw.startswith(b":"):
+            decoded = bytearray()
+            for line in raw.splitlines():
+                line = line.strip()
+                if len(line) < 11 or not line.startswith(b":"):
+                    continue
+                try:
+                    record = bytes.fromhex(line[1:].decode())
+                except ValueError:
+                    continue
+                if record[3] == 0x00: # data record
+                    decoded.extend(record[4:4 + record[0]])
+            raw = bytes(decoded)
+
+        start = raw.find(CSProfiler.FIRMWARE_TAG_MARKER)
+        if start < 0:
+            return None
+        end = raw.find(b"\x00", start)
+        if end < 0:
+            return None
+        return raw[start:end]
+
+    @staticmethod
+    def _file_sha256(path):
+        digest = hashlib.sha256()
+        with open(path, "rb") as f:
+            for chunk in iter(lambda: f.read(1 << 20), b""):
+                digest.update(chunk)
+        return digest.hexdigest()
+
+    def _collect_provenance(self):
+        """
+        Snapshot of everything that defines this campaign's setup,
+        captured at campaign start: firmware identity (image hash and
+        embedded build tag), profiler version (git describe), host and
+        bench identity (ChipWhisperer serial and hub port, as resolved
+        through the USB topology cache), and the start timestamp.
+        store_results adds finished_at plus the target payload state.
+        Every field is best-effort - a bench without git or with a
+        missing image records what it can instead of failing the
+        campaign.
+        """
+        firmware = {"path": self.target_config.firmware_path}
+        try:
+            firmware["sha256"] = self._file_sha256(
+                self.target_config.firmware_path
+            )
+        except OSError:
+            pass
+        tag = self._image_build_tag(self.target_config.firmware_path)
+        if tag:
+            firmware["build_tag"] = tag.decode("ascii", "replace")
+
+        try:
+            described = subprocess.run(
+                ["git", "describe", "--always", "--dirty", "--tags"],
+                cwd=os.path.dirname(os.path.abspath(__file__)),
+                capture_output=True, text=True, timeout=5,
             )
+            profiler_git = described.stdout.strip() or None
+        except (OSError, subprocess.SubprocessError):
+            profiler_git = None
+
+        bench = {}
+        cw = getattr(self, "cw", None)
+        if cw is not None:
+            bench = {
+                "cw_serial_number": getattr(cw, "_sn", None),
+                "tty": getattr(cw, "chipwhisperer_tty", None),
+                "hub_path": getattr(cw, "_hub_path", None),
+                "hub_port": getattr(cw, "_hub_port_num", None),
+            }
+
+        return {
+            "started_at": datetime.now(timezone.utc).isoformat(),
+            "host": os.uname().nodename,
+            "firmware": firmware,
+            "profiler_git": profiler_git,
+            "bench": bench,
+        }
+
+    def _installed_firmware_matches(self):
+        """
+        Ask the target ('v' packet) whether it already runs the image at
+        `firmware_path`. False on any mismatch, missing tag, or an
+        unresponsive target, so callers always fall back to flashing.
+        """
+        expected = self._image_build_tag(self.target_config.firmware_path)
+        if expected is None:
+            return False
+        try:
+            self.target_serial.send_packet(TargetSerial.type_convert_cmd("v"), None)
+            cmd, data = self.target_serial.read_packet(timeout=500)
+        except Exception:
+            return False
+        return cmd == TargetSerial.type_convert_cmd("v") and data == expected
+
+    def _flash_firmware(self):
+        """
+        Flash `firmware_path` unless the target already reports its tag.
+
+        The serial version query takes milliseconds; only when it fails
+        or mismatches does cw.flash run (which itself falls back from
+        read-back verify to a full reprogram).
+        """
+        if self._installed_firmware_matches():
+            print("Installed firmware matches image build tag, skipping flash")
+            return
+        self.cw.flash(self.target_config.firmware_path)
+
+    def _campaign_setup(self, build, flash, home, resume_from=None):
+        # Catch bad grids and bad configs before any hardware arms
+        self.validate_positions()
+        self.validate_glitch_configs()
+
+        # Staged hardware bringup: the device stacks enumerate
+        # concurrently while the build (a pure subprocess) runs; flash
+        # joins just the ChipWhisperer it programs through and homing
+        # joins just the table, so each optional step starts as soon as
+        # its own device is up
+        self._start_hardware_init()
+        if build:
+            self._build_firmware()
+        self._join_hardware_init(("target",))
         if flash:
-            self.cw.flash(self.target_config.firmware_path)
+            self._flash_firmware()
+        self._join_hardware_init(("table",))
         if home:
-            self.table.home_all()
+            # Verified against the persisted calibration when
+            # home_reference is set; full home_all() otherwise
+            self.home_table()
+        self._join_hardware_init()
+        self.start_usb_monitor()
 
-        # Reset catched_errors and results
-        self.catched_errors = []
-        self.results = copy.deepcopy(self._results)
+        if resume_from:
+            # Reload counters, planned orders and the scan cursor; the
+            # position iterator fast-forwards in _scan_positions
+            self._load_checkpoint(resume_from)
+        else:
+            # Reset catched_errors and results (fresh zeroed counter
+            # arrays, memory-mapped to the campaign's xy_map .npy; the
+            # template in self._results stays untouched)
+            self.catched_errors = ErrorLog()
+            self._open_result_stream()
+            self._xy_map_path = f"results/xy_map_{self._campaign_id}.npy"
+            self._counters, self._effective = self._build_counter_arrays(
+                mmap_path=self._xy_map_path
+            )
+            self.results = self._bind_result_views(self._counters, self._effective)
+            self._scan_cursor = 0
+            self._resume_skip = 0
+            # After build/flash, so the hashed image is the one on the
+            # target; resumes keep the checkpointed block (original
+            # started_at included)
+            self._provenance = self._collect_provenance()
 
-        # Store partial results on Ctrl+c
+        # Checkpoint-and-exit on Ctrl+C (see ctrl_c_signal_handler)
+        self._interrupt_requested = False
         signal.signal(signal.SIGINT, self.ctrl_c_signal_handler)
 
+        if not resume_from:
+            # Group by probe and sweep voltage monotonically so consecutive
+            # configs share as much ChipShouter state as possible (a resume
+            # keeps the checkpointed order so the cursor stays aligned)
+            self.config_order = self.plan_config_order()
+
+        return bool(resume_from)
+
+    def _scan_positions(self, position_indices, config_indices=None):
+        """Visit the given position indices in order (move, then test),
+        optionally restricted to a subset of glitch configs."""
+        config_sequence = list(config_indices) if config_indices is not None else self.config_order
+        first_glitch_config = self.glitch_configs[config_sequence[0]]
+
+        sequence = list(position_indices)
+        pending_move = None
         prev_y = 0
-        stepsize_y = 1 # TODO temp workaround, all of this shit should not be needed if xyztable library was properly written
+        stepsize_y = 1 # row-change threshold for the legacy settle fallback
+        for sequence_pos, position_index in enumerate(sequence):
+            # Fast-forward over scans a resumed checkpoint already covers
+            if self._resume_skip > 0:
+                self._resume_skip -= 1
+                continue
+            position = self.positions[position_index]
+            # Move to position (unless already issued below during the
+            # previous position's bookkeeping); ChipShouter/Delay-
+            # Controller prep for the first glitch config runs
+            # concurrently with travel
+            x, y, z = position
+            prepared = self._advance_position(position_index, position,
+                                              first_glitch_config, move=pending_move)
+            pending_move = None
+            self._wait_table_settled(row_changed=(prev_y - y >= stepsize_y))
+            prev_y = y
+
+            # Test position
+            self.test_position(position_index, first_config_prepared=prepared,
+                               config_indices=config_sequence)
+
+            # Issue the next move now: the bookkeeping tail below
+            # (checkpoint write, stream flush, control poll) is pure
+            # host CPU/disk and runs during stage travel
+            if sequence_pos + 1 < len(sequence):
+                pending_move = self._start_position_move(
+                    self.positions[sequence[sequence_pos + 1]]
+                )
+            self._scan_cursor += 1
+            self._maybe_checkpoint()
+            self._poll_control()
+
+    def run_campaign(self, build=False, flash=False, home=False, config_major=False,
+                     resume_from=None):
+        """
+        Run the full campaign over self.positions.
+
+        `config_major` selects the traversal order: False nests configs
+        inside positions (right when movement is expensive and
+        reconfiguration cheap), True runs one config over the whole
+        grid at a time (few positions x many configs, amortizing
+        probe/voltage changes across the grid), and "auto" lets the
+        cost model pick - estimate_traversal_cost() on the planned
+        config schedule, both ways. The numpy counter arrays are
+        order-agnostic, so results are identical either way.
+
+        Pass resume_from=<checkpoint path> to continue an interrupted
+        campaign: counters and the planned visit orders are reloaded from
+        the checkpoint (written periodically during scanning and on
+        Ctrl+C/errors), already-scanned positions are skipped, and results
+        keep appending to the same stream log. Pass home=True as well so
+        the table reference is re-established after a power loss.
+        """
+        resumed = self._campaign_setup(build, flash, home, resume_from=resume_from)
+
+        if config_major == "auto":
+            # Planner hint: cheaper traversal according to the cost model
+            config_major = (self.estimate_traversal_cost(config_major=True)
+                            < self.estimate_traversal_cost(config_major=False))
+            self.progress.event(
+                f"Cost model picked "
+                f"{'config' if config_major else 'position'}-major traversal"
+            )
+
+        if not resumed:
+            # Reorder the visit sequence to minimize stage travel; results
+            # are still booked under the original position_index (a resume
+            # keeps the checkpointed order so the cursor stays aligned)
+            self.position_order = self.plan_position_order()
+            # Initial checkpoint: gives a following visualizer the campaign
+            # header (positions, configs, stream path) before the first
+            # interval checkpoint lands
+            self._write_checkpoint()
+
+        try:
+            # Each probe's work runs to completion before the next coil
+            # swap; with a single probe this degenerates to the plain
+            # traversal with no prompt
+            probe_groups = self.probe_groups()
+            for probe, group_indices in probe_groups:
+                if len(probe_groups) > 1:
+                    self._await_probe_swap(probe)
+                if config_major:
+                    # One config at a time over the whole grid: pays the
+                    # config schedule once but travels once per config.
+                    # estimate_traversal_cost() compares both traversals.
+                    for config_index in group_indices:
+                        self._scan_positions(self.position_order,
+                                             config_indices=[config_index])
+                else:
+                    self._scan_positions(self.position_order,
+                                         config_indices=group_indices)
+
+        except CampaignInterrupted:
+            return self._interrupt_exit()
+        # Global last resort error handling (store partial results and exit)
+        except Exception as e:
+            self.catched_errors.append(
+                {"position_index": "unknown", "error": str(e),
+                 "type": type(e).__name__})
+
+            # Store partial results
+            print("An error occurred:", file=sys.stderr)
+            print("TRYING TO SAVE PARTIAL RESULTS!")
+            self._write_checkpoint()
+            self._close_result_stream()
+            self.store_results(self.results, partial=True)
+
+            # Print full traceback to stderr
+            traceback.print_exc()
+            return -1
+
+
+        # Finish campaign
+        self.cs.disarm()
+        self._disconnect_delay_controller()
+        self._close_result_stream()
+        self.store_results(self.results, partial=False)
+        self.progress.finish()
+        print("Phase timing summary:")
+        print(self.timing.summary_table())
+        return 0
+
+    def run_workplan(self, items, build=False, flash=False, home=False):
+        """
+        Run an explicit list of (position_index, config_index) work
+        items through the standard campaign machinery - setup, overlapped
+        movement, test_position, checkpointing and teardown - in the
+        given order. Used by the replay engine (replay.py); also handy
+        for hand-picked confirmation runs.
+
+        Results have run_campaign's shape; position_order records the
+        realized visit order.
+        """
+        self._campaign_setup(build, flash, home)
+        self.position_order = []
+        self._write_checkpoint()
+
+        visited = set()
         try:
-            # Iterate over positions
-            for (position_index, position) in enumerate(self.positions):
-                # Move to position
-                x, y, z = position
-                self.table.move_absolute(x, y, z)
-                if(prev_y - y >= stepsize_y):
-                    print("changing pos")
-                    time.sleep(5)
-                prev_y = y
-
-                # Test position
-                self.test_position(position_index)
+            for position_index, config_index in items:
+                glitch_config = self.glitch_configs[config_index]
+                prepared = self._advance_position(
+                    position_index, self.positions[position_index], glitch_config
+                )
+                self.test_position(position_index, first_config_prepared=prepared,
+                                   config_indices=[config_index])
+                if position_index not in visited:
+                    visited.add(position_index)
+                    self.position_order.append(position_index)
+                self._scan_cursor += 1
+                self._maybe_checkpoint()
+                self._poll_control()
+
+        except CampaignInterrupted:
+            return self._interrupt_exit()
+        # Global last resort error handling (store partial results and exit)
+        except Exception as e:
+            self.catched_errors.append(
+                {"position_index": "unknown", "error": str(e),
+                 "type": type(e).__name__})
+
+            # Store partial results
+            print("An error occurred:", file=sys.stderr)
+            print("TRYING TO SAVE PARTIAL RESULTS!")
+            self._write_checkpoint()
+            self._close_result_stream()
+            self.store_results(self.results, partial=True)
+
+            # Print full traceback to stderr
+            traceback.print_exc()
+            return -1
+
+        # Finish campaign
+        self.cs.disarm()
+        self._disconnect_delay_controller()
+        self._close_result_stream()
+        self.store_results(self.results, partial=False)
+        self.progress.finish()
+        print("Phase timing summary:")
+        print(self.timing.summary_table())
+        return 0
+
+    def run_campaign_prioritized(self, build=False, flash=False, home=False,
+                                 movement_weight=0.5, adjacency_boost=3.0,
+                                 dead_decay=0.25, radius=None, resume_from=None,
+                                 seed_regions=None):
+        """
+        Campaign mode driven by an online priority queue instead of a
+        fixed visit order (see scheduler.PriorityScheduler).
+
+        Every (position, glitch config) pair is a work item. After each
+        batch the observed fault count feeds back into the queue:
+        faults boost the surrounding neighborhood so clusters are chased
+        immediately, quiet batches decay it, and the travel distance
+        from the current position is part of the priority so the stage
+        is not thrashed. The queue and interest map are checkpointed, so
+        resume_from restores the scheduler exactly where it stopped.
+
+        The pops are thermal-aware: each batch's observed coil heating
+        feeds CSUtils.HeatingModel, and items whose config is predicted
+        to overshoot the remaining thermal headroom are deferred in
+        favor of pending low-energy work, so the 10-second cooldown
+        sleeps of the fixed-order runners become scheduled shots here.
+        The campaign only blocks on cooldown once every pending item
+        would overshoot.
+
+        Results are identical in shape to run_campaign's; position_order
+        in the output records the realized visit order.
+
+        seed_regions takes a fault_clusters.region_stats list (e.g.
+        clustered from a previous campaign on the same die) and
+        pre-boosts the interest map so the queue opens inside the known
+        regions; resumed campaigns ignore it, their interest map is
+        restored from the checkpoint.
+        """
+        resumed = self._campaign_setup(build, flash, home, resume_from=resume_from)
+
+        if resumed and getattr(self, "_checkpoint_scheduler_state", None):
+            self._scheduler = PriorityScheduler.from_state(
+                self.positions, self._checkpoint_scheduler_state
+            )
+        else:
+            self._scheduler = PriorityScheduler(
+                self.positions, list(range(len(self.glitch_configs))),
+                movement_weight=movement_weight,
+                adjacency_boost=adjacency_boost,
+                dead_decay=dead_decay, radius=radius,
+            )
+            if seed_regions:
+                self._scheduler.seed_regions(seed_regions)
+            self.position_order = []
+            self._write_checkpoint()
+
+        current_position = None
+        visited = set(self.position_order)
+        try:
+            while True:
+                # Thermal-aware pop: items whose predicted heating
+                # overshoots the remaining coil headroom are deferred,
+                # so cooldown windows run the pool's low-energy
+                # remainder instead of idling (see CSUtils.HeatingModel)
+                headroom = self.cs.thermal_headroom()
+                config_heat = None
+                if headroom is not None:
+                    config_heat = {
+                        index: self.cs.heating_model.predict(
+                            config.voltage, config.pulse_width,
+                            config.pulse_repeats)
+                        for index, config in enumerate(self.glitch_configs)
+                    }
+                item = self._scheduler.pop(current_position,
+                                           heat_limit=headroom,
+                                           config_heat=config_heat)
+                if item is None:
+                    if not len(self._scheduler):
+                        break
+                    # Everything pending overshoots: only now block on
+                    # cooldown, as the fixed-order runners always do
+                    self.progress.event("Chipshouter Temp too high, waiting...")
+                    while not self.cs.thermal_ready():
+                        time.sleep(1)
+                    continue
+                position_index, config_index = item
+                position = self.positions[position_index]
+                glitch_config = self.glitch_configs[config_index]
+
+                prepared = self._advance_position(position_index, position, glitch_config)
+                self.test_position(position_index, first_config_prepared=prepared,
+                                   config_indices=[config_index])
+                current_position = position
+
+                # Feed the batch's observed temperature rise back into
+                # the heating model (headroom shrinks as the coil heats)
+                headroom_after = self.cs.thermal_headroom()
+                if headroom is not None and headroom_after is not None:
+                    self.cs.heating_model.observe(
+                        glitch_config.voltage, glitch_config.pulse_width,
+                        glitch_config.pulse_repeats,
+                        headroom - headroom_after)
+                if position_index not in visited:
+                    visited.add(position_index)
+                    self.position_order.append(position_index)
+
+                faults = int(self.results[config_index]["num_faults"][position_index])
+                executions = int(self.results[config_index]["effective_executions"][position_index])
+                self._scheduler.record_result(
+                    position_index, config_index, faults,
+                    executions or glitch_config.num_executions,
+                )
+                self._scan_cursor += 1
+                self._maybe_checkpoint()
+                self._poll_control()
+
+        except CampaignInterrupted:
+            return self._interrupt_exit()
+        # Global last resort error handling (store partial results and exit)
+        except Exception as e:
+            self.catched_errors.append(
+                {"position_index": "unknown", "error": str(e),
+                 "type": type(e).__name__})
+
+            # Store partial results
+            print("An error occurred:", file=sys.stderr)
+            print("TRYING TO SAVE PARTIAL RESULTS!")
+            self._write_checkpoint()
+            self._close_result_stream()
+            self.store_results(self.results, partial=True)
+
+            # Print full traceback to stderr
+            traceback.print_exc()
+            return -1
+
+        # Finish campaign
+        self.cs.disarm()
+        self._disconnect_delay_controller()
+        self._close_result_stream()
+        self.store_results(self.results, partial=False)
+        self.progress.finish()
+        print("Phase timing summary:")
+        print(self.timing.summary_table())
+        return 0
+
+    def run_campaign_sweep(self, sweep, chunk_size=16, build=False, flash=False, home=False):
+        """
+        Run a lazily generated parameter sweep (config_classes.SweepSpec
+        or any GlitchConfig iterable) without materializing every
+        combination up front.
+
+        Construct the profiler with glitch_configs=[]; configs are drawn
+        from the sweep in its reconfiguration-friendly order and
+        appended in chunks of chunk_size through the incremental counter
+        growth (_append_glitch_configs), so result storage scales with
+        the combinations actually reached - a 10k-combination sweep
+        interrupted at combination 900 never allocated the other 9100.
+        Traversal is config-major (one config over the whole grid, then
+        the next), which is also how sweeps are analyzed.
+        """
+        self._campaign_setup(build, flash, home)
+        self.position_order = self.plan_position_order()
+        self._write_checkpoint()
+
+        generator = iter(sweep)
+        try:
+            while True:
+                chunk = list(itertools.islice(generator, chunk_size))
+                if not chunk:
+                    break
+                for config_index in self._append_glitch_configs(chunk):
+                    self._scan_positions(self.position_order,
+                                         config_indices=[config_index])
+
+        except CampaignInterrupted:
+            return self._interrupt_exit()
+        # Global last resort error handling (store partial results and exit)
+        except Exception as e:
+            self.catched_errors.append(
+                {"position_index": "unknown", "error": str(e),
+                 "type": type(e).__name__})
+
+            # Store partial results
+            print("An error occurred:", file=sys.stderr)
+            print("TRYING TO SAVE PARTIAL RESULTS!")
+            self._write_checkpoint()
+            self._close_result_stream()
+            self.store_results(self.results, partial=True)
+
+            # Print full traceback to stderr
+            traceback.print_exc()
+            return -1
+
+        # Finish campaign
+        self.cs.disarm()
+        self._disconnect_delay_controller()
+        self._close_result_stream()
+        self.store_results(self.results, partial=False)
+        self.progress.finish()
+        print("Phase timing summary:")
+        print(self.timing.summary_table())
+        return 0
+
+    def partition_position_order(self, order, num_shards):
+        """Split a planned visit order into num_shards contiguous,
+        near-equal slices; contiguous so each slice keeps the travel
+        optimization of the plan."""
+        shards = []
+        base, extra = divmod(len(order), num_shards)
+        start = 0
+        for shard_index in range(num_shards):
+            size = base + (1 if shard_index < extra else 0)
+            shards.append(order[start:start + size])
+            start += size
+        return shards
+
+    def run_campaign_multibench(self, bench_configs, build=False, flash=False, home=False):
+        """
+        Run the campaign with the position list partitioned across
+        several ChipWhisperer/target benches under the shared gantry.
+
+        Each bench scans a contiguous slice of the planned visit order,
+        translated by the bench's table offset; results keep their
+        original position indices so the counter block stays one
+        coherent grid. Only one bench is ever under the probe, but while
+        it is being shot the next bench's target is reset (and flashed,
+        with flash=True) on a worker thread, so switching benches costs
+        no target bring-up. Checkpoint resume is not supported here.
+
+        Parameters
+        ----------
+        bench_configs : list[BenchConfig]
+            One entry per bench (serial number + table offset).
+        build, flash, home : bool, optional
+            Same as run_campaign; flash covers every bench (bench 0 in
+            setup, the others via the overlapped prep).
+        """
+        # _campaign_setup's prepare_hardware call builds the benches;
+        # build/flash then apply to bench 0, already the active one
+        original_prepare_hardware = self.prepare_hardware
+        self.prepare_hardware = lambda: self.prepare_benches(bench_configs)
+        try:
+            self._campaign_setup(build, flash, home)
+        finally:
+            self.prepare_hardware = original_prepare_hardware
+
+        self.position_order = self.plan_position_order()
+        self._write_checkpoint()
+        shards = self.partition_position_order(self.position_order, len(self.benches))
+
+        base_positions = self.positions
+        try:
+            prep_thread = None
+            for bench_index, shard in enumerate(shards):
+                if not shard:
+                    continue
+                if prep_thread is not None:
+                    # The prep ran during the previous bench's shard;
+                    # normally long finished by now
+                    prep_thread.join()
+                    prep_thread = None
+                self.activate_bench(bench_index)
+
+                if bench_index + 1 < len(shards) and shards[bench_index + 1]:
+                    prep_thread = threading.Thread(
+                        target=self._prepare_bench_target,
+                        args=(self.benches[bench_index + 1],
+                              self.target_config.firmware_path if flash else None),
+                        name=f"bench-prep-{bench_index + 1}",
+                        daemon=True,
+                    )
+                    prep_thread.start()
+
+                bench_config = self.benches[bench_index]["config"]
+                offset = (bench_config.offset_x, bench_config.offset_y, bench_config.offset_z)
+                if any(offset):
+                    self.positions = [
+                        (x + offset[0], y + offset[1], z + offset[2])
+                        for x, y, z in base_positions
+                    ]
+                else:
+                    self.positions = base_positions
+                self._scan_positions(shard)
 
+        except CampaignInterrupted:
+            return self._interrupt_exit()
         # Global last resort error handling (store partial results and exit)
         except Exception as e:
-            self.catched_errors.append({"position_index": "unknown", "error": str(e)})
+            self.catched_errors.append(
+                {"position_index": "unknown", "error": str(e),
+                 "type": type(e).__name__})
 
             # Store partial results
             print("An error occurred:", file=sys.stderr)
             print("TRYING TO SAVE PARTIAL RESULTS!")
+            self._write_checkpoint()
+            self._close_result_stream()
             self.store_results(self.results, partial=True)
 
             # Print full traceback to stderr
             traceback.print_exc()
             return -1
+        finally:
+            self.positions = base_positions
+
+        # Finish campaign
+        self.cs.disarm()
+        self._disconnect_delay_controller()
+        self._close_result_stream()
+        self.store_results(self.results, partial=False)
+        self.progress.finish()
+        print("Phase timing summary:")
+        print(self.timing.summary_table())
+        return 0
+
+    def _append_positions(self, new_positions, depth):
+        """
+        Append refinement positions and grow every per-position result
+        counter accordingly.
+
+        Returns
+        -------
+        list[int]
+            The indices assigned to the new positions.
+        """
+        start = self.num_positions
+        self.positions = list(self.positions) + list(new_positions)
+        self.num_positions = len(self.positions)
+        self.position_depths.extend([depth] * len(new_positions))
+
+        # Grow the counter arrays along the position axis (keeping the
+        # existing counts) and rebind the dict-style views; a
+        # memory-mapped block is rewritten at the larger shape
+        pad_counters, pad_effective = self._build_counter_arrays(len(new_positions))
+        grown = np.concatenate([np.asarray(self._counters), pad_counters], axis=1)
+        if self._xy_map_path and isinstance(self._counters, np.memmap):
+            self._counters = np.lib.format.open_memmap(
+                self._xy_map_path, mode="w+", dtype=np.uint32, shape=grown.shape
+            )
+            self._counters[:] = grown
+        else:
+            self._counters = grown
+        self._effective = np.concatenate([self._effective, pad_effective], axis=1)
+        self.results = self._bind_result_views(self._counters, self._effective)
+
+        return list(range(start, self.num_positions))
+
+    def _hot_positions(self, indices, fault_threshold, reset_threshold):
+        """Indices (from the given ones) whose fault/reset counters, summed
+        over all glitch configs, reach the thresholds."""
+        hot = []
+        for index in indices:
+            faults = sum(cr["num_faults"][index] for cr in self.results)
+            resets = sum(cr["num_resets"][index] for cr in self.results)
+            if faults >= fault_threshold or (
+                reset_threshold is not None and resets >= reset_threshold
+            ):
+                hot.append(index)
+        return hot
+
+    def _refinement_positions(self, hot_indices, step):
+        """3x3 sub-grid at `step` spacing around each hot position,
+        deduplicated against positions already in the scan."""
+        seen = {
+            tuple(round(v, 6) for v in position) for position in self.positions
+        }
+        new_positions = []
+        for index in hot_indices:
+            x0, y0, z0 = self.positions[index]
+            for dy in (-step, 0, step):
+                for dx in (-step, 0, step):
+                    position = (x0 + dx, y0 + dy, z0)
+                    key = tuple(round(v, 6) for v in position)
+                    if key not in seen:
+                        seen.add(key)
+                        new_positions.append(position)
+        return new_positions
+
+    def run_adaptive_campaign(self, coarse_step, min_step, fault_threshold=1,
+                              reset_threshold=None, build=False, flash=False, home=False):
+        """
+        Coarse-to-fine campaign: scan self.positions as the coarse grid,
+        then repeatedly add finer sub-grids around productive positions.
+
+        Dense uniform grids waste most of their time on die area that
+        yields nothing. After each scan level, positions whose summed
+        num_faults (or num_resets) counters reach the thresholds get a
+        3x3 neighborhood at half the previous step appended, fed through
+        the same test_position machinery, until the step would drop
+        below min_step or no position qualifies. Refined positions are
+        regular entries in positions/results; their level is recorded in
+        position_depths (stored in the results JSON).
+
+        Parameters
+        ----------
+        coarse_step : float
+            Spacing of the initial grid in self.positions.
+        min_step : float
+            Minimum sub-grid spacing; refinement stops below this.
+        fault_threshold : int, optional
+            Summed num_faults count that marks a position for refinement.
+        reset_threshold : int, optional
+            Summed num_resets count that marks a position for refinement.
+            None (default) disables refining on resets.
+        build, flash, home : bool, optional
+            Same as run_campaign.
+        """
+        self._campaign_setup(build, flash, home)
+
+        pending = list(range(self.num_positions))
+        step = coarse_step
+        depth = 0
+        self.position_order = []
 
+        try:
+            while pending:
+                batch_order = self.plan_position_order(pending)
+                self.position_order.extend(batch_order)
+                self._scan_positions(batch_order)
+
+                step /= 2.0
+                if step < min_step:
+                    break
+
+                hot = self._hot_positions(pending, fault_threshold, reset_threshold)
+                new_positions = self._refinement_positions(hot, step)
+                if not new_positions:
+                    break
+
+                depth += 1
+                print(f"Refinement depth {depth}: {len(hot)} hot positions, {len(new_positions)} new positions at step {step}")
+                pending = self._append_positions(new_positions, depth)
+
+        except CampaignInterrupted:
+            return self._interrupt_exit()
+        # Global last resort error handling (store partial results and exit)
+        except Exception as e:
+            self.catched_errors.append(
+                {"position_index": "unknown", "error": str(e),
+                 "type": type(e).__name__})
+
+            # Store partial results
+            print("An error occurred:", file=sys.stderr)
+            print("TRYING TO SAVE PARTIAL RESULTS!")
+            self._write_checkpoint()
+            self._close_result_stream()
+            self.store_results(self.results, partial=True)
+
+            # Print full traceback to stderr
+            traceback.print_exc()
+            return -1
 
         # Finish campaign
         self.cs.disarm()
+        self._disconnect_delay_controller()
+        self._close_result_stream()
         self.store_results(self.results, partial=False)
-        return 0
\ No newline at end of file
+        self.progress.finish()
+        print("Phase timing summary:")
+        print(self.timing.summary_table())
+        return 0
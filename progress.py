@@ -0,0 +1,107 @@
+"""
+Rate-limited progress display with an optional structured log stream.
+
+A print per execution turns terminal I/O into a real fraction of loop
+time at high shot rates (worse over SSH), and the output cannot be
+parsed by anything. ProgressReporter aggregates instead: updates from
+the hot path only bump counters and cheap fields, and the single
+status line is redrawn at most ~5 Hz. Events (recovery, early stops)
+break the line and are printed normally so they stay in the scrollback.
+
+With a structured path set, every event plus a rate-limited snapshot of
+the status fields is appended as one JSON object per line, giving
+machines a stable alternative to scraping the console.
+"""
+
+import json
+import sys
+import time
+
+
+class ProgressReporter:
+    # Minimum seconds between status-line redraws (~5 Hz)
+    MIN_INTERVAL_S = 0.2
+
+    def __init__(self, stream=None, structured_path=None):
+        self._out = stream if stream is not None else sys.stdout
+        self._fields = {}
+        self._counts = {}
+        self._line_len = 0
+        self._last_render = 0.0
+        # Shots/sec over the last render interval
+        self._updates_since = 0
+        self._last_rate_time = time.monotonic()
+        self._rate = 0.0
+        self._structured = open(structured_path, "a") if structured_path else None
+
+    def update(self, counts=None, **fields):
+        """Hot-path update: merge status fields, bump aggregate counts,
+        redraw only when the render interval has passed."""
+        self._fields.update(fields)
+        if counts:
+            for key, value in counts.items():
+                self._counts[key] = self._counts.get(key, 0) + value
+        self._updates_since += 1
+
+        now = time.monotonic()
+        if now - self._last_render >= self.MIN_INTERVAL_S:
+            self._render(now)
+
+    def event(self, message, **data):
+        """Out-of-band message (recovery, early stop, ...): breaks the
+        status line so it survives in the scrollback, and is always
+        written to the structured stream."""
+        self._clear_line()
+        print(message, file=self._out)
+        self._write_structured({"type": "event", "message": message, **data})
+        # Redraw the status line under the event immediately
+        if self._fields or self._counts:
+            self._render(time.monotonic())
+
+    def finish(self):
+        """Terminate the status line and close the structured stream."""
+        if self._line_len:
+            self._out.write("\n")
+            self._out.flush()
+            self._line_len = 0
+        if self._structured is not None:
+            self._structured.close()
+            self._structured = None
+
+    def _render(self, now):
+        interval = now - self._last_rate_time
+        if interval > 0:
+            self._rate = self._updates_since / interval
+        self._updates_since = 0
+        self._last_rate_time = now
+        self._last_render = now
+
+        parts = [f"{key} {value}" for key, value in self._fields.items()]
+        nonzero = " ".join(f"{key}:{count}" for key, count in
+                           self._counts.items() if count)
+        if nonzero:
+            parts.append(nonzero)
+        parts.append(f"{self._rate:.0f}/s")
+        line = " | ".join(parts)
+
+        # Overwrite in place, padding out the previous line's remainder
+        pad = max(self._line_len - len(line), 0)
+        self._out.write("\r" + line + " " * pad)
+        self._out.flush()
+        self._line_len = len(line)
+
+        self._write_structured({"type": "progress", **self._fields,
+                                "counts": dict(self._counts),
+                                "rate_per_s": round(self._rate, 1)})
+
+    def _clear_line(self):
+        if self._line_len:
+            self._out.write("\r" + " " * self._line_len + "\r")
+            self._line_len = 0
+
+    def _write_structured(self, record):
+        if self._structured is None:
+            return
+        record["ts"] = round(time.time(), 3)
+        self._structured.write(json.dumps(record) + "\n")
+        self._structured.flush()
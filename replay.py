@@ -0,0 +1,219 @@
+"""
+Replay engine: re-execute selected points from a results file.
+
+Confirming an interesting fault used to mean hand-writing a mini
+campaign with the coordinates and GlitchConfig copied out of the JSON.
+The replay engine does that reconstruction: given a results file and a
+filter (result categories, a position list, specific configs), it
+rebuilds the matching positions and GlitchConfig objects, optionally
+scales the execution count, and runs them through the normal
+test_position machinery. The new results carry a replay_of section
+linking every replayed point back to the source campaign, so
+confirmation runs stay connected to what they confirm.
+
+From code:
+
+    profiler, rc = replay_campaign(
+        "results/results_12.json", target_config,
+        categories=("faults",), scale=4, flash=True,
+    )
+
+Or as a command (the target config is reduced to the firmware image):
+
+    python3 -m <package>.replay results/results_12.json \\
+        --firmware target-firmware/build/emfi-profiler-CW308_STM32F4.hex \\
+        [--category faults] [--scale N] [--executions N] [--flash]
+"""
+
+import os
+import sys
+from dataclasses import fields
+
+from .analysis_runner import load_results_file
+from .config_classes import GlitchConfig, TargetConfig
+from .profile_target import CSProfiler
+
+_GLITCH_FIELDS = tuple(field.name for field in fields(GlitchConfig))
+
+
+def select_points(results, categories=("faults",), position_indices=None,
+                  config_indices=None):
+    """
+    (position_index, config_index) pairs in the source campaign whose
+    counters show at least one result in the given categories,
+    optionally restricted to source position/config index subsets.
+    """
+    if position_indices is not None:
+        position_indices = set(position_indices)
+    points = []
+    num_positions = len(results["positions"])
+    for config_index, cfg in enumerate(results["glitch_configs"]):
+        if config_indices is not None and config_index not in config_indices:
+            continue
+        counters = [cfg.get("results", {}).get(f"num_{category}")
+                    for category in categories]
+        for position_index in range(num_positions):
+            if position_indices is not None and position_index not in position_indices:
+                continue
+            if any(isinstance(counter, list) and position_index < len(counter)
+                   and counter[position_index] > 0 for counter in counters):
+                points.append((position_index, config_index))
+    return points
+
+
+def build_replay(results, points, scale=1.0, num_executions=None):
+    """
+    Reconstruct the campaign inputs for a point list.
+
+    Returns (positions, glitch_configs, plan, provenance): the deduped
+    position/config lists for the CSProfiler constructor, the work plan
+    in the new indexing, and the provenance mapping back to the source
+    indices. num_executions overrides the per-config count outright,
+    scale multiplies it (a confirmation run usually wants more samples
+    than the scan that found the point).
+    """
+    position_map, config_map = {}, {}
+    positions, glitch_configs, plan = [], [], []
+    for source_position, source_config in points:
+        if source_position not in position_map:
+            position_map[source_position] = len(positions)
+            positions.append(tuple(results["positions"][source_position]))
+        if source_config not in config_map:
+            source = results["glitch_configs"][source_config]
+            cfg = GlitchConfig(**{field: source[field]
+                                  for field in _GLITCH_FIELDS if field in source})
+            if num_executions is not None:
+                cfg.num_executions = num_executions
+            else:
+                cfg.num_executions = max(1, round(cfg.num_executions * scale))
+            config_map[source_config] = len(glitch_configs)
+            glitch_configs.append(cfg)
+        plan.append((position_map[source_position], config_map[source_config]))
+
+    provenance = {
+        "points": [
+            {
+                "source_position_index": source_position,
+                "source_config_index": source_config,
+                "position_index": position_map[source_position],
+                "config_index": config_map[source_config],
+            }
+            for source_position, source_config in points
+        ],
+    }
+    return positions, glitch_configs, plan, provenance
+
+
+def verify_setup(results, target_config):
+    """
+    Check the current setup against the source campaign's provenance
+    block before replaying.
+
+    A replay against a different firmware image measures a different
+    thing without anyone noticing; the image hash mismatch raises. The
+    softer identity fields (profiler version, bench) only warn - they
+    change legitimately between sessions. Source results without a
+    provenance block (pre-provenance campaigns) are let through with a
+    note.
+    """
+    provenance = results.get("provenance")
+    if not provenance:
+        print("Replay: source results carry no provenance block, "
+              "cannot verify setup")
+        return
+    source_sha = provenance.get("firmware", {}).get("sha256")
+    if source_sha:
+        try:
+            current_sha = CSProfiler._file_sha256(target_config.firmware_path)
+        except OSError:
+            current_sha = None
+        if current_sha != source_sha:
+            raise ValueError(
+                f"Replay setup mismatch: firmware image "
+                f"{target_config.firmware_path} does not hash to the "
+                f"source campaign's ({source_sha[:12]}…); pass "
+                f"verify=False to replay against different firmware"
+            )
+    source_host = provenance.get("host")
+    if source_host and source_host != os.uname().nodename:
+        print(f"Replay: source campaign ran on host {source_host}, "
+              f"bench identity may differ")
+
+
+def replay_campaign(results_path, target_config, categories=("faults",),
+                    position_indices=None, config_indices=None,
+                    scale=1.0, num_executions=None,
+                    build=False, flash=False, home=False, verify=True):
+    """
+    Re-execute the filtered points of a results file on hardware.
+
+    Returns (profiler, returncode); the stored results carry the
+    replay_of provenance section. With verify (default), the firmware
+    image is checked against the source campaign's provenance hash
+    before any hardware moves - unless build is requested, in which
+    case the image is about to be regenerated and the check would race
+    it.
+    """
+    results = load_results_file(results_path)
+    if verify and not build:
+        verify_setup(results, target_config)
+    points = select_points(results, categories, position_indices, config_indices)
+    if not points:
+        raise ValueError(
+            f"{results_path}: no points match categories {tuple(categories)}"
+        )
+
+    positions, glitch_configs, plan, provenance = build_replay(
+        results, points, scale=scale, num_executions=num_executions
+    )
+    provenance["source_results"] = results_path
+
+    profiler = CSProfiler(target_config, positions, glitch_configs)
+    profiler.replay_provenance = provenance
+    returncode = profiler.run_workplan(plan, build=build, flash=flash, home=home)
+    return profiler, returncode
+
+
+def main():
+    args = sys.argv[1:]
+
+    def take(flag, cast=str, default=None):
+        if flag in args:
+            index = args.index(flag)
+            value = cast(args[index + 1])
+            del args[index:index + 2]
+            return value
+        return default
+
+    firmware = take("--firmware")
+    categories = tuple((take("--category", default="faults")).split(","))
+    scale = take("--scale", float, 1.0)
+    num_executions = take("--executions", int)
+    flash = "--flash" in args
+    if flash:
+        args.remove("--flash")
+    verify = "--no-verify" not in args
+    if not verify:
+        args.remove("--no-verify")
+
+    if len(args) != 1 or firmware is None:
+        print("usage: python3 -m <package>.replay <results file> --firmware <hex> "
+              "[--category faults[,resets]] [--scale N] [--executions N] [--flash]"
+              " [--no-verify]")
+        return 1
+
+    target_config = TargetConfig(
+        firmware_build_dir="target-firmware",
+        firmware_build_command=["true"],  # replays never rebuild
+        firmware_path=firmware,
+    )
+    _, returncode = replay_campaign(
+        args[0], target_config, categories=categories,
+        scale=scale, num_executions=num_executions, flash=flash,
+        verify=verify,
+    )
+    return returncode
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,172 @@
+"""
+Regression comparison between two campaign sets.
+
+After a firmware or setup change we re-run the reference campaigns and
+compare fault maps by eye - slow and blind to marginal shifts. This
+tool aligns the two sets on (position coordinates, glitch parameters),
+treats each side's per-region counts as binomial samples, and ranks the
+regions by the significance of their fault-rate change (two-proportion
+pooled z-test, p via the normal approximation - counts here are in the
+hundreds, where it is accurate). Aggregates come straight out of the
+SQLite index (refreshed incrementally first, see results_query), so
+comparing month-long archives is a couple of GROUP BY queries:
+
+    python3 -m <package>.results_compare results/ \
+        --baseline 1-10 --candidate 11-20 [--alpha 0.01] [--csv]
+
+Campaign sets are comma/range lists of campaign ids. Only regions
+significant at --alpha print by default; --all shows every aligned
+region. compare() is the code entry point.
+"""
+
+import argparse
+import csv
+import math
+import os
+import sys
+
+from .results_index import DEFAULT_DB_NAME, open_index
+from .results_query import ensure_index, format_table
+
+# Alignment key: a physical region is its stage coordinates plus the
+# glitch parameters applied there (position/config indices differ
+# between campaigns, coordinates do not)
+_KEY_COLUMNS = ("x", "y", "z", "probe", "voltage", "pulse_width",
+                "pulse_spacing", "pulse_repeats")
+
+_AGGREGATE_SQL = f"""
+SELECT {", ".join(_KEY_COLUMNS)},
+       SUM(num_faults) AS faults,
+       SUM(num_faults + num_nofaults) AS trials
+FROM results
+WHERE campaign_id IN ({{ids}})
+GROUP BY {", ".join(_KEY_COLUMNS)}
+"""
+
+
+def parse_campaign_set(spec):
+    """Campaign ids from a "1,3,5-8" style list, as a sorted list."""
+    ids = set()
+    for part in spec.split(","):
+        part = part.strip()
+        if "-" in part:
+            low, high = part.split("-", 1)
+            ids.update(range(int(low), int(high) + 1))
+        elif part:
+            ids.add(int(part))
+    return sorted(ids)
+
+
+def _aggregate(connection, campaign_ids):
+    """{alignment key: (faults, trials)} over one campaign set. Trials
+    are the Bernoulli outcomes only (faults + nofaults) - crashes and
+    resets are a different failure mode, not a miss."""
+    placeholders = ", ".join("?" * len(campaign_ids))
+    rows = connection.execute(
+        _AGGREGATE_SQL.format(ids=placeholders), campaign_ids
+    )
+    return {tuple(row[:len(_KEY_COLUMNS)]): (row[-2] or 0, row[-1] or 0)
+            for row in rows}
+
+
+def proportion_test(faults_a, trials_a, faults_b, trials_b):
+    """
+    Two-proportion pooled z-test. Returns (delta, z, p) where delta is
+    rate_b - rate_a and p is the two-sided p-value; (0, 0, 1) when
+    either side has no trials or the pooled rate is degenerate.
+    """
+    if not trials_a or not trials_b:
+        return 0.0, 0.0, 1.0
+    rate_a = faults_a / trials_a
+    rate_b = faults_b / trials_b
+    pooled = (faults_a + faults_b) / (trials_a + trials_b)
+    variance = pooled * (1 - pooled) * (1 / trials_a + 1 / trials_b)
+    if variance <= 0:
+        return rate_b - rate_a, 0.0, 1.0
+    z = (rate_b - rate_a) / math.sqrt(variance)
+    p = math.erfc(abs(z) / math.sqrt(2))
+    return rate_b - rate_a, z, p
+
+
+def compare(db_path, baseline_ids, candidate_ids):
+    """
+    Aligned per-region comparison between two campaign sets, sorted by
+    significance. Each entry is a dict with the alignment key columns,
+    both sides' faults/trials/rate, and delta/z_score/p. Regions present on
+    only one side are skipped (nothing to compare against).
+    """
+    connection = open_index(db_path)
+    try:
+        baseline = _aggregate(connection, baseline_ids)
+        candidate = _aggregate(connection, candidate_ids)
+    finally:
+        connection.close()
+
+    entries = []
+    for key in baseline.keys() & candidate.keys():
+        faults_a, trials_a = baseline[key]
+        faults_b, trials_b = candidate[key]
+        delta, z, p = proportion_test(faults_a, trials_a, faults_b, trials_b)
+        entry = dict(zip(_KEY_COLUMNS, key))
+        entry.update({
+            "base_faults": faults_a, "base_trials": trials_a,
+            "base_rate": faults_a / trials_a if trials_a else 0.0,
+            "cand_faults": faults_b, "cand_trials": trials_b,
+            "cand_rate": faults_b / trials_b if trials_b else 0.0,
+            "delta": delta, "z_score": z, "p": p,
+        })
+        entries.append(entry)
+    entries.sort(key=lambda e: (e["p"], -abs(e["delta"])))
+    return entries
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Fault-rate regression comparison between campaign sets"
+    )
+    parser.add_argument("results_dir", nargs="?", default="results/",
+                        help="results directory holding the index"
+                             " (default: results/)")
+    parser.add_argument("--baseline", required=True,
+                        help="baseline campaign ids, e.g. 1,3,5-8")
+    parser.add_argument("--candidate", required=True,
+                        help="candidate campaign ids")
+    parser.add_argument("--alpha", type=float, default=0.01,
+                        help="significance threshold (default 0.01)")
+    parser.add_argument("--all", action="store_true",
+                        help="print every aligned region, not only the"
+                             " significant ones")
+    parser.add_argument("--csv", action="store_true",
+                        help="emit CSV instead of a table")
+    parser.add_argument("--no-refresh", action="store_true",
+                        help="skip the incremental index refresh")
+    args = parser.parse_args()
+
+    db_path = os.path.join(args.results_dir, DEFAULT_DB_NAME)
+    if not args.no_refresh:
+        db_path = ensure_index(args.results_dir, db_path)
+    elif not os.path.exists(db_path):
+        parser.error(f"no index at {db_path} (run without --no-refresh)")
+
+    entries = compare(db_path, parse_campaign_set(args.baseline),
+                      parse_campaign_set(args.candidate))
+    shown = entries if args.all else \
+        [e for e in entries if e["p"] < args.alpha]
+
+    columns = list(_KEY_COLUMNS) + ["base_rate", "cand_rate", "delta",
+                                    "z_score", "p", "base_trials", "cand_trials"]
+    rows = [[e[c] if not isinstance(e[c], float) else round(e[c], 5)
+             for c in columns] for e in shown]
+    if args.csv:
+        writer = csv.writer(sys.stdout)
+        writer.writerow(columns)
+        writer.writerows(rows)
+    else:
+        print(f"{len(entries)} aligned regions, "
+              f"{len(shown)} shown (alpha={args.alpha})")
+        print(format_table(columns, rows))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
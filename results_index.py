@@ -0,0 +1,183 @@
+"""
+SQLite index over campaign results for fast cross-campaign queries.
+
+Questions like "which (voltage, pulse_width, position) combinations ever
+produced a fault on this die" used to mean JSON-decoding every
+results_N.json in the directory. store_results now upserts one row per
+(campaign, config, position) - counters plus the GlitchConfig parameters
+- into results/index.db, so they become millisecond SQL instead:
+
+    SELECT DISTINCT voltage, pulse_width, x, y
+    FROM results WHERE num_faults > 0;
+
+Run this module directly to backfill the index from existing results
+files:
+
+    python3 results_index.py [results_dir]
+"""
+
+import os
+import re
+import sys
+import json
+import gzip
+import sqlite3
+from datetime import datetime, timezone
+
+DEFAULT_DB_NAME = "index.db"
+
+# The counter columns mirror the default result types in
+# CSProfiler.result_types; unknown/extra result types are ignored.
+COUNTER_KEYS = (
+    "num_nofaults",
+    "num_faults",
+    "num_crashes",
+    "num_resets",
+    "num_soft_bricked",
+    "num_hard_bricked",
+    "num_skipped",
+)
+
+_SCHEMA = f"""
+CREATE TABLE IF NOT EXISTS campaigns (
+    campaign_id INTEGER PRIMARY KEY,
+    results_file TEXT,
+    partial INTEGER,
+    indexed_at TEXT
+);
+CREATE TABLE IF NOT EXISTS results (
+    campaign_id INTEGER,
+    config_index INTEGER,
+    position_index INTEGER,
+    x REAL,
+    y REAL,
+    z REAL,
+    probe TEXT,
+    voltage REAL,
+    pulse_width REAL,
+    pulse_spacing REAL,
+    pulse_repeats INTEGER,
+    pulse_offset REAL,
+    {", ".join(f"{key} INTEGER" for key in COUNTER_KEYS)},
+    effective_executions INTEGER,
+    PRIMARY KEY (campaign_id, config_index, position_index)
+);
+CREATE INDEX IF NOT EXISTS idx_results_faults
+    ON results (num_faults) WHERE num_faults > 0;
+CREATE INDEX IF NOT EXISTS idx_results_params
+    ON results (voltage, pulse_width);
+"""
+
+
+def open_index(db_path):
+    """Open (creating if needed) the index database."""
+    connection = sqlite3.connect(db_path)
+    connection.executescript(_SCHEMA)
+    return connection
+
+
+def _per_position(config_results, key, position_index):
+    """Counter value for one position. Duck-typed indexing covers both
+    the JSON lists of backfilled files and the live numpy counter views;
+    missing keys and the legacy scalar num_skipped entries count as 0."""
+    values = config_results.get(key)
+    try:
+        return int(values[position_index])
+    except (TypeError, KeyError, IndexError):
+        return 0
+
+
+def index_results(log_json, campaign_id, results_file=None, partial=False,
+                  db_path=None):
+    """
+    Upsert one campaign's summary into the index.
+
+    Parameters
+    ----------
+    log_json : dict
+        Parsed results structure as written by CSProfiler.store_results.
+    campaign_id : int
+        Manifest-allocated campaign id (the N in results_N.json).
+    results_file : str, optional
+        Path of the results file, recorded for provenance.
+    partial : bool, optional
+        Whether the results come from a partial (interrupted) store.
+    db_path : str, optional
+        Index database path; defaults to index.db next to results_file
+        (or results/index.db).
+    """
+    if db_path is None:
+        results_dir = os.path.dirname(results_file) if results_file else "results/"
+        db_path = os.path.join(results_dir or ".", DEFAULT_DB_NAME)
+
+    positions = log_json.get("positions", [])
+    glitch_configs = log_json.get("glitch_configs", [])
+
+    rows = []
+    for config_index, config in enumerate(glitch_configs):
+        config_results = config.get("results", {})
+        for position_index, position in enumerate(positions):
+            x, y, z = (list(position) + [None, None, None])[:3]
+            rows.append((
+                campaign_id, config_index, position_index, x, y, z,
+                str(config.get("probe")), config.get("voltage"),
+                config.get("pulse_width"), config.get("pulse_spacing"),
+                config.get("pulse_repeats"), config.get("pulse_offset"),
+                *(_per_position(config_results, key, position_index)
+                  for key in COUNTER_KEYS),
+                _per_position(config_results, "effective_executions", position_index),
+            ))
+
+    placeholders = ", ".join("?" * (12 + len(COUNTER_KEYS) + 1))
+    connection = open_index(db_path)
+    try:
+        with connection:
+            connection.execute(
+                "INSERT OR REPLACE INTO campaigns VALUES (?, ?, ?, ?)",
+                (campaign_id, results_file, int(partial),
+                 datetime.now(timezone.utc).isoformat()),
+            )
+            connection.execute(
+                "DELETE FROM results WHERE campaign_id = ?", (campaign_id,)
+            )
+            connection.executemany(
+                f"INSERT INTO results VALUES ({placeholders})", rows
+            )
+    finally:
+        connection.close()
+
+
+def backfill(results_dir="results/", db_path=None):
+    """
+    Ingest every results_N[_partial].json[.gz] in a directory into the
+    index. Existing campaign rows are replaced, so re-running after new
+    campaigns (or re-stores) is safe.
+    """
+    if db_path is None:
+        db_path = os.path.join(results_dir, DEFAULT_DB_NAME)
+
+    pattern = re.compile(r"results_(\d+)(_partial)?\.json(\.gz)?$")
+    indexed = 0
+    for name in sorted(os.listdir(results_dir)):
+        match = pattern.match(name)
+        if not match:
+            continue
+        path = os.path.join(results_dir, name)
+        opener = gzip.open if name.endswith(".gz") else open
+        try:
+            with opener(path, "rt") as f:
+                log_json = json.load(f)
+        except (OSError, ValueError) as e:
+            print(f"Skipping {name}: {e}")
+            continue
+        index_results(
+            log_json, int(match.group(1)), results_file=path,
+            partial=bool(match.group(2)), db_path=db_path,
+        )
+        indexed += 1
+        print(f"Indexed {name}")
+    print(f"Backfill done: {indexed} results files -> {db_path}")
+
+
+if __name__ == "__main__":
+    backfill(sys.argv[1] if len(sys.argv) > 1 else "results/")
@@ -0,0 +1,218 @@
+"""
+Command-line aggregation over the results archive.
+
+Recurring questions - "total faults per config across the last 10
+campaigns", "top 20 hottest positions" - each used to mean a throwaway
+script over the results JSONs. This tool answers them from the SQLite
+index (results_index.py) instead: named queries for the common
+aggregations, arbitrary SQL for the rest, tables or CSV out. Before
+querying it runs an incremental backfill that skips every results file
+already indexed and unchanged since (mtime vs the campaigns table), so
+repeated queries over a month-long archive only parse new files:
+
+    python3 -m <package>.results_query faults-per-config results/ --last 10
+    python3 -m <package>.results_query hot-positions results/ --limit 20
+    python3 -m <package>.results_query sql results/ \
+        "SELECT voltage, SUM(num_faults) FROM results GROUP BY voltage"
+
+`list` shows the named queries. --csv switches the table to CSV.
+"""
+
+import argparse
+import csv
+import gzip
+import json
+import os
+import re
+import sys
+from datetime import datetime, timezone
+
+from .results_index import (COUNTER_KEYS, DEFAULT_DB_NAME, index_results,
+                            open_index)
+
+_TOTAL_EXECUTIONS = " + ".join(COUNTER_KEYS)
+
+# Named aggregations; {where} receives the campaign filter (--last)
+QUERIES = {
+    "faults-per-config": (
+        "Fault totals and rates per glitch parameter combination",
+        f"""
+        SELECT probe, voltage, pulse_width, pulse_spacing, pulse_repeats,
+               SUM(num_faults) AS faults,
+               SUM({_TOTAL_EXECUTIONS}) AS executions,
+               ROUND(1.0 * SUM(num_faults) /
+                     MAX(SUM({_TOTAL_EXECUTIONS}), 1), 5) AS fault_rate
+        FROM results {{where}}
+        GROUP BY probe, voltage, pulse_width, pulse_spacing, pulse_repeats
+        ORDER BY faults DESC
+        """,
+    ),
+    "hot-positions": (
+        "Positions ranked by total faults across configs and campaigns",
+        f"""
+        SELECT x, y, z,
+               SUM(num_faults) AS faults,
+               SUM(num_crashes) AS crashes,
+               SUM({_TOTAL_EXECUTIONS}) AS executions,
+               ROUND(1.0 * SUM(num_faults) /
+                     MAX(SUM({_TOTAL_EXECUTIONS}), 1), 5) AS fault_rate
+        FROM results {{where}}
+        GROUP BY x, y, z
+        ORDER BY faults DESC
+        """,
+    ),
+    "campaign-summary": (
+        "Per-campaign counter totals",
+        f"""
+        SELECT results.campaign_id, campaigns.results_file,
+               {", ".join(f"SUM({key}) AS {key[4:]}" for key in COUNTER_KEYS)}
+        FROM results JOIN campaigns USING (campaign_id) {{where}}
+        GROUP BY results.campaign_id
+        ORDER BY results.campaign_id
+        """,
+    ),
+    "category-totals": (
+        "Archive-wide totals per result category",
+        f"""
+        SELECT {", ".join(f"SUM({key}) AS {key[4:]}" for key in COUNTER_KEYS)}
+        FROM results {{where}}
+        """,
+    ),
+}
+
+
+def ensure_index(results_dir, db_path=None):
+    """
+    Incrementally bring the index up to date with the results directory.
+
+    A results file whose campaign row postdates the file's mtime is
+    already indexed and is skipped - this is the per-file cache that
+    keeps repeated queries from re-parsing the archive. New and changed
+    files go through the normal results_index backfill machinery.
+    """
+    if db_path is None:
+        db_path = os.path.join(results_dir, DEFAULT_DB_NAME)
+    indexed = {}
+    if os.path.exists(db_path):
+        connection = open_index(db_path)
+        try:
+            indexed = dict(connection.execute(
+                "SELECT results_file, indexed_at FROM campaigns"
+            ))
+        finally:
+            connection.close()
+
+    def is_current(path):
+        indexed_at = indexed.get(path)
+        if not indexed_at:
+            return False
+        mtime = datetime.fromtimestamp(os.path.getmtime(path), timezone.utc)
+        return mtime <= datetime.fromisoformat(indexed_at)
+
+    pattern = re.compile(r"results_(\d+)(_partial)?\.json(\.gz)?$")
+    for name in sorted(os.listdir(results_dir)):
+        match = pattern.match(name)
+        if not match:
+            continue
+        path = os.path.join(results_dir, name)
+        if is_current(path):
+            continue
+        opener = gzip.open if name.endswith(".gz") else open
+        try:
+            with opener(path, "rt") as f:
+                log_json = json.load(f)
+        except (OSError, ValueError) as e:
+            print(f"Skipping {name}: {e}", file=sys.stderr)
+            continue
+        index_results(
+            log_json, int(match.group(1)), results_file=path,
+            partial=bool(match.group(2)), db_path=db_path,
+        )
+    return db_path
+
+
+def format_table(header, rows):
+    """Plain-text table, column widths fitted to the content."""
+    cells = [[("" if v is None else str(v)) for v in row] for row in rows]
+    widths = [max(len(name), *(len(row[i]) for row in cells), 1)
+              if cells else len(name) for i, name in enumerate(header)]
+    lines = ["  ".join(name.ljust(w) for name, w in zip(header, widths))]
+    lines.append("  ".join("-" * w for w in widths))
+    for row in cells:
+        lines.append("  ".join(v.ljust(w) for v, w in zip(row, widths)))
+    return "\n".join(lines)
+
+
+def run_query(db_path, sql, limit=None, last=None):
+    """Execute one aggregation, returning (header, rows)."""
+    where = ""
+    if last:
+        where = ("WHERE results.campaign_id IN (SELECT campaign_id FROM"
+                 " campaigns ORDER BY campaign_id DESC LIMIT"
+                 f" {int(last)})")
+    sql = sql.format(where=where) if "{where}" in sql else sql
+    if limit:
+        sql = f"{sql.rstrip().rstrip(';')} LIMIT {int(limit)}"
+    connection = open_index(db_path)
+    try:
+        cursor = connection.execute(sql)
+        header = [column[0] for column in cursor.description]
+        return header, cursor.fetchall()
+    finally:
+        connection.close()
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Aggregation queries over the results index"
+    )
+    parser.add_argument("query",
+                        help="named query (see `list`), or `sql` with the"
+                             " statement as the extra argument")
+    parser.add_argument("results_dir", nargs="?", default="results/",
+                        help="results directory holding the index"
+                             " (default: results/)")
+    parser.add_argument("statement", nargs="?", default=None,
+                        help="SQL statement for the `sql` query")
+    parser.add_argument("--limit", type=int, default=None,
+                        help="cap the number of output rows")
+    parser.add_argument("--last", type=int, default=None,
+                        help="restrict to the N most recent campaigns")
+    parser.add_argument("--csv", action="store_true",
+                        help="emit CSV instead of a table")
+    parser.add_argument("--no-refresh", action="store_true",
+                        help="skip the incremental index refresh")
+    args = parser.parse_args()
+
+    if args.query == "list":
+        for name, (description, _) in QUERIES.items():
+            print(f"{name:<18} {description}")
+        return 0
+
+    if args.query == "sql":
+        if not args.statement:
+            parser.error("the `sql` query needs a statement argument")
+        sql = args.statement
+    elif args.query in QUERIES:
+        sql = QUERIES[args.query][1]
+    else:
+        parser.error(f"unknown query {args.query!r} (try `list`)")
+
+    db_path = os.path.join(args.results_dir, DEFAULT_DB_NAME)
+    if not args.no_refresh:
+        db_path = ensure_index(args.results_dir, db_path)
+    elif not os.path.exists(db_path):
+        parser.error(f"no index at {db_path} (run without --no-refresh)")
+
+    header, rows = run_query(db_path, sql, limit=args.limit, last=args.last)
+    if args.csv:
+        writer = csv.writer(sys.stdout)
+        writer.writerow(header)
+        writer.writerows(rows)
+    else:
+        print(format_table(header, rows))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,175 @@
+"""
+Online priority scheduling of (position, config) work items.
+
+run_campaign commits to a planned visit order up front, so a fault
+cluster discovered in the first hour waits behind acres of dead
+silicon. The scheduler keeps every remaining (position, config) item in
+a pool and always pops the most promising one: a per-position interest
+score, boosted around observed faults (fault-adjacency) and decayed
+around quiet results (dead-region decay), minus the stage travel from
+the current position so chasing a distant boost never thrashes the
+table.
+
+Selection is a linear scan over the pending items. At one pop per work
+item - a full execution batch, i.e. seconds of shots - the scan costs
+microseconds, and it stays exact under the moving-target priorities
+(travel term changes with every move, interest with every result) where
+a heap would need rebuilding per pop anyway.
+"""
+
+import math
+
+
+class PriorityScheduler:
+    def __init__(self, positions, config_indices, movement_weight=0.5,
+                 adjacency_boost=3.0, dead_decay=0.25, radius=None):
+        """
+        Parameters
+        ----------
+        positions : list[tuple]
+            The campaign's (x, y, z) grid; indices match the profiler's.
+        config_indices : list[int]
+            Glitch config indices to schedule at every position.
+        movement_weight : float, optional
+            Priority cost per distance unit of stage travel.
+        adjacency_boost : float, optional
+            Interest added to a fault's neighborhood, per fault.
+        dead_decay : float, optional
+            Interest removed from the neighborhood of a faultless batch.
+        radius : float, optional
+            Neighborhood radius for boost/decay; defaults to 1.5x the
+            estimated grid step.
+        """
+        self.positions = [tuple(position) for position in positions]
+        self.movement_weight = movement_weight
+        self.adjacency_boost = adjacency_boost
+        self.dead_decay = dead_decay
+        self.radius = radius if radius is not None else self._default_radius()
+        self.interest = [0.0] * len(self.positions)
+        self._pending = {
+            (position_index, config_index)
+            for position_index in range(len(self.positions))
+            for config_index in config_indices
+        }
+        # position -> indices within radius, built on first use (only
+        # positions that produce results ever need their neighborhood)
+        self._neighbor_cache = {}
+
+    def _default_radius(self):
+        """1.5x the grid step, estimated as the smallest distance from
+        the first position to any other: boosts reach a hit's immediate
+        neighbors without bleeding across the die."""
+        if len(self.positions) < 2:
+            return 1.0
+        first = self.positions[0]
+        distances = [
+            math.dist(first, position)
+            for position in self.positions[1:] if position != first
+        ]
+        return 1.5 * min(distances) if distances else 1.0
+
+    def _neighbor_indices(self, position_index):
+        cached = self._neighbor_cache.get(position_index)
+        if cached is None:
+            center = self.positions[position_index]
+            cached = [
+                index for index, position in enumerate(self.positions)
+                if math.dist(center, position) <= self.radius
+            ]
+            self._neighbor_cache[position_index] = cached
+        return cached
+
+    def record_result(self, position_index, config_index, faults, executions):
+        """Feed back one completed work item: faults boost the
+        neighborhood (including the position itself, for its other
+        configs), a faultless batch decays it."""
+        if faults > 0:
+            delta = self.adjacency_boost * faults
+        else:
+            delta = -self.dead_decay
+        for neighbor_index in self._neighbor_indices(position_index):
+            self.interest[neighbor_index] += delta
+
+    def seed_regions(self, regions, boost=None):
+        """
+        Pre-boost the interest map with known-sensitive regions (the
+        fault_clusters.region_stats output of a previous campaign), so
+        the first pops start inside them instead of a cold uniform
+        sweep. Positions within a region's radius (plus the scheduler's
+        own neighborhood radius) of its centroid gain boost * the
+        region's weight - the same scale record_result uses per
+        observed fault, so seeded and live interest stay commensurate.
+        """
+        boost = self.adjacency_boost if boost is None else boost
+        for region in regions:
+            center = tuple(region["centroid"])
+            reach = region.get("radius", 0.0) + self.radius
+            delta = boost * region.get("weight", 1.0)
+            for index, position in enumerate(self.positions):
+                if math.dist(center, position[:2]) <= reach:
+                    self.interest[index] += delta
+
+    def add_config(self, config_index):
+        """Queue a config appended mid-campaign (hot-reload) at every
+        position, at the current neighborhood interest."""
+        for position_index in range(len(self.positions)):
+            self._pending.add((position_index, config_index))
+
+    def pop(self, current_position=None, heat_limit=None, config_heat=None):
+        """Remove and return the pending (position_index, config_index)
+        with the highest priority from `current_position` (None skips
+        the travel term, e.g. for the first pop). Returns None when the
+        pool is empty.
+
+        heat_limit with config_heat (config_index -> predicted degC
+        rise, see CSUtils.HeatingModel) makes the pop thermal-aware:
+        items whose config would overshoot the limit are passed over,
+        so cooldown windows schedule the low-energy remainder of the
+        pool instead of idling. A None return then only means nothing
+        *fits* - the caller distinguishes a thermally blocked pool from
+        an empty one via len() and waits for headroom on the former."""
+        best = None
+        best_score = -math.inf
+        # Sorted iteration makes ties (the whole first pop, typically)
+        # deterministic across runs and resumes
+        for item in sorted(self._pending):
+            if heat_limit is not None and config_heat is not None \
+                    and config_heat.get(item[1], 0.0) > heat_limit:
+                continue
+            score = self.interest[item[0]]
+            if current_position is not None:
+                score -= self.movement_weight * math.dist(
+                    current_position, self.positions[item[0]]
+                )
+            if score > best_score:
+                best, best_score = item, score
+        if best is not None:
+            self._pending.discard(best)
+        return best
+
+    def __len__(self):
+        return len(self._pending)
+
+    def to_state(self):
+        """JSON-serializable snapshot for the campaign checkpoint."""
+        return {
+            "pending": sorted(self._pending),
+            "interest": self.interest,
+            "movement_weight": self.movement_weight,
+            "adjacency_boost": self.adjacency_boost,
+            "dead_decay": self.dead_decay,
+            "radius": self.radius,
+        }
+
+    @classmethod
+    def from_state(cls, positions, state):
+        scheduler = cls(
+            positions, [],
+            movement_weight=state["movement_weight"],
+            adjacency_boost=state["adjacency_boost"],
+            dead_decay=state["dead_decay"],
+            radius=state["radius"],
+        )
+        scheduler._pending = {tuple(item) for item in state["pending"]}
+        scheduler.interest = list(state["interest"])
+        return scheduler
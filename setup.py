@@ -0,0 +1,19 @@
+"""
+Builds the optional compiled codec extension for the SimpleSerial host side
+(simpleserial/_codec.c). The profiler works without it — simpleserial.py
+falls back to the pure-Python COBS/CRC implementations — but during fault
+storms the compiled codec removes most of the host-side per-packet CPU cost.
+
+Build in place:
+    python setup.py build_ext --inplace
+"""
+
+from setuptools import setup, Extension
+
+setup(
+    name="cs-profiler-codec",
+    version="0.1",
+    ext_modules=[
+        Extension("simpleserial._codec", sources=["simpleserial/_codec.c"]),
+    ],
+)
@@ -0,0 +1,297 @@
+"""
+Campaign sharding across independent rigs.
+
+Dies whose grids exceed one bench's maintenance window get split into
+self-contained shard specs, each run as a normal campaign on its own
+machine, and merged back into one coherent results file afterwards.
+A shard spec carries its slice of the positions list, the full glitch
+config set, and the global indices of its positions; the shard's
+campaign id is pinned to the deterministic string <label>_shard<k>of<n>
+so result files copied into one results directory cannot collide and
+always identify their shard.
+
+Split programmatically, run each spec on its rig, merge on one machine:
+
+    specs = make_shard_specs(positions, glitch_configs, 3, label="die7")
+    write_shard_specs(specs, "shards/")
+
+    # on each rig:
+    positions, glitch_configs, spec = load_shard_spec("shards/shard_die7_0of3.json")
+    profiler = CSProfiler(target_config, positions, glitch_configs)
+    apply_shard(profiler, spec)
+    profiler.run_campaign(...)
+
+    # back on one machine:
+    python3 -m <package>.sharding merge results/results_die7_shard*of3.json -o results_die7.json
+
+The merge validates that the shards belong together (same label and
+shard count, identical glitch configs) and cover disjoint positions,
+then remaps every per-position counter, extradata entry and visit order
+back to global indices, so visualize.py reads the merged file like any
+single-rig campaign. Stream logs and fault-blob sidecars stay on their
+rigs; the merged file references them per shard.
+"""
+
+import gzip
+import json
+import os
+import sys
+from dataclasses import asdict
+
+from .config_classes import GlitchConfig
+
+SHARD_SCHEMA_VERSION = 1
+
+
+def make_shard_specs(positions, glitch_configs, num_shards, label):
+    """
+    Split a campaign into num_shards self-contained shard specs.
+
+    Positions are split into contiguous slices (each rig plans its own
+    travel order over its slice); every shard carries the full glitch
+    config set so the merge can verify the shards ran the same campaign.
+    """
+    specs = []
+    base, extra = divmod(len(positions), num_shards)
+    start = 0
+    for shard_index in range(num_shards):
+        size = base + (1 if shard_index < extra else 0)
+        specs.append({
+            "shard_schema_version": SHARD_SCHEMA_VERSION,
+            "label": label,
+            "shard_index": shard_index,
+            "num_shards": num_shards,
+            "global_position_indices": list(range(start, start + size)),
+            "positions": list(positions[start:start + size]),
+            "glitch_configs": [asdict(cfg) for cfg in glitch_configs],
+        })
+        start += size
+    return specs
+
+
+def write_shard_specs(specs, out_dir):
+    """Write each spec to out_dir as shard_<label>_<k>of<n>.json;
+    returns the paths."""
+    os.makedirs(out_dir, exist_ok=True)
+    paths = []
+    for spec in specs:
+        path = os.path.join(
+            out_dir,
+            f"shard_{spec['label']}_{spec['shard_index']}of{spec['num_shards']}.json",
+        )
+        with open(path, "w") as f:
+            json.dump(spec, f, indent=4)
+        paths.append(path)
+    return paths
+
+
+def load_shard_spec(path):
+    """Load a shard spec; returns (positions, glitch_configs, spec)
+    ready for the CSProfiler constructor."""
+    with open(path) as f:
+        spec = json.load(f)
+    positions = [tuple(position) for position in spec["positions"]]
+    glitch_configs = [GlitchConfig(**cfg) for cfg in spec["glitch_configs"]]
+    return positions, glitch_configs, spec
+
+
+def shard_campaign_id(spec):
+    return f"{spec['label']}_shard{spec['shard_index']}of{spec['num_shards']}"
+
+
+def apply_shard(profiler, spec):
+    """
+    Mark a profiler as running a shard: pins the deterministic shard
+    campaign id (used for every result/stream/checkpoint filename
+    instead of a manifest-allocated one) and embeds the shard metadata
+    the merge needs into store_results output.
+    """
+    profiler._campaign_id = shard_campaign_id(spec)
+    profiler._shard_spec = {
+        "label": spec["label"],
+        "shard_index": spec["shard_index"],
+        "num_shards": spec["num_shards"],
+        "global_position_indices": list(spec["global_position_indices"]),
+    }
+
+
+def _load_results(path):
+    opener = gzip.open if path.endswith(".gz") else open
+    with opener(path, "rt") as f:
+        return json.load(f)
+
+
+def _bare_configs(data):
+    return [{key: value for key, value in cfg.items() if key != "results"}
+            for cfg in data["glitch_configs"]]
+
+
+def _merge_catched_errors(dest, errors):
+    """Fold one shard's catched_errors into the merged summary. Current
+    shards store an errors.ErrorLog summary dict; shards from before the
+    bounded log stored the raw entry list."""
+    if not errors:
+        return
+    if isinstance(errors, dict):
+        dest["total"] += errors.get("total", 0)
+        for key, count in (errors.get("by_type") or {}).items():
+            dest["by_type"][key] = dest["by_type"].get(key, 0) + count
+        dest["recent"].extend(errors.get("recent") or [])
+        if errors.get("log"):
+            dest["logs"].append(errors["log"])
+    else:
+        dest["total"] += len(errors)
+        for entry in errors:
+            key = entry.get("type", "unknown") if isinstance(entry, dict) \
+                else "unknown"
+            dest["by_type"][key] = dest["by_type"].get(key, 0) + 1
+        dest["recent"].extend(errors)
+
+
+def _merge_config_results(dest, src, global_indices, num_positions):
+    """Fold one shard's per-config results into the merged store,
+    remapping local position indices to global ones."""
+    for key, value in src.items():
+        if isinstance(value, list) and value and isinstance(value[0], dict) \
+                and "position_index" in value[0]:
+            # Extradata entries ({position_index, data})
+            entries = dest.setdefault(key, [])
+            entries.extend(
+                {**entry, "position_index": global_indices[entry["position_index"]]}
+                for entry in value
+            )
+        elif isinstance(value, list):
+            # Per-position counter list
+            merged_list = dest.setdefault(key, [0] * num_positions)
+            for local_index, count in enumerate(value):
+                merged_list[global_indices[local_index]] = count
+        else:
+            # Scalar total (e.g. a config's num_skipped overwrite)
+            dest[key] = dest.get(key, 0) + value
+
+
+def merge_shard_results(paths):
+    """
+    Combine shard result files into one merged results dict.
+
+    Raises ValueError when the shards do not form one complete campaign:
+    missing/duplicate shard indices, mismatched labels or glitch
+    configs, or overlapping position coverage.
+    """
+    shards = [(_load_results(path), path) for path in paths]
+
+    metas = []
+    for data, path in shards:
+        meta = data.get("shard")
+        if not meta:
+            raise ValueError(f"{path}: not a shard result (no 'shard' section)")
+        metas.append(meta)
+
+    labels = {meta["label"] for meta in metas}
+    if len(labels) != 1:
+        raise ValueError(f"shards from different campaigns: {sorted(labels)}")
+    shard_counts = {meta["num_shards"] for meta in metas}
+    if len(shard_counts) != 1:
+        raise ValueError(f"inconsistent shard counts: {sorted(shard_counts)}")
+    num_shards = shard_counts.pop()
+    indices = [meta["shard_index"] for meta in metas]
+    if sorted(indices) != list(range(num_shards)):
+        raise ValueError(
+            f"expected shards 0..{num_shards - 1}, got {sorted(indices)}"
+        )
+
+    covered = set()
+    num_positions = 0
+    for meta, (data, path) in zip(metas, shards):
+        global_indices = meta["global_position_indices"]
+        if len(data["positions"]) != len(global_indices):
+            raise ValueError(
+                f"{path}: {len(data['positions'])} positions but "
+                f"{len(global_indices)} global indices (refined grids "
+                "cannot be merged)"
+            )
+        overlap = covered.intersection(global_indices)
+        if overlap:
+            raise ValueError(
+                f"{path}: positions {sorted(overlap)[:5]} covered by two shards"
+            )
+        covered.update(global_indices)
+        num_positions += len(global_indices)
+    if covered != set(range(num_positions)):
+        raise ValueError("shards do not cover a contiguous 0..N-1 position range")
+
+    reference = _bare_configs(shards[0][0])
+    for data, path in shards[1:]:
+        if _bare_configs(data) != reference:
+            raise ValueError(f"{path}: glitch_configs differ from {shards[0][1]}")
+
+    ordered = [shard for _, shard in
+               sorted(zip(indices, shards), key=lambda pair: pair[0])]
+    first = ordered[0][0]
+
+    merged = {key: value for key, value in first.items() if key.startswith("Info:")}
+    if "schema_version" in first:
+        merged["schema_version"] = first["schema_version"]
+    merged["positions"] = [None] * num_positions
+    merged["position_depths"] = [0] * num_positions
+    merged["position_order"] = []
+    merged["catched_errors"] = {"total": 0, "by_type": {}, "recent": [],
+                                "logs": []}
+    merged["shards"] = []
+    merged_configs = [dict(cfg) for cfg in reference]
+    for cfg in merged_configs:
+        cfg["results"] = {}
+
+    for data, path in ordered:
+        global_indices = data["shard"]["global_position_indices"]
+        depths = data.get("position_depths") or []
+        for local_index, global_index in enumerate(global_indices):
+            merged["positions"][global_index] = data["positions"][local_index]
+            if local_index < len(depths):
+                merged["position_depths"][global_index] = depths[local_index]
+        merged["position_order"].extend(
+            global_indices[local_index]
+            for local_index in data.get("position_order", [])
+        )
+        _merge_catched_errors(merged["catched_errors"],
+                              data.get("catched_errors"))
+        merged["shards"].append({
+            "shard_index": data["shard"]["shard_index"],
+            "source": path,
+            "results_stream": data.get("results_stream"),
+            "fault_blobs": data.get("fault_blobs"),
+            "timing": data.get("timing"),
+        })
+        for config_index, cfg in enumerate(data["glitch_configs"]):
+            _merge_config_results(
+                merged_configs[config_index]["results"],
+                cfg.get("results", {}),
+                global_indices, num_positions,
+            )
+
+    merged["glitch_configs"] = merged_configs
+    return merged
+
+
+def main():
+    args = sys.argv[1:]
+    if not args or args[0] != "merge":
+        print("usage: python3 -m <package>.sharding merge <shard results...> [-o merged.json]")
+        return 1
+    args = args[1:]
+    out_path = "results_merged.json"
+    if "-o" in args:
+        index = args.index("-o")
+        out_path = args[index + 1]
+        del args[index:index + 2]
+
+    merged = merge_shard_results(args)
+    with open(out_path, "w") as f:
+        json.dump(merged, f, indent=4)
+    print(f"Merged {len(merged['shards'])} shards "
+          f"({len(merged['positions'])} positions) into {out_path}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,236 @@
+"""
+Hardware-free simulated campaign harness.
+
+Everything test_profile_target.py does needs a physical bench; this
+module swaps every device for a software stand-in - the simulated
+target driver (simpleserial_readers/sim.py) emulating the firmware
+protocol in-process, plus mock ChipShouter/xyzTable/ChipWhisperer/
+DelayController classes - so the complete run_campaign loop executes
+at maximum software speed. Intended for profiling test_position/
+test_execution changes and for CI runs where no coil time is available.
+
+    python3 -m <package>.sim_target [-n POS] [-m EXEC] [--seed S] [--profile]
+
+The mock classes are also importable on their own (bench_campaign.py
+uses them with a real ChipWhisperer attached).
+"""
+
+import cProfile
+import math
+import pstats
+import sys
+
+from .config_classes import GlitchConfig, TargetConfig
+from .profile_target import CSProfiler
+from simpleserial.simpleserial import TargetSerial
+from simpleserial.simpleserial_readers.sim import (
+    SimpleSerial_SimulatedTarget, SimTargetConfig,
+)
+
+
+class MockShouter:
+    """ChipShouter stand-in: reports armed/charged/cool/trigger-safe
+    without touching hardware, so test_execution runs its full control
+    flow but no pulse can ever fire."""
+
+    def __init__(self):
+        self.voltage = 0
+        self.armed = False
+
+    def set_voltage(self, value):
+        # Dedup/deferral variant used by configure_chipshouter
+        self.voltage = value
+
+    def configure_pulsegen(self, deadtime, repeat, width):
+        # Internal-generator path of configure_chipshouter
+        pass
+
+    def note_pulse_shape(self, width, repeats):
+        # Recharge-model feed from configure_chipshouter
+        pass
+
+    def arm(self):
+        self.armed = True
+
+    def disarm(self):
+        self.armed = False
+
+    def ensure_armed(self):
+        self.armed = True
+
+    def wait_charge_ready(self, *args, **kwargs):
+        pass
+
+    def thermal_ready(self):
+        return True
+
+    def trigger_safe(self):
+        return True
+
+    def refresh_status(self):
+        pass
+
+    def clear_faults(self):
+        pass
+
+    def clear_faults_async(self):
+        pass
+
+    def fault_clear_pending(self):
+        return False
+
+    def start_thermal_monitor(self):
+        pass
+
+    def power_cycle_usb(self):
+        pass
+
+
+class MockTable:
+    """xyzTable stand-in: all moves complete instantly."""
+
+    def home_all(self):
+        pass
+
+    def move_absolute(self, x, y, z):
+        pass
+
+    def move_axis_absolute(self, axis, value):
+        # Per-axis variant of move_absolute (axis in "x"/"y"/"z"), used
+        # by CSProfiler.move_table for coordinated multi-axis moves
+        pass
+
+    def is_settled(self):
+        # Settle status polled by CSProfiler._wait_table_settled
+        return True
+
+    def set_motion_profile(self, velocity, acceleration):
+        # Velocity/acceleration tuning (stage units) applied by
+        # CSProfiler._apply_motion_profile before moves
+        pass
+
+    def get_position(self):
+        # Encoder readback polled by CSProfiler.run_line_sweep to bin
+        # continuous-motion shots; the real wrapper returns (x, y, z)
+        return (0.0, 0.0, 0.0)
+
+    def probe_z(self, x, y):
+        # Touch-off probe used by CSProfiler.build_clearance_map; the
+        # real wrapper lowers Z until contact and returns the touch Z
+        return 0.0
+
+
+class MockDelayController:
+    """DelayController stand-in (context-manager protocol like the
+    Pico pulse generator driver)."""
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, exc_type, exc_value, tb):
+        pass
+
+    def set_parameters(self, parameters):
+        pass
+
+
+class MockChipWhisperer:
+    """ChipWhisperer stand-in wired to a simulated target driver:
+    reset/power-cycle trigger the driver's reboot announce, flashing is
+    a no-op."""
+
+    def __init__(self, sim_driver):
+        self._sim = sim_driver
+        self.scope = None
+
+    def reset_target(self):
+        self._sim.reset()
+
+    def power_cycle_usb(self):
+        self._sim.reset()
+
+    def flash(self, binary_path, verify_first=True):
+        pass
+
+    def arm_trigger_counter(self):
+        # Trigger-width path of _arm_trigger_counter
+        pass
+
+    def read_trigger_width_ns(self):
+        # Fixed plausible loop duration so simulated extradata records
+        # carry a trigger_width_ns field when the feature is enabled
+        return 125000.0
+
+
+def attach_simulated_hardware(profiler, sim_config=None):
+    """prepare_hardware replacement: simulated target serial plus mocks
+    for every other device. Usage:
+
+        profiler.prepare_hardware = lambda: attach_simulated_hardware(profiler)
+    """
+    profiler.target_serial = TargetSerial(SimpleSerial_SimulatedTarget,
+                                          sim_config or SimTargetConfig())
+    profiler.cw = MockChipWhisperer(profiler.target_serial.ser)
+    profiler.cs = MockShouter()
+    profiler.table = MockTable()
+    profiler.delay_controller = MockDelayController()
+    profiler._last_pulse_parameters = None
+
+
+def run_simulated_campaign(num_positions=100, num_executions=25,
+                           sim_config=None):
+    """Run a full campaign against the simulated target and return the
+    profiler (results/stream files are written as in a real campaign)."""
+    target_config = TargetConfig(
+        firmware_build_dir=".",
+        firmware_build_command=[],
+        firmware_path="simulated",
+    )
+
+    # Square grid so the results also make sense in the visualizer
+    side = max(1, math.isqrt(num_positions - 1) + 1)
+    positions = [[i % side, i // side, 15.0] for i in range(num_positions)]
+
+    glitch_config = GlitchConfig(
+        probe="simulated",
+        voltage=0,
+        pulse_width=40,
+        pulse_spacing=50,
+        pulse_repeats=0,
+        pulse_offset=0,
+        num_executions=num_executions,
+        dead_timeout=100,
+    )
+
+    profiler = CSProfiler(target_config, positions, [glitch_config])
+    profiler.prepare_hardware = lambda: attach_simulated_hardware(
+        profiler, sim_config
+    )
+    profiler.run_campaign(build=False, flash=False, home=False)
+    return profiler
+
+
+def main():
+    args = sys.argv[1:]
+
+    def int_arg(flag, default):
+        if flag in args:
+            return int(args[args.index(flag) + 1])
+        return default
+
+    sim_config = SimTargetConfig(seed=int_arg("--seed", 0))
+    num_positions = int_arg("-n", 100)
+    num_executions = int_arg("-m", 25)
+
+    if "--profile" in args:
+        profile = cProfile.Profile()
+        profile.enable()
+        run_simulated_campaign(num_positions, num_executions, sim_config)
+        profile.disable()
+        pstats.Stats(profile).sort_stats("cumulative").print_stats(30)
+    else:
+        run_simulated_campaign(num_positions, num_executions, sim_config)
+
+
+if __name__ == "__main__":
+    main()
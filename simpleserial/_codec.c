@@ -0,0 +1,214 @@
+/*
+ * _codec.c
+ *
+ * Compiled hot-loop codec for the SimpleSerial host side: COBS
+ * stuffing/unstuffing and the 8-bit CRC (poly 0x4D) that TargetSerial
+ * otherwise runs as pure-Python byte loops on every packet.
+ *
+ * Build in place with:
+ *     python setup.py build_ext --inplace
+ *
+ * The module is optional — simpleserial.py falls back to the pure-Python
+ * implementations when the import fails. All functions accept any object
+ * supporting the buffer protocol (bytes, bytearray, memoryview) and the
+ * results are byte-for-byte identical to the Python versions.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#define CRC_POLY 0x4D
+
+static unsigned char crc_table[256];
+
+static void build_crc_table(void)
+{
+    for (int i = 0; i < 256; i++)
+    {
+        unsigned char crc = (unsigned char)i;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            if (crc & 0x80)
+                crc = (unsigned char)((crc << 1) ^ CRC_POLY);
+            else
+                crc = (unsigned char)(crc << 1);
+        }
+        crc_table[i] = crc;
+    }
+}
+
+PyDoc_STRVAR(crc_doc,
+"crc(buf) -> int\n\n"
+"Calculate the 8-bit CRC (poly 0x4D) of a buffer.");
+
+static PyObject *codec_crc(PyObject *self, PyObject *args)
+{
+    Py_buffer view;
+
+    if (!PyArg_ParseTuple(args, "y*:crc", &view))
+        return NULL;
+
+    const unsigned char *buf = (const unsigned char *)view.buf;
+    unsigned char crc = 0x00;
+    for (Py_ssize_t i = 0; i < view.len; i++)
+        crc = crc_table[crc ^ buf[i]];
+
+    PyBuffer_Release(&view);
+    return PyLong_FromLong(crc);
+}
+
+PyDoc_STRVAR(cobs_stuff_doc,
+"cobs_stuff(buf, frame_byte=0) -> bytes\n\n"
+"COBS-encode a buffer (blocks split on frame_byte or at 254 bytes).");
+
+static PyObject *codec_cobs_stuff(PyObject *self, PyObject *args)
+{
+    Py_buffer view;
+    int frame_byte = 0x00;
+
+    if (!PyArg_ParseTuple(args, "y*|i:cobs_stuff", &view, &frame_byte))
+        return NULL;
+
+    if (view.len == 0)
+    {
+        PyBuffer_Release(&view);
+        return PyBytes_FromStringAndSize(NULL, 0);
+    }
+
+    // Worst case: one extra code byte per 254 input bytes, plus the first
+    const unsigned char *buf = (const unsigned char *)view.buf;
+    Py_ssize_t max_len = view.len + view.len / 254 + 1;
+    PyObject *result = PyBytes_FromStringAndSize(NULL, max_len);
+    if (!result)
+    {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+    unsigned char *out = (unsigned char *)PyBytes_AS_STRING(result);
+
+    Py_ssize_t out_len = 1;   // placeholder for first code byte
+    Py_ssize_t code_index = 0;
+    unsigned char code = 1;
+
+    for (Py_ssize_t i = 0; i < view.len; i++)
+    {
+        unsigned char b = buf[i];
+        if (code == 0xFF)
+        {
+            // Full 254-byte block: close it before looking at b, so a
+            // frame byte right behind it still gets its own empty block
+            out[code_index] = code;
+            code_index = out_len;
+            out_len++;            // new code byte placeholder
+            code = 1;
+        }
+        if (b == (unsigned char)frame_byte)
+        {
+            out[code_index] = code;
+            code_index = out_len;
+            out_len++;            // new code byte placeholder
+            code = 1;
+        }
+        else
+        {
+            out[out_len++] = b;
+            code++;
+        }
+    }
+    out[code_index] = code;
+
+    PyBuffer_Release(&view);
+    if (_PyBytes_Resize(&result, out_len) < 0)
+        return NULL;
+    return result;
+}
+
+PyDoc_STRVAR(cobs_unstuff_doc,
+"cobs_unstuff(buf, frame_byte=0) -> bytes\n\n"
+"Decode a COBS-encoded buffer.\n\n"
+"Raises ValueError on a zero code byte or a block past the buffer end.");
+
+static PyObject *codec_cobs_unstuff(PyObject *self, PyObject *args)
+{
+    Py_buffer view;
+    int frame_byte = 0x00;
+
+    if (!PyArg_ParseTuple(args, "y*|i:cobs_unstuff", &view, &frame_byte))
+        return NULL;
+
+    if (view.len == 0)
+    {
+        PyBuffer_Release(&view);
+        return PyBytes_FromStringAndSize(NULL, 0);
+    }
+
+    // Decoded output is never longer than the encoded input
+    const unsigned char *buf = (const unsigned char *)view.buf;
+    PyObject *result = PyBytes_FromStringAndSize(NULL, view.len);
+    if (!result)
+    {
+        PyBuffer_Release(&view);
+        return NULL;
+    }
+    unsigned char *out = (unsigned char *)PyBytes_AS_STRING(result);
+
+    Py_ssize_t out_len = 0;
+    Py_ssize_t index = 0;
+
+    while (index < view.len)
+    {
+        unsigned char code = buf[index];
+        if (code == 0)
+        {
+            Py_DECREF(result);
+            PyBuffer_Release(&view);
+            PyErr_SetString(PyExc_ValueError,
+                            "Invalid COBS: code byte cannot be 0");
+            return NULL;
+        }
+        index++;
+
+        Py_ssize_t end = index + code - 1;
+        if (end > view.len)
+        {
+            Py_DECREF(result);
+            PyBuffer_Release(&view);
+            PyErr_SetString(PyExc_ValueError,
+                            "Invalid COBS: block extends past end of buffer");
+            return NULL;
+        }
+
+        memcpy(out + out_len, buf + index, (size_t)(end - index));
+        out_len += end - index;
+        index = end;
+
+        if (code < 0xFF && index < view.len)
+            out[out_len++] = (unsigned char)frame_byte;
+    }
+
+    PyBuffer_Release(&view);
+    if (_PyBytes_Resize(&result, out_len) < 0)
+        return NULL;
+    return result;
+}
+
+static PyMethodDef codec_methods[] = {
+    {"crc", codec_crc, METH_VARARGS, crc_doc},
+    {"cobs_stuff", codec_cobs_stuff, METH_VARARGS, cobs_stuff_doc},
+    {"cobs_unstuff", codec_cobs_unstuff, METH_VARARGS, cobs_unstuff_doc},
+    {NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef codec_module = {
+    PyModuleDef_HEAD_INIT,
+    "_codec",
+    "Compiled COBS/CRC codec for the SimpleSerial host side.",
+    -1,
+    codec_methods
+};
+
+PyMODINIT_FUNC PyInit__codec(void)
+{
+    build_crc_table();
+    return PyModule_Create(&codec_module);
+}
@@ -0,0 +1,50 @@
+"""
+Monotonic-clock deadline helper shared by the serial layer and the
+hardware utilities.
+
+Replaces two timeout mechanisms that cause trouble in long campaigns:
+wall-clock time.time() arithmetic (misbehaves on NTP steps) and
+SIGALRM-based decorators (unusable from worker threads).
+"""
+
+import time
+
+
+class Deadline:
+    """
+    A fixed point in monotonic time to test loops against.
+
+    Instances are immutable after construction, so they are thread-safe,
+    and expired()/remaining() allocate nothing — safe to call per
+    iteration in receive hot loops.
+
+    Example:
+        deadline = Deadline(timeout_ms)
+        while not deadline.expired():
+            ...
+    """
+
+    __slots__ = ("_end",)
+
+    def __init__(self, timeout_ms=None):
+        """
+        Args:
+            timeout_ms (float | None): Timeout in milliseconds from now.
+                None creates a deadline that never expires.
+        """
+        self._end = None if timeout_ms is None else time.monotonic() + timeout_ms / 1000.0
+
+    def expired(self) -> bool:
+        """True once the deadline has passed (never for unbounded)."""
+        return self._end is not None and time.monotonic() >= self._end
+
+    def remaining(self):
+        """Seconds until expiry (never negative), or None if unbounded."""
+        if self._end is None:
+            return None
+        return max(0.0, self._end - time.monotonic())
+
+    def remaining_ms(self):
+        """Milliseconds until expiry (never negative), or None if unbounded."""
+        remaining = self.remaining()
+        return None if remaining is None else remaining * 1000.0
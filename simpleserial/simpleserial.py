@@ -1,8 +1,21 @@
 from .simpleserial_readers.cwlite import SimpleSerial_ChipWhispererLite
-from collections import OrderedDict, deque
+from .deadline import Deadline
+from collections import OrderedDict
 import time
 import inspect
 import ctypes
+import json
+import os
+import threading
+import zlib
+
+# Optional compiled codec (COBS + CRC hot loops, see _codec.c). Built with
+# `python setup.py build_ext --inplace`; the pure-Python implementations
+# below are used when the extension is not available.
+try:
+    from . import _codec
+except ImportError:
+    _codec = None
 
 def dict_to_str(input_dict: dict, indent=""):
     """
@@ -113,6 +126,94 @@ class PacketDataStruct(ctypes.Structure):
 
         return result
 
+class RxRingBuffer:
+    """
+    Single-producer/single-consumer byte ring buffer.
+
+    The producer (TargetSerial's background reader thread) only ever writes
+    the head index, the consumer (the campaign thread) only the tail index,
+    so no lock is needed: each side publishes its index with a single
+    assignment after the data is in place.
+
+    One slot is kept unused to distinguish a full from an empty buffer.
+    Pushed data that does not fit is dropped and counted in `overflows`.
+    """
+
+    def __init__(self, size=1 << 16):
+        self._buf = bytearray(size)
+        self._size = size
+        self._head = 0  # producer write index
+        self._tail = 0  # consumer read index
+        self.overflows = 0
+
+    def __len__(self):
+        return (self._head - self._tail) % self._size
+
+    def push(self, data):
+        """Append bytes (producer side). Drops data that does not fit."""
+        head = self._head
+        free = self._size - 1 - ((head - self._tail) % self._size)
+        if len(data) > free:
+            self.overflows += 1
+            data = data[:free]
+        if not data:
+            return
+
+        end = head + len(data)
+        if end <= self._size:
+            self._buf[head:end] = data
+        else:
+            split = self._size - head
+            self._buf[head:] = data[:split]
+            self._buf[:end - self._size] = data[split:]
+        # Publish the new head only after the bytes are in place
+        self._head = end % self._size
+
+    def peek(self, num_bytes):
+        """Return up to num_bytes without consuming them (consumer side)."""
+        head = self._head  # snapshot of what the producer has published
+        avail = (head - self._tail) % self._size
+        n = min(num_bytes, avail)
+        start = self._tail
+        end = start + n
+        if end <= self._size:
+            return bytes(self._buf[start:end])
+        return bytes(self._buf[start:]) + bytes(self._buf[:end - self._size])
+
+    def pop(self, num_bytes):
+        """Return and consume up to num_bytes (consumer side)."""
+        data = self.peek(num_bytes)
+        self._tail = (self._tail + len(data)) % self._size
+        return data
+
+    def pop_into(self, dst, num_bytes):
+        """
+        Copy up to num_bytes into the writable buffer dst and consume
+        them (consumer side). Allocation-free counterpart of pop() for
+        the zero-copy receive path: the bytes land directly in the
+        caller's scratch buffer instead of a fresh bytes object.
+        Returns the number of bytes copied.
+        """
+        head = self._head  # snapshot of what the producer has published
+        avail = (head - self._tail) % self._size
+        n = min(num_bytes, avail, len(dst))
+        src = memoryview(self._buf)
+        start = self._tail
+        end = start + n
+        if end <= self._size:
+            dst[:n] = src[start:end]
+        else:
+            split = self._size - start
+            dst[:split] = src[start:]
+            dst[split:n] = src[:end - self._size]
+        self._tail = (self._tail + n) % self._size
+        return n
+
+    def clear(self):
+        """Drop all buffered bytes (consumer side)."""
+        self._tail = self._head
+
+
 class SimpleSerial_Err:
     OK = 0
     ERR_CMD = 1
@@ -131,6 +232,7 @@ class TargetSerial:
         - read_until():         Read until a specific sequence is received. (used by `read_until_reset()`)
         - wait_for_seaquence(): Block until a specific sequence is received. (used by `wait_ack()`)
         - read_packet():        Read a packet (with or without data)
+        - read_packet_view():   Zero-copy read_packet() variant returning views into reusable scratch buffers
         - send_packet():        Send a packet (with or without data)
 
     Packets are composed of a command, optional data (including crc) and a terminator frame_byte (0x00).
@@ -144,12 +246,35 @@ class TargetSerial:
     An acknowledged not bound to a specific command is defined as: [0x00]
 
     Acknowleging a packet is not required and not done automatically.
+
+    negotiate_framing() can switch the link to the length-prefixed v2
+    framing [cmd, len16 LE, payload, crc] (acks become zero-length
+    frames), replacing the terminator scan and COBS en/decode with two
+    exact-length reads; the target falls back to the COBS framing above
+    on every reset and the host follows after a failure streak.
+
+    negotiate_crc() can independently switch the integrity check from
+    the single CRC-8 byte to a 4-byte CRC-32 trailer (little endian,
+    zlib-compatible), giving fault payloads real error detection on a
+    link the EMFI pulses actively corrupt; the target likewise reverts
+    to CRC-8 on reset and the host follows after a failure streak.
+
+    autotune_baud() discovers the highest reliable baud rate for a
+    bench by ramping negotiate_baud() under an echo probe and can
+    persist the verdict per target serial number for later sessions.
     """
     _frame_byte = bytes([0])
     _reset_sequence = bytes([0, 0, 0, 114, 0, 0, 0])
     _simple_ack = bytes([0])
     # _command_ack = bytes[<command_byte>, 0x00]
 
+    # Persistent tuned-baud cache: serial_id -> {"baud": rate}. The
+    # maximum reliable rate depends on the probe, cable run and target
+    # board, so autotune_baud() stores its verdict per bench and later
+    # sessions jump straight to the tuned rate.
+    _tuned_baud_cache_path = os.path.expanduser(
+        "~/.cache/cs-profiler/tuned-baud.json")
+
     def __init__(self, driver, interface=None, baud=38400, stopbits=1, parity="none", flush_on_err=True):
         """
         Initialize the serial connection wrapper.
@@ -179,6 +304,27 @@ class TargetSerial:
 
         self.ser = driver()
         self.interface = interface
+
+        # All reads are served from this ring buffer; a background reader
+        # thread (started by connect()) drains the driver into it so bytes
+        # sent while the host is busy never sit in the small USB FIFO.
+        # Created before connect(), which flushes it.
+        self._rx_ring = RxRingBuffer()
+        self._rx_stop = threading.Event()
+        self._rx_thread = None
+
+        # Link-health counters (see the stats property): incremented on
+        # the paths they describe, so a degrading link is visible and
+        # attributable instead of vanishing into generic exceptions.
+        # Created before connect(), which flushes (and counts it).
+        self._bytes_in_total = 0
+        self._bytes_out_total = 0
+        self._timeouts_total = 0
+        self._framing_errors_total = 0
+        self._retransmissions_total = 0
+        self._resyncs_total = 0
+        self._flushes_total = 0
+
         self.connect()
 
         self.baud=baud
@@ -187,6 +333,47 @@ class TargetSerial:
 
         self._flush_on_err = flush_on_err
 
+        # Cache of fully encoded packets keyed by (cmd, data): the campaign
+        # hot loop sends the identical start packet millions of times, so
+        # CRC + COBS encoding only ever runs once per distinct packet.
+        self._packet_cache = {}
+        self._packet_cache_limit = 256
+
+        # Precompiled ack sequences keyed by (framing, command): the
+        # campaign waits for the identical ack millions of times, so the
+        # type conversions and bytes build only ever run once per pair
+        # (the ack wire format depends on the framing mode)
+        self._ack_cache = {}
+
+        # High-baud negotiation state (see negotiate_baud())
+        self._fallback_baud = None      # baud to revert to on CRC-error storms
+        self._crc_error_streak = 0      # consecutive CRC failures in read_packet
+        self._crc_errors_total = 0      # lifetime CRC failures (metrics)
+        self._baud_fallback_threshold = 8
+
+        # Framing negotiation state (see negotiate_framing()). "cobs" is
+        # the protocol v1 boot default; "len16" the negotiated v2
+        # length-prefixed framing. The target reverts to COBS on every
+        # reset, so a streak of v2 read failures drops the host back too.
+        self.framing = "cobs"
+        self._framing_error_streak = 0
+        self._framing_fallback_threshold = 8
+
+        # CRC mode negotiation state (see negotiate_crc()). "crc8" is the
+        # boot default (0x4D, 1 trailing byte); "crc32" the negotiated
+        # zlib-compatible mode (4 trailing bytes, little endian). The
+        # target reverts to CRC-8 on every reset, so a streak of CRC
+        # failures drops the host back before blaming the baud rate.
+        self.crc_mode = "crc8"
+        self._crc_fallback_threshold = 8
+
+        # Reusable scratch buffers for read_packet_view(): one holds the
+        # raw frame, one the decoded payload. Views returned by
+        # read_packet_view() point into the decode scratch and stay
+        # valid until the next read_packet_view() call.
+        self._rx_frame_buf = bytearray(4096)
+        self._rx_decode_buf = bytearray(4096)
+
 
     def connect(self):
         """
@@ -206,34 +393,183 @@ class TargetSerial:
         self.ser.con(self.interface)
         self.flush()
 
+        # Start the background reader thread (idempotent on reconnects)
+        if self._rx_thread is None or not self._rx_thread.is_alive():
+            self._rx_stop.clear()
+            self._rx_thread = threading.Thread(
+                target=self._rx_reader_loop, name="TargetSerial-rx", daemon=True
+            )
+            self._rx_thread.start()
+
+    def close(self):
+        """
+        Stop the background reader thread. Call before discarding the
+        object if a new TargetSerial will reuse the same driver/interface.
+        """
+        self._rx_stop.set()
+        if self._rx_thread is not None:
+            self._rx_thread.join(timeout=1)
+            self._rx_thread = None
+
+    def _rx_reader_loop(self):
+        """
+        Background producer: drains the driver into the RX ring buffer.
+
+        Runs until close() is called. Driver errors (e.g. during a USB
+        power cycle) are swallowed with a short backoff so the thread
+        survives target recovery.
+        """
+        while not self._rx_stop.is_set():
+            try:
+                available = self.ser.inWaiting()
+                # Block at most 10ms when idle so stop requests are seen
+                data = self.ser.read_bytes(max(1, available), timeout=10)
+                # Opportunistic batch drain: the first byte of a burst
+                # usually arrives alone (the idle read above asks for 1),
+                # so collapse whatever the FIFO holds by now into the
+                # same iteration instead of one driver call per granule
+                while data:
+                    available = self.ser.inWaiting()
+                    if not available:
+                        break
+                    chunk = self.ser.read_bytes(available, timeout=0)
+                    if not chunk:
+                        break
+                    data += chunk
+            except Exception:
+                time.sleep(0.01)
+                continue
+            if data:
+                self._bytes_in_total += len(data)
+                self._rx_ring.push(data)
+
+    def _wait_rx(self, num_bytes, deadline):
+        """
+        Block until the ring holds num_bytes or the Deadline expires.
+        Returns the number of bytes available.
+        """
+        while len(self._rx_ring) < num_bytes and not deadline.expired():
+            time.sleep(0.0005)
+        return len(self._rx_ring)
+
     def flush_on_error(self):
         """
         Function called when an error occured (e.g. timeout in wait_for_sequence) and flush_on_err is set to true in __init__
 
-        Removes all data from the serial buffer.
+        Realigns with the stream via resync() instead of dumping the
+        whole buffer, so in-flight response bytes and reset announces
+        survive the error recovery.
         """
         if self._flush_on_err:
-            self.flush()
+            self.resync()
+
+    def resync(self, timeout=50):
+        """
+        Realign with the packet stream after an error, consuming as
+        little buffered data as possible.
+
+        flush() throws away everything received - including in-flight
+        response bytes and occasionally a freshly arrived reset
+        sequence, which then costs a full dead_timeout plus a reset
+        cycle to rediscover. resync() instead consumes only up to (and
+        including) the next frame boundary, leaving whatever follows
+        intact for the next read:
+
+        - A complete reset sequence anywhere in the buffer is consumed
+          through its end and reported, so the caller knows the target
+          rebooted and can skip its own reset probe.
+        - A partial reset sequence at the end of the buffer (the prefix
+          is only unambiguous once the 'r' is in; shorter all-zero
+          suffixes look like ordinary packet terminators) is finished
+          by waiting for its remaining bytes within the timeout instead
+          of being cut in half.
+        - Otherwise, in COBS framing, everything up to the first frame
+          boundary is consumed. The length-prefixed framing has no
+          scannable boundary, so nothing else is consumed there - the
+          framing error streak handles realignment in that mode.
+
+        Args:
+            timeout (int, optional): Time in ms to wait for a partial
+                reset sequence to complete. Defaults to 50.
+
+        Returns:
+            bool: True if a reset sequence was consumed (the target
+                rebooted), False otherwise.
+        """
+        self._resyncs_total += 1
+        ring = self._rx_ring
+        deadline = Deadline(timeout)
+        reset_seq = self._reset_sequence
+
+        while True:
+            buffered = ring.peek(len(ring))
+
+            idx = buffered.find(reset_seq)
+            if idx != -1:
+                ring.pop(idx + len(reset_seq))
+                return True
+
+            partial = False
+            for n in range(len(reset_seq) - 1, 3, -1):
+                if buffered.endswith(reset_seq[:n]):
+                    partial = True
+                    break
+            if partial and not deadline.expired():
+                time.sleep(0.0005)
+                continue
+
+            break
+
+        if self.framing == "len16":
+            return False
+
+        idx = buffered.find(self._frame_byte)
+        if idx != -1:
+            ring.pop(idx + 1)
+        return False
+
+    @staticmethod
+    def _build_crc_table(poly=0x4D):
+        """
+        Build the 256-entry lookup table for the 8-bit CRC (poly 0x4D).
+        """
+        table = []
+        for i in range(256):
+            crc = i
+            for _ in range(8):
+                if crc & 0x80:
+                    crc = ((crc << 1) ^ poly) & 0xFF
+                else:
+                    crc = (crc << 1) & 0xFF
+            table.append(crc)
+        return table
+
+    # Class-level CRC table, built once at import time (one lookup per byte
+    # instead of eight Python-level shift/xor iterations per byte)
+    _crc_table = None
 
     @staticmethod
     def _calc_crc(buf):
         """
-        Calculate CRC (0x4D) for buf
+        Calculate CRC (0x4D) for buf using a 256-entry lookup table.
 
         Raises:
             RuntimeError: If CRC calculation failed.
         """
+        if _codec is not None:
+            try:
+                return _codec.crc(bytes(buf))
+            except Exception as e:
+                raise RuntimeError(f"CRC calculation failed for buffer {buf}") from e
+
+        if TargetSerial._crc_table is None:
+            TargetSerial._crc_table = TargetSerial._build_crc_table()
+
+        table = TargetSerial._crc_table
         crc = 0x00
         try:
             for b in buf:
-                crc ^= b
-                for _ in range(8):
-                    if crc & 0x80:
-                        crc = (crc << 1) ^ 0x4D
-                        crc &= 0xFF
-                    else:
-                        crc <<= 1
-                        crc &= 0xFF
+                crc = table[crc ^ b]
         except Exception as e:
             raise RuntimeError(f"CRC calculation failed for buffer {buf}") from e
 
@@ -268,6 +604,8 @@ class TargetSerial:
             >>> TargetSerial._cobs_stuff_data(data)
             b'\x02\x11\x02\x22'
         """
+        if _codec is not None:
+            return _codec.cobs_stuff(bytes(buf), frame_byte)
 
         if not buf:
             return b""
@@ -277,14 +615,21 @@ class TargetSerial:
         code_index = 0  # index of last code byte
 
         for b in buf:
-            # frame_byte is detected or block length reached 0xFF
-            if b == frame_byte or code == 0xFF:
+            if code == 0xFF:
+                # Full 254-byte block: close it before looking at b, so
+                # a frame_byte right behind it still gets its own empty
+                # block below
+                out[code_index] = code
+                code_index = len(out)
+                out.append(0)  # append new placeholder for next code
+                code = 1
+            if b == frame_byte:
                 # close current block
                 out[code_index] = code
                 code_index = len(out)
                 out.append(0)  # append new placeholder for next code
                 code = 1
-            if b != frame_byte:
+            else:
                 out.append(b)
                 code += 1
 
@@ -321,6 +666,8 @@ class TargetSerial:
             >>> TargetSerial._cobs_unstuff_data(encoded)
             b'\x11\x00\x22'
         """
+        if _codec is not None:
+            return _codec.cobs_unstuff(bytes(buf), frame_byte)
 
         if not buf:
             return b""
@@ -350,6 +697,54 @@ class TargetSerial:
 
         return bytes(out)  # return immutable bytes obect
 
+    @staticmethod
+    def _cobs_unstuff_into(buf, out, frame_byte: int = 0x00) -> int:
+        """
+        In-place variant of _cobs_unstuff_data: decode into the
+        caller-provided writable buffer `out` instead of building a new
+        bytes object. Used by read_packet_view(), where `buf` is a
+        memoryview into the frame scratch and `out` the decode scratch,
+        so the decode copies each block exactly once.
+
+        Args:
+            buf (memoryview | bytes): COBS-encoded input.
+            out (bytearray | memoryview): Destination buffer; must hold
+                at least len(buf) bytes (decoded length never exceeds
+                the encoded length).
+            frame_byte (int, optional): Frame separator byte. Defaults to 0x00.
+
+        Raises:
+            ValueError: If a code byte is 0, or a block extends past the
+                end of the input.
+
+        Returns:
+            int: Number of decoded bytes written to `out`.
+        """
+        index = 0
+        out_index = 0
+        length = len(buf)
+
+        while index < length:
+            code = buf[index]
+            if code == 0:
+                raise ValueError("Invalid COBS: code byte cannot be 0")
+            index += 1
+
+            end = index + code - 1
+            if end > length:
+                raise ValueError("Invalid COBS: block extends past end of buffer")
+
+            block_len = end - index
+            out[out_index:out_index + block_len] = buf[index:end]
+            out_index += block_len
+            index = end
+
+            if code < 0xFF and index < length:
+                out[out_index] = frame_byte
+                out_index += 1
+
+        return out_index
+
     @staticmethod
     def _verify_crc(buf: bytes) -> bool:
         """
@@ -371,6 +766,19 @@ class TargetSerial:
         calculated_crc = TargetSerial._calc_crc(data)
         return calculated_crc == received_crc
 
+    def _crc_bytes(self, data) -> bytes:
+        """
+        CRC trailer for `data` in the active CRC mode: a single CRC-8
+        (0x4D) byte, or after negotiate_crc() the 4-byte little-endian
+        CRC-32 computed by zlib.crc32 (C speed on the host; the firmware
+        uses a matching 256-entry table).
+        """
+        if self.crc_mode == "crc32":
+            # zlib.crc32 accepts any buffer, so memoryviews from the
+            # zero-copy receive path need no conversion
+            return zlib.crc32(data).to_bytes(4, "little")
+        return bytes([self._calc_crc(data)])
+
     @staticmethod
     def type_convert_cmd(cmd) -> int:
         """
@@ -440,6 +848,60 @@ class TargetSerial:
 
         return bytes(data)
 
+    # Cache of generated PacketDataStruct subclasses keyed by field tuple,
+    # so repeated parses (one per fault packet) reuse the compiled struct
+    # instead of re-running class creation and ctypes field compilation.
+    _packet_struct_cache = {}
+
+    @staticmethod
+    def _get_packet_struct(struct_fields: list) -> type:
+        """
+        Return (and cache) the PacketDataStruct subclass for a field list.
+
+        Args:
+            struct_fields (list): Ctypes field list, e.g.
+                [("target_buffer", ctypes.c_uint8 * 68), ...]
+
+        Returns:
+            type: PacketDataStruct subclass with the given _fields_.
+        """
+        key = tuple(struct_fields)
+        struct_cls = TargetSerial._packet_struct_cache.get(key)
+        if struct_cls is None:
+            class PacketData(PacketDataStruct):
+                _fields_ = list(key)
+            struct_cls = PacketData
+            TargetSerial._packet_struct_cache[key] = struct_cls
+        return struct_cls
+
+    @staticmethod
+    def view_packet_data_struct(data, struct_fields: list):
+        """
+        Zero-copy variant of parse_packet_data_struct.
+
+        Maps the struct directly onto a writable buffer (e.g. bytearray)
+        with `from_buffer` instead of copying, and returns the struct
+        instance itself — field access reads straight from the buffer.
+        Use for read-only parsing; mutating the buffer mutates the view.
+
+        Args:
+            data (bytearray | memoryview): Writable buffer to map.
+            struct_fields (list): Ctypes field list used for parsing.
+
+        Raises:
+            ValueError: If data is too short for the struct.
+
+        Returns:
+            PacketDataStruct: Struct instance backed by `data`.
+        """
+        struct_cls = TargetSerial._get_packet_struct(struct_fields)
+        struct_size = ctypes.sizeof(struct_cls)
+
+        if len(data) < struct_size:
+            raise ValueError(f"Data too short (expected {struct_size} bytes, got {len(data)})")
+
+        return struct_cls.from_buffer(data)
+
     @staticmethod
     def parse_packet_data_struct(data: bytes | None, struct_fields: list) -> dict:
         """
@@ -468,17 +930,15 @@ class TargetSerial:
             ]
             ```
         """
-        class PacketData(PacketDataStruct):
-            _fields_ = struct_fields
-
-        struct_size = ctypes.sizeof(PacketData)
+        struct_cls = TargetSerial._get_packet_struct(struct_fields)
+        struct_size = ctypes.sizeof(struct_cls)
 
         # Ensure received data is long enough
         if len(data) < struct_size:
             raise ValueError(f"Data too short (expected {struct_size} bytes, got {len(data)})")
 
         # Populate structure from buffer
-        parsed = PacketData.from_buffer_copy(data)
+        parsed = struct_cls.from_buffer_copy(data)
         return parsed.as_dict()
 
 
@@ -505,30 +965,41 @@ class TargetSerial:
         if data:
             data = self.type_convert_data(data)
 
-        # Packet without data (just send command and terminator)
-        if not data:
-            buf = bytearray([cmd, 0])
-            self.write(buf, timeout)
-            return
+        # Serve repeated packets from the template cache (framing and CRC
+        # mode are part of the key: the same payload encodes differently
+        # per mode)
+        cache_key = (self.framing, self.crc_mode, cmd, data if data else None)
+        pkt = self._packet_cache.get(cache_key)
+
+        if pkt is None:
+            # Length-prefixed v2 framing: no COBS, no terminator
+            if self.framing == "len16":
+                if not data:
+                    pkt = bytes([cmd, 0, 0])
+                else:
+                    pkt = (bytes([cmd]) + len(data).to_bytes(2, "little")
+                           + data + self._crc_bytes(data))
 
-        # Packet with data (send encoded packet)
-        else:
-            # Compute CRC over data only
-            crc = self._calc_crc(data)
+            # Packet without data (just command and terminator)
+            elif not data:
+                pkt = bytes([cmd, 0])
 
-            # Build block = data + crc
-            block = data + bytes([crc])
+            # Packet with data (encoded packet)
+            else:
+                # Build block = data + CRC trailer (1 or 4 bytes)
+                block = data + self._crc_bytes(data)
+
+                # COBS encode
+                encoded = self._cobs_stuff_data(block)
 
-            # COBS encode
-            encoded = self._cobs_stuff_data(block)
+                # Final packet: cmd + encoded + terminator
+                pkt = bytes([cmd]) + encoded + b"\x00"
 
-            # Final packet: cmd + encoded + terminator
-            pkt = bytearray([cmd])
-            pkt.extend(encoded)
-            pkt.append(0x00)
+            if len(self._packet_cache) < self._packet_cache_limit:
+                self._packet_cache[cache_key] = pkt
 
-            # Send
-            self.write(buf, timeout)
+        # Send
+        self.write(pkt, timeout)
 
     def send_ack(self, cmd, timeout=0):
         self.send_packet(cmd, timeout)
@@ -546,10 +1017,10 @@ class TargetSerial:
             bytes: received data
         """
         if num_bytes == 0:
-            num_bytes = self.ser.inWaiting()
-        if timeout == 0:
-            timeout = 1000000000000
-        return self.ser.read_bytes(num_bytes, timeout)
+            num_bytes = len(self._rx_ring)
+
+        self._wait_rx(num_bytes, Deadline(None if timeout == 0 else timeout))
+        return self._rx_ring.pop(num_bytes)
 
     def peek(self, num_bytes : int, timeout=250) -> bytes:
         """
@@ -563,7 +1034,8 @@ class TargetSerial:
         Returns:
             bytes: received data
         """
-        self.ser.peek_bytes(num_bytes, timeout)
+        self._wait_rx(num_bytes, Deadline(None if timeout == 0 else timeout))
+        return self._rx_ring.peek(num_bytes)
 
     def read_until(self, sequence, timeout=250) -> bytes:
         """Read data until a specific sequence is encountered or timeout is reached.
@@ -577,23 +1049,23 @@ class TargetSerial:
         """
         sequence = self.type_convert_data(sequence)
 
-        result = bytearray()
         seq_len = len(sequence)
-        buffer = deque(maxlen=seq_len)  # keeps only last seq_len bytes
-        end_time = time.time() + (timeout / 1000.0)
-
-        while time.time() < end_time:
-            byte_read = self.ser.read_bytes(1, timeout=10)
-            if byte_read:
-                b = byte_read[0]
-                result.append(b)
-                buffer.append(b)
-
-                # Always check only the last seq_len bytes
-                if len(buffer) == seq_len and bytes(buffer) == bytes(sequence):
-                    break
+        ring = self._rx_ring
+        deadline = Deadline(timeout)
 
-        return bytes(result)
+        while True:
+            # Scan everything received so far without consuming it, so
+            # bytes after the sequence stay buffered for the next read
+            data = ring.peek(len(ring))
+            idx = data.find(sequence)
+            if idx != -1:
+                return ring.pop(idx + seq_len)
+
+            if deadline.expired():
+                # Timeout: return (and consume) everything received so far
+                return ring.pop(len(ring))
+
+            time.sleep(0.0005)
 
     def read_until_reset(self, timeout=250):
         """
@@ -638,10 +1110,14 @@ class TargetSerial:
             >>> cmd, data = obj.read_packet(timeout=500)
             >>> print(cmd, data)
         """
+        if self.framing == "len16":
+            return self._read_packet_len16(timeout)
+
         buf = bytearray()
         buf = self.read_until(self._frame_byte, timeout)
 
         if not buf.endswith(self._frame_byte):
+            self._timeouts_total += 1
             raise TimeoutError("receive_packet: Timeout waiting for packet terminator")
 
         # Strip terminator
@@ -659,19 +1135,511 @@ class TargetSerial:
 
             # Extract COBS-encoded block
             encoded = buf[1:]
-            decoded = self._cobs_unstuff_data(encoded)
-            if len(decoded) < 1:
+            try:
+                decoded = self._cobs_unstuff_data(encoded)
+            except ValueError:
+                self._framing_errors_total += 1
+                raise
+            crc_len = 4 if self.crc_mode == "crc32" else 1
+            if len(decoded) < crc_len:
+                self._framing_errors_total += 1
                 raise ValueError("read_packet: decode failed")
 
-            # Split data + CRC
-            data, crc = decoded[:-1], decoded[-1]
+            # Split data + CRC trailer
+            data, crc = decoded[:-crc_len], decoded[-crc_len:]
 
             # Verify CRC
-            if self._calc_crc(data) != crc:
+            if self._crc_bytes(data) != bytes(crc):
+                self._register_crc_error()
                 raise ValueError("read_packet: CRC mismatch")
 
+            self._crc_error_streak = 0
             return (cmd, data)
 
+    def _read_packet_len16(self, timeout=250):
+        """
+        Length-prefixed (protocol v2) variant of read_packet(): one
+        exact-length read for the [cmd, len16 LE] header and one for
+        [payload, crc] - no terminator scan, no COBS decode. Entered via
+        read_packet() after negotiate_framing().
+
+        The target reverts to COBS framing on every reset, so read
+        failures here feed _register_framing_error(), which drops the
+        host back to COBS after a streak.
+        """
+        header = self.read(3, timeout)
+        if len(header) < 3:
+            self._timeouts_total += 1
+            self._register_framing_error()
+            raise TimeoutError("read_packet: timeout waiting for v2 header")
+
+        cmd = header[0]
+        length = int.from_bytes(header[1:3], "little")
+        if length == 0:
+            self._framing_error_streak = 0
+            return (cmd, None)
+
+        crc_len = 4 if self.crc_mode == "crc32" else 1
+        body = self.read(length + crc_len, timeout)
+        if len(body) < length + crc_len:
+            self._timeouts_total += 1
+            self._register_framing_error()
+            raise TimeoutError("read_packet: timeout waiting for v2 payload")
+
+        data, crc = body[:length], body[length:]
+        if self._crc_bytes(data) != bytes(crc):
+            self._register_crc_error()
+            self._register_framing_error()
+            raise ValueError("read_packet: CRC mismatch")
+
+        self._crc_error_streak = 0
+        self._framing_error_streak = 0
+        return (cmd, data)
+
+    def read_packet_view(self, timeout=250):
+        """
+        Zero-copy variant of read_packet().
+
+        read_packet() allocates four times per packet before the handler
+        sees data: the frame from read_until(), the terminator strip, the
+        decode output and the CRC split. This variant parses inside two
+        reusable per-instance scratch buffers instead: the frame is
+        popped straight into one (RxRingBuffer.pop_into), COBS-decoded
+        in place into the other (_cobs_unstuff_into), and the payload is
+        returned as a writable memoryview into that scratch - which
+        view_packet_data_struct()'s from_buffer can map without further
+        copies. Works in both framings; the CRC check and error
+        registration match read_packet().
+
+        The returned view is only valid until the next read_packet_view()
+        call; callers keeping data across packets must copy it
+        (bytes(view)).
+
+        Args:
+            timeout (int, optional): Timeout in milliseconds to wait for a
+                complete packet. Defaults to 250.
+
+        Returns:
+            tuple: `(cmd, view)` where:
+                - `cmd`  (int): Command byte
+                - `view` (memoryview | None): Payload view, None for
+                  packets without data
+
+        Raises:
+            TimeoutError: If no complete packet is received before the timeout.
+            ValueError: If decoding fails or the CRC check fails.
+        """
+        ring = self._rx_ring
+        crc_len = 4 if self.crc_mode == "crc32" else 1
+
+        if self.framing == "len16":
+            header = self.read(3, timeout)
+            if len(header) < 3:
+                self._timeouts_total += 1
+                self._register_framing_error()
+                raise TimeoutError("read_packet_view: timeout waiting for v2 header")
+
+            cmd = header[0]
+            length = int.from_bytes(header[1:3], "little")
+            if length == 0:
+                self._framing_error_streak = 0
+                return (cmd, None)
+
+            body_len = length + crc_len
+            if body_len > len(self._rx_decode_buf):
+                self._rx_decode_buf = bytearray(body_len)
+            if self._wait_rx(body_len, Deadline(timeout)) < body_len:
+                self._timeouts_total += 1
+                self._register_framing_error()
+                raise TimeoutError("read_packet_view: timeout waiting for v2 payload")
+            ring.pop_into(memoryview(self._rx_decode_buf), body_len)
+
+            data = memoryview(self._rx_decode_buf)[:length]
+            crc = bytes(self._rx_decode_buf[length:body_len])
+            if self._crc_bytes(data) != crc:
+                self._register_crc_error()
+                self._register_framing_error()
+                raise ValueError("read_packet_view: CRC mismatch")
+
+            self._crc_error_streak = 0
+            self._framing_error_streak = 0
+            return (cmd, data)
+
+        # COBS framing: wait for the terminator, then pop the whole
+        # frame into the frame scratch without building intermediates
+        deadline = Deadline(timeout)
+        while True:
+            buffered = ring.peek(len(ring))
+            idx = buffered.find(self._frame_byte)
+            if idx != -1:
+                break
+            if deadline.expired():
+                self._timeouts_total += 1
+                raise TimeoutError("read_packet_view: Timeout waiting for packet terminator")
+            time.sleep(0.0005)
+
+        frame_len = idx + 1
+        if frame_len > len(self._rx_frame_buf):
+            self._rx_frame_buf = bytearray(frame_len)
+            self._rx_decode_buf = bytearray(frame_len)
+        ring.pop_into(memoryview(self._rx_frame_buf), frame_len)
+
+        # Strip terminator and split off cmd as views, no copies
+        frame = memoryview(self._rx_frame_buf)[:frame_len - 1]
+        cmd = frame[0]
+
+        # Packet without data
+        if len(frame) == 1:
+            return (cmd, None)
+
+        try:
+            decoded_len = self._cobs_unstuff_into(frame[1:], self._rx_decode_buf)
+        except ValueError:
+            self._framing_errors_total += 1
+            raise
+        if decoded_len < crc_len:
+            self._framing_errors_total += 1
+            raise ValueError("read_packet_view: decode failed")
+
+        data = memoryview(self._rx_decode_buf)[:decoded_len - crc_len]
+        crc = bytes(self._rx_decode_buf[decoded_len - crc_len:decoded_len])
+        if self._crc_bytes(data) != crc:
+            self._register_crc_error()
+            raise ValueError("read_packet_view: CRC mismatch")
+
+        self._crc_error_streak = 0
+        return (cmd, data)
+
+    def _register_framing_error(self):
+        """
+        Track consecutive v2 read failures and drop back to COBS framing
+        when a storm indicates the negotiated framing is out of step -
+        a noisy link, or a target that reset back to its COBS default.
+        """
+        if self.framing != "len16":
+            return
+        self._framing_errors_total += 1
+        self._framing_error_streak += 1
+        if self._framing_error_streak >= self._framing_fallback_threshold:
+            print(f"TargetSerial: {self._framing_error_streak} consecutive framing "
+                  "errors, falling back to COBS framing")
+            self.framing = "cobs"
+            self._framing_error_streak = 0
+            self.flush()
+
+    def negotiate_framing(self, mode="len16", timeout=500):
+        """
+        Negotiate the frame format with the target.
+
+        The target boots in COBS framing (protocol v1: COBS-encoded
+        payload plus zero terminator), which makes both ends scan and
+        en/decode every payload byte. For the trusted point-to-point
+        UART the length-prefixed v2 framing [cmd, len16 LE, payload,
+        crc] turns response parsing into two exact-length reads and
+        lets the firmware skip COBS entirely.
+
+        Sends an 'F' packet with the mode byte (0 = COBS, 1 = len16);
+        the target acks in the old framing, switches, and confirms with
+        a second ack in the new framing. The target reverts to COBS on
+        every reset and the host drops back automatically after a
+        streak of v2 read failures, so noisy links degrade to the
+        robust framing instead of desynchronizing.
+
+        Args:
+            mode (str, optional): "len16" or "cobs". Defaults to "len16".
+            timeout (int, optional): Per-ack timeout in ms. Defaults to 500.
+
+        Raises:
+            ValueError: If `mode` is unknown.
+            RuntimeError: If the target does not ack the switch, or does
+                not confirm in the new framing (host framing is restored).
+        """
+        modes = {"cobs": 0, "len16": 1}
+        if mode not in modes:
+            raise ValueError(f"negotiate_framing: unknown mode `{mode}`")
+        old_framing = self.framing
+
+        self.send_packet('F', bytes([modes[mode]]))
+        if self.wait_ack('F', timeout) != SimpleSerial_Err.OK:
+            raise RuntimeError("negotiate_framing: target did not ack mode switch")
+
+        self.framing = mode
+        if self.wait_ack('F', timeout) != SimpleSerial_Err.OK:
+            self.framing = old_framing
+            self.flush()
+            raise RuntimeError(
+                f"negotiate_framing: no confirmation in {mode} framing, reverted")
+        self._framing_error_streak = 0
+
+    def negotiate_crc(self, mode="crc32", timeout=500):
+        """
+        Negotiate the packet integrity check with the target.
+
+        The target boots with the single-byte 0x4D CRC, which misses one
+        in 256 corrupted packets - marginal for 68-byte fault payloads on
+        a link that EMFI pulses actively disturb. CRC-32 replaces the
+        trailer with 4 little-endian bytes in both framings; the host
+        computes it with zlib.crc32 (C speed, cheaper per byte than the
+        Python CRC-8 table loop) and the firmware with a 256-entry
+        lookup table at the same one-lookup-per-byte cost as its CRC-8.
+
+        Sends a 'C' packet with the mode byte (0 = crc8, 1 = crc32); the
+        target acks, switches, and confirms with a second ack (acks
+        carry no CRC, so the handshake is mode-independent). The target
+        reverts to CRC-8 on every reset and the host drops back
+        automatically after a streak of CRC failures.
+
+        Args:
+            mode (str, optional): "crc32" or "crc8". Defaults to "crc32".
+            timeout (int, optional): Per-ack timeout in ms. Defaults to 500.
+
+        Raises:
+            ValueError: If `mode` is unknown.
+            RuntimeError: If the target does not ack the switch, or does
+                not confirm it (host CRC mode is restored).
+        """
+        modes = {"crc8": 0, "crc32": 1}
+        if mode not in modes:
+            raise ValueError(f"negotiate_crc: unknown mode `{mode}`")
+        old_mode = self.crc_mode
+
+        self.send_packet('C', bytes([modes[mode]]))
+        if self.wait_ack('C', timeout) != SimpleSerial_Err.OK:
+            raise RuntimeError("negotiate_crc: target did not ack mode switch")
+
+        self.crc_mode = mode
+        if self.wait_ack('C', timeout) != SimpleSerial_Err.OK:
+            self.crc_mode = old_mode
+            self.flush()
+            raise RuntimeError(
+                f"negotiate_crc: no confirmation of {mode} mode, reverted")
+        self._crc_error_streak = 0
+
+    def _register_crc_error(self):
+        """
+        Track consecutive CRC failures and fall back to the pre-negotiation
+        baud rate when a storm indicates the high-speed link is unreliable.
+
+        A negotiated CRC-32 mode is dropped first: a target that reset is
+        back to its CRC-8 default, and that mismatch produces the same
+        storm signature without the baud rate being at fault.
+        """
+        self._crc_error_streak += 1
+        self._crc_errors_total += 1
+        if (self.crc_mode == "crc32"
+                and self._crc_error_streak >= self._crc_fallback_threshold):
+            print(f"TargetSerial: {self._crc_error_streak} consecutive CRC errors, "
+                  "falling back to CRC-8")
+            self.crc_mode = "crc8"
+            self._crc_error_streak = 0
+            self.flush()
+            return
+        if (self._fallback_baud is not None
+                and self._crc_error_streak >= self._baud_fallback_threshold):
+            print(f"TargetSerial: {self._crc_error_streak} consecutive CRC errors, "
+                  f"falling back to {self._fallback_baud} baud")
+            self.baud = self._fallback_baud
+            self._fallback_baud = None
+            self._crc_error_streak = 0
+            self.flush()
+
+    def negotiate_baud(self, new_baud=921600, timeout=500):
+        """
+        Negotiate a high-speed serial mode with the target.
+
+        The target boots at the default 38400 baud. This sends a 'b' packet
+        with the requested rate (4 bytes, little endian); the target acks at
+        the old rate, reprograms its UART divider and sends a second ack at
+        the new rate. Only after that confirmation does the negotiation count
+        as successful.
+
+        If a CRC-error storm occurs later (see `_register_crc_error`), the
+        host automatically reverts to the pre-negotiation baud rate.
+
+        Args:
+            new_baud (int, optional): Requested baud rate. Defaults to 921600
+                (exactly reachable from the target's 7.37MHz UART clock).
+            timeout (int, optional): Per-ack timeout in ms. Defaults to 500.
+
+        Raises:
+            RuntimeError: If the target does not ack the switch, or does not
+                confirm at the new rate (host baud is restored in that case).
+        """
+        old_baud = self.baud
+
+        self.send_packet('b', int(new_baud).to_bytes(4, 'little'))
+
+        # First ack arrives at the old baud rate
+        if self.wait_ack('b', timeout) != SimpleSerial_Err.OK:
+            raise RuntimeError(f"negotiate_baud: target did not ack switch to {new_baud}")
+
+        # Switch host side and wait for the confirmation ack at the new rate
+        self.baud = new_baud
+        if self.wait_ack('b', timeout) != SimpleSerial_Err.OK:
+            self.baud = old_baud
+            self.flush()
+            raise RuntimeError(f"negotiate_baud: no confirmation at {new_baud} baud, reverted to {old_baud}")
+
+        self._fallback_baud = old_baud
+        self._crc_error_streak = 0
+
+    @classmethod
+    def tuned_baud(cls, serial_id):
+        """
+        Cached auto-tuned baud rate for `serial_id`, or None when the
+        bench has not been tuned yet (see autotune_baud()).
+        """
+        try:
+            with open(cls._tuned_baud_cache_path) as f:
+                entry = json.load(f).get(str(serial_id))
+            return int(entry["baud"]) if entry else None
+        except (OSError, ValueError, KeyError, TypeError):
+            return None
+
+    @classmethod
+    def _store_tuned_baud(cls, serial_id, baud):
+        try:
+            with open(cls._tuned_baud_cache_path) as f:
+                cache = json.load(f)
+        except (OSError, ValueError):
+            cache = {}
+        cache[str(serial_id)] = {"baud": int(baud)}
+        try:
+            os.makedirs(os.path.dirname(cls._tuned_baud_cache_path),
+                        exist_ok=True)
+            with open(cls._tuned_baud_cache_path, "w") as f:
+                json.dump(cache, f, indent=2)
+        except OSError:
+            pass  # tuning still applies this session, just not the next
+
+    def _probe_echo(self, transactions, timeout=500, payload_len=32):
+        """
+        Probe the current link settings with echo transactions ('e'
+        control packet) and report whether they are clean: every reply
+        must match the sent payload and the CRC/framing/timeout counters
+        must not move.
+        """
+        payload = bytes(i % 255 + 1 for i in range(payload_len))
+        before = self.stats
+        clean = True
+        for _ in range(transactions):
+            try:
+                self.send_packet('e', payload)
+                cmd, data = self.read_packet(timeout=timeout)
+            except (TimeoutError, ValueError):
+                self.flush_on_error()
+                clean = False
+                continue
+            # Echo replies carry a 4-byte turnaround prefix (DWT cycles)
+            if cmd != ord('e') or data is None or data[4:] != payload:
+                clean = False
+        after = self.stats
+        for key in ("crc_errors", "frame_errors", "timeouts"):
+            if after[key] != before[key]:
+                clean = False
+        return clean
+
+    def autotune_baud(self, serial_id=None,
+                      rates=(115200, 230400, 460800, 921600),
+                      transactions=50, timeout=500):
+        """
+        Discover the highest reliable baud rate for this bench setup.
+
+        Different probes, cable runs and target boards support different
+        maximum rates, and the conservative 38400 default leaves most of
+        that headroom unused. This ramps negotiate_baud() upward through
+        `rates`, probing each step with echo transactions while watching
+        the link-health counters; the first rate with a CRC or framing
+        error, a timeout or an echo mismatch ends the ramp and the link
+        settles back on the last clean rate.
+
+        With `serial_id` (the ChipWhisperer serial number, or any stable
+        bench identifier) the verdict is persisted in the tuned-baud
+        cache, and the next call re-validates the cached rate with one
+        probe burst instead of ramping - so later sessions start at the
+        tuned rate immediately via `autotune_baud(serial_id)` or
+        `negotiate_baud(TargetSerial.tuned_baud(serial_id))`.
+
+        Args:
+            serial_id (str, optional): Cache key for persisting the result.
+                None skips the cache entirely. Defaults to None.
+            rates (tuple, optional): Candidate rates, tried in ascending
+                order. The defaults are the rates exactly reachable from
+                the target's 7.37MHz UART clock.
+            transactions (int, optional): Echo roundtrips per probe burst.
+                Defaults to 50.
+            timeout (int, optional): Per-ack/per-echo timeout in ms.
+                Defaults to 500.
+
+        Returns:
+            int: The baud rate the link settled on.
+        """
+        # Fast path: a cached verdict that still probes clean is re-used
+        if serial_id is not None:
+            cached = self.tuned_baud(serial_id)
+            if cached == self.baud:
+                return cached
+            if cached:
+                try:
+                    self.negotiate_baud(cached, timeout)
+                    if self._probe_echo(transactions, timeout):
+                        return cached
+                except RuntimeError:
+                    pass
+                # Cached rate no longer clean (recabled bench?): retune
+
+        best = self.baud
+        for rate in sorted(rates):
+            if rate <= best:
+                continue
+            try:
+                self.negotiate_baud(rate, timeout)
+            except RuntimeError:
+                break
+            if not self._probe_echo(transactions, timeout):
+                # Dirty rate: step the link back to the last clean one
+                try:
+                    self.negotiate_baud(best, timeout)
+                except RuntimeError:
+                    self.baud = best
+                    self.flush()
+                break
+            best = rate
+
+        if serial_id is not None:
+            self._store_tuned_baud(serial_id, best)
+        return best
+
+    def read_packet_tagged(self, timeout=250):
+        """
+        Receive a SimpleSerial packet whose first data byte is a sequence tag.
+
+        Counterpart of the firmware's sendpacket_buffered(): the target
+        prepends an 8-bit sequence number to the payload so responses can be
+        associated with executions even when transmission is double-buffered
+        and overlaps the next start command.
+
+        Args:
+            timeout (int, optional): Timeout in milliseconds to wait for a complete
+                packet. Defaults to 250.
+
+        Returns:
+            tuple: `(cmd, seq, data)` where:
+                - `cmd`  (int): Command byte
+                - `seq`  (int): Sequence tag (wraps at 256)
+                - `data` (bytes): Payload without the sequence tag
+
+        Raises:
+            TimeoutError: If no complete packet is received before the timeout.
+            ValueError: If decoding fails, the CRC check fails, or the packet
+                carries no data (tagged packets always have at least the tag).
+        """
+        cmd, data = self.read_packet(timeout)
+        if not data:
+            raise ValueError("read_packet_tagged: packet carries no sequence tag")
+
+        return (cmd, data[0], data[1:])
+
     def wait_for_sequence(self, sequence: bytes, timeout=250):
         """
         Waits for specific sequence from the target for timeout ms
@@ -688,15 +1656,26 @@ class TargetSerial:
         """
         sequence = self.type_convert_data(sequence)
 
+        # Fast path: the sequence usually arrived while send_packet was
+        # still running, so compare against the ring synchronously before
+        # arming any timeout machinery
+        ring = self._rx_ring
+        if len(ring) >= len(sequence):
+            if ring.pop(len(sequence)) == sequence:
+                return SimpleSerial_Err.OK
+            self.flush_on_error()
+            return SimpleSerial_Err.ERR_CMD
+
         x = self.read(len(sequence), timeout=timeout)
         if x == sequence:
             return SimpleSerial_Err.OK
-        elif x is None:
-            self.flush_on_error()
+
+        self.flush_on_error()
+        if len(x) < len(sequence):
+            # Fewer bytes than requested can only mean the read timed out
+            self._timeouts_total += 1
             return SimpleSerial_Err.ERR_TIMEOUT
-        else:
-            self.flush_on_error()
-            return SimpleSerial_Err.ERR_CMD
+        return SimpleSerial_Err.ERR_CMD
 
     def wait_ack(self, command=None, timeout=250):
         """
@@ -713,11 +1692,20 @@ class TargetSerial:
             SimpleSerial_Err.ERR_CMD (1): If wrong data was received
         """
 
-        if command:
-            command = self.type_convert_cmd(command)
-            ack_sequence = bytes([command, 0])
-        else:
-            ack_sequence = bytes([0])
+        cache_key = (self.framing, command)
+        ack_sequence = self._ack_cache.get(cache_key)
+        if ack_sequence is None:
+            if command:
+                command = self.type_convert_cmd(command)
+                ack_sequence = bytes([command, 0])
+            else:
+                ack_sequence = bytes([0])
+
+            # v2 acks are zero-length frames: [cmd, len16=0]; the bare ack
+            # becomes a zero-length frame with cmd 0
+            if self.framing == "len16":
+                ack_sequence = bytes([command, 0, 0]) if command else bytes([0, 0, 0])
+            self._ack_cache[cache_key] = ack_sequence
 
         return self.wait_for_sequence(ack_sequence, timeout)
 
@@ -735,6 +1723,7 @@ class TargetSerial:
         """
         data = self.type_convert_data(data)
 
+        self._bytes_out_total += len(data)
         self.ser.write(data, timeout)
 
     # Serial buffer status
@@ -745,14 +1734,48 @@ class TargetSerial:
         Returns:
             The number of characters available via a target.read() call.
         """
-        return self.ser.inWaiting()
+        return len(self._rx_ring)
 
     def flush(self):
         """
         Removes all data from the serial buffer.
         """
+        self._flushes_total += 1
+        self._rx_ring.clear()
         self.ser.flush()
 
+    @property
+    def stats(self):
+        """
+        Snapshot of the link-health counters as a plain dict:
+        bytes_in/bytes_out, crc_errors, frame_errors (COBS decode
+        failures and v2 framing errors), timeouts, retransmissions
+        (start commands re-issued by higher-level protocols, see
+        note_retransmissions), resyncs, flushes and ring_overflows.
+        Reading it is a dict build over plain ints - cheap enough to
+        snapshot per position or per metrics scrape.
+        """
+        return {
+            "bytes_in": self._bytes_in_total,
+            "bytes_out": self._bytes_out_total,
+            "crc_errors": self._crc_errors_total,
+            "frame_errors": self._framing_errors_total,
+            "timeouts": self._timeouts_total,
+            "retransmissions": self._retransmissions_total,
+            "resyncs": self._resyncs_total,
+            "flushes": self._flushes_total,
+            "ring_overflows": self._rx_ring.overflows,
+        }
+
+    def note_retransmissions(self, count=1):
+        """
+        Record start commands re-issued by a higher-level protocol (the
+        windowed pipeline re-sends in-flight starts after a fault
+        reset). The serial layer itself never retransmits; the counter
+        lives here so all link-health numbers come from one stats dict.
+        """
+        self._retransmissions_total += count
+
     def in_waiting_tx(self):
         """
         Returns the number of characters waiting to be sent by the ChipWhisperer.
@@ -38,10 +38,42 @@ class SimpleSerial_ChipWhispererLite(SimpleSerialTemplate):
         self._stopbits = 1
         self.cwlite_usart = None
         self._buf_size = None
+        # Bulk mode: fetch everything inWaiting() reports with a single USB
+        # transfer and serve subsequent reads from the target queue, instead
+        # of one USB transaction per read_bytes request. Set to False to get
+        # the old request-by-request behavior.
+        self.bulk_read = True
 
     def close(self):
         pass
 
+    def _drain_usb(self):
+        """
+        Pull all bytes the CW-Lite reports as waiting in one USB transfer
+        and buffer them in the template's target queue.
+        """
+        waiting = self.hardware_inWaiting()
+        if waiting <= 0:
+            return
+
+        data = self.cwlite_usart.read(waiting, 0)
+        for c in bytearray(data):
+            self.target_queue.append(c)
+            if self.target_count < self.max_queue_size:
+                self.target_count += 1
+            else:
+                self.target_queue.popleft()
+
+    def read_bytes(self, num=0, timeout=250) -> bytes:
+        if self.bulk_read:
+            self._drain_usb()
+        return SimpleSerialTemplate.read_bytes(self, num, timeout)
+
+    def peek_bytes(self, num=1, timeout=250) -> bytes:
+        if self.bulk_read:
+            self._drain_usb()
+        return SimpleSerialTemplate.peek_bytes(self, num, timeout)
+
     def setBaud(self, baud):
         self._baud = baud
         if self.cwlite_usart:
@@ -1 +1,202 @@
-#TODO
\ No newline at end of file
+"""
+SimpleSerial reader for plain Linux serial devices (USB-UART adapters,
+onboard UARTs) without going through the ChipWhisperer USB stack.
+
+The port is put into raw termios mode and opened non-blocking; reads are
+poll-driven and drain everything available with one bulk os.readv into a
+reusable buffer, so the per-byte overhead of the CW-Lite detour (one USB
+transaction per read) does not apply.
+
+Usage:
+    TargetSerial(SimpleSerial_LinuxTTY, "/dev/ttyUSB0")
+"""
+
+import os
+import fcntl
+import select
+import struct
+import termios
+import logging
+import time
+
+from ._base import SimpleSerialTemplate
+
+
+class SimpleSerial_LinuxTTY(SimpleSerialTemplate):
+    _name = 'Linux TTY'
+
+    # Size of the reusable bulk read buffer
+    _READ_BUF_SIZE = 4096
+
+    def __init__(self):
+        SimpleSerialTemplate.__init__(self)
+        self._baud = 38400
+        self._parity = "none"
+        self._stopbits = 1
+        self.fd = None
+        self._poll_in = None
+        # Reusable bulk read buffer: os.readv fills it in place, no
+        # per-read allocation
+        self._read_buf = bytearray(self._READ_BUF_SIZE)
+        self._read_view = memoryview(self._read_buf)
+
+    def close(self):
+        if self.fd is not None:
+            os.close(self.fd)
+            self.fd = None
+            self._poll_in = None
+
+    def con(self, interface=None):
+        """
+        Open and configure the serial device.
+
+        Args:
+            interface (str): Device path, e.g. "/dev/ttyUSB0".
+        """
+        if not interface:
+            raise ValueError("SimpleSerial_LinuxTTY requires the device path "
+                             "as interface (e.g. '/dev/ttyUSB0')")
+
+        self.fd = os.open(interface, os.O_RDWR | os.O_NOCTTY | os.O_NONBLOCK)
+        self._poll_in = select.poll()
+        self._poll_in.register(self.fd, select.POLLIN)
+
+        self._configure_port()
+        termios.tcflush(self.fd, termios.TCIOFLUSH)
+        self.connectStatus = True
+
+    def _configure_port(self):
+        """Apply raw mode, 8 data bits and the current baud/parity/stopbits."""
+        baud_const = getattr(termios, f"B{self._baud}", None)
+        if baud_const is None:
+            raise ValueError(f"Unsupported baud rate: {self._baud}")
+
+        iflag, oflag, cflag, lflag, ispeed, ospeed, cc = termios.tcgetattr(self.fd)
+
+        # Raw mode: no line editing, signals, flow control or translation
+        iflag &= ~(termios.IGNBRK | termios.BRKINT | termios.PARMRK |
+                   termios.ISTRIP | termios.INLCR | termios.IGNCR |
+                   termios.ICRNL | termios.IXON | termios.IXOFF | termios.IXANY)
+        oflag &= ~termios.OPOST
+        lflag &= ~(termios.ECHO | termios.ECHONL | termios.ICANON |
+                   termios.ISIG | termios.IEXTEN)
+
+        # 8 data bits, receiver on, ignore modem control lines
+        cflag &= ~(termios.CSIZE | termios.PARENB | termios.PARODD | termios.CSTOPB)
+        cflag |= termios.CS8 | termios.CREAD | termios.CLOCAL
+
+        if self._parity == "even":
+            cflag |= termios.PARENB
+        elif self._parity == "odd":
+            cflag |= termios.PARENB | termios.PARODD
+        elif self._parity != "none":
+            raise ValueError(f"Unsupported parity: {self._parity}")
+
+        if self._stopbits == 2:
+            cflag |= termios.CSTOPB
+        elif self._stopbits != 1:
+            raise ValueError(f"Unsupported stop bits: {self._stopbits}")
+
+        # Non-blocking reads: poll() provides the timeout behavior
+        cc[termios.VMIN] = 0
+        cc[termios.VTIME] = 0
+
+        termios.tcsetattr(self.fd, termios.TCSANOW,
+                          [iflag, oflag, cflag, lflag, baud_const, baud_const, cc])
+
+    def setBaud(self, baud):
+        self._baud = baud
+        if self.fd is not None:
+            self._configure_port()
+        else:
+            logging.error('Baud rate not set, need to connect first')
+
+    def baud(self):
+        return self._baud
+
+    def setParity(self, parity):
+        old = self._parity
+        try:
+            self._parity = parity
+            if self.fd is not None:
+                self._configure_port()
+            else:
+                logging.error('Parity not set, need to connect first')
+        except ValueError as e:
+            self._parity = old
+            raise e
+
+    def parity(self):
+        return self._parity
+
+    def setStopBits(self, stopbits):
+        old = self._stopbits
+        try:
+            self._stopbits = stopbits
+            if self.fd is not None:
+                self._configure_port()
+            else:
+                logging.error('Stop bits not set, need to connect first')
+        except ValueError as e:
+            self._stopbits = old
+            raise e
+
+    def stopBits(self):
+        return self._stopbits
+
+    def hardware_inWaiting(self):
+        buf = struct.pack("i", 0)
+        buf = fcntl.ioctl(self.fd, termios.FIONREAD, buf)
+        return struct.unpack("i", buf)[0]
+
+    def hardware_inWaitingTX(self):
+        buf = struct.pack("i", 0)
+        buf = fcntl.ioctl(self.fd, termios.TIOCOUTQ, buf)
+        return struct.unpack("i", buf)[0]
+
+    def hardware_write(self, string):
+        data = bytes(string)
+        while data:
+            try:
+                written = os.write(self.fd, data)
+                data = data[written:]
+            except BlockingIOError:
+                # Kernel TX buffer full: wait for it to drain
+                select.select([], [self.fd], [], 0.1)
+
+    def hardware_read(self, num, timeout=250):
+        """
+        Read up to num bytes, waiting at most timeout ms.
+
+        Drains whatever the kernel has buffered with one bulk os.readv per
+        poll wakeup instead of one read per byte.
+        """
+        out = bytearray()
+        deadline = time.monotonic() + timeout / 1000.0
+
+        while len(out) < num:
+            remaining_ms = (deadline - time.monotonic()) * 1000.0
+            if remaining_ms <= 0:
+                break
+            if not self._poll_in.poll(remaining_ms):
+                break  # timeout
+
+            try:
+                n = os.readv(self.fd, [self._read_view])
+            except BlockingIOError:
+                continue
+            if n == 0:
+                break  # device vanished (EOF)
+
+            take = min(n, num - len(out))
+            out.extend(self._read_view[:take])
+            if take < n:
+                # Keep the surplus for the next call via the base queue
+                for b in self._read_view[take:n]:
+                    self.target_queue.append(b)
+                    if self.target_count < self.max_queue_size:
+                        self.target_count += 1
+                    else:
+                        self.target_queue.popleft()
+
+        return bytes(out)
@@ -0,0 +1,230 @@
+"""
+In-process simulated target driver.
+
+Implements the SimpleSerialTemplate interface without any hardware: the
+firmware protocol (reset announce, 's' ack + result packet, 'p'/'c'
+echoes, 'b' baud negotiation, 'e' echo benchmark) is emulated directly
+in hardware_write()/hardware_read(), with configurable outcome
+probabilities and latencies. Together with the mock hardware classes in
+sim_target.py this lets the whole run_campaign loop execute at software
+speed for profiling, load testing and CI.
+
+Responses are scheduled on a wall-clock timeline (write computes a
+ready time, read only serves bytes whose time has come), so latency is
+modeled without ever blocking the writer - the host-side threading
+behaves exactly as it does against real hardware.
+"""
+
+import random
+import threading
+import time
+
+from ._base import SimpleSerialTemplate
+
+RESET_SEQUENCE = bytes([0, 0, 0, 114, 0, 0, 0])
+
+
+class SimTargetConfig:
+    """
+    Behavior of the simulated target.
+
+    Outcome probabilities are drawn per 's' execution (the remainder is
+    a clean 'e' end packet); latencies are uniform around the configured
+    mean with +/- `latency_jitter` relative spread. Pass an instance as
+    the TargetSerial `interface` argument:
+
+        TargetSerial(SimpleSerial_SimulatedTarget, SimTargetConfig(seed=0))
+    """
+
+    def __init__(self, fault_probability=0.01, reset_probability=0.002,
+                 crash_probability=0.001, ack_latency_s=0.0003,
+                 exec_latency_s=0.0015, latency_jitter=0.5,
+                 boot_latency_s=0.002, fault_data=None, seed=None):
+        self.fault_probability = fault_probability
+        self.reset_probability = reset_probability
+        self.crash_probability = crash_probability
+        self.ack_latency_s = ack_latency_s
+        self.exec_latency_s = exec_latency_s
+        self.latency_jitter = latency_jitter
+        self.boot_latency_s = boot_latency_s
+        # Default mimics the loop payload: a 4-byte corrupted counter
+        self.fault_data = fault_data if fault_data is not None else \
+            (12345).to_bytes(4, "little")
+        self.seed = seed
+
+
+class SimpleSerial_SimulatedTarget(SimpleSerialTemplate):
+    _name = 'Simulated Target (in-process)'
+
+    def __init__(self):
+        SimpleSerialTemplate.__init__(self)
+        self._baud = 38400
+        self._parity = "none"
+        self._stopbits = 1
+        self.config = SimTargetConfig()
+        self._random = random.Random()
+
+        # Pending output: (ready_time, bytes) chunks in timeline order,
+        # guarded by a lock since the campaign thread writes while the
+        # TargetSerial reader thread reads
+        self._lock = threading.Lock()
+        self._pending = []
+        self._rx_stream = bytearray()
+        self._write_buffer = bytearray()
+
+    def con(self, scope=None):
+        """Connect; `scope` may be a SimTargetConfig instance."""
+        if scope is not None:
+            self.config = scope
+        self._random = random.Random(self.config.seed)
+        self.connectStatus = True
+
+    def setBaud(self, baud):
+        self._baud = baud
+
+    def baud(self):
+        return self._baud
+
+    def setParity(self, parity):
+        self._parity = parity
+
+    def parity(self):
+        return self._parity
+
+    def setStopBits(self, stopbits):
+        self._stopbits = stopbits
+
+    def stopBits(self):
+        return self._stopbits
+
+    # ---------------- firmware emulation ----------------
+
+    def reset(self):
+        """Simulate a target reset (wired to MockChipWhisperer.reset_target):
+        drop all in-flight traffic and announce the reboot."""
+        with self._lock:
+            self._pending.clear()
+            self._rx_stream.clear()
+        self._queue(RESET_SEQUENCE, self.config.boot_latency_s)
+
+    def _latency(self, mean_s):
+        jitter = self.config.latency_jitter
+        return mean_s * self._random.uniform(1.0 - jitter, 1.0 + jitter)
+
+    def _queue(self, payload, delay_s):
+        """Schedule bytes on the output timeline (never earlier than
+        already-queued data, like a real UART)."""
+        ready = time.monotonic() + delay_s
+        with self._lock:
+            if self._pending and self._pending[-1][0] > ready:
+                ready = self._pending[-1][0]
+            self._pending.append((ready, bytes(payload)))
+
+    @staticmethod
+    def _encode_packet(cmd, data=None):
+        # Same wire format as the firmware's sendpacket(); reuse the
+        # host codec instead of duplicating COBS/CRC here
+        from ..simpleserial import TargetSerial
+        if not data:
+            return bytes([cmd, 0])
+        crc = TargetSerial._calc_crc(data)
+        return bytes([cmd]) + TargetSerial._cobs_stuff_data(data + bytes([crc])) + b"\x00"
+
+    def _handle_frame(self, frame):
+        """Emulate the firmware's readpacket dispatch for one frame
+        (terminator already stripped)."""
+        if not frame:
+            return
+        from ..simpleserial import TargetSerial
+
+        cmd = frame[0]
+        data = None
+        if len(frame) > 1:
+            decoded = TargetSerial._cobs_unstuff_data(bytes(frame[1:]))
+            if len(decoded) < 1 or TargetSerial._calc_crc(decoded[:-1]) != decoded[-1]:
+                return  # CRC/decode error: firmware stays silent
+            data = decoded[:-1]
+
+        if cmd == ord('s'):
+            self._execute(data[0] if data and len(data) == 1 else None)
+        elif cmd in (ord('p'), ord('c')) and data:
+            # Payload selection / runtime config: firmware echoes the
+            # applied values
+            self._queue(self._encode_packet(cmd, data),
+                        self._latency(self.config.ack_latency_s))
+        elif cmd == ord('b') and data and len(data) == 4:
+            # Baud switch: ack at the old rate, confirmation at the new
+            ack = self._encode_packet(cmd)
+            self._queue(ack, self._latency(self.config.ack_latency_s))
+            self._queue(ack, self._latency(self.config.ack_latency_s))
+        elif cmd == ord('e'):
+            # Echo benchmark: zero turnaround cycles + payload
+            self._queue(self._encode_packet(cmd, bytes(4) + (data or b"")),
+                        self._latency(self.config.ack_latency_s))
+        # Unknown commands are dropped, like the firmware's -1 return
+
+    def _execute(self, seq):
+        """One simulated payload execution: ack, then an outcome drawn
+        from the configured distribution after the execution latency.
+        `seq` mirrors the tagged-response mode (sendpacket_buffered)."""
+        cfg = self.config
+        self._queue(self._encode_packet(ord('s')), self._latency(cfg.ack_latency_s))
+
+        draw = self._random.random()
+        exec_delay = self._latency(cfg.exec_latency_s)
+        prefix = bytes([seq]) if seq is not None else b""
+
+        if draw < cfg.crash_probability:
+            return  # crash: ack was sent, the result never comes
+        if draw < cfg.crash_probability + cfg.reset_probability:
+            self._queue(self._encode_packet(ord('r'), prefix or None), exec_delay)
+        elif draw < (cfg.crash_probability + cfg.reset_probability
+                     + cfg.fault_probability):
+            self._queue(self._encode_packet(ord('f'), prefix + cfg.fault_data),
+                        exec_delay)
+        else:
+            self._queue(self._encode_packet(ord('e'), prefix or None), exec_delay)
+
+    # ---------------- SimpleSerialTemplate hardware hooks ----------------
+
+    def _collect_ready(self, num):
+        """Move due bytes from the timeline into the flat RX stream and
+        pop up to `num` of them. Caller holds no locks."""
+        now = time.monotonic()
+        with self._lock:
+            while self._pending and self._pending[0][0] <= now:
+                self._rx_stream.extend(self._pending.pop(0)[1])
+            take = self._rx_stream[:num]
+            del self._rx_stream[:num]
+        return bytes(take)
+
+    def hardware_read(self, num, timeout=250):
+        deadline = time.monotonic() + timeout / 1000.0
+        out = bytearray()
+        while len(out) < num:
+            out.extend(self._collect_ready(num - len(out)))
+            if len(out) >= num or time.monotonic() >= deadline:
+                break
+            time.sleep(0.0002)
+        return bytes(out)
+
+    def hardware_inWaiting(self):
+        now = time.monotonic()
+        with self._lock:
+            pending_ready = sum(len(chunk) for ready, chunk in self._pending
+                                if ready <= now)
+            return len(self._rx_stream) + pending_ready
+
+    def hardware_inWaitingTX(self):
+        return 0
+
+    def hardware_write(self, string):
+        # Frames end with the 0x00 terminator; COBS guarantees no zero
+        # inside a frame, so a plain split reassembles them
+        buffer = self._write_buffer
+        buffer.extend(bytearray(string))
+        while b"\x00" in buffer:
+            idx = buffer.index(0)
+            frame = bytes(buffer[:idx])
+            del buffer[:idx + 1]
+            self._handle_frame(frame)
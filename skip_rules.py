@@ -0,0 +1,62 @@
+"""
+Saturation-based skip rules for (position, glitch config) batches.
+
+A sweep-style campaign runs every config at every position, but the
+live counters often prove a batch redundant before it starts: a
+position faulting on 100% of its executions at 200V will fault at 400V
+too, and a position that hard-bricked the target twice mostly produces
+reflash time. A skip rule is a callable
+
+    rule(profiler, position_index, config_index) -> str | None
+
+returning a short reason to skip that batch or None to run it,
+registered via CSProfiler.add_skip_rule and evaluated against the live
+counters at the top of test_position's config loop. Skipped batches
+book their num_executions under the existing num_skipped result type,
+so the pruning stays auditable in the results.
+
+This module carries the stock rules; campaign scripts register plain
+closures for anything custom.
+"""
+
+
+def saturated_faults(threshold=1.0, min_trials=None):
+    """
+    Skip a config at positions where a lower-voltage config with the
+    same probe already faulted on at least `threshold` of its
+    fault/nofault trials. min_trials floors the sample size (the lower
+    config's num_executions by default), so a 1/1 fluke never prunes
+    anything.
+    """
+    def rule(profiler, position_index, config_index):
+        config = profiler.glitch_configs[config_index]
+        for other_index, other in enumerate(profiler.glitch_configs):
+            if other_index == config_index or other.probe != config.probe:
+                continue
+            if other.voltage >= config.voltage:
+                continue
+            counters = profiler.results[other_index]
+            faults = int(counters["num_faults"][position_index])
+            trials = faults + int(counters["num_nofaults"][position_index])
+            floor = min_trials if min_trials is not None \
+                else other.num_executions
+            if trials >= max(1, floor) and faults >= threshold * trials:
+                return (f"saturated at {other.voltage}V "
+                        f"({faults}/{trials} faults)")
+        return None
+    return rule
+
+
+def hard_brick_limit(limit=2):
+    """Skip every config at positions whose target hard-bricked (power
+    cycle insufficient, reflash needed) at least `limit` times, summed
+    across configs."""
+    def rule(profiler, position_index, config_index):
+        bricks = sum(
+            int(counters["num_hard_bricked"][position_index])
+            for counters in profiler.results
+        )
+        if bricks >= limit:
+            return f"hard-bricked {bricks}x"
+        return None
+    return rule
@@ -0,0 +1,135 @@
+#ifndef STM32F4_EXTI_H
+#define STM32F4_EXTI_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * Register-level EXTI capture of pulse-slot tags for the pulse-train
+ * attribution builds (-DSS_PULSE_TAG, see build/Makefile).
+ *
+ * GlitchConfig.pulse_repeats fires several pulses inside one trigger
+ * window, but a single fault/nofault response cannot say which slot of
+ * the train did the damage. With the generator's per-pulse sync output
+ * wired to the tag input, every rising edge latches the DWT cycle
+ * count - relative to ss_pulse_tag_arm(), called at trigger raise -
+ * into a small RAM array; the payload appends the snapshots to its
+ * response packet, handing the host the in-window position of every
+ * delivered pulse without a scope on the line.
+ *
+ * The ISR costs a few dozen cycles per edge inside the glitch window;
+ * the loop counter keeps counting through it, so the nofault baseline
+ * (loop_cycles) grows by a constant per delivered pulse. The host sees
+ * the slot count in the same packet and can correct for it.
+ *
+ * Included from simpleserial.c only (owns the ISR), like stm32f4-uart.h.
+ */
+
+// Tag input: PA8 by default (free on these payloads; PA11 and PA12
+// carry the boot/result and trigger lines). The pin number selects the
+// EXTI line; lines 5-9 share the one vector defined below, so a pin
+// outside that range additionally needs its matching IRQHandler.
+#ifndef SS_PULSE_TAG_PORT
+#define SS_PULSE_TAG_PORT GPIOA
+#endif
+#ifndef SS_PULSE_TAG_PIN
+#define SS_PULSE_TAG_PIN 8
+#endif
+
+// Slot capacity per execution; normally inherited from
+// simpleserial.h (the payloads size their response appendix with it),
+// kept here as a guard for standalone inclusion.
+#ifndef SS_PULSE_TAG_SLOTS
+#define SS_PULSE_TAG_SLOTS 16
+#endif
+
+/* -----------------------------
+ * SYSCFG / EXTI registers
+ * ----------------------------- */
+#define EXTI_SYSCFG_BASE   0x40013800UL
+#define EXTI_BASE          0x40013C00UL
+#define EXTI_RCC_APB2ENR   (*(volatile uint32_t *)0x40023844UL)
+#define EXTI_SYSCFGEN      (1u << 14)
+
+#define EXTI_REG32(addr)   (*(volatile uint32_t *)(addr))
+#define SYSCFG_EXTICR(n)   EXTI_REG32(EXTI_SYSCFG_BASE + 0x08 + 4 * (n))
+#define EXTI_IMR           EXTI_REG32(EXTI_BASE + 0x00)
+#define EXTI_RTSR          EXTI_REG32(EXTI_BASE + 0x08)
+#define EXTI_PR            EXTI_REG32(EXTI_BASE + 0x14)
+
+#define EXTI_NVIC_ISER0    (*(volatile uint32_t *)0xE000E100UL)
+#define EXTI9_5_IRQN       23
+
+#define PULSE_TAG_LINE     (1u << SS_PULSE_TAG_PIN)
+// Raw CYCCNT access, as in the payloads' busy-wait: no function call
+// inside the ISR. The counter is started by ss_pulse_tag_setup().
+#define PULSE_TAG_CYCCNT   (*(volatile uint32_t *)0xE0001004UL)
+
+static volatile uint32_t pulse_tag_base;
+static volatile uint32_t pulse_tag_count;
+static volatile uint32_t pulse_tag_slots_buf[SS_PULSE_TAG_SLOTS];
+
+/**
+ * @brief Configure the tag input pin and its EXTI rising-edge line.
+ *
+ * Call once after platform_init() (ss_init() does). Pulls the pin down
+ * so an unwired input never generates edges.
+ */
+void ss_pulse_tag_setup(void)
+{
+    (void)ss_cycles(); // ensure the DWT counter is running
+
+    inline_gpio_mode_setup(SS_PULSE_TAG_PORT, GPIO_MODE_INPUT,
+                           GPIO_PUPD_PULLDOWN, PULSE_TAG_LINE);
+
+    EXTI_RCC_APB2ENR |= EXTI_SYSCFGEN;
+    SYSCFG_EXTICR(SS_PULSE_TAG_PIN / 4) =
+        (SYSCFG_EXTICR(SS_PULSE_TAG_PIN / 4)
+         & ~(0xFu << ((SS_PULSE_TAG_PIN % 4) * 4)))
+        | ((uint32_t)((SS_PULSE_TAG_PORT - GPIOA) / 0x400)
+           << ((SS_PULSE_TAG_PIN % 4) * 4));
+    EXTI_RTSR |= PULSE_TAG_LINE;
+    EXTI_PR = PULSE_TAG_LINE; // clear a stale pending flag
+    EXTI_IMR |= PULSE_TAG_LINE;
+
+    EXTI_NVIC_ISER0 = (1u << EXTI9_5_IRQN);
+}
+
+/**
+ * @brief Start a capture window: zero the slot count, latch the time base.
+ *
+ * The payloads call this immediately before raising the trigger, so
+ * the recorded slot offsets are cycles into the glitch window.
+ */
+void ss_pulse_tag_arm(void)
+{
+    pulse_tag_count = 0;
+    pulse_tag_base = PULSE_TAG_CYCCNT;
+}
+
+/**
+ * @brief Snapshots of the current capture window.
+ *
+ * @param slots Receives the slot-offset array (cycles since arm).
+ * @return Edges observed since ss_pulse_tag_arm(), possibly more than
+ *         the SS_PULSE_TAG_SLOTS timestamps actually stored.
+ */
+size_t ss_pulse_tag_read(const volatile uint32_t **slots)
+{
+    *slots = pulse_tag_slots_buf;
+    return pulse_tag_count;
+}
+
+void EXTI9_5_IRQHandler(void)
+{
+    if (EXTI_PR & PULSE_TAG_LINE)
+    {
+        EXTI_PR = PULSE_TAG_LINE; // write-1-to-clear
+        uint32_t count = pulse_tag_count;
+        if (count < SS_PULSE_TAG_SLOTS)
+            pulse_tag_slots_buf[count] = PULSE_TAG_CYCCNT - pulse_tag_base;
+        pulse_tag_count = count + 1;
+    }
+}
+
+#endif /* STM32F4_EXTI_H */
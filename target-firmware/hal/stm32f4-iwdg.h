@@ -0,0 +1,59 @@
+#ifndef IWDG_H
+#define IWDG_H
+
+#include <stdint.h>
+
+/*
+ * Independent watchdog (IWDG), clocked from the ~32kHz LSI.
+ *
+ * Once started the IWDG can only be cleared by a reset — which is
+ * exactly the property the profiling payloads want: a glitch that
+ * corrupts control flow stops the kicks, the target self-resets within
+ * the configured window and announces itself through the normal reset
+ * sequence, without waiting for the host's dead_timeout plus an nrst
+ * toggle. Because it cannot be stopped, the kicks must also cover the
+ * idle wait for host commands (see the getch wait loops in
+ * stm32f4-uart.h).
+ */
+
+#define IWDG_BASE 0x40003000UL
+#define IWDG_KR   (*(volatile uint32_t *)(IWDG_BASE + 0x00))
+#define IWDG_PR   (*(volatile uint32_t *)(IWDG_BASE + 0x04))
+#define IWDG_RLR  (*(volatile uint32_t *)(IWDG_BASE + 0x08))
+#define IWDG_SR   (*(volatile uint32_t *)(IWDG_BASE + 0x0C))
+
+#define IWDG_KEY_UNLOCK 0x5555u
+#define IWDG_KEY_KICK   0xAAAAu
+#define IWDG_KEY_START  0xCCCCu
+
+/**
+ * @brief Start the watchdog with a timeout of roughly timeout_ms.
+ *
+ * Prescaler is fixed at /32, giving ~1ms per tick from the 32kHz LSI;
+ * the reload value clamps to the 12-bit maximum (~4s). Starting the
+ * IWDG also starts the LSI oscillator.
+ */
+static inline void iwdg_start(uint32_t timeout_ms)
+{
+    uint32_t reload = timeout_ms; /* 1 tick ~= 1ms at LSI/32 */
+    if (reload > 0xFFF)
+        reload = 0xFFF;
+
+    IWDG_KR = IWDG_KEY_START;  /* enables LSI and the counter */
+    IWDG_KR = IWDG_KEY_UNLOCK; /* unlock PR/RLR */
+    IWDG_PR = 3;               /* LSI / 32 */
+    IWDG_RLR = reload;
+    while (IWDG_SR & 0x3)
+        ; /* wait for PR/RLR to latch */
+    IWDG_KR = IWDG_KEY_KICK;
+}
+
+/**
+ * @brief Reload the watchdog counter.
+ */
+static inline void iwdg_kick(void)
+{
+    IWDG_KR = IWDG_KEY_KICK;
+}
+
+#endif /* IWDG_H */
@@ -0,0 +1,398 @@
+#ifndef STM32F4_UART_H
+#define STM32F4_UART_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// Watchdog builds (-DSS_WATCHDOG) must keep kicking while blocked in a
+// getch wait loop, otherwise an idle target (host between executions)
+// would watchdog-reset despite being perfectly healthy.
+#ifdef SS_WATCHDOG
+#include "stm32f4-iwdg.h"
+#endif
+
+/*
+ * Register-level DMA/interrupt-driven UART path for the STM32F4 target.
+ *
+ * The ChipWhisperer HAL's putch()/getch() are fully blocking: at 38400 baud
+ * a 68-byte fault packet stalls the target for ~18ms during which it cannot
+ * accept the next start command. This header provides:
+ *
+ *   - RX: DMA2 Stream2 (channel 4, USART1_RX) filling a circular buffer,
+ *     drained by uart_dma_getch() with a software read index.
+ *   - TX: a software ring buffer drained by the USART1 TXE interrupt, so
+ *     uart_dma_putch() returns as soon as the byte is queued.
+ *
+ * The DMA/interrupt path is enabled by building with -DSS_UART_DMA (see
+ * build/Makefile); uart_set_baud() is always available. This header is
+ * included from simpleserial.c only; with SS_UART_DMA it contains the
+ * interrupt handler and must not be included from a second translation unit.
+ *
+ * Assumes init_uart() from the ChipWhisperer HAL has already configured
+ * USART1 pins, baud rate and enabled the peripheral.
+ */
+
+/* -----------------------------
+ * STM32F4 Base Addresses
+ * ----------------------------- */
+#define USART1_BASE 0x40011000UL
+#define RCC_BASE    0x40023800UL
+#define DMA2_BASE   0x40026400UL
+#define NVIC_ISER   0xE000E100UL
+
+/* -----------------------------
+ * USART Register Offsets
+ * ----------------------------- */
+#define USART_SR_OFFSET  0x00
+#define USART_DR_OFFSET  0x04
+#define USART_BRR_OFFSET 0x08
+#define USART_CR1_OFFSET 0x0C
+#define USART_CR3_OFFSET 0x14
+
+#define UART_REG32(addr) (*(volatile uint32_t *)(addr))
+
+#define USART1_SR  UART_REG32(USART1_BASE + USART_SR_OFFSET)
+#define USART1_DR  UART_REG32(USART1_BASE + USART_DR_OFFSET)
+#define USART1_BRR UART_REG32(USART1_BASE + USART_BRR_OFFSET)
+#define USART1_CR1 UART_REG32(USART1_BASE + USART_CR1_OFFSET)
+#define USART1_CR3 UART_REG32(USART1_BASE + USART_CR3_OFFSET)
+
+/* USART bits */
+#define USART_SR_TXE   (1u << 7)
+#define USART_CR1_TXEIE (1u << 7)
+#define USART_CR1_OVER8 (1u << 15)
+#define USART_CR3_DMAR (1u << 6)
+
+/* -----------------------------
+ * RCC
+ * ----------------------------- */
+#define RCC_AHB1ENR UART_REG32(RCC_BASE + 0x30)
+#define RCC_AHB1ENR_DMA2EN (1u << 22)
+
+/* -----------------------------
+ * DMA2 Stream 2 (USART1_RX, channel 4)
+ * ----------------------------- */
+#define DMA_LISR_OFFSET   0x00
+#define DMA_LIFCR_OFFSET  0x08
+#define DMA_S2CR_OFFSET   (0x10 + 0x18 * 2)
+#define DMA_S2NDTR_OFFSET (0x14 + 0x18 * 2)
+#define DMA_S2PAR_OFFSET  (0x18 + 0x18 * 2)
+#define DMA_S2M0AR_OFFSET (0x1C + 0x18 * 2)
+
+#define DMA2_LIFCR  UART_REG32(DMA2_BASE + DMA_LIFCR_OFFSET)
+#define DMA2_S2CR   UART_REG32(DMA2_BASE + DMA_S2CR_OFFSET)
+#define DMA2_S2NDTR UART_REG32(DMA2_BASE + DMA_S2NDTR_OFFSET)
+#define DMA2_S2PAR  UART_REG32(DMA2_BASE + DMA_S2PAR_OFFSET)
+#define DMA2_S2M0AR UART_REG32(DMA2_BASE + DMA_S2M0AR_OFFSET)
+
+/* Stream CR bits */
+#define DMA_SxCR_EN     (1u << 0)
+#define DMA_SxCR_CIRC   (1u << 8)
+#define DMA_SxCR_MINC   (1u << 10)
+#define DMA_SxCR_CHSEL4 (4u << 25)
+
+/* USART1 global interrupt */
+#define USART1_IRQn 37
+
+/* -----------------------------
+ * Baud Rate Reconfiguration
+ * ----------------------------- */
+
+// USART1 peripheral clock. The CW308 STM32F4 target runs directly off the
+// 7.37MHz ChipWhisperer CLKIN, which divides exactly into 38400/460800 (16x
+// oversampling) and 921600 (8x oversampling).
+#ifndef SS_UART_PCLK_HZ
+#define SS_UART_PCLK_HZ 7372800UL
+#endif
+
+/**
+ * @brief Reprogram the USART1 baud rate divider.
+ *
+ * Uses 16x oversampling where possible and switches to 8x oversampling
+ * (OVER8) for baud rates above fPCLK/16, which is required to reach
+ * 921600 baud from the 7.37MHz peripheral clock.
+ *
+ * @param baud New baud rate in bit/s.
+ */
+static inline void uart_set_baud(uint32_t baud)
+{
+    if (baud > SS_UART_PCLK_HZ / 16)
+    {
+        // 8x oversampling: USARTDIV*16 = 2*fPCLK/baud,
+        // fraction uses 3 bits in BRR[2:0]
+        uint32_t div16 = (2 * SS_UART_PCLK_HZ + baud / 2) / baud;
+        USART1_CR1 |= USART_CR1_OVER8;
+        USART1_BRR = (div16 & 0xFFF0) | ((div16 & 0xF) >> 1);
+    }
+    else
+    {
+        // 16x oversampling: BRR = fPCLK/baud (fixed point, 1/16ths)
+        USART1_CR1 &= ~USART_CR1_OVER8;
+        USART1_BRR = (SS_UART_PCLK_HZ + baud / 2) / baud;
+    }
+}
+
+#ifdef SS_FAST_BOOT
+
+/*
+ * Fast-boot bring-up: replaces the HAL's platform_init()/init_uart() pair
+ * (PLL lock, RNG, full HAL UART driver) with the minimum needed for the
+ * profiling payloads — HSE bypass clock, PA9/PA10 UART pins, USART1.
+ * Boot time lands on the critical path of every fault: faultPacketHandler
+ * resets the target and waits for the reset sequence before continuing.
+ *
+ * The DWT cycle counter is started first so send_reset_sequence() can
+ * report the reset-to-ready time in an extended reset packet.
+ */
+
+/* RCC clock control / configuration */
+#define RCC_CR   UART_REG32(RCC_BASE + 0x00)
+#define RCC_CFGR UART_REG32(RCC_BASE + 0x08)
+#define RCC_CR_HSEON  (1u << 16)
+#define RCC_CR_HSERDY (1u << 17)
+#define RCC_CR_HSEBYP (1u << 18)
+#define RCC_CFGR_SW_HSE  0x1u
+#define RCC_CFGR_SWS_HSE (0x1u << 2)
+
+#define RCC_APB2ENR UART_REG32(RCC_BASE + 0x44)
+#define RCC_AHB1ENR_GPIOAEN  (1u << 0)
+#define RCC_APB2ENR_USART1EN (1u << 4)
+
+/* GPIOA pin muxing (PA9 = USART1_TX, PA10 = USART1_RX, AF7) */
+#define GPIOA_BASE  0x40020000UL
+#define GPIOA_MODER UART_REG32(GPIOA_BASE + 0x00)
+#define GPIOA_AFRH  UART_REG32(GPIOA_BASE + 0x24)
+
+/* USART enable bits */
+#define USART_CR1_UE (1u << 13)
+#define USART_CR1_TE (1u << 3)
+#define USART_CR1_RE (1u << 2)
+#define USART_SR_RXNE (1u << 5)
+
+/* DWT cycle counter (boot-time measurement) */
+#define DWT_CTRL   UART_REG32(0xE0001000UL)
+#define DWT_CYCCNT UART_REG32(0xE0001004UL)
+#define SCB_DEMCR  UART_REG32(0xE000EDFCUL)
+#define SCB_DEMCR_TRCENA    (1u << 24)
+#define DWT_CTRL_CYCCNTENA  (1u << 0)
+
+/**
+ * @brief Minimal platform bring-up for the profiling payloads.
+ *
+ * Switches SYSCLK to the external 7.37MHz CLKIN (HSE bypass, required for
+ * the SS_UART_PCLK_HZ baud dividers), configures the UART pins and enables
+ * USART1 at 38400 baud. Skips the PLL, flash wait states and RNG that
+ * platform_init() sets up — none of the payloads use them.
+ */
+void fast_boot_init(void)
+{
+    // Start the cycle counter first so the boot report covers everything
+    SCB_DEMCR |= SCB_DEMCR_TRCENA;
+    DWT_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+
+    // HSE bypass (external clock, no crystal startup delay) as SYSCLK
+    RCC_CR |= RCC_CR_HSEBYP | RCC_CR_HSEON;
+    while (!(RCC_CR & RCC_CR_HSERDY))
+        ;
+    RCC_CFGR = (RCC_CFGR & ~0x3u) | RCC_CFGR_SW_HSE;
+    while ((RCC_CFGR & (0x3u << 2)) != RCC_CFGR_SWS_HSE)
+        ;
+
+    // GPIOA (UART pins + trigger) and USART1 clocks
+    RCC_AHB1ENR |= RCC_AHB1ENR_GPIOAEN;
+    RCC_APB2ENR |= RCC_APB2ENR_USART1EN;
+
+    // PA9/PA10 to alternate function 7 (USART1)
+    GPIOA_MODER = (GPIOA_MODER & ~((3u << 18) | (3u << 20))) |
+                  (2u << 18) | (2u << 20);
+    GPIOA_AFRH = (GPIOA_AFRH & ~((0xFu << 4) | (0xFu << 8))) |
+                 (7u << 4) | (7u << 8);
+
+    uart_set_baud(38400);
+    USART1_CR1 |= USART_CR1_UE | USART_CR1_TE | USART_CR1_RE;
+}
+
+/**
+ * @brief Blocking register-level transmit (fast-boot putch replacement).
+ */
+static void uart_putch_poll(char c)
+{
+    while (!(USART1_SR & USART_SR_TXE))
+        ;
+    USART1_DR = (uint8_t)c;
+}
+
+/**
+ * @brief Blocking register-level receive (fast-boot getch replacement).
+ */
+static char uart_getch_poll(void)
+{
+    while (!(USART1_SR & USART_SR_RXNE))
+    {
+#ifdef SS_WATCHDOG
+        iwdg_kick();
+#endif
+    }
+    return (char)USART1_DR;
+}
+
+#endif /* SS_FAST_BOOT */
+
+#ifdef SS_UART_DMA
+
+/* -----------------------------
+ * Buffer Configuration
+ * ----------------------------- */
+#ifndef SS_UART_RX_DMA_BUF_SIZE
+#define SS_UART_RX_DMA_BUF_SIZE 256 // must be a power of two
+#endif
+// The TX queue must absorb the largest in-flight response burst without
+// filling, or uart_dma_putch() stalls the main loop and target turnaround
+// becomes dependent on response size again: size it above the windowed
+// pipeline's worst case (window of 4 x COBS-encoded 68-byte memcpy fault
+// responses is ~300 bytes).
+#ifndef SS_UART_TX_QUEUE_SIZE
+#define SS_UART_TX_QUEUE_SIZE 512 // must be a power of two
+#endif
+
+/* DMA circular RX buffer, written by hardware, drained by uart_dma_getch() */
+static volatile uint8_t uart_rx_dma_buf[SS_UART_RX_DMA_BUF_SIZE];
+static size_t uart_rx_read_index = 0;
+
+/* Interrupt-driven TX ring buffer */
+static volatile uint8_t uart_tx_queue[SS_UART_TX_QUEUE_SIZE];
+static volatile size_t uart_tx_head = 0; // next write slot (producer)
+static volatile size_t uart_tx_tail = 0; // next byte to send (ISR)
+
+/**
+ * @brief Configure DMA2 Stream2 as circular USART1 RX and enable the
+ *        USART1 interrupt used for the TX queue.
+ *
+ * Call once after init_uart().
+ */
+static void uart_dma_init(void)
+{
+    // Enable DMA2 clock
+    RCC_AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+
+    // Disable stream before configuration
+    DMA2_S2CR &= ~DMA_SxCR_EN;
+    while (DMA2_S2CR & DMA_SxCR_EN)
+        ;
+    // Clear stream 2 interrupt flags
+    DMA2_LIFCR = (0x3Du << 16);
+
+    // Peripheral: USART1 data register, Memory: circular RX buffer
+    DMA2_S2PAR = USART1_BASE + USART_DR_OFFSET;
+    DMA2_S2M0AR = (uint32_t)uart_rx_dma_buf;
+    DMA2_S2NDTR = SS_UART_RX_DMA_BUF_SIZE;
+
+    // Channel 4, circular, memory increment, peripheral-to-memory
+    DMA2_S2CR = DMA_SxCR_CHSEL4 | DMA_SxCR_CIRC | DMA_SxCR_MINC;
+    DMA2_S2CR |= DMA_SxCR_EN;
+
+    // Route USART1 RX through DMA
+    USART1_CR3 |= USART_CR3_DMAR;
+
+    uart_rx_read_index = 0;
+    uart_tx_head = 0;
+    uart_tx_tail = 0;
+
+    // Enable USART1 interrupt in NVIC (TXEIE is toggled on demand)
+    UART_REG32(NVIC_ISER + 4 * (USART1_IRQn / 32)) = (1u << (USART1_IRQn % 32));
+}
+
+/**
+ * @brief Number of received bytes waiting in the DMA RX buffer.
+ */
+static size_t uart_dma_rx_available(void)
+{
+    // DMA write position = buffer size - remaining transfer count
+    size_t write_index = SS_UART_RX_DMA_BUF_SIZE - DMA2_S2NDTR;
+    return (write_index - uart_rx_read_index) & (SS_UART_RX_DMA_BUF_SIZE - 1);
+}
+
+/**
+ * @brief Read one byte from the DMA RX buffer (blocks until available).
+ */
+static uint8_t uart_dma_getch(void)
+{
+    while (uart_dma_rx_available() == 0)
+    {
+#ifdef SS_WATCHDOG
+        iwdg_kick();
+#endif
+    }
+    uint8_t byte = uart_rx_dma_buf[uart_rx_read_index];
+    uart_rx_read_index = (uart_rx_read_index + 1) & (SS_UART_RX_DMA_BUF_SIZE - 1);
+    return byte;
+}
+
+/**
+ * @brief Number of bytes still queued for transmission.
+ */
+static size_t uart_dma_tx_pending(void)
+{
+    return (uart_tx_head - uart_tx_tail) & (SS_UART_TX_QUEUE_SIZE - 1);
+}
+
+/**
+ * @brief Queue one byte for interrupt-driven transmission.
+ *
+ * Returns immediately once the byte is enqueued; the TXE interrupt drains
+ * the queue in the background. Blocks only if the queue is full.
+ */
+static void uart_dma_putch(uint8_t c)
+{
+    size_t next_head = (uart_tx_head + 1) & (SS_UART_TX_QUEUE_SIZE - 1);
+
+    // Queue full: wait for the ISR to free a slot. Should not happen with
+    // a correctly sized queue (see SS_UART_TX_QUEUE_SIZE); the drain takes
+    // ~260us per byte at 38400 baud, so kick the watchdog while stalled.
+    while (next_head == uart_tx_tail)
+    {
+#ifdef SS_WATCHDOG
+        iwdg_kick();
+#endif
+    }
+
+    uart_tx_queue[uart_tx_head] = c;
+    uart_tx_head = next_head;
+
+    // Kick the transmitter (enables TXE interrupt)
+    USART1_CR1 |= USART_CR1_TXEIE;
+}
+
+/**
+ * @brief Block until the TX queue has fully drained.
+ */
+static void uart_dma_tx_flush(void)
+{
+    while (uart_dma_tx_pending() > 0)
+        ;
+}
+
+/**
+ * @brief USART1 interrupt handler: drains the TX queue on TXE.
+ */
+void USART1_IRQHandler(void)
+{
+    if ((USART1_SR & USART_SR_TXE) && (USART1_CR1 & USART_CR1_TXEIE))
+    {
+        if (uart_tx_tail != uart_tx_head)
+        {
+            USART1_DR = uart_tx_queue[uart_tx_tail];
+            uart_tx_tail = (uart_tx_tail + 1) & (SS_UART_TX_QUEUE_SIZE - 1);
+        }
+        else
+        {
+            // Queue empty: stop TXE interrupts until the next putch
+            USART1_CR1 &= ~USART_CR1_TXEIE;
+        }
+    }
+}
+
+#endif /* SS_UART_DMA */
+
+#endif /* STM32F4_UART_H */
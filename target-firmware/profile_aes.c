@@ -0,0 +1,145 @@
+/*
+ * emfi-profiler_aes.c
+ *
+ * Description:
+ * AES-128 known-answer fault target: encrypts a fixed plaintext with a
+ * fixed key inside the trigger window and compares the ciphertext
+ * against the reference computed at boot. A mismatch is exactly the
+ * faulty-ciphertext input DFA-style key recovery needs, so the fault
+ * packet carries the full ciphertext.
+ *
+ * Communication:
+ * 1. Reset Signal (sent on startup):
+ *    - At program start, the MCU sends a reset sequence using send_reset_sequence().
+ *
+ *  2. Host sends a start packet:
+ *       - Command: 's'
+ *       - Data:    None (or a one-byte sequence tag for windowed mode)
+ *       - Action:  MCU raises trigger GPIO and runs one encryption
+ *
+ *  3. MCU sends a response packet:
+ *       - If the ciphertext matches the boot-time reference:
+ *           - Command: 'e' (end signal)
+ *           - Data:    None
+ *       - If the ciphertext differs:
+ *           - Command: 'f' (fault)
+ *           - Data:    the 16-byte faulty ciphertext
+ *
+ * Crypto backend (see build/Makefile `aes` target):
+ *       - default:   software mbedtls (CRYPTO_TARGET=MBEDTLS), ~10k
+ *                    cycles per encryption
+ *       - AES_HW=1:  STM32F4 CRYP peripheral (CRYPTO_TARGET=HWAES),
+ *                    hundreds of cycles - a much shorter per-shot
+ *                    window, so far more shots/hour at a given
+ *                    dead_timeout
+ * Both route through the aes-independant.c dispatch, so this file is
+ * backend-agnostic.
+ */
+
+#include "hal.h"
+#include "hal/stm32f4-hal.h"
+#include "simpleserial/simpleserial.h"
+#include "aes-independant.h"
+#include <stdint.h>
+#include <string.h>
+
+#define setup_trigger() inline_gpio_mode_setup(GPIOA, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLDOWN, GPIO12)
+#define set_trigger() inline_gpio_set(GPIOA, GPIO12)
+#define clear_trigger() inline_gpio_clear(GPIOA, GPIO12)
+
+#define AES_BLOCK_LEN 16
+
+// Fixed key/plaintext (SP 800-38A AES-128 ECB vector): DFA wants every
+// shot on the identical computation, so neither is runtime-configurable.
+static uint8_t aes_key[KEY_LENGTH] = {DEFAULT_KEY};
+static const uint8_t plaintext[AES_BLOCK_LEN] = {
+    0x6b, 0xc1, 0xbe, 0xe2, 0x2e, 0x40, 0x9f, 0x96,
+    0xe9, 0x3d, 0x7e, 0x11, 0x73, 0x93, 0x17, 0x2a,
+};
+
+// Reference ciphertext, computed once at boot (unglitched)
+static uint8_t expected[AES_BLOCK_LEN];
+
+/**
+ * @brief Run one encryption of the fixed plaintext, wrapped in the trigger GPIO.
+ *
+ * The backend's pre/post-trigger hooks (peripheral re-init on the CRYP
+ * path, no-ops on mbedtls) run outside the window, so only the
+ * encryption proper is exposed to the pulse.
+ *
+ * @param ciphertext Output buffer (AES_BLOCK_LEN bytes).
+ */
+static void run_aes_once(uint8_t *ciphertext)
+{
+    memcpy(ciphertext, plaintext, AES_BLOCK_LEN);
+    aes_indep_enc_pretrigger(ciphertext);
+
+    set_trigger(); // Raise trigger
+    aes_indep_enc(ciphertext); // in-place encryption
+    clear_trigger(); // Lower trigger
+
+    aes_indep_enc_posttrigger(ciphertext);
+}
+
+int main(void)
+{
+    platform_init();
+    init_uart();
+    ss_init(); // set up DMA/interrupt UART path when built with SS_UART_DMA
+    setup_trigger();
+    ss_result_gpio_setup(); // no-op unless built with SS_RESULT_GPIO
+    send_reset_sequence();
+
+    aes_indep_init();
+    aes_indep_key(aes_key);
+
+    // Boot-time reference: trigger toggles before the host sends any
+    // start, which is harmless (the pulse generator is not yet armed
+    // for this position while the target is still announcing itself)
+    run_aes_once(expected);
+
+    uint8_t ciphertext[AES_BLOCK_LEN];
+    while (1)
+    {
+        ss_wdt_kick();
+        uint8_t cmd;
+        uint8_t *data;
+        size_t data_len;
+        int res = readpacket(&cmd, &data, &data_len); // Read start signal
+        if (res == 0 && cmd == 's' && data && data_len == 1)
+        {
+            // Windowed mode: sequence-tagged start, no per-start ack; the
+            // response carries the same tag for host-side matching.
+            uint8_t seq = data[0];
+            run_aes_once(ciphertext);
+
+            if (memcmp(ciphertext, expected, AES_BLOCK_LEN) != 0)
+                sendpacket_buffered('f', seq, ciphertext, AES_BLOCK_LEN);
+            else
+                sendpacket_buffered('e', seq, NULL, 0);
+        }
+        else if (res == 0 && cmd == 's')
+        {
+            if (!ss_merged_ack_enabled())
+                send_ack(cmd); // Acknowledge start signal (skipped in merged-ack mode)
+            ss_result_gpio_clear(); // Result line low while executing
+
+            run_aes_once(ciphertext);
+
+            if (memcmp(ciphertext, expected, AES_BLOCK_LEN) != 0){
+                sendpacket('f', ciphertext, AES_BLOCK_LEN); // Fault packet
+            }
+            else {
+#ifdef SS_RESULT_GPIO
+                ss_result_gpio_set(); // Nofault: no serial response at all
+#else
+                sendpacket('e', NULL, 0); // End signal
+#endif
+            }
+        }
+        else if (res == 0)
+        {
+            ss_handle_control_packet(cmd, data, data_len); // e.g. 'b' baud switch
+        }
+    }
+}
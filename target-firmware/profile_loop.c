@@ -21,17 +21,37 @@
  *       - Trigger GPIO set high at start, low at end
  *       - Loop counter incremented OUTER_COUNT * INNER_COUNT times
  *
- *  4. MCU sends a response packet:
+ *  4. MCU sends a response packet (all fields uint32, little endian):
  *       - If loop count matches TOTAL_COUNT:
  *           - Command: 'e' (end signal)
- *           - Data:    None
+ *           - Data:    [loop_cycles] DWT cycles between trigger raise
+ *                      and trigger clear
  *       - If loop count does not match TOTAL_COUNT:
  *           - Command: 'f' (fault)
- *           - Data:    unsigned int (usually 4 bytes) containing the actual counter value
+ *           - Data:    [counter, trigger_cycles, detect_cycles]
+ *                      counter        actual counter value
+ *                      trigger_cycles DWT->CYCCNT snapshot at trigger raise
+ *                      detect_cycles  DWT->CYCCNT snapshot at fault detection
+ *                      The host subtracts the snapshots to place the
+ *                      disturbance within the loop window per shot,
+ *                      without a scope on the trigger line.
  *
  * Configuration:
  *       - OUTER_COUNT (500): Number of iterations for the outer loop
  *       - INNER_COUNT (500): Number of iterations for the inner loop
+ *       - Pre-trigger delay ('c' packet, CFG_PRE_TRIGGER_DELAY): DWT
+ *         cycles to busy-wait between trigger raise and loop entry,
+ *         for on-target injection-timing sweeps (default 0)
+ *       - ART accelerator ('c' packet, CFG_ART_CONFIG): flash prefetch/
+ *         cache enable bits, for deterministic-timing experiments; see
+ *         ss_configure_art(). Build with SS_RAM_PAYLOAD=1 to run the
+ *         loop from SRAM and take flash timing out entirely.
+ *       - Pulse-train attribution (SS_PULSE_TAG builds): 'e'/'f'
+ *         responses additionally carry [slot_count (u8),
+ *         slot_cycles (u32 LE) x stored] - per-pulse DWT snapshots
+ *         relative to trigger raise, captured from the generator's
+ *         sync line (hal/stm32f4-exti.h) - so every pulse of a
+ *         pulse_repeats train is placeable within the loop window.
  */
 
 #include "hal.h"
@@ -47,6 +67,11 @@
 #define set_trigger() inline_gpio_set(GPIOA, GPIO12)
 #define clear_trigger() inline_gpio_clear(GPIOA, GPIO12)
 
+// Direct CYCCNT access for the pre-trigger busy-wait: polling through
+// ss_cycles() would add a function call to every loop iteration. The
+// counter is guaranteed running by the ss_cycles() snapshot taken first.
+#define DWT_CYCCNT_RAW (*(volatile uint32_t *)0xE0001004UL)
+
 #define TOTAL_COUNT (OUTER_COUNT * INNER_COUNT) // Make sure that 
 // Compile-time check: ensure TOTAL_COUNT fits in unsigned int
 #if TOTAL_COUNT > UINT_MAX
@@ -59,42 +84,326 @@
 #define OUTER_COUNT 500 // Number of iterations for outer loop
 #define INNER_COUNT 500 // Number of iterations for inner loop
 
+#define BATCH_MAX_ITERATIONS 64 // Upper bound for 'B' batch requests
+
+// Runtime-configurable loop bounds ('c' config packet), defaulting to the
+// compile-time values. Sweeping loop length no longer requires a reflash.
+static unsigned int outer_count = OUTER_COUNT;
+static unsigned int inner_count = INNER_COUNT;
+
+// DWT-based busy-wait inserted between trigger raise and loop entry.
+// Sweeping this parameter moves the pulse window across the loop in
+// single-cycle steps entirely on-target, without the trigger-path
+// latency and jitter of sweeping the external generator's pulse_offset.
+static uint32_t pre_trigger_delay_cycles = 0;
+
+// Config packet parameter IDs (payload-specific)
+#define CFG_OUTER_COUNT       0x01
+#define CFG_INNER_COUNT       0x02
+#define CFG_PRE_TRIGGER_DELAY 0x04
+#define CFG_ART_CONFIG        0x05
+
+/**
+ * @brief Apply a 'c' configuration packet and echo the applied values.
+ *
+ * Packet data is a sequence of 5-byte entries: [param_id, value(u32 LE)].
+ * Out-of-range values are clamped; unknown IDs are skipped. The applied
+ * (id, value) pairs are echoed back in a 'c' response so the host can
+ * verify the configuration took effect.
+ */
+static void apply_config(const uint8_t *data, size_t data_len)
+{
+    static uint8_t echo[4 * 5];
+    size_t echo_len = 0;
+
+    for (size_t i = 0; i + 5 <= data_len; i += 5)
+    {
+        uint8_t id = data[i];
+        uint32_t value = (uint32_t)data[i + 1] | ((uint32_t)data[i + 2] << 8) |
+                         ((uint32_t)data[i + 3] << 16) | ((uint32_t)data[i + 4] << 24);
+
+        switch (id)
+        {
+        case CFG_OUTER_COUNT:
+            if (value < 1) value = 1;
+            if (value > 65535) value = 65535;
+            outer_count = value;
+            break;
+        case CFG_INNER_COUNT:
+            if (value < 1) value = 1;
+            if (value > 65535) value = 65535;
+            inner_count = value;
+            break;
+        case CFG_PRE_TRIGGER_DELAY:
+            pre_trigger_delay_cycles = value;
+            break;
+        case CFG_ART_CONFIG:
+            value &= 0x7; // bit0 prefetch, bit1 icache, bit2 dcache
+            ss_configure_art(value);
+            break;
+        default:
+            continue; // unknown parameter, do not echo
+        }
+
+        if (echo_len + 5 <= sizeof(echo))
+        {
+            echo[echo_len] = id;
+            echo[echo_len + 1] = (uint8_t)(value & 0xFF);
+            echo[echo_len + 2] = (uint8_t)((value >> 8) & 0xFF);
+            echo[echo_len + 3] = (uint8_t)((value >> 16) & 0xFF);
+            echo[echo_len + 4] = (uint8_t)((value >> 24) & 0xFF);
+            echo_len += 5;
+        }
+    }
+
+    sendpacket('c', echo, echo_len);
+}
+
+// DWT->CYCCNT snapshots of the most recent run_loop_once() call, for
+// the response-packet timestamps (see header comment).
+static uint32_t loop_trigger_cycles;
+static uint32_t loop_end_cycles;
+
+/**
+ * @brief Run the nested counting loop once, wrapped in the trigger GPIO.
+ *
+ * Snapshots the DWT cycle counter at trigger raise and trigger clear
+ * into loop_trigger_cycles / loop_end_cycles.
+ *
+ * @return Final counter value (TOTAL_COUNT when no fault occurred).
+ */
+SS_RAM_FUNC static unsigned int run_loop_once(void)
+{
+    volatile unsigned int counter = 0;
+
+    ss_pulse_tag_arm(); // capture window opens with the trigger
+    set_trigger(); // Raise trigger
+    loop_trigger_cycles = ss_cycles();
+    // Pre-trigger delay: wraparound-safe poll on the raw counter. The
+    // poll loop quantizes the wait by a few cycles, but its overhead is
+    // constant per build, so a single-cycle parameter sweep still moves
+    // the loop window monotonically in single-cycle steps.
+    if (pre_trigger_delay_cycles)
+        while ((uint32_t)(DWT_CYCCNT_RAW - loop_trigger_cycles) < pre_trigger_delay_cycles)
+            ;
+    for (unsigned int i = 0; i < outer_count; i++)
+    {
+        for (unsigned int j = 0; j < inner_count; j++)
+        {
+            counter++;
+        }
+    }
+    clear_trigger(); // Lower trigger
+    loop_end_cycles = ss_cycles();
+
+    return counter;
+}
+
+/**
+ * @brief Fill a 'f' packet payload: [counter, trigger_cycles, detect_cycles].
+ *
+ * detect_cycles is sampled here, i.e. at the point the counter
+ * validation failed.
+ */
+static size_t fill_fault_payload(uint32_t payload[3], unsigned int counter)
+{
+    payload[0] = (uint32_t)counter;
+    payload[1] = loop_trigger_cycles;
+    payload[2] = ss_cycles();
+    return 3 * sizeof(uint32_t);
+}
+
+#ifdef SS_PULSE_TAG
+/**
+ * @brief Append [slot_count (u8), slot_cycles (u32 LE) x stored] to a
+ *        response payload; returns the bytes written.
+ *
+ * slot_count is the edges observed (it may exceed the stored
+ * timestamps when a train outruns SS_PULSE_TAG_SLOTS). The count byte
+ * also makes the extended loop payloads odd-length, so the host's
+ * exact-length dispatch keeps them apart from the fixed even-length
+ * AES/UOV fault payloads.
+ */
+static size_t append_pulse_slots(uint8_t *out)
+{
+    const volatile uint32_t *slots;
+    size_t count = ss_pulse_tag_read(&slots);
+    size_t stored = count < SS_PULSE_TAG_SLOTS ? count : SS_PULSE_TAG_SLOTS;
+
+    out[0] = (uint8_t)(count < 255 ? count : 255);
+    for (size_t i = 0; i < stored; i++)
+    {
+        uint32_t value = slots[i];
+        out[1 + 4 * i + 0] = (uint8_t)(value & 0xFF);
+        out[1 + 4 * i + 1] = (uint8_t)((value >> 8) & 0xFF);
+        out[1 + 4 * i + 2] = (uint8_t)((value >> 16) & 0xFF);
+        out[1 + 4 * i + 3] = (uint8_t)((value >> 24) & 0xFF);
+    }
+    return 1 + 4 * stored;
+}
+#endif
+
+/**
+ * @brief Send an 'e'/'f' response, appending the pulse-slot snapshots
+ *        on SS_PULSE_TAG builds (plain pass-through otherwise).
+ *
+ * @param tagged Nonzero for the windowed (sequence-tagged) path.
+ */
+static int send_response(uint8_t cmd, int tagged, uint8_t seq,
+                         const uint8_t *data, size_t data_len)
+{
+#ifdef SS_PULSE_TAG
+    static uint8_t resp[3 * sizeof(uint32_t) + 1 + 4 * SS_PULSE_TAG_SLOTS];
+    if (data_len <= 3 * sizeof(uint32_t))
+    {
+        memcpy(resp, data, data_len);
+        data_len += append_pulse_slots(resp + data_len);
+        data = resp;
+    }
+#endif
+    if (tagged)
+        return sendpacket_buffered(cmd, seq, data, data_len);
+    return sendpacket(cmd, data, data_len);
+}
+
+/**
+ * @brief Run a batch of loop executions and report an aggregate result.
+ *
+ * Response packet ('B'):
+ *   [0..1]  number of iterations actually run (little endian)
+ *   [2..]   fault bitmap, one bit per iteration (bit set = fault)
+ *   [..]    faulty counter values (little endian uint32, in iteration order)
+ *
+ * The external pulse generator fires on the trigger line for every
+ * iteration, so no per-iteration host roundtrip is needed.
+ *
+ * @param n Requested number of iterations (clamped to BATCH_MAX_ITERATIONS).
+ */
+static void run_batch(unsigned int n)
+{
+    static uint8_t resp[2 + (BATCH_MAX_ITERATIONS + 7) / 8 + 4 * BATCH_MAX_ITERATIONS];
+
+    if (n > BATCH_MAX_ITERATIONS)
+        n = BATCH_MAX_ITERATIONS;
+
+    size_t bitmap_len = (n + 7) / 8;
+    uint8_t *bitmap = &resp[2];
+    uint8_t *fault_values = &resp[2 + bitmap_len];
+    size_t num_faults = 0;
+
+    resp[0] = (uint8_t)(n & 0xFF);
+    resp[1] = (uint8_t)((n >> 8) & 0xFF);
+    memset(bitmap, 0, bitmap_len);
+
+    for (unsigned int i = 0; i < n; i++)
+    {
+        unsigned int counter = run_loop_once();
+        if (counter != outer_count * inner_count)
+        {
+            bitmap[i / 8] |= (1u << (i % 8));
+            fault_values[num_faults * 4 + 0] = (uint8_t)(counter & 0xFF);
+            fault_values[num_faults * 4 + 1] = (uint8_t)((counter >> 8) & 0xFF);
+            fault_values[num_faults * 4 + 2] = (uint8_t)((counter >> 16) & 0xFF);
+            fault_values[num_faults * 4 + 3] = (uint8_t)((counter >> 24) & 0xFF);
+            num_faults++;
+        }
+    }
+
+    sendpacket('B', resp, 2 + bitmap_len + 4 * num_faults);
+}
+
+/**
+ * @brief Accumulate-mode exec callback (see ss_run_accumulate).
+ */
+static uint32_t accumulate_exec(int *fault)
+{
+    unsigned int counter = run_loop_once();
+    *fault = (counter != outer_count * inner_count);
+    return (uint32_t)counter;
+}
+
 
 int main(void)
 {
     platform_init();
     init_uart();
+    ss_init(); // set up DMA/interrupt UART path when built with SS_UART_DMA
     setup_trigger();
+    ss_result_gpio_setup(); // no-op unless built with SS_RESULT_GPIO
     send_reset_sequence();
 
     char uart_ret;
     while (1)
     {
+        ss_wdt_kick();
         uint8_t cmd;
-        size_t dummy_len;
-        int res = readpacket(&cmd, NULL, &dummy_len); // Read start signal
-        if (res == 0 && cmd == 's')
+        uint8_t *data;
+        size_t data_len;
+        int res = readpacket(&cmd, &data, &data_len); // Read start signal
+        if (res == 0 && cmd == 's' && data && data_len == 1)
         {
-            send_ack(cmd); // Acknowledge start signal
-
-            volatile unsigned int counter = 0;
+            // Windowed mode: the start command carries a sequence tag and
+            // is not acked per packet; the tagged response lets the host
+            // keep several starts in flight (see run_pipelined_executions;
+            // use the SS_UART_DMA build so queued starts are buffered).
+            uint8_t seq = data[0];
+            unsigned int counter = run_loop_once();
 
-            set_trigger(); // Raise trigger
-            for (int i = 0; i < OUTER_COUNT; i++)
+            if (counter != outer_count * inner_count)
             {
-                for (int j = 0; j < INNER_COUNT; j++)
-                {
-                    counter++;
-                }
+                uint32_t payload[3];
+                size_t payload_len = fill_fault_payload(payload, counter);
+                send_response('f', 1, seq, (const uint8_t *)payload, payload_len);
             }
-            clear_trigger(); // Lower trigger
+            else
+            {
+                uint32_t loop_cycles = loop_end_cycles - loop_trigger_cycles;
+                send_response('e', 1, seq, (const uint8_t *)&loop_cycles, sizeof(loop_cycles));
+            }
+        }
+        else if (res == 0 && cmd == 's')
+        {
+            if (!ss_merged_ack_enabled())
+                send_ack(cmd); // Acknowledge start signal (skipped in merged-ack mode)
+            ss_result_gpio_clear(); // Result line low while executing
+
+            unsigned int counter = run_loop_once();
 
-            if (counter != TOTAL_COUNT){
-                sendpacket('f', (const uint8_t *)&counter, sizeof(counter)); // Fault packet
+            if (counter != outer_count * inner_count){
+                // Fault: line stays low, details go over serial as usual
+                uint32_t payload[3];
+                size_t payload_len = fill_fault_payload(payload, counter);
+                send_response('f', 0, 0, (const uint8_t *)payload, payload_len); // Fault packet
             }
             else {
-                sendpacket('e', NULL, 0); // End signal
+#ifdef SS_RESULT_GPIO
+                ss_result_gpio_set(); // Nofault: no serial response at all
+#else
+                uint32_t loop_cycles = loop_end_cycles - loop_trigger_cycles;
+                send_response('e', 0, 0, (const uint8_t *)&loop_cycles, sizeof(loop_cycles)); // End signal
+#endif
             }
         }
+        else if (res == 0 && cmd == 'c' && data && data_len > 0)
+        {
+            apply_config(data, data_len); // echoes applied values back
+        }
+        else if (res == 0 && cmd == 'B' && data && data_len == 2)
+        {
+            send_ack(cmd); // Acknowledge batch command
+            run_batch((unsigned int)data[0] | ((unsigned int)data[1] << 8));
+        }
+        else if (res == 0 && cmd == 'A' && data && data_len == 4)
+        {
+            // Accumulate mode: run continuously, one summary per interval
+            send_ack(cmd);
+            ss_run_accumulate((uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+                              ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24),
+                              accumulate_exec);
+        }
+        else if (res == 0)
+        {
+            ss_handle_control_packet(cmd, data, data_len); // e.g. 'b' baud switch
+        }
     }
 }
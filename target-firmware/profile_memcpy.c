@@ -72,10 +72,117 @@
 // #define SRC_BUFFER_INIT_SEQUENCE {0xAA, 0xAA}
 // #define TARGET_BUFFER_INIT_SEQUENCE {0xBB, 0xBB}
 
+// Runtime-configurable buffer parameters ('c' config packet), defaulting to
+// the compile-time values. BUFFER_SIZE stays the allocation upper bound.
+static size_t buffer_len = BUFFER_SIZE;
+static uint8_t src_init_byte = SRC_BUFFER_INIT_BYTE;
+static uint8_t target_init_byte = TARGET_BUFFER_INIT_BYTE;
+
+// Config packet parameter IDs (payload-specific)
+#define CFG_BUFFER_LEN       0x10
+#define CFG_SRC_INIT_BYTE    0x11
+#define CFG_TARGET_INIT_BYTE 0x12
+#define CFG_FAULT_DELTA      0x13
+
+// Delta fault encoding ('c' config id CFG_FAULT_DELTA, default off):
+// instead of the full target buffer, a 'd' packet with (offset, value)
+// pairs of the corrupted bytes is sent. The median fault corrupts fewer
+// than 4 bytes, cutting fault-response TX time by roughly 10x.
+static uint8_t fault_delta_mode = 0;
+
+/**
+ * @brief Send the fault response, delta-encoded when enabled and smaller.
+ *
+ * Falls back to the full 'f' packet when delta mode is off or the delta
+ * would not be smaller than the full buffer (heavily corrupted result).
+ */
+static void send_fault_response(const char *src_buf, const char *target_buf)
+{
+    if (fault_delta_mode)
+    {
+        static uint8_t delta[2 * BUFFER_SIZE];
+        size_t delta_len = 0;
+
+        for (size_t i = 0; i < buffer_len; i++)
+        {
+            if (target_buf[i] != src_buf[i])
+            {
+                delta[delta_len++] = (uint8_t)i;
+                delta[delta_len++] = (uint8_t)target_buf[i];
+            }
+        }
+
+        if (delta_len < buffer_len)
+        {
+            sendpacket('d', delta, delta_len); // Delta fault packet
+            return;
+        }
+        // Delta not smaller -> fall through to the full buffer
+    }
+
+    sendpacket('f', (const uint8_t *)target_buf, buffer_len); // Fault packet
+}
+
+/**
+ * @brief Apply a 'c' configuration packet and echo the applied values.
+ *
+ * Packet data is a sequence of 5-byte entries: [param_id, value(u32 LE)].
+ * buffer_len is clamped to the compile-time BUFFER_SIZE allocation.
+ * The applied (id, value) pairs are echoed back in a 'c' response.
+ */
+static void apply_config(const uint8_t *data, size_t data_len)
+{
+    static uint8_t echo[4 * 5];
+    size_t echo_len = 0;
+
+    for (size_t i = 0; i + 5 <= data_len; i += 5)
+    {
+        uint8_t id = data[i];
+        uint32_t value = (uint32_t)data[i + 1] | ((uint32_t)data[i + 2] << 8) |
+                         ((uint32_t)data[i + 3] << 16) | ((uint32_t)data[i + 4] << 24);
+
+        switch (id)
+        {
+        case CFG_BUFFER_LEN:
+            if (value < 1) value = 1;
+            if (value > BUFFER_SIZE) value = BUFFER_SIZE;
+            buffer_len = value;
+            break;
+        case CFG_SRC_INIT_BYTE:
+            value &= 0xFF;
+            src_init_byte = (uint8_t)value;
+            break;
+        case CFG_TARGET_INIT_BYTE:
+            value &= 0xFF;
+            target_init_byte = (uint8_t)value;
+            break;
+        case CFG_FAULT_DELTA:
+            value = value ? 1 : 0;
+            fault_delta_mode = (uint8_t)value;
+            break;
+        default:
+            continue; // unknown parameter, do not echo
+        }
+
+        if (echo_len + 5 <= sizeof(echo))
+        {
+            echo[echo_len] = id;
+            echo[echo_len + 1] = (uint8_t)(value & 0xFF);
+            echo[echo_len + 2] = (uint8_t)((value >> 8) & 0xFF);
+            echo[echo_len + 3] = (uint8_t)((value >> 16) & 0xFF);
+            echo[echo_len + 4] = (uint8_t)((value >> 24) & 0xFF);
+            echo_len += 5;
+        }
+    }
+
+    sendpacket('c', echo, echo_len);
+}
+
 int main(void)
 {
     platform_init();
     init_uart();
+    ss_init(); // set up DMA/interrupt UART path when built with SS_UART_DMA
     setup_trigger(); // using custom hal
     send_reset_sequence();
     volatile unsigned int count = 500;
@@ -92,40 +199,83 @@ int main(void)
     char src[BUFFER_SIZE];
     char target[BUFFER_SIZE];
 
+    #ifdef SS_UART_DMA
+    uint8_t tx_seq = 0; // per-execution sequence tag for buffered fault packets
+    #endif
+
     while (1)
     {
+        ss_wdt_kick();
         uint8_t cmd;
-        size_t dummy_len;
-        int res = readpacket(&cmd, NULL, &dummy_len); // Read start signal
-        if (res == 0 && cmd == 's')
+        uint8_t *data;
+        size_t data_len;
+        int res = readpacket(&cmd, &data, &data_len); // Read start signal
+        if (res == 0 && cmd == 's' && data && data_len == 1)
         {
-            send_ack(cmd); // Acknowledge start signal
+            // Windowed mode: sequence-tagged start, no per-start ack; the
+            // response carries the same tag for host-side matching.
+            uint8_t seq = data[0];
+
+            memset(src, src_init_byte, buffer_len);
+            memset(target, target_init_byte, buffer_len);
+
+            set_trigger();
+            memcpy(target, src, buffer_len); // Attacked code
+            clear_trigger();
+
+            if (memcmp(src, target, buffer_len) != 0)
+                sendpacket_buffered('f', seq, (const uint8_t *)target, buffer_len);
+            else
+                sendpacket_buffered('e', seq, NULL, 0);
+        }
+        else if (res == 0 && cmd == 's')
+        {
+            if (!ss_merged_ack_enabled())
+                send_ack(cmd); // Acknowledge start signal (skipped in merged-ack mode)
 
             // Initalize src buffer
             #ifdef SRC_BUFFER_INIT_SEQUENCE
             memcpy(src, src_init, BUFFER_SIZE);
             #else
-            memset(src, SRC_BUFFER_INIT_BYTE, sizeof(src)); // Initialize source buffer
+            memset(src, src_init_byte, buffer_len); // Initialize source buffer
             #endif
 
             // Initalize target buffer
             #ifdef TARGET_BUFFER_INIT_SEQUENCE
             memcpy(target, target_init, BUFFER_SIZE);
             #else
-            memset(target, TARGET_BUFFER_INIT_BYTE, sizeof(target)); // Initialize target buffer
+            memset(target, target_init_byte, buffer_len); // Initialize target buffer
             #endif
 
             set_trigger();
 
-            memcpy(target, src, sizeof(src)); // Attacked code
+            memcpy(target, src, buffer_len); // Attacked code
 
             clear_trigger();
 
-            if (memcmp(src, target, sizeof(src)) != 0) {
-                sendpacket('f', target, sizeof(target)); // Fault packet
+            if (memcmp(src, target, buffer_len) != 0) {
+                #ifdef SS_UART_DMA
+                if (!fault_delta_mode) {
+                    // Snapshot the corrupted buffer and transmit in the background:
+                    // the loop can service the next 's' while the packet drains.
+                    sendpacket_buffered('f', tx_seq++, (const uint8_t *)target, buffer_len);
+                } else {
+                    send_fault_response(src, target);
+                }
+                #else
+                send_fault_response(src, target);
+                #endif
             } else {
                 sendpacket('e', NULL, 0); // End signal
             }
         }
+        else if (res == 0 && cmd == 'c' && data && data_len > 0)
+        {
+            apply_config(data, data_len); // echoes applied values back
+        }
+        else if (res == 0)
+        {
+            ss_handle_control_packet(cmd, data, data_len); // e.g. 'b' baud switch
+        }
     }
 }
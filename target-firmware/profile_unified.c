@@ -0,0 +1,528 @@
+/*
+ * emfi-profiler_unified.c
+ *
+ * Description:
+ * Combined firmware image containing all three profiling payloads
+ * (nested loop, unrolled loop, memcpy). A selection packet chooses which
+ * payload the 's' command dispatches to, so a campaign can interleave
+ * payload types per position with zero flash cycles.
+ *
+ * Communication:
+ * 1. Reset Signal (sent on startup):
+ *    - At program start, the MCU sends a reset sequence using send_reset_sequence().
+ *
+ * 2. Host selects a payload:
+ *    - Command: 'p'
+ *    - Data:    1 byte payload id (0 = loop, 1 = unrolled loop, 2 = memcpy)
+ *    - Action:  MCU echoes the applied payload id in a 'p' response.
+ *               Invalid ids are ignored (current selection is echoed).
+ *
+ * 3. Host sends a start packet:
+ *    - Command: 's'
+ *    - Data:    None
+ *    - Action:  MCU raises trigger GPIO and runs the selected payload
+ *
+ * 4. MCU sends the payload's usual response packet ('e' or 'f'),
+ *    identical in format to the standalone images.
+ *
+ * The 'c' runtime configuration packet and the 'B' batch command are
+ * supported as in the standalone payloads; config parameter IDs are
+ * disjoint across payloads so one packet can configure all of them.
+ *
+ * Configuration defaults match the standalone images:
+ *       - OUTER_COUNT/INNER_COUNT (500/500): nested loop bounds
+ *       - NUM_EXECUTIONS (100): unrolled loop length (10/100/1000/10000)
+ *       - BUFFER_SIZE (68), SRC/TARGET_BUFFER_INIT_BYTE (0xAA/0xBB): memcpy
+ */
+
+#include "hal.h"
+#include "hal/stm32f4-hal.h"
+#include "simpleserial/simpleserial.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#define setup_trigger() inline_gpio_mode_setup(GPIOA, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLDOWN, GPIO12)
+#define set_trigger() inline_gpio_set(GPIOA, GPIO12)
+#define clear_trigger() inline_gpio_clear(GPIOA, GPIO12)
+
+// Raw CYCCNT access for the pre-trigger busy-wait poll loop
+#define DWT_CYCCNT_RAW (*(volatile uint32_t *)0xE0001004UL)
+
+// +-----------------------------------------+
+// |             CONFIG VARIABLES            |
+// +-----------------------------------------+
+#define OUTER_COUNT 500 // Number of iterations for outer loop
+#define INNER_COUNT 500 // Number of iterations for inner loop
+#define NUM_EXECUTIONS 100 // Default unrolled loop length
+#define BUFFER_SIZE 68
+#define SRC_BUFFER_INIT_BYTE 0xAA
+#define TARGET_BUFFER_INIT_BYTE 0xBB
+
+#define BATCH_MAX_ITERATIONS 64 // Upper bound for 'B' batch requests
+
+/* ---------------- Payload selection ---------------- */
+
+#define PAYLOAD_LOOP     0
+#define PAYLOAD_UNROLLED 1
+#define PAYLOAD_MEMCPY   2
+
+static uint8_t selected_payload = PAYLOAD_LOOP;
+
+/* ---------------- Runtime configuration ---------------- */
+
+// Nested loop payload
+static unsigned int outer_count = OUTER_COUNT;
+static unsigned int inner_count = INNER_COUNT;
+// DWT-cycle busy-wait between trigger raise and loop entry, for
+// on-target injection-timing sweeps (see profile_loop.c)
+static uint32_t pre_trigger_delay_cycles = 0;
+// Unrolled loop payload
+static unsigned int num_executions = NUM_EXECUTIONS;
+// Memcpy payload
+static size_t buffer_len = BUFFER_SIZE;
+static uint8_t src_init_byte = SRC_BUFFER_INIT_BYTE;
+static uint8_t target_init_byte = TARGET_BUFFER_INIT_BYTE;
+
+// Config packet parameter IDs (disjoint across payloads)
+#define CFG_OUTER_COUNT       0x01
+#define CFG_INNER_COUNT       0x02
+#define CFG_NUM_EXECUTIONS    0x03
+#define CFG_PRE_TRIGGER_DELAY 0x04
+#define CFG_ART_CONFIG        0x05
+#define CFG_BUFFER_LEN        0x10
+#define CFG_SRC_INIT_BYTE     0x11
+#define CFG_TARGET_INIT_BYTE  0x12
+#define CFG_FAULT_DELTA       0x13
+
+// Delta fault encoding for the memcpy payload (default off): send a 'd'
+// packet with (offset, value) pairs of the corrupted bytes instead of the
+// full target buffer, falling back to 'f' when the delta is not smaller.
+static uint8_t fault_delta_mode = 0;
+
+/* ---------------- Unrolled loop code generation ---------------- */
+
+#define ADD_COMMAND "add r7, r7, #1;"
+
+#define o ADD_COMMAND
+#define t o o o o o o o o o o
+#define h t t t t t t t t t t
+#define d h h h h h h h h h h
+#define x d d d d d d d d d d
+
+#define ADD_10    t
+#define ADD_100   h
+#define ADD_1000  d
+#define ADD_10000 x
+
+// Emit one unrolled addition sequence wrapped in the standard asm frame
+#define RUN_UNROLLED(LOOP_MACRO) \
+    asm volatile ( \
+        "mov r7, #0;" /* Set r7 to 0 */ \
+        LOOP_MACRO    /* Unrolled loop */ \
+        "mov %[counter], r7;" /* Set counter variable to r7 */ \
+        : [counter] "=r" (counter) \
+        : \
+        : "r7" \
+    )
+
+/* ---------------- Payload implementations ---------------- */
+
+/**
+ * @brief Run the nested counting loop once, wrapped in the trigger GPIO.
+ *
+ * @return Final counter value (outer_count * inner_count when no fault occurred).
+ */
+SS_RAM_FUNC static unsigned int run_loop_once(void)
+{
+    volatile unsigned int counter = 0;
+
+    set_trigger(); // Raise trigger
+    // Pre-trigger delay: wraparound-safe busy-wait on the raw cycle
+    // counter (started by the ss_cycles() snapshot)
+    if (pre_trigger_delay_cycles)
+    {
+        uint32_t start = ss_cycles();
+        while ((uint32_t)(DWT_CYCCNT_RAW - start) < pre_trigger_delay_cycles)
+            ;
+    }
+    for (unsigned int i = 0; i < outer_count; i++)
+    {
+        for (unsigned int j = 0; j < inner_count; j++)
+        {
+            counter++;
+        }
+    }
+    clear_trigger(); // Lower trigger
+
+    return counter;
+}
+
+/**
+ * @brief Run the unrolled addition sequence once, wrapped in the trigger GPIO.
+ *
+ * @return Final counter value (num_executions when no fault occurred).
+ */
+SS_RAM_FUNC static unsigned int run_unrolled_once(void)
+{
+    volatile unsigned int counter = 0;
+
+    set_trigger(); // Raise trigger
+
+    // Dispatch to the compile-time generated unroll variant
+    switch (num_executions)
+    {
+    case 10:    RUN_UNROLLED(ADD_10);    break;
+    case 100:   RUN_UNROLLED(ADD_100);   break;
+    case 1000:  RUN_UNROLLED(ADD_1000);  break;
+    case 10000: RUN_UNROLLED(ADD_10000); break;
+    }
+
+    clear_trigger(); // Lower trigger
+
+    return counter;
+}
+
+// Memcpy payload buffers (shared across executions like the standalone image)
+static char memcpy_src[BUFFER_SIZE];
+static char memcpy_target[BUFFER_SIZE];
+
+/**
+ * @brief Run the memcpy payload once and send its 'e'/'f' response.
+ */
+static void run_memcpy_execution(void)
+{
+    memset(memcpy_src, src_init_byte, buffer_len);       // Initialize source buffer
+    memset(memcpy_target, target_init_byte, buffer_len); // Initialize target buffer
+
+    set_trigger();
+
+    memcpy(memcpy_target, memcpy_src, buffer_len); // Attacked code
+
+    clear_trigger();
+
+    if (memcmp(memcpy_src, memcpy_target, buffer_len) != 0) {
+        if (fault_delta_mode)
+        {
+            static uint8_t delta[2 * BUFFER_SIZE];
+            size_t delta_len = 0;
+
+            for (size_t i = 0; i < buffer_len; i++)
+            {
+                if (memcpy_target[i] != memcpy_src[i])
+                {
+                    delta[delta_len++] = (uint8_t)i;
+                    delta[delta_len++] = (uint8_t)memcpy_target[i];
+                }
+            }
+
+            if (delta_len < buffer_len)
+            {
+                sendpacket('d', delta, delta_len); // Delta fault packet
+                return;
+            }
+            // Delta not smaller -> fall through to the full buffer
+        }
+        sendpacket('f', (const uint8_t *)memcpy_target, buffer_len); // Fault packet
+    } else {
+        sendpacket('e', NULL, 0); // End signal
+    }
+}
+
+/**
+ * @brief Run a counter-style payload once and send its 'e'/'f' response.
+ *
+ * @param counter Measured counter value.
+ * @param expected Expected counter value for a fault-free run.
+ */
+static void send_counter_result(unsigned int counter, unsigned int expected)
+{
+    if (counter != expected) {
+        sendpacket('f', (const uint8_t *)&counter, sizeof(counter)); // Fault packet
+    }
+    else {
+        sendpacket('e', NULL, 0); // End signal
+    }
+}
+
+/**
+ * @brief Run one execution of the currently selected payload.
+ */
+static void run_selected_payload(void)
+{
+    switch (selected_payload)
+    {
+    case PAYLOAD_LOOP:
+        send_counter_result(run_loop_once(), outer_count * inner_count);
+        break;
+    case PAYLOAD_UNROLLED:
+        send_counter_result(run_unrolled_once(), num_executions);
+        break;
+    case PAYLOAD_MEMCPY:
+        run_memcpy_execution();
+        break;
+    }
+}
+
+/**
+ * @brief Run the selected payload once and send a sequence-tagged response.
+ *
+ * Windowed-mode counterpart of run_selected_payload(): the response is a
+ * tagged 'e'/'f' packet (sequence byte first) so the host can match it to
+ * one of several in-flight start commands.
+ *
+ * @param seq Sequence tag from the start command.
+ */
+static void run_selected_payload_tagged(uint8_t seq)
+{
+    if (selected_payload == PAYLOAD_MEMCPY)
+    {
+        memset(memcpy_src, src_init_byte, buffer_len);
+        memset(memcpy_target, target_init_byte, buffer_len);
+
+        set_trigger();
+        memcpy(memcpy_target, memcpy_src, buffer_len); // Attacked code
+        clear_trigger();
+
+        if (memcmp(memcpy_src, memcpy_target, buffer_len) != 0)
+            sendpacket_buffered('f', seq, (const uint8_t *)memcpy_target, buffer_len);
+        else
+            sendpacket_buffered('e', seq, NULL, 0);
+        return;
+    }
+
+    unsigned int counter;
+    unsigned int expected;
+    if (selected_payload == PAYLOAD_UNROLLED) {
+        counter = run_unrolled_once();
+        expected = num_executions;
+    } else {
+        counter = run_loop_once();
+        expected = outer_count * inner_count;
+    }
+
+    if (counter != expected)
+        sendpacket_buffered('f', seq, (const uint8_t *)&counter, sizeof(counter));
+    else
+        sendpacket_buffered('e', seq, NULL, 0);
+}
+
+/* ---------------- Batch execution ---------------- */
+
+/**
+ * @brief Run a batch of counter-payload executions and report an aggregate result.
+ *
+ * Response packet ('B'):
+ *   [0..1]  number of iterations actually run (little endian)
+ *   [2..]   fault bitmap, one bit per iteration (bit set = fault)
+ *   [..]    faulty counter values (little endian uint32, in iteration order)
+ *
+ * Only supported for the counter payloads (loop, unrolled loop).
+ *
+ * @param n Requested number of iterations (clamped to BATCH_MAX_ITERATIONS).
+ */
+static void run_batch(unsigned int n)
+{
+    static uint8_t resp[2 + (BATCH_MAX_ITERATIONS + 7) / 8 + 4 * BATCH_MAX_ITERATIONS];
+
+    if (n > BATCH_MAX_ITERATIONS)
+        n = BATCH_MAX_ITERATIONS;
+
+    size_t bitmap_len = (n + 7) / 8;
+    uint8_t *bitmap = &resp[2];
+    uint8_t *fault_values = &resp[2 + bitmap_len];
+    size_t num_faults = 0;
+
+    resp[0] = (uint8_t)(n & 0xFF);
+    resp[1] = (uint8_t)((n >> 8) & 0xFF);
+    memset(bitmap, 0, bitmap_len);
+
+    for (unsigned int i = 0; i < n; i++)
+    {
+        unsigned int counter;
+        unsigned int expected;
+
+        if (selected_payload == PAYLOAD_UNROLLED) {
+            counter = run_unrolled_once();
+            expected = num_executions;
+        } else {
+            counter = run_loop_once();
+            expected = outer_count * inner_count;
+        }
+
+        if (counter != expected)
+        {
+            bitmap[i / 8] |= (1u << (i % 8));
+            fault_values[num_faults * 4 + 0] = (uint8_t)(counter & 0xFF);
+            fault_values[num_faults * 4 + 1] = (uint8_t)((counter >> 8) & 0xFF);
+            fault_values[num_faults * 4 + 2] = (uint8_t)((counter >> 16) & 0xFF);
+            fault_values[num_faults * 4 + 3] = (uint8_t)((counter >> 24) & 0xFF);
+            num_faults++;
+        }
+    }
+
+    sendpacket('B', resp, 2 + bitmap_len + 4 * num_faults);
+}
+
+/**
+ * @brief Accumulate-mode exec callback (see ss_run_accumulate).
+ *
+ * Like run_batch(), only supported for the counter payloads; the memcpy
+ * selection falls back to the loop payload.
+ */
+static uint32_t accumulate_exec(int *fault)
+{
+    unsigned int counter;
+    unsigned int expected;
+
+    if (selected_payload == PAYLOAD_UNROLLED) {
+        counter = run_unrolled_once();
+        expected = num_executions;
+    } else {
+        counter = run_loop_once();
+        expected = outer_count * inner_count;
+    }
+
+    *fault = (counter != expected);
+    return (uint32_t)counter;
+}
+
+/* ---------------- Configuration ---------------- */
+
+/**
+ * @brief Apply a 'c' configuration packet and echo the applied values.
+ *
+ * Packet data is a sequence of 5-byte entries: [param_id, value(u32 LE)].
+ * Handles the parameters of all payloads (the IDs are disjoint).
+ * Out-of-range values are clamped (or rejected for the unroll length);
+ * unknown IDs are skipped. The applied (id, value) pairs are echoed back
+ * in a 'c' response so the host can verify the configuration took effect.
+ */
+static void apply_config(const uint8_t *data, size_t data_len)
+{
+    static uint8_t echo[8 * 5];
+    size_t echo_len = 0;
+
+    for (size_t i = 0; i + 5 <= data_len; i += 5)
+    {
+        uint8_t id = data[i];
+        uint32_t value = (uint32_t)data[i + 1] | ((uint32_t)data[i + 2] << 8) |
+                         ((uint32_t)data[i + 3] << 16) | ((uint32_t)data[i + 4] << 24);
+
+        switch (id)
+        {
+        case CFG_OUTER_COUNT:
+            if (value < 1) value = 1;
+            if (value > 65535) value = 65535;
+            outer_count = value;
+            break;
+        case CFG_INNER_COUNT:
+            if (value < 1) value = 1;
+            if (value > 65535) value = 65535;
+            inner_count = value;
+            break;
+        case CFG_NUM_EXECUTIONS:
+            if (value != 10 && value != 100 && value != 1000 && value != 10000)
+                continue; // only the compiled unroll variants are selectable
+            num_executions = value;
+            break;
+        case CFG_PRE_TRIGGER_DELAY:
+            pre_trigger_delay_cycles = value;
+            break;
+        case CFG_ART_CONFIG:
+            value &= 0x7; // bit0 prefetch, bit1 icache, bit2 dcache
+            ss_configure_art(value);
+            break;
+        case CFG_BUFFER_LEN:
+            if (value < 1) value = 1;
+            if (value > BUFFER_SIZE) value = BUFFER_SIZE;
+            buffer_len = value;
+            break;
+        case CFG_SRC_INIT_BYTE:
+            value &= 0xFF;
+            src_init_byte = (uint8_t)value;
+            break;
+        case CFG_TARGET_INIT_BYTE:
+            value &= 0xFF;
+            target_init_byte = (uint8_t)value;
+            break;
+        case CFG_FAULT_DELTA:
+            value = value ? 1 : 0;
+            fault_delta_mode = (uint8_t)value;
+            break;
+        default:
+            continue; // unknown parameter, do not echo
+        }
+
+        if (echo_len + 5 <= sizeof(echo))
+        {
+            echo[echo_len] = id;
+            echo[echo_len + 1] = (uint8_t)(value & 0xFF);
+            echo[echo_len + 2] = (uint8_t)((value >> 8) & 0xFF);
+            echo[echo_len + 3] = (uint8_t)((value >> 16) & 0xFF);
+            echo[echo_len + 4] = (uint8_t)((value >> 24) & 0xFF);
+            echo_len += 5;
+        }
+    }
+
+    sendpacket('c', echo, echo_len);
+}
+
+int main(void)
+{
+    platform_init();
+    init_uart();
+    ss_init(); // set up DMA/interrupt UART path when built with SS_UART_DMA
+    setup_trigger();
+    send_reset_sequence();
+
+    while (1)
+    {
+        ss_wdt_kick();
+        uint8_t cmd;
+        uint8_t *data;
+        size_t data_len;
+        int res = readpacket(&cmd, &data, &data_len); // Read next command
+        if (res == 0 && cmd == 's' && data && data_len == 1)
+        {
+            // Windowed mode: sequence-tagged start, no per-start ack
+            run_selected_payload_tagged(data[0]);
+        }
+        else if (res == 0 && cmd == 's')
+        {
+            if (!ss_merged_ack_enabled())
+                send_ack(cmd); // Acknowledge start signal (skipped in merged-ack mode)
+            run_selected_payload();
+        }
+        else if (res == 0 && cmd == 'p' && data && data_len == 1)
+        {
+            // Payload selection: apply if valid, always echo current selection
+            if (data[0] <= PAYLOAD_MEMCPY)
+                selected_payload = data[0];
+            sendpacket('p', &selected_payload, 1);
+        }
+        else if (res == 0 && cmd == 'c' && data && data_len > 0)
+        {
+            apply_config(data, data_len); // echoes applied values back
+        }
+        else if (res == 0 && cmd == 'B' && data && data_len == 2)
+        {
+            send_ack(cmd); // Acknowledge batch command
+            run_batch((unsigned int)data[0] | ((unsigned int)data[1] << 8));
+        }
+        else if (res == 0 && cmd == 'A' && data && data_len == 4)
+        {
+            // Accumulate mode: run continuously, one summary per interval
+            send_ack(cmd);
+            ss_run_accumulate((uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+                              ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24),
+                              accumulate_exec);
+        }
+        else if (res == 0)
+        {
+            ss_handle_control_packet(cmd, data, data_len); // e.g. 'b' baud switch
+        }
+    }
+}
@@ -32,6 +32,9 @@
  *  * Configuration:
  *       - NUM_EXECUTIONS (1000): Number of additions to perform (nested loop count).
  *                                Can only be one of  (10, 100, 1000, 10000)!
+ *       - ART accelerator ('c' packet, CFG_ART_CONFIG): flash prefetch/
+ *         cache enable bits (see ss_configure_art). Build with
+ *         SS_RAM_PAYLOAD=1 to run the unrolled adds from SRAM.
  */
 
 #include "hal.h"
@@ -67,45 +70,215 @@
 // +-----------------------------------------+
 #define NUM_EXECUTIONS 100 // Can only be 10, 100 or 1000, 10000 without modification to above defines
 
+#define BATCH_MAX_ITERATIONS 64 // Upper bound for 'B' batch requests
+
+// Runtime-selectable unroll length ('c' config packet). The unrolled code is
+// generated at compile time for all four supported lengths; the config packet
+// only selects which variant the 's' command dispatches to.
+static unsigned int num_executions = NUM_EXECUTIONS;
+
+// Config packet parameter IDs (payload-specific)
+#define CFG_NUM_EXECUTIONS 0x03
+#define CFG_ART_CONFIG     0x05
+
+// Emit one unrolled addition sequence wrapped in the standard asm frame
+#define RUN_UNROLLED(LOOP_MACRO) \
+    asm volatile ( \
+        "mov r7, #0;" /* Set r7 to 0 */ \
+        LOOP_MACRO    /* Unrolled loop */ \
+        "mov %[counter], r7;" /* Set counter variable to r7 */ \
+        : [counter] "=r" (counter) \
+        : \
+        : "r7" \
+    )
+
+/**
+ * @brief Apply a 'c' configuration packet and echo the applied values.
+ *
+ * Packet data is a sequence of 5-byte entries: [param_id, value(u32 LE)].
+ * Only the supported unroll lengths (10, 100, 1000, 10000) are accepted;
+ * other values are rejected and not echoed. The ART accelerator toggle
+ * (CFG_ART_CONFIG) is also handled. The applied (id, value) pairs are
+ * echoed back in a 'c' response.
+ */
+static void apply_config(const uint8_t *data, size_t data_len)
+{
+    static uint8_t echo[2 * 5];
+    size_t echo_len = 0;
+
+    for (size_t i = 0; i + 5 <= data_len; i += 5)
+    {
+        uint8_t id = data[i];
+        uint32_t value = (uint32_t)data[i + 1] | ((uint32_t)data[i + 2] << 8) |
+                         ((uint32_t)data[i + 3] << 16) | ((uint32_t)data[i + 4] << 24);
+
+        if (id == CFG_ART_CONFIG)
+        {
+            value &= 0x7; // bit0 prefetch, bit1 icache, bit2 dcache
+            ss_configure_art(value);
+        }
+        else if (id != CFG_NUM_EXECUTIONS)
+            continue; // unknown parameter, do not echo
+        else if (value != 10 && value != 100 && value != 1000 && value != 10000)
+            continue; // only the compiled unroll variants are selectable
+        else
+            num_executions = value;
+
+        if (echo_len + 5 <= sizeof(echo))
+        {
+            echo[echo_len] = id;
+            echo[echo_len + 1] = (uint8_t)(value & 0xFF);
+            echo[echo_len + 2] = (uint8_t)((value >> 8) & 0xFF);
+            echo[echo_len + 3] = (uint8_t)((value >> 16) & 0xFF);
+            echo[echo_len + 4] = (uint8_t)((value >> 24) & 0xFF);
+            echo_len += 5;
+        }
+    }
+
+    sendpacket('c', echo, echo_len);
+}
+
+/**
+ * @brief Run the unrolled addition sequence once, wrapped in the trigger GPIO.
+ *
+ * @return Final counter value (NUM_EXECUTIONS when no fault occurred).
+ */
+SS_RAM_FUNC static unsigned int run_unrolled_once(void)
+{
+    volatile unsigned int counter = 0;
+
+    set_trigger(); // Raise trigger
+
+    // Dispatch to the compile-time generated unroll variant
+    switch (num_executions)
+    {
+    case 10:    RUN_UNROLLED(ADD_10);    break;
+    case 100:   RUN_UNROLLED(ADD_100);   break;
+    case 1000:  RUN_UNROLLED(ADD_1000);  break;
+    case 10000: RUN_UNROLLED(ADD_10000); break;
+    }
+
+    clear_trigger(); // Lower trigger
+
+    return counter;
+}
+
+/**
+ * @brief Run a batch of unrolled-loop executions and report an aggregate result.
+ *
+ * Response packet ('B'):
+ *   [0..1]  number of iterations actually run (little endian)
+ *   [2..]   fault bitmap, one bit per iteration (bit set = fault)
+ *   [..]    faulty counter values (little endian uint32, in iteration order)
+ *
+ * @param n Requested number of iterations (clamped to BATCH_MAX_ITERATIONS).
+ */
+static void run_batch(unsigned int n)
+{
+    static uint8_t resp[2 + (BATCH_MAX_ITERATIONS + 7) / 8 + 4 * BATCH_MAX_ITERATIONS];
+
+    if (n > BATCH_MAX_ITERATIONS)
+        n = BATCH_MAX_ITERATIONS;
+
+    size_t bitmap_len = (n + 7) / 8;
+    uint8_t *bitmap = &resp[2];
+    uint8_t *fault_values = &resp[2 + bitmap_len];
+    size_t num_faults = 0;
+
+    resp[0] = (uint8_t)(n & 0xFF);
+    resp[1] = (uint8_t)((n >> 8) & 0xFF);
+    for (size_t i = 0; i < bitmap_len; i++)
+        bitmap[i] = 0;
+
+    for (unsigned int i = 0; i < n; i++)
+    {
+        unsigned int counter = run_unrolled_once();
+        if (counter != num_executions)
+        {
+            bitmap[i / 8] |= (1u << (i % 8));
+            fault_values[num_faults * 4 + 0] = (uint8_t)(counter & 0xFF);
+            fault_values[num_faults * 4 + 1] = (uint8_t)((counter >> 8) & 0xFF);
+            fault_values[num_faults * 4 + 2] = (uint8_t)((counter >> 16) & 0xFF);
+            fault_values[num_faults * 4 + 3] = (uint8_t)((counter >> 24) & 0xFF);
+            num_faults++;
+        }
+    }
+
+    sendpacket('B', resp, 2 + bitmap_len + 4 * num_faults);
+}
+
+/**
+ * @brief Accumulate-mode exec callback (see ss_run_accumulate).
+ */
+static uint32_t accumulate_exec(int *fault)
+{
+    unsigned int counter = run_unrolled_once();
+    *fault = (counter != num_executions);
+    return (uint32_t)counter;
+}
+
 int main(void)
 {
     platform_init();
     init_uart();
+    ss_init(); // set up DMA/interrupt UART path when built with SS_UART_DMA
     setup_trigger();
     send_reset_sequence();
 
     char uart_ret;
     while (1)
     {
+        ss_wdt_kick();
         uint8_t cmd;
-        size_t dummy_len;
-        int res = readpacket(&cmd, NULL, &dummy_len); // Read start signal
-        if (res == 0 && cmd == 's')
+        uint8_t *data;
+        size_t data_len;
+        int res = readpacket(&cmd, &data, &data_len); // Read start signal
+        if (res == 0 && cmd == 's' && data && data_len == 1)
         {
-            send_ack(cmd); // Acknowledge start signal
-
-            volatile unsigned int counter = 0;
-
-            set_trigger(); // Raise trigger
+            // Windowed mode: sequence-tagged start, no per-start ack; the
+            // response carries the same tag for host-side matching.
+            uint8_t seq = data[0];
+            unsigned int counter = run_unrolled_once();
 
-            asm volatile (
-                "mov r7, #0;" // Set r7 to 0
-                NESTED_LOOP_MACRO(NUM_EXECUTIONS) // Unrolled loop
-                "mov %[counter], r7;" // Set counter variable to r7
-
-                : [counter] "=r" (counter) // Refer to variable counter from c code as counter in assembly code
-                :
-                : "r7"
-            );
+            if (counter != num_executions)
+                sendpacket_buffered('f', seq, (const uint8_t *)&counter, sizeof(counter));
+            else
+                sendpacket_buffered('e', seq, NULL, 0);
+        }
+        else if (res == 0 && cmd == 's')
+        {
+            if (!ss_merged_ack_enabled())
+                send_ack(cmd); // Acknowledge start signal (skipped in merged-ack mode)
 
-            clear_trigger(); // Lower trigger
+            unsigned int counter = run_unrolled_once();
 
-            if (counter != NUM_EXECUTIONS){
+            if (counter != num_executions){
                 sendpacket('f', (const uint8_t *)&counter, sizeof(counter)); // Fault packet
             }
             else {
                 sendpacket('e', NULL, 0); // End signal
             }
         }
+        else if (res == 0 && cmd == 'c' && data && data_len > 0)
+        {
+            apply_config(data, data_len); // echoes applied values back
+        }
+        else if (res == 0 && cmd == 'B' && data && data_len == 2)
+        {
+            send_ack(cmd); // Acknowledge batch command
+            run_batch((unsigned int)data[0] | ((unsigned int)data[1] << 8));
+        }
+        else if (res == 0 && cmd == 'A' && data && data_len == 4)
+        {
+            // Accumulate mode: run continuously, one summary per interval
+            send_ack(cmd);
+            ss_run_accumulate((uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+                              ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24),
+                              accumulate_exec);
+        }
+        else if (res == 0)
+        {
+            ss_handle_control_packet(cmd, data, data_len); // e.g. 'b' baud switch
+        }
     }
 }
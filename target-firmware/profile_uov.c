@@ -0,0 +1,294 @@
+/*
+ * emfi-profiler_uov.c
+ *
+ * Description:
+ * UOV signature-verification fault target. The public key (a set of
+ * quadratic forms over GF(256)) and a signature vector are expanded
+ * on-device from a 32-bit seed and cached in RAM, so per-shot serial
+ * traffic stays at a few bytes regardless of key size - streaming tens
+ * of KB of key material through the 38400-baud packet path per
+ * experiment would cost seconds per shot. Each execution evaluates the
+ * public map on the signature inside the trigger window and compares
+ * the result vector against the reference computed at expansion time.
+ *
+ * Parameters are reduced from the standardized uov-Ip set (n=112,
+ * m=44) to n=64, m=28 so the expanded key fits comfortably in SRAM;
+ * the evaluation structure - and therefore the fault surface of the
+ * accept/reject comparison - is identical.
+ *
+ * Communication:
+ * 1. Reset Signal (sent on startup):
+ *    - At program start, the MCU sends a reset sequence using send_reset_sequence().
+ *
+ *  2. Host sends a start packet:
+ *       - Command: 's'
+ *       - Data:    None (or a one-byte sequence tag for windowed mode)
+ *       - Action:  MCU raises trigger GPIO and runs one verification
+ *
+ *  3. MCU sends a response packet:
+ *       - If the result vector matches the reference (signature accepts):
+ *           - Command: 'e' (end signal)
+ *           - Data:    None
+ *       - If the result vector differs (faulted verification):
+ *           - Command: 'f' (fault)
+ *           - Data:    the m-byte faulty result vector
+ *
+ * Configuration:
+ *       - Key seed ('c' packet, CFG_UOV_SEED): re-expands public key,
+ *         signature and reference from the new seed (default 0x1)
+ *       - ART accelerator ('c' packet, CFG_ART_CONFIG): see
+ *         ss_configure_art()
+ */
+
+#include "hal.h"
+#include "hal/stm32f4-hal.h"
+#include "simpleserial/simpleserial.h"
+#include <stdint.h>
+#include <string.h>
+
+#define setup_trigger() inline_gpio_mode_setup(GPIOA, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLDOWN, GPIO12)
+#define set_trigger() inline_gpio_set(GPIOA, GPIO12)
+#define clear_trigger() inline_gpio_clear(GPIOA, GPIO12)
+
+// +-----------------------------------------+
+// |             CONFIG VARIABLES            |
+// +-----------------------------------------+
+#define UOV_N 64 // Number of variables
+#define UOV_M 28 // Number of equations (= result vector length)
+
+// Upper-triangular coefficient count per quadratic form
+#define UOV_TERMS (UOV_N * (UOV_N + 1) / 2)
+
+// Config packet parameter IDs (payload-specific)
+#define CFG_ART_CONFIG 0x05
+#define CFG_UOV_SEED   0x06
+
+// Expanded key material, regenerated only when the seed changes: one
+// packed upper-triangular coefficient array per equation (~57 KB total)
+static uint8_t public_key[UOV_M][UOV_TERMS];
+static uint8_t signature[UOV_N];
+static uint32_t key_seed = 0x1;
+
+// Reference result vector, computed once per expansion (unglitched)
+static uint8_t expected[UOV_M];
+
+// GF(256) log/antilog tables (AES polynomial 0x11b, generator 0x03),
+// filled at boot: table lookups keep the ~58k multiplications per
+// verification fast enough for EMFI shot rates.
+static uint8_t gf_log[256];
+static uint8_t gf_exp[256];
+
+static void gf_tables_init(void)
+{
+    uint8_t x = 1;
+    for (int i = 0; i < 255; i++)
+    {
+        gf_exp[i] = x;
+        gf_log[x] = (uint8_t)i;
+        // multiply x by the generator 0x03 = x * 2 ^ x
+        uint8_t x2 = (uint8_t)((x << 1) ^ ((x & 0x80) ? 0x1b : 0x00));
+        x = (uint8_t)(x2 ^ x);
+    }
+    gf_exp[255] = gf_exp[0];
+}
+
+static inline uint8_t gf_mul(uint8_t a, uint8_t b)
+{
+    if (a == 0 || b == 0)
+        return 0;
+    unsigned int s = (unsigned int)gf_log[a] + (unsigned int)gf_log[b];
+    if (s >= 255)
+        s -= 255;
+    return gf_exp[s];
+}
+
+// xorshift32 PRNG for key expansion: the host only needs the stream to
+// be reproducible from the seed, not cryptographic.
+static uint32_t prng_state;
+
+static uint8_t prng_byte(void)
+{
+    uint32_t x = prng_state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    prng_state = x;
+    return (uint8_t)(x & 0xFF);
+}
+
+/**
+ * @brief Evaluate the public map on the signature vector.
+ *
+ * For each equation k: out[k] = sum over i<=j of P_k[i][j] * s_i * s_j
+ * in GF(256), with P_k packed upper-triangular row-major.
+ *
+ * @param out Output result vector (UOV_M bytes).
+ */
+SS_RAM_FUNC static void eval_public_map(uint8_t out[UOV_M])
+{
+    for (unsigned int k = 0; k < UOV_M; k++)
+    {
+        const uint8_t *coefs = public_key[k];
+        uint8_t acc = 0;
+        unsigned int idx = 0;
+        for (unsigned int i = 0; i < UOV_N; i++)
+        {
+            uint8_t si = signature[i];
+            for (unsigned int j = i; j < UOV_N; j++, idx++)
+                acc ^= gf_mul(coefs[idx], gf_mul(si, signature[j]));
+        }
+        out[k] = acc;
+    }
+}
+
+/**
+ * @brief Expand public key, signature and reference from key_seed.
+ *
+ * Runs outside the trigger window (at boot and on CFG_UOV_SEED), so
+ * expansion cost is paid once per seed rather than per shot.
+ */
+static void expand_key_material(void)
+{
+    prng_state = key_seed ? key_seed : 0x1; // xorshift must not be seeded 0
+
+    for (unsigned int k = 0; k < UOV_M; k++)
+        for (unsigned int t = 0; t < UOV_TERMS; t++)
+            public_key[k][t] = prng_byte();
+    for (unsigned int i = 0; i < UOV_N; i++)
+        signature[i] = prng_byte();
+
+    eval_public_map(expected);
+}
+
+/**
+ * @brief Apply a 'c' configuration packet and echo the applied values.
+ *
+ * Packet data is a sequence of 5-byte entries: [param_id, value(u32 LE)].
+ * Unknown IDs are skipped. The applied (id, value) pairs are echoed
+ * back in a 'c' response so the host can verify the configuration took
+ * effect. A CFG_UOV_SEED entry triggers a full re-expansion, so the
+ * echo doubles as the "key material ready" signal.
+ */
+static void apply_config(const uint8_t *data, size_t data_len)
+{
+    static uint8_t echo[2 * 5];
+    size_t echo_len = 0;
+
+    for (size_t i = 0; i + 5 <= data_len; i += 5)
+    {
+        uint8_t id = data[i];
+        uint32_t value = (uint32_t)data[i + 1] | ((uint32_t)data[i + 2] << 8) |
+                         ((uint32_t)data[i + 3] << 16) | ((uint32_t)data[i + 4] << 24);
+
+        if (id == CFG_UOV_SEED)
+        {
+            if (value == 0) value = 0x1;
+            key_seed = value;
+            expand_key_material();
+        }
+        else if (id == CFG_ART_CONFIG)
+        {
+            value &= 0x7; // bit0 prefetch, bit1 icache, bit2 dcache
+            ss_configure_art(value);
+        }
+        else
+        {
+            continue; // unknown parameter, do not echo
+        }
+
+        if (echo_len + 5 <= sizeof(echo))
+        {
+            echo[echo_len] = id;
+            echo[echo_len + 1] = (uint8_t)(value & 0xFF);
+            echo[echo_len + 2] = (uint8_t)((value >> 8) & 0xFF);
+            echo[echo_len + 3] = (uint8_t)((value >> 16) & 0xFF);
+            echo[echo_len + 4] = (uint8_t)((value >> 24) & 0xFF);
+            echo_len += 5;
+        }
+    }
+
+    sendpacket('c', echo, echo_len);
+}
+
+/**
+ * @brief Run one verification, wrapped in the trigger GPIO.
+ *
+ * Only the public-map evaluation and the accept comparison are inside
+ * the window; key material is already resident in RAM.
+ *
+ * @param result Output result vector (UOV_M bytes).
+ * @return Non-zero when the result matches the reference (accept).
+ */
+static int run_verify_once(uint8_t result[UOV_M])
+{
+    int accept;
+
+    set_trigger(); // Raise trigger
+    eval_public_map(result);
+    accept = (memcmp(result, expected, UOV_M) == 0);
+    clear_trigger(); // Lower trigger
+
+    return accept;
+}
+
+int main(void)
+{
+    platform_init();
+    init_uart();
+    ss_init(); // set up DMA/interrupt UART path when built with SS_UART_DMA
+    setup_trigger();
+    ss_result_gpio_setup(); // no-op unless built with SS_RESULT_GPIO
+    send_reset_sequence();
+
+    gf_tables_init();
+    expand_key_material();
+
+    uint8_t result[UOV_M];
+    while (1)
+    {
+        ss_wdt_kick();
+        uint8_t cmd;
+        uint8_t *data;
+        size_t data_len;
+        int res = readpacket(&cmd, &data, &data_len); // Read start signal
+        if (res == 0 && cmd == 's' && data && data_len == 1)
+        {
+            // Windowed mode: sequence-tagged start, no per-start ack; the
+            // response carries the same tag for host-side matching.
+            uint8_t seq = data[0];
+            int accept = run_verify_once(result);
+
+            if (!accept)
+                sendpacket_buffered('f', seq, result, UOV_M);
+            else
+                sendpacket_buffered('e', seq, NULL, 0);
+        }
+        else if (res == 0 && cmd == 's')
+        {
+            if (!ss_merged_ack_enabled())
+                send_ack(cmd); // Acknowledge start signal (skipped in merged-ack mode)
+            ss_result_gpio_clear(); // Result line low while executing
+
+            int accept = run_verify_once(result);
+
+            if (!accept){
+                sendpacket('f', result, UOV_M); // Fault packet
+            }
+            else {
+#ifdef SS_RESULT_GPIO
+                ss_result_gpio_set(); // Nofault: no serial response at all
+#else
+                sendpacket('e', NULL, 0); // End signal
+#endif
+            }
+        }
+        else if (res == 0 && cmd == 'c' && data && data_len > 0)
+        {
+            apply_config(data, data_len); // echoes applied values back
+        }
+        else if (res == 0)
+        {
+            ss_handle_control_packet(cmd, data, data_len); // e.g. 'b' baud switch
+        }
+    }
+}
@@ -0,0 +1,15 @@
+// Host conformance build stand-in for the ChipWhisperer hal.h
+// (cw-deps/hal/hal.h). utils/conformance_codec.py compiles
+// simpleserial.c against this directory so sendpacket()/readpacket()
+// run unmodified on the build host; putch()/getch() are provided by
+// shim.c over capture/feed buffers instead of a UART.
+#ifndef HOST_HAL_H
+#define HOST_HAL_H
+
+void putch(char c);
+char getch(void);
+
+#define platform_init() ((void)0)
+#define init_uart()     ((void)0)
+
+#endif // HOST_HAL_H
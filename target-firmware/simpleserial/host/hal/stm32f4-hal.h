@@ -0,0 +1,6 @@
+// Host conformance build stand-in for hal/stm32f4-hal.h: simpleserial.c
+// includes it unconditionally but only the payloads use its GPIO and
+// trigger inlines, so nothing is needed here.
+#ifndef HOST_STM32F4_HAL_H
+#define HOST_STM32F4_HAL_H
+#endif // HOST_STM32F4_HAL_H
@@ -0,0 +1,22 @@
+// Host conformance build stand-in for hal/stm32f4-uart.h. The real
+// header is register-level; here the registers simpleserial.c touches
+// become plain variables (there is no hardware behind a host build)
+// and the baud switch is a no-op.
+#ifndef HOST_STM32F4_UART_H
+#define HOST_STM32F4_UART_H
+
+#include <stdint.h>
+
+static inline void uart_set_baud(uint32_t baud) { (void)baud; }
+
+static volatile uint32_t host_dwt_ctrl;
+static volatile uint32_t host_dwt_cyccnt;
+static volatile uint32_t host_scb_demcr;
+static volatile uint32_t host_usart1_sr;
+
+#define SS_DWT_CTRL   host_dwt_ctrl
+#define SS_DWT_CYCCNT host_dwt_cyccnt
+#define SS_SCB_DEMCR  host_scb_demcr
+#define USART1_SR     host_usart1_sr
+
+#endif // HOST_STM32F4_UART_H
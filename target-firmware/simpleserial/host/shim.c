@@ -0,0 +1,54 @@
+// Host-side I/O shim for the conformance harness
+// (utils/conformance_codec.py): putch() captures the firmware's TX
+// stream into a buffer and getch() feeds bytes loaded by the host, so
+// sendpacket()/readpacket() exercise their real wire paths - including
+// the stream-mode COBS encoder - against the Python codec on the other
+// end.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HOST_IO_BUF_SIZE 65536
+
+static uint8_t host_tx_buf[HOST_IO_BUF_SIZE];
+static size_t host_tx_count;
+static uint8_t host_rx_buf[HOST_IO_BUF_SIZE];
+static size_t host_rx_count;
+static size_t host_rx_pos;
+
+void putch(char c)
+{
+    if (host_tx_count < sizeof(host_tx_buf))
+        host_tx_buf[host_tx_count++] = (uint8_t)c;
+}
+
+char getch(void)
+{
+    if (host_rx_pos >= host_rx_count)
+    {
+        // Underflow means the host loaded an incomplete packet; failing
+        // loudly beats readpacket() spinning on phantom bytes.
+        fprintf(stderr, "host shim: getch() underflow\n");
+        abort();
+    }
+    return (char)host_rx_buf[host_rx_pos++];
+}
+
+/* ------------- control interface (ctypes) ------------- */
+
+void host_tx_reset(void) { host_tx_count = 0; }
+size_t host_tx_len(void) { return host_tx_count; }
+const uint8_t *host_tx_data(void) { return host_tx_buf; }
+
+void host_rx_load(const uint8_t *data, size_t len)
+{
+    if (len > sizeof(host_rx_buf))
+        len = sizeof(host_rx_buf);
+    memcpy(host_rx_buf, data, len);
+    host_rx_count = len;
+    host_rx_pos = 0;
+}
+
+size_t host_rx_remaining(void) { return host_rx_count - host_rx_pos; }
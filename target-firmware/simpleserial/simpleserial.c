@@ -6,8 +6,69 @@
 #include <stdlib.h>
 #include <string.h>
 
+// With SS_UART_DMA the UART is driven by DMA (RX) and the TXE interrupt (TX),
+// so sendpacket() returns as soon as the packet is queued and the main loop
+// can re-enter readpacket() while the previous response is still draining:
+// the payload loops are full-duplex, parsing the next 's' command from the
+// RX ring concurrently with the TX drain, and target turnaround time is
+// independent of response size as long as the TX queue never fills (see
+// SS_UART_TX_QUEUE_SIZE in hal/stm32f4-uart.h for the sizing rule).
+// Without the flag the blocking ChipWhisperer HAL putch()/getch() are used.
+#include "hal/stm32f4-uart.h"
+#ifdef SS_UART_DMA
+#define ss_putch(c) uart_dma_putch(c)
+#define ss_getch()  uart_dma_getch()
+#elif defined(SS_FAST_BOOT)
+// Fast-boot builds skip the HAL UART driver entirely, so putch()/getch()
+// are replaced by the register-level polling variants.
+#define ss_putch(c) uart_putch_poll(c)
+#define ss_getch()  uart_getch_poll()
+#else
+#define ss_putch(c) putch(c)
+#define ss_getch()  getch()
+#endif
+
+// The IWDG cannot be stopped once armed, so the idle wait for host bytes
+// must kick it too. Only the register-level getch variants expose their
+// wait loops; the blocking HAL getch() would starve the watchdog while
+// the host is between executions.
+#if defined(SS_WATCHDOG) && !defined(SS_UART_DMA) && !defined(SS_FAST_BOOT)
+#error "SS_WATCHDOG requires SS_UART_DMA or SS_FAST_BOOT (HAL getch() cannot kick the watchdog while idle)"
+#endif
+
+#ifndef SS_WATCHDOG_MS
+#define SS_WATCHDOG_MS 1000
+#endif
+
+// Pulse-train attribution: EXTI tag-edge capture and its ISR live in the
+// HAL header, included from this translation unit only (see the header).
+#ifdef SS_PULSE_TAG
+#include "hal/stm32f4-exti.h"
+#endif
+
 /**
- * @brief Send a raw buffer of bytes sequentially via putch().
+ * @brief Initialize the SimpleSerial transport layer.
+ *
+ * Call once after init_uart(). Sets up the DMA RX buffer and interrupt TX
+ * queue when built with SS_UART_DMA and arms the watchdog when built with
+ * SS_WATCHDOG; no-op otherwise.
+ */
+void ss_init(void)
+{
+#ifdef SS_UART_DMA
+    uart_dma_init();
+#endif
+#ifdef SS_WATCHDOG
+    iwdg_start(SS_WATCHDOG_MS);
+#endif
+    ss_pulse_tag_setup(); // no-op unless built with SS_PULSE_TAG
+}
+
+/**
+ * @brief Send a raw buffer of bytes sequentially via ss_putch().
+ *
+ * With SS_UART_DMA the bytes are only queued and transmitted in the
+ * background; otherwise each byte blocks until the UART accepts it.
  *
  * @param buf Pointer to the byte buffer.
  * @param len Number of bytes to send.
@@ -19,12 +80,12 @@ void send_buf(const uint8_t *buf, size_t len)
 
     for (size_t i = 0; i < len; i++)
     {
-        putch(buf[i]);
+        ss_putch(buf[i]);
     }
 }
 
 /**
- * @brief Send a null terminated string via putch (not including the terminator).
+ * @brief Send a null terminated string via ss_putch (not including the terminator).
  *
  * @param in Pointer to the byte buffer.
  */
@@ -32,15 +93,107 @@ void send_str(const char* in)
 {
     const char* cur = in;
     while (*cur) {
-        putch(*cur);
+        ss_putch(*cur);
         cur += 1;
     }
 }
 
+// DWT cycle counter, used to timestamp packet reception for the 'e'
+// echo benchmark command. The addresses are fixed by the Cortex-M4
+// core; fast-boot builds define the same registers in stm32f4-uart.h
+// and start the counter during boot, so the lazy enable below is a
+// no-op there. Host conformance builds (see host/) predefine the
+// macros to plain variables, since the core registers obviously do
+// not exist off-target.
+#ifndef SS_DWT_CYCCNT
+#define SS_DWT_CTRL         (*(volatile uint32_t *)0xE0001000UL)
+#define SS_DWT_CYCCNT       (*(volatile uint32_t *)0xE0001004UL)
+#define SS_SCB_DEMCR        (*(volatile uint32_t *)0xE000EDFCUL)
+#endif
+#define SS_SCB_DEMCR_TRCENA (1u << 24)
+#define SS_DWT_CYCCNTENA    (1u << 0)
+
+// CYCCNT value captured when the last packet's terminator arrived
+// (see readpacket); the echo command reports its turnaround relative
+// to this, so the measurement includes COBS decode and CRC check.
+static uint32_t ss_rx_done_cycles;
+
+static void ss_dwt_ensure_running(void)
+{
+    if (!(SS_DWT_CTRL & SS_DWT_CYCCNTENA))
+    {
+        SS_SCB_DEMCR |= SS_SCB_DEMCR_TRCENA;
+        SS_DWT_CYCCNT = 0;
+        SS_DWT_CTRL |= SS_DWT_CYCCNTENA;
+    }
+}
+
+uint32_t ss_cycles(void)
+{
+    ss_dwt_ensure_running();
+    return SS_DWT_CYCCNT;
+}
+
+// FLASH interface ACR (ART accelerator / prefetch control), for the
+// payloads' art_config runtime toggle. Register address is fixed on
+// the STM32F4.
+#define SS_FLASH_ACR        (*(volatile uint32_t *)0x40023C00UL)
+#define SS_FLASH_ACR_PRFTEN (1u << 8)
+#define SS_FLASH_ACR_ICEN   (1u << 9)
+#define SS_FLASH_ACR_DCEN   (1u << 10)
+#define SS_FLASH_ACR_ICRST  (1u << 11)
+#define SS_FLASH_ACR_DCRST  (1u << 12)
+
+void ss_configure_art(uint32_t flags)
+{
+    uint32_t acr = SS_FLASH_ACR &
+        ~(SS_FLASH_ACR_PRFTEN | SS_FLASH_ACR_ICEN | SS_FLASH_ACR_DCEN);
+
+    // Caches may only be reset while disabled (RM0090); resetting on
+    // every reconfiguration keeps the cache state independent of the
+    // toggle history.
+    SS_FLASH_ACR = acr;
+    SS_FLASH_ACR = acr | SS_FLASH_ACR_ICRST | SS_FLASH_ACR_DCRST;
+    SS_FLASH_ACR = acr;
+
+    if (flags & 1u) acr |= SS_FLASH_ACR_PRFTEN;
+    if (flags & 2u) acr |= SS_FLASH_ACR_ICEN;
+    if (flags & 4u) acr |= SS_FLASH_ACR_DCEN;
+    SS_FLASH_ACR = acr;
+}
+
+// 256-entry lookup table for the 0x4D CRC, built once on first use.
+// Note: the STM32F4 hardware CRC peripheral is hardwired to the 32-bit
+// polynomial 0x04C11DB7 and cannot compute this 8-bit CRC, so the table
+// is the fastest option available on this target.
+static uint8_t crc_table[256];
+static uint8_t crc_table_initialized = 0;
+
+/**
+ * @brief Build the 256-entry lookup table for the 0x4D CRC.
+ */
+static void init_crc_table(void)
+{
+    for (int i = 0; i < 256; ++i)
+    {
+        uint8_t crc = (uint8_t)i;
+        for (uint8_t j = 0; j < 8; ++j)
+        {
+            if (crc & 0x80)
+                crc = (crc << 1) ^ 0x4D;
+            else
+                crc <<= 1;
+        }
+        crc_table[i] = crc;
+    }
+    crc_table_initialized = 1;
+}
+
 /**
  * @brief Calculate 8-bit CRC for a given buffer using polynomial 0x4D.
  *
- * This implements a bitwise CRC calculation. The CRC is initialized to 0x00.
+ * Table-driven implementation (one lookup per byte instead of eight
+ * shift/xor iterations). The CRC is initialized to 0x00.
  *
  * @param buf Pointer to input data buffer.
  * @param len Length of the input buffer.
@@ -48,21 +201,95 @@ void send_str(const char* in)
  */
 uint8_t calc_crc(const uint8_t *buf, size_t len)
 {
+    if (!crc_table_initialized)
+        init_crc_table();
+
     uint8_t crc = 0x00;
     for (size_t i = 0; i < len; ++i)
     {
-        crc ^= buf[i];
-        for (uint8_t j = 0; j < 8; ++j)
-        {
-            if (crc & 0x80)
-                crc = (crc << 1) ^ 0x4D;
-            else
-                crc <<= 1;
-        }
+        crc = crc_table[crc ^ buf[i]];
     }
     return crc;
 }
 
+// CRC-32 (IEEE: reflected, init and final xor 0xFFFFFFFF) lookup
+// table, built on first use like the CRC-8 table above. Matches
+// zlib.crc32 on the host. The STM32F4 CRC peripheral computes the
+// non-reflected MPEG-2 variant over full 32-bit words only, so
+// matching the host would cost per-byte bit reversals; the table is
+// one lookup per byte, the same hot-path cost as the CRC-8.
+static uint32_t crc32_table[256];
+static uint8_t crc32_table_initialized = 0;
+
+static void init_crc32_table(void)
+{
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i;
+        for (int j = 0; j < 8; ++j)
+            crc = (crc & 1u) ? (crc >> 1) ^ 0xEDB88320UL : crc >> 1;
+        crc32_table[i] = crc;
+    }
+    crc32_table_initialized = 1;
+}
+
+/**
+ * @brief Calculate the IEEE CRC-32 (zlib-compatible) of a buffer.
+ *
+ * Used instead of calc_crc() once CRC-32 integrity has been negotiated
+ * via the 'C' control packet; packets then carry 4 CRC bytes (little
+ * endian) instead of 1.
+ *
+ * @param buf Pointer to input data buffer.
+ * @param len Length of the input buffer.
+ * @return Calculated CRC-32 value.
+ */
+uint32_t calc_crc32(const uint8_t *buf, size_t len)
+{
+    if (!crc32_table_initialized)
+        init_crc32_table();
+
+    uint32_t crc = 0xFFFFFFFFUL;
+    for (size_t i = 0; i < len; ++i)
+        crc = crc32_table[(crc ^ buf[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFUL;
+}
+
+// Active integrity mode, negotiated via the 'C' control packet. The
+// boot default is the 8-bit 0x4D CRC; CRC-32 gives 68-byte fault
+// payloads real error detection on a link that EMFI pulses actively
+// corrupt. A reset drops back to CRC-8, like the framing default.
+static uint8_t ss_crc_mode = SS_CRC_MODE_CRC8;
+
+// Number of CRC bytes a payload carries in the active mode
+static size_t ss_crc_len(void)
+{
+    return (ss_crc_mode == SS_CRC_MODE_CRC32) ? 4 : 1;
+}
+
+// Write the active-mode CRC of data into out (little endian for CRC-32)
+static void ss_crc_write(const uint8_t *data, size_t len, uint8_t *out)
+{
+    if (ss_crc_mode == SS_CRC_MODE_CRC32)
+    {
+        uint32_t crc = calc_crc32(data, len);
+        out[0] = (uint8_t)(crc & 0xFF);
+        out[1] = (uint8_t)((crc >> 8) & 0xFF);
+        out[2] = (uint8_t)((crc >> 16) & 0xFF);
+        out[3] = (uint8_t)((crc >> 24) & 0xFF);
+        return;
+    }
+    out[0] = calc_crc(data, len);
+}
+
+// Check the active-mode CRC bytes trailing a received payload
+static int ss_crc_check(const uint8_t *data, size_t len, const uint8_t *crc)
+{
+    uint8_t expect[4];
+    ss_crc_write(data, len, expect);
+    return memcmp(crc, expect, ss_crc_len()) == 0;
+}
+
 /**
  * @brief Encode a buffer using Consistent Overhead Byte Stuffing (COBS).
  *
@@ -86,14 +313,23 @@ size_t cobs_stuff_data(const uint8_t *buf, size_t len, uint8_t *out)
     for (size_t i = 0; i < len; ++i)
     {
         uint8_t b = buf[i];
-        if (b == FRAME_BYTE || code == 0xFF)
+        if (code == 0xFF)
         {
+            // Full 254-byte block: close it before looking at b, so a
+            // FRAME_BYTE right behind it still gets its own empty block
             out[code_index] = code;
             code_index = out_index;
             out[out_index++] = 0; // placeholder for next code byte
             code = 1;
         }
-        if (b != FRAME_BYTE)
+        if (b == FRAME_BYTE)
+        {
+            out[code_index] = code;
+            code_index = out_index;
+            out[out_index++] = 0; // placeholder for next code byte
+            code = 1;
+        }
+        else
         {
             out[out_index++] = b;
             code++;
@@ -176,6 +412,58 @@ size_t get_max_decode_len(size_t encoded_len)
     return encoded_len;
 }
 
+/* ---------------- Static (zero-allocation) RX path ---------------- */
+
+// Preallocated receive and decode buffers used by readpacket().
+// Sized for the largest expected packet (cmd + COBS(data + crc) + terminator).
+// Callers needing larger payloads can still use the malloc-based
+// read_until_terminator() / read_until_sequence() API below.
+static uint8_t ss_rx_buf[SS_STATIC_RX_BUF_SIZE];
+static uint8_t ss_decode_buf[SS_STATIC_RX_BUF_SIZE];
+
+/**
+ * @brief Reads bytes into a caller-provided buffer until FRAME_BYTE is seen.
+ *
+ * Zero-allocation variant of read_until_terminator(): no malloc/realloc is
+ * performed, so this is safe to use in the receive hot path between the
+ * start packet and the trigger raise. The terminator byte is included in
+ * the output.
+ *
+ * @param buf Destination buffer (preallocated by the caller).
+ * @param buf_size Size of the destination buffer.
+ * @param[out] len Number of bytes written (including the terminator).
+ * @return 0 on success, -1 on invalid arguments or buffer overflow.
+ *
+ * @note On overflow the function keeps consuming input until the next
+ *       FRAME_BYTE so the stream stays framed, then returns -1.
+ */
+int read_until_terminator_static(uint8_t *buf, size_t buf_size, size_t *len)
+{
+    if (!buf || buf_size == 0 || !len)
+        return -1;
+
+    size_t pos = 0;
+    while (1)
+    {
+        uint8_t byte = ss_getch();
+
+        if (pos >= buf_size) {
+            // Overflow: resynchronize on the next terminator, then fail
+            while (byte != FRAME_BYTE)
+                byte = ss_getch();
+            return -1;
+        }
+
+        buf[pos] = byte;
+        pos++;
+
+        if (byte == FRAME_BYTE) break; // terminator
+    }
+
+    *len = pos;
+    return 0;
+}
+
 /**
  * @brief Reads from the input until a specified byte sequence is seen.
  *
@@ -201,7 +489,7 @@ uint8_t *read_until_sequence(const uint8_t *seq, size_t seq_len, size_t *out_len
     while (1)
     {
         uint8_t byte;
-        byte = getch();
+        byte = ss_getch();
 
         if (pos >= buf_size) {
             size_t new_size = buf_size + 64; // grow buffer
@@ -262,7 +550,7 @@ uint8_t *read_until_terminator(size_t *len)
     while (1)
     {
         uint8_t byte;
-        byte = getch();
+        byte = ss_getch();
 
         if (pos >= buf_size) {
             size_t new_size = buf_size + 64;
@@ -294,20 +582,71 @@ uint8_t *read_until_terminator(size_t *len)
  */
 void send_reset_sequence()
 {
+#ifdef SS_BOOT_GPIO
+    // Boot-ready line: PA11 (IO3 on the CW308 header, separate from the
+    // PA12 trigger so a boot edge can never fire the pulse generator).
+    // Raised before the serial announce, so the host can confirm a reset
+    // from the scope's IO state instead of scanning the UART stream.
+    inline_gpio_mode_setup(GPIOA, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLDOWN, GPIO11);
+    inline_gpio_set(GPIOA, GPIO11);
+#endif
+
     uint8_t reset_sequence[] = {0, 0, 0, 114, 0, 0, 0};
     send_buf(reset_sequence, sizeof(reset_sequence));
+
+#ifdef SS_FAST_BOOT
+    // Extended reset packet: report the reset-to-ready time in cycles
+    // (DWT counter started at the top of fast_boot_init()) so the host
+    // can verify the fast-boot path stays within budget.
+    uint32_t boot_cycles = DWT_CYCCNT;
+    uint8_t report[4];
+    report[0] = (uint8_t)(boot_cycles & 0xFF);
+    report[1] = (uint8_t)((boot_cycles >> 8) & 0xFF);
+    report[2] = (uint8_t)((boot_cycles >> 16) & 0xFF);
+    report[3] = (uint8_t)((boot_cycles >> 24) & 0xFF);
+    sendpacket('t', report, sizeof(report)); // Boot-time packet
+#endif
+}
+
+// Active framing mode, negotiated via the 'F' control packet. The boot
+// default is COBS framing (protocol v1: COBS-encoded payload, zero
+// terminator), which survives noisy links but makes both ends scan and
+// en/decode every byte. The length-prefixed v2 framing [cmd, len16 LE,
+// payload, crc] skips COBS entirely and lets the host read responses
+// with exact-length reads. A reset drops the target back to the COBS
+// default; the host detects that from the resulting v2 read failures.
+static uint8_t ss_framing = SS_FRAMING_COBS;
+
+// Merged-ack mode, toggled via the 'a' control packet: payload main
+// loops skip the per-start ack and the response packet itself
+// acknowledges the start, saving one serial roundtrip per execution.
+// A reset drops back to acked starts; the host re-applies the mode
+// after every reset_target().
+static uint8_t ss_merged_ack = 0;
+
+int ss_merged_ack_enabled(void)
+{
+    return ss_merged_ack;
 }
 
 /**
  * @brief Send an ACK packet for a given command.
  *
- * The ACK format is simply [command, FRAME_BYTE].
+ * The ACK format is [command, FRAME_BYTE] in COBS framing and a
+ * zero-length v2 frame [command, 0, 0] in length-prefixed framing.
  *
  * @param command Command byte (0–255) to acknowledge.
  */
 
 void send_ack(uint8_t command)
 {
+    if (ss_framing == SS_FRAMING_LEN16)
+    {
+        uint8_t ack[3] = {command, 0, 0};
+        send_buf(ack, sizeof(ack));
+        return;
+    }
+
     uint8_t ack[2];
     ack[0] = command;
     ack[1] = FRAME_BYTE;
@@ -363,6 +702,24 @@ int wait_ack(uint8_t cmd)
 int sendpacket(uint8_t cmd, const uint8_t *data, size_t data_len)
 {
     if (!data) data_len = 0;
+
+    if (ss_framing == SS_FRAMING_LEN16)
+    {
+        uint8_t header[3];
+        header[0] = cmd;
+        header[1] = (uint8_t)(data_len & 0xFF);
+        header[2] = (uint8_t)((data_len >> 8) & 0xFF);
+        send_buf(header, sizeof(header));
+        if (data_len > 0)
+        {
+            uint8_t crc_bytes[4];
+            send_buf(data, data_len);
+            ss_crc_write(data, data_len, crc_bytes);
+            send_buf(crc_bytes, ss_crc_len());
+        }
+        return 0;
+    }
+
     // No data: just [cmd, terminator]
     if (data_len == 0)
     {
@@ -376,8 +733,10 @@ int sendpacket(uint8_t cmd, const uint8_t *data, size_t data_len)
     // Send cmd byte
     send_buf(&cmd, 1);
 
-    // Compute CRC
-    uint8_t crc = calc_crc(data, data_len);
+    // Compute CRC trailer (1 byte CRC-8 or 4 bytes CRC-32 LE)
+    uint8_t crc_bytes[4];
+    ss_crc_write(data, data_len, crc_bytes);
+    size_t crc_len = ss_crc_len();
 
     // COBS stuffing in stream mode (directly send out blocks after computing)
     // -> more efficient than using cobs_stuff_data() and allocating large buffers
@@ -389,18 +748,20 @@ int sendpacket(uint8_t cmd, const uint8_t *data, size_t data_len)
     size_t code_index = 0; // code byte index
     uint8_t code = 1; // code (block length)
 
-    for (size_t i = 0; i < data_len + 1; ++i) // +1 for CRC
+    for (size_t i = 0; i < data_len + crc_len; ++i) // CRC trailer included
     {
         uint8_t b;
         if (i < data_len) {
             b = data[i];
         }
         else {
-            b = crc;
+            b = crc_bytes[i - data_len];
         }
 
-        // Block terminated by frame byte or by reaching max block length
-        if (b == FRAME_BYTE || code == 0xFF)
+        // Block terminated by reaching max block length; closed before
+        // looking at b so a FRAME_BYTE right behind a full 254-byte
+        // block still gets its own empty block below
+        if (code == 0xFF)
         {
             // Set code (block length)
             cobs_block[code_index] = code;
@@ -412,8 +773,16 @@ int sendpacket(uint8_t cmd, const uint8_t *data, size_t data_len)
             code_index = 0;
             code = 1; // only code byte
         }
+        // Block terminated by frame byte
+        if (b == FRAME_BYTE)
+        {
+            cobs_block[code_index] = code;
+            send_buf(cobs_block, code);
+            code_index = 0;
+            code = 1; // only code byte
+        }
         // Normal byte (non - FRAME_BYTE) -> append to cobs_block
-        if (b != FRAME_BYTE)
+        else
         {
             cobs_block[code] = b;
             code++;
@@ -431,11 +800,262 @@ int sendpacket(uint8_t cmd, const uint8_t *data, size_t data_len)
     return 0;
 }
 
+/**
+ * @brief Block until all queued TX bytes have left the software queue.
+ *
+ * With the blocking putch() path this is a no-op since every byte has
+ * already been handed to the UART when send_buf() returns.
+ */
+static void ss_tx_flush(void)
+{
+#ifdef SS_UART_DMA
+    uart_dma_tx_flush();
+#endif
+}
+
+/**
+ * @brief Handle protocol control packets shared by all payloads.
+ *
+ * Payload main loops pass any packet that is not their start command here.
+ * Currently handled:
+ *   'b' + 4 bytes (little endian): switch UART baud rate.
+ *       The switch is acknowledged at the old baud rate, the TX path is
+ *       drained, then the divider is reprogrammed and a second ack is sent
+ *       at the new rate so the host can verify the link.
+ *   'e' + payload: echo transaction (utils/bench_serial.py).
+ *       Replies with the frame-received-to-response-queued turnaround in
+ *       DWT cycles (4 bytes, little endian) followed by the unmodified
+ *       payload.
+ *   'k' + [len u16 LE, pattern, iterations]: codec benchmark
+ *       (utils/bench_codec.py). Times calc_crc/cobs_stuff_data/
+ *       cobs_unstuff_data over a generated buffer and replies with the
+ *       per-function total cycles (3x u32 LE) plus the effective input
+ *       and encoded lengths (2x u16 LE).
+ *   'v': firmware version query. Replies with the build tag compiled
+ *       into the image; the host locates the same tag inside the image
+ *       file on disk and skips reflashing when they match.
+ *   'F' + 1 byte: framing negotiation (0 = COBS, 1 = length-prefixed
+ *       v2). Acked in the old framing, then the TX path is drained,
+ *       the mode switched and a second ack sent in the new framing -
+ *       the same handshake shape as the baud switch.
+ *   'C' + 1 byte: CRC mode negotiation (0 = CRC-8 0x4D, 1 = CRC-32).
+ *       Same two-ack handshake; acks carry no CRC in either framing,
+ *       so the confirmation ack needs no special casing.
+ *   'a' + 1 byte: merged-ack mode (0 = acked starts, 1 = merged).
+ *       When enabled, payload main loops skip the per-start ack (see
+ *       ss_merged_ack_enabled) and the response packet itself
+ *       acknowledges the start.
+ *
+ * @param cmd Received command byte.
+ * @param data Packet data (may be NULL).
+ * @param data_len Length of packet data.
+ * @return 0 if the packet was handled, -1 otherwise.
+ */
+// Build identity reported by the 'v' control packet. __DATE__/__TIME__
+// change on every compile, so the tag distinguishes rebuilds of the
+// same payload; the marker prefix lets the host find the identical
+// string inside the firmware image on disk for comparison.
+static const char ss_build_tag[] = "SSBUILDTAG:" __DATE__ " " __TIME__;
+
+int ss_handle_control_packet(uint8_t cmd, const uint8_t *data, size_t data_len)
+{
+    if (cmd == 'v')
+    {
+        sendpacket('v', (const uint8_t *)ss_build_tag, sizeof(ss_build_tag) - 1);
+        return 0;
+    }
+
+    if (cmd == 'F' && data && data_len == 1)
+    {
+        if (data[0] > SS_FRAMING_LEN16)
+            return -1;
+
+        send_ack(cmd); // ack in the old framing
+        ss_tx_flush();
+        ss_framing = data[0];
+        send_ack(cmd); // confirmation ack in the new framing
+        return 0;
+    }
+
+    if (cmd == 'a' && data && data_len == 1)
+    {
+        ss_merged_ack = data[0] ? 1 : 0;
+        send_ack(cmd);
+        return 0;
+    }
+
+    if (cmd == 'C' && data && data_len == 1)
+    {
+        if (data[0] > SS_CRC_MODE_CRC32)
+            return -1;
+
+        send_ack(cmd); // ack in the old CRC mode
+        ss_tx_flush();
+        ss_crc_mode = data[0];
+        send_ack(cmd); // confirmation ack in the new mode
+        return 0;
+    }
+
+    if (cmd == 'b' && data && data_len == 4)
+    {
+        uint32_t baud = (uint32_t)data[0] | ((uint32_t)data[1] << 8) |
+                        ((uint32_t)data[2] << 16) | ((uint32_t)data[3] << 24);
+
+        // Reject rates the 7.37MHz peripheral clock cannot hit cleanly
+        if (baud < 9600 || baud > 921600)
+            return -1;
+
+        send_ack(cmd); // ack at the old baud rate
+        ss_tx_flush();
+
+        // Let the last stop bit shift out and give the host time to switch
+        for (volatile uint32_t i = 0; i < 20000; i++)
+            ;
+
+        uart_set_baud(baud);
+
+        send_ack(cmd); // confirmation ack at the new baud rate
+        return 0;
+    }
+
+    if (cmd == 'e')
+    {
+        // Echo benchmark: [turnaround cycles LE32, payload]. The
+        // turnaround is measured from the terminator byte of the echo
+        // request (timestamped in readpacket) to here, so it covers
+        // COBS decode, CRC check and dispatch - the part of the
+        // roundtrip the host cannot observe directly.
+        static uint8_t echo_buf[SS_STATIC_RX_BUF_SIZE];
+
+        if (data_len + 4 > sizeof(echo_buf))
+            return -1;
+        if (data && data_len > 0)
+            memcpy(&echo_buf[4], data, data_len);
+
+        uint32_t cycles = SS_DWT_CYCCNT - ss_rx_done_cycles;
+        echo_buf[0] = (uint8_t)(cycles & 0xFF);
+        echo_buf[1] = (uint8_t)((cycles >> 8) & 0xFF);
+        echo_buf[2] = (uint8_t)((cycles >> 16) & 0xFF);
+        echo_buf[3] = (uint8_t)((cycles >> 24) & 0xFF);
+
+        sendpacket('e', echo_buf, data_len + 4);
+        return 0;
+    }
+
+    if (cmd == 'k' && data && data_len == 4)
+    {
+        // Codec benchmark: generate a buffer of the requested length and
+        // pattern, run each codec function `iterations` times under the
+        // DWT cycle counter and report the totals. Patterns select the
+        // frame-byte density (the COBS worst-case axis):
+        //   0: no frame bytes, 1: every other byte zero, 2: all zeros
+        static uint8_t bench_in[SS_CODEC_BENCH_BUF_SIZE];
+        static uint8_t bench_enc[SS_CODEC_BENCH_BUF_SIZE
+                                 + SS_CODEC_BENCH_BUF_SIZE / 254 + 1];
+        static uint8_t bench_dec[SS_CODEC_BENCH_BUF_SIZE];
+
+        size_t len = (size_t)data[0] | ((size_t)data[1] << 8);
+        uint8_t pattern = data[2];
+        uint8_t iterations = data[3];
+        if (len == 0 || len > sizeof(bench_in) || iterations == 0)
+            return -1;
+
+        for (size_t i = 0; i < len; ++i)
+        {
+            if (pattern == 2)
+                bench_in[i] = 0;
+            else if (pattern == 1)
+                bench_in[i] = (i & 1) ? 0 : (uint8_t)(i * 37 % 255 + 1);
+            else
+                bench_in[i] = (uint8_t)(i * 37 % 255 + 1); // never 0
+        }
+
+        ss_dwt_ensure_running();
+        volatile uint8_t crc_sink; // keep calc_crc calls observable
+
+        uint32_t start = SS_DWT_CYCCNT;
+        for (uint8_t i = 0; i < iterations; ++i)
+            crc_sink = calc_crc(bench_in, len);
+        uint32_t crc_cycles = SS_DWT_CYCCNT - start;
+        (void)crc_sink;
+
+        size_t encoded_len = 0;
+        start = SS_DWT_CYCCNT;
+        for (uint8_t i = 0; i < iterations; ++i)
+            encoded_len = cobs_stuff_data(bench_in, len, bench_enc);
+        uint32_t stuff_cycles = SS_DWT_CYCCNT - start;
+
+        start = SS_DWT_CYCCNT;
+        for (uint8_t i = 0; i < iterations; ++i)
+            cobs_unstuff_data(bench_enc, encoded_len, bench_dec);
+        uint32_t unstuff_cycles = SS_DWT_CYCCNT - start;
+
+        uint8_t report[16];
+        uint32_t cycles[3] = {crc_cycles, stuff_cycles, unstuff_cycles};
+        for (int i = 0; i < 3; ++i)
+        {
+            report[i * 4 + 0] = (uint8_t)(cycles[i] & 0xFF);
+            report[i * 4 + 1] = (uint8_t)((cycles[i] >> 8) & 0xFF);
+            report[i * 4 + 2] = (uint8_t)((cycles[i] >> 16) & 0xFF);
+            report[i * 4 + 3] = (uint8_t)((cycles[i] >> 24) & 0xFF);
+        }
+        report[12] = (uint8_t)(len & 0xFF);
+        report[13] = (uint8_t)((len >> 8) & 0xFF);
+        report[14] = (uint8_t)(encoded_len & 0xFF);
+        report[15] = (uint8_t)((encoded_len >> 8) & 0xFF);
+
+        sendpacket('k', report, sizeof(report));
+        return 0;
+    }
+
+    return -1; // unknown control packet
+}
+
+// Snapshot buffer for double-buffered transmission (sendpacket_buffered).
+// Holds seq tag + payload while the original buffer is reused by the caller.
+static uint8_t ss_tx_snapshot[SS_TX_SNAPSHOT_BUF_SIZE];
+
+/**
+ * @brief Send a packet from a snapshot copy, tagged with a sequence number.
+ *
+ * The payload is copied into a dedicated TX snapshot buffer before
+ * transmission, so the caller may immediately reuse (or re-initialize) its
+ * own buffer. Combined with SS_UART_DMA the transmission then drains in the
+ * background while the payload loop restarts.
+ *
+ * The sequence number is prepended as the first data byte, letting the host
+ * associate each response with its execution even when responses overlap
+ * the next start command (see TargetSerial.read_packet_tagged()).
+ *
+ * @param cmd Command byte (0-255).
+ * @param seq Sequence tag, incremented by the caller per execution.
+ * @param data Pointer to payload buffer (may be NULL for seq-only packets).
+ * @param data_len Length of payload (0 if none).
+ * @return 0 on success, -1 if the payload exceeds the snapshot buffer.
+ */
+int sendpacket_buffered(uint8_t cmd, uint8_t seq, const uint8_t *data, size_t data_len)
+{
+    if (!data) data_len = 0;
+    if (data_len + 1 > sizeof(ss_tx_snapshot))
+        return -1;
+
+    ss_tx_snapshot[0] = seq;
+    if (data_len > 0)
+        memcpy(&ss_tx_snapshot[1], data, data_len);
+
+    return sendpacket(cmd, ss_tx_snapshot, data_len + 1);
+}
+
 /**
  * @brief Reads and decodes a SimpleSerial packet.
  *
+ * The packet is received into a preallocated static buffer, so no heap
+ * allocation happens in the receive hot path. The returned data pointer
+ * references that static buffer: it stays valid until the next call to
+ * readpacket() and must NOT be free'd by the caller.
+ *
  * @param cmd Pointer to store received command byte.
- * @param data Pointer to store dynamically allocated data buffer (must be free'd by caller).
+ * @param data Pointer to store data pointer (into static buffer, do not free).
  * @param data_len Pointer to store length of received data.
  * @return Number of data bytes on success, 0 for empty packet, -1 on error.
  *
@@ -453,19 +1073,79 @@ int sendpacket(uint8_t cmd, const uint8_t *data, size_t data_len)
  *      size_t dummy_len;
  *      int res = readpacket(&cmd, NULL, &dummy_len);
  */
+/**
+ * @brief Length-prefixed (v2) variant of readpacket().
+ *
+ * Reads the fixed [cmd, len16 LE] header, then exactly len payload
+ * bytes plus the CRC - no terminator scan and no COBS decode. Entered
+ * by readpacket() after the 'F' negotiation switched framing.
+ */
+static int readpacket_len16(uint8_t *cmd, uint8_t **data, size_t *data_len)
+{
+    *cmd = ss_getch();
+    size_t len = (size_t)ss_getch();
+    len |= (size_t)ss_getch() << 8;
+
+    if (len == 0)
+    {
+        ss_dwt_ensure_running();
+        ss_rx_done_cycles = SS_DWT_CYCCNT;
+        if (data) *data = NULL;
+        if (data_len) *data_len = 0;
+        return 0;
+    }
+
+    if (!data || !data_len)
+        return -1;
+
+    size_t crc_len = ss_crc_len();
+
+    if (len > sizeof(ss_decode_buf))
+    {
+        // Drain the oversized frame so the stream stays aligned
+        for (size_t i = 0; i < len + crc_len; ++i)
+            (void)ss_getch();
+        return -1;
+    }
+
+    uint8_t crc_bytes[4];
+    for (size_t i = 0; i < len; ++i)
+        ss_decode_buf[i] = ss_getch();
+    for (size_t i = 0; i < crc_len; ++i)
+        crc_bytes[i] = ss_getch();
+
+    ss_dwt_ensure_running();
+    ss_rx_done_cycles = SS_DWT_CYCCNT;
+
+    if (!ss_crc_check(ss_decode_buf, len, crc_bytes))
+        return -1;
+
+    *data = ss_decode_buf;
+    *data_len = len;
+    return 0;
+}
+
 int readpacket(uint8_t *cmd, uint8_t **data, size_t *data_len)
 {
     if (!cmd) {
         return -1;
     }
-    // Read full packet including terminator
+
+    if (ss_framing == SS_FRAMING_LEN16)
+        return readpacket_len16(cmd, data, data_len);
+
+    // Read full packet including terminator into the static RX buffer
+    // (no allocation between the start packet and the trigger raise)
     size_t buf_len;
-    uint8_t *buf = read_until_terminator(&buf_len);
+    if (read_until_terminator_static(ss_rx_buf, sizeof(ss_rx_buf), &buf_len) != 0)
+        return -1; // read error or oversized packet
 
-    if (!buf) return -1; // read error
+    // Timestamp frame completion for the echo benchmark turnaround
+    // report (one volatile read + test; negligible on the hot path)
+    ss_dwt_ensure_running();
+    ss_rx_done_cycles = SS_DWT_CYCCNT;
 
     if (buf_len == 0) {
-        free(buf);
         return -1;
     }
 
@@ -473,8 +1153,9 @@ int readpacket(uint8_t *cmd, uint8_t **data, size_t *data_len)
 
     if (buf_len == 1) {
         // Simple packet: only cmd, no data
-        *cmd = buf[0];
-        free(buf);
+        *cmd = ss_rx_buf[0];
+        if (data) *data = NULL;
+        if (data_len) *data_len = 0;
         return 0;
     }
 
@@ -482,38 +1163,157 @@ int readpacket(uint8_t *cmd, uint8_t **data, size_t *data_len)
         return -1;
     }
 
-    *cmd = buf[0];
+    *cmd = ss_rx_buf[0];
 
-    // Packet with data
+    // Packet with data: decode into the static decode buffer
     size_t cobs_block_len = buf_len - 1; // exclude cmd
     size_t max_decode_len = get_max_decode_len(cobs_block_len);
-    uint8_t *decoded = malloc(max_decode_len);
-    if (!decoded) {
-        free(buf);
-        return -1;
+    if (max_decode_len > sizeof(ss_decode_buf)) {
+        return -1; // cannot happen while both static buffers are equally sized
     }
 
-    size_t decoded_len = cobs_unstuff_data(&buf[1], cobs_block_len, decoded);
-    free(buf);
+    size_t decoded_len = cobs_unstuff_data(&ss_rx_buf[1], cobs_block_len, ss_decode_buf);
 
     if (decoded_len > max_decode_len || decoded_len == 0) {
-        free(decoded);
         return -1; // decode error or length mismatch
     }
 
-    // Separate CRC
-    uint8_t crc = decoded[decoded_len - 1];
-    *data_len = decoded_len - 1;
+    // Separate CRC trailer (1 byte CRC-8 or 4 bytes CRC-32 LE)
+    size_t crc_len = ss_crc_len();
+    if (decoded_len < crc_len) {
+        return -1; // shorter than the CRC trailer alone
+    }
+    *data_len = decoded_len - crc_len;
 
     // Validate CRC
-    if (calc_crc(decoded, *data_len) != crc) {
-        free(decoded);
+    if (!ss_crc_check(ss_decode_buf, *data_len, &ss_decode_buf[*data_len])) {
         return -1;
     }
 
-    // Return decoded data to caller
-    *data = decoded;
+    // Return pointer into the static decode buffer. Contents stay valid
+    // until the next readpacket() call; callers must NOT free() it.
+    *data = ss_decode_buf;
 
     return 0;
 }
 
+
+/**
+ * @brief Number of received bytes waiting to be read, without blocking.
+ *
+ * With SS_UART_DMA this is the DMA RX ring occupancy; otherwise it
+ * reports at most 1 (the USART RXNE data register). The accumulate
+ * engine polls this between executions, so on non-DMA builds a
+ * multi-byte stop packet can overrun the single-byte register while an
+ * execution is in flight - build with SS_UART_DMA for reliable
+ * mid-accumulation commands.
+ */
+size_t ss_rx_pending(void)
+{
+#ifdef SS_UART_DMA
+    return uart_dma_rx_available();
+#else
+    return (USART1_SR & (1u << 5)) ? 1 : 0; // RXNE
+#endif
+}
+
+// Ring of the most recent faulty counter values within one summary
+// interval; older faults are overwritten once it is full.
+static uint32_t ss_accum_ring[SS_ACCUM_RING_SIZE];
+
+/**
+ * @brief Send one 'A' summary packet and reset the interval counters.
+ *
+ * Packet layout (little endian):
+ *   [0..3]  executions since the previous summary
+ *   [4..7]  faults since the previous summary
+ *   [8]     number of ring entries that follow (<= SS_ACCUM_RING_SIZE)
+ *   [9..]   most recent faulty counter values, oldest first (u32 each)
+ */
+static void ss_accum_send_summary(uint32_t *execs, uint32_t *faults)
+{
+    uint8_t resp[9 + 4 * SS_ACCUM_RING_SIZE];
+    uint32_t num_ring = *faults;
+    if (num_ring > SS_ACCUM_RING_SIZE)
+        num_ring = SS_ACCUM_RING_SIZE;
+
+    resp[0] = (uint8_t)(*execs & 0xFF);
+    resp[1] = (uint8_t)((*execs >> 8) & 0xFF);
+    resp[2] = (uint8_t)((*execs >> 16) & 0xFF);
+    resp[3] = (uint8_t)((*execs >> 24) & 0xFF);
+    resp[4] = (uint8_t)(*faults & 0xFF);
+    resp[5] = (uint8_t)((*faults >> 8) & 0xFF);
+    resp[6] = (uint8_t)((*faults >> 16) & 0xFF);
+    resp[7] = (uint8_t)((*faults >> 24) & 0xFF);
+    resp[8] = (uint8_t)num_ring;
+
+    // Emit oldest-first: the ring write index is *faults modulo size
+    for (uint32_t i = 0; i < num_ring; i++)
+    {
+        uint32_t v = ss_accum_ring[(*faults - num_ring + i) % SS_ACCUM_RING_SIZE];
+        resp[9 + i * 4 + 0] = (uint8_t)(v & 0xFF);
+        resp[9 + i * 4 + 1] = (uint8_t)((v >> 8) & 0xFF);
+        resp[9 + i * 4 + 2] = (uint8_t)((v >> 16) & 0xFF);
+        resp[9 + i * 4 + 3] = (uint8_t)((v >> 24) & 0xFF);
+    }
+
+    sendpacket('A', resp, 9 + 4 * num_ring);
+    *execs = 0;
+    *faults = 0;
+}
+
+/**
+ * @brief Run executions continuously, reporting aggregate summaries.
+ *
+ * The payload's exec callback is invoked back-to-back (the external
+ * pulse generator fires on the trigger line for each execution), with
+ * nofault/fault outcomes only counted on-target: one 'A' summary packet
+ * is sent per `interval` executions instead of one response per shot.
+ * Between executions the RX path is polled; any received packet ends
+ * the run with a final summary covering the partial interval, so an
+ * 'A' request doubles as the on-demand fetch/stop command. Commands
+ * other than 'A' are consumed and dropped - the host must stop the run
+ * before issuing anything else.
+ *
+ * @param interval Executions per summary packet (clamped to >= 1).
+ * @param exec Callback running one trigger-wrapped execution; sets
+ *             *fault nonzero on a fault and returns the counter value
+ *             recorded in the summary ring.
+ */
+void ss_run_accumulate(uint32_t interval, ss_exec_fn exec)
+{
+    uint32_t execs = 0;
+    uint32_t faults = 0;
+
+    if (interval < 1)
+        interval = 1;
+
+    while (1)
+    {
+        ss_wdt_kick();
+
+        if (ss_rx_pending() > 0)
+        {
+            // Fetch/stop request (or a decode error - stop either way,
+            // the host resynchronizes from the final summary)
+            uint8_t cmd;
+            uint8_t *data;
+            size_t data_len;
+            readpacket(&cmd, &data, &data_len);
+            ss_accum_send_summary(&execs, &faults);
+            return;
+        }
+
+        int fault = 0;
+        uint32_t value = exec(&fault);
+        if (fault)
+        {
+            ss_accum_ring[faults % SS_ACCUM_RING_SIZE] = value;
+            faults++;
+        }
+        execs++;
+
+        if (execs >= interval)
+            ss_accum_send_summary(&execs, &faults);
+    }
+}
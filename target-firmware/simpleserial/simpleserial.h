@@ -6,8 +6,30 @@
 
 #define FRAME_BYTE 0x00
 
+// Framing modes negotiated via the 'F' control packet. The firmware
+// always boots in COBS framing and a reset drops back to it; the
+// length-prefixed v2 framing [cmd, len16 LE, payload, crc] avoids COBS
+// en/decode and terminator scans on both ends.
+#define SS_FRAMING_COBS  0
+#define SS_FRAMING_LEN16 1
+
+// Size of the static RX/decode buffers used by readpacket().
+// Has to cover the largest host->target packet including COBS overhead
+// and terminator. Larger payloads must use the malloc-based read API.
+#ifndef SS_STATIC_RX_BUF_SIZE
+#define SS_STATIC_RX_BUF_SIZE 128
+#endif
+
+
+// Integrity modes negotiated via the 'C' control packet. The firmware
+// always boots with the 8-bit 0x4D CRC and a reset drops back to it;
+// CRC-32 (IEEE, zlib-compatible) replaces the 1 trailing CRC byte with
+// 4 (little endian) in both framings.
+#define SS_CRC_MODE_CRC8  0
+#define SS_CRC_MODE_CRC32 1
 
 uint8_t calc_crc(const uint8_t *buf, size_t len);
+uint32_t calc_crc32(const uint8_t *buf, size_t len);
 
 /* ---------------- COBS ---------------- */
 size_t get_max_encode_len(size_t input_len);
@@ -17,8 +39,54 @@ size_t cobs_unstuff_data(const uint8_t *buf, size_t len, uint8_t *out);
 
 uint8_t *read_until_sequence(const uint8_t *seq, size_t seq_len, size_t *out_len);
 uint8_t *read_until_terminator(size_t *len);
+int read_until_terminator_static(uint8_t *buf, size_t buf_size, size_t *len);
+
+// Size of the static input buffer used by the 'k' codec benchmark
+// control packet (utils/bench_codec.py); larger inputs are rejected.
+#ifndef SS_CODEC_BENCH_BUF_SIZE
+#define SS_CODEC_BENCH_BUF_SIZE 512
+#endif
+
+// Size of the TX snapshot buffer used by sendpacket_buffered()
+// (sequence tag + largest payload the payloads transmit).
+#ifndef SS_TX_SNAPSHOT_BUF_SIZE
+#define SS_TX_SNAPSHOT_BUF_SIZE 128
+#endif
+
+void ss_init(void);
+
+// Current DWT cycle counter value, starting the counter on first use.
+// Free-running u32 at core clock; callers work with differences, so
+// wraparound (every ~9 min at 7.37 MHz) is harmless for loop-scale spans.
+uint32_t ss_cycles(void);
+
+// Reprogram the FLASH ACR ART-accelerator bits (flags: bit0 prefetch,
+// bit1 instruction cache, bit2 data cache); both caches are reset in
+// the process so a re-enable never serves stale lines.
+void ss_configure_art(uint32_t flags);
+
+// SRAM-resident payload builds (-DSS_RAM_PAYLOAD, see build/Makefile):
+// functions marked SS_RAM_FUNC land in a .data subsection, so the
+// startup data-copy loop places them in SRAM and the trigger-wrapped
+// window executes without flash/ART prefetch timing nondeterminism.
+// long_call because SRAM is outside branch range from flash callers.
+#ifdef SS_RAM_PAYLOAD
+#define SS_RAM_FUNC __attribute__((section(".data.ramfunc"), noinline, long_call))
+#else
+#define SS_RAM_FUNC
+#endif
+
+// Fast-boot builds (-DSS_FAST_BOOT, see build/Makefile) replace the HAL's
+// platform_init()/init_uart() with a minimal register-level bring-up
+// (hal/stm32f4-uart.h) and report boot time in an extended reset packet.
+#ifdef SS_FAST_BOOT
+void fast_boot_init(void);
+#define platform_init() fast_boot_init()
+#define init_uart()     ((void)0)
+#endif
 
 int sendpacket(uint8_t cmd, const uint8_t *data, size_t data_len);
+int sendpacket_buffered(uint8_t cmd, uint8_t seq, const uint8_t *data, size_t data_len);
 void send_reset_sequence();
 void send_str(const char* in);
 void send_ack(uint8_t command);
@@ -26,4 +94,82 @@ int wait_ack(uint8_t cmd);
 
 int readpacket(uint8_t *cmd, uint8_t **data, size_t *data_len);
 
+int ss_handle_control_packet(uint8_t cmd, const uint8_t *data, size_t data_len);
+
+// Nonzero once the 'a' control packet enabled merged-ack mode; payload
+// main loops then skip the per-start send_ack() and the response packet
+// itself acknowledges the start. Cleared by reset.
+int ss_merged_ack_enabled(void);
+
+// Number of received bytes available without blocking (at most 1 can be
+// reported on non-DMA builds, see the definition).
+size_t ss_rx_pending(void);
+
+// Ring capacity for faulty counter values within one accumulate
+// summary interval; older faults are overwritten once exceeded.
+#ifndef SS_ACCUM_RING_SIZE
+#define SS_ACCUM_RING_SIZE 16
+#endif
+
+// One trigger-wrapped execution for the accumulate engine: sets *fault
+// nonzero on a fault and returns the counter value for the summary ring.
+typedef uint32_t (*ss_exec_fn)(int *fault);
+
+// Accumulate mode ('A' command): run exec back-to-back, count outcomes
+// on-target and send one 'A' summary packet per `interval` executions;
+// any received packet ends the run with a final partial summary.
+void ss_run_accumulate(uint32_t interval, ss_exec_fn exec);
+
+// GPIO result builds (-DSS_RESULT_GPIO, see build/Makefile): payloads
+// report the nofault common case by raising the result line PA11 (IO3
+// on the CW308 header, same pin the boot-ready signal uses) instead of
+// sending an 'e' packet; the line is lowered when a start command is
+// accepted, and only fault details still travel over serial. The host
+// polls the line through the scope IO state (gpio_result_mode). The
+// macros expand to inline_gpio_* calls, so payloads using them must
+// include hal/stm32f4-hal.h.
+#ifdef SS_RESULT_GPIO
+#define ss_result_gpio_setup() inline_gpio_mode_setup(GPIOA, GPIO_MODE_OUTPUT, GPIO_PUPD_PULLDOWN, GPIO11)
+#define ss_result_gpio_clear() inline_gpio_clear(GPIOA, GPIO11)
+#define ss_result_gpio_set()   inline_gpio_set(GPIOA, GPIO11)
+#else
+#define ss_result_gpio_setup() ((void)0)
+#define ss_result_gpio_clear() ((void)0)
+#define ss_result_gpio_set()   ((void)0)
+#endif
+
+// Pulse-train attribution builds (-DSS_PULSE_TAG, see build/Makefile):
+// the generator's per-pulse sync output, wired to the tag input (PA8
+// by default), latches a DWT snapshot per rising edge into a small RAM
+// array via EXTI (hal/stm32f4-exti.h). Payloads arm the capture at
+// trigger raise and append the per-slot snapshots to their response
+// packet, so a multi-pulse train's slots are individually placeable
+// within the glitch window. Without the flag everything compiles away.
+#ifdef SS_PULSE_TAG
+// Slot capacity per execution; edges beyond it are counted but not
+// timestamped. Payloads size their response appendix with this, so it
+// lives here rather than in the EXTI header only simpleserial.c sees.
+#ifndef SS_PULSE_TAG_SLOTS
+#define SS_PULSE_TAG_SLOTS 16
+#endif
+void ss_pulse_tag_setup(void);
+void ss_pulse_tag_arm(void);
+size_t ss_pulse_tag_read(const volatile uint32_t **slots);
+#else
+#define ss_pulse_tag_setup() ((void)0)
+#define ss_pulse_tag_arm()   ((void)0)
+#endif
+
+// Watchdog builds (-DSS_WATCHDOG, see build/Makefile) arm the IWDG in
+// ss_init() so a glitch that corrupts control flow self-resets the target
+// within SS_WATCHDOG_MS instead of waiting out the host's dead_timeout.
+// Payload main loops call ss_wdt_kick() once per command iteration; it
+// compiles away entirely without the flag.
+#ifdef SS_WATCHDOG
+#include "../hal/stm32f4-iwdg.h"
+#define ss_wdt_kick() iwdg_kick()
+#else
+#define ss_wdt_kick() ((void)0)
+#endif
+
 #endif // TARGET_SIMPLESERIAL_H
@@ -1,5 +1,6 @@
 import os
 import sys
+import time
 from .config_classes import GlitchConfig, TargetConfig, SimpleSerialPacket
 from .profile_target import CSProfiler
 import ctypes
@@ -42,10 +43,100 @@ def get_raster_positions(origin, dim_x, dim_y, stepsize_x, stepsize_y):
     return positions
 
 
+# ---------------------------------------------------------------------------- #
+#                         Performance regression gates                          #
+# ---------------------------------------------------------------------------- #
+# Timed scenarios against the simulated target (no hardware needed), run
+# with --perf-gate. Budgets are the stored baselines; a run fails when
+# the measured mean exceeds budget * (1 + tolerance), so a change that
+# reintroduces per-packet allocations or O(n) dispatch fails here
+# instead of silently costing campaign throughput. Re-baseline budgets
+# deliberately, in their own commit.
+PERF_BUDGETS = {
+    # Mean decode cost per pre-queued 16-byte packet through
+    # TargetSerial.read_packet (data already in the RX ring)
+    "read_packet_us": {"budget": 120.0, "tolerance": 0.5},
+    # Mean wall time per simulated execution through the full
+    # test_position loop (zero simulated latencies; the floor is the
+    # host-side polling and bookkeeping)
+    "execution_ms": {"budget": 4.0, "tolerance": 0.5},
+}
+
+
+def perf_read_packet(num_packets=1000):
+    """Mean read_packet cost in us with the packets already received."""
+    from simpleserial.simpleserial import TargetSerial
+    from simpleserial.simpleserial_readers.sim import (
+        SimpleSerial_SimulatedTarget, SimTargetConfig,
+    )
+
+    config = SimTargetConfig(ack_latency_s=0, exec_latency_s=0,
+                             boot_latency_s=0, latency_jitter=0, seed=0)
+    target_serial = TargetSerial(SimpleSerial_SimulatedTarget, config)
+    payload = bytes(range(16))
+    for _ in range(num_packets):
+        target_serial.ser._queue(
+            target_serial.ser._encode_packet(ord('f'), payload), 0)
+    time.sleep(0.3)  # let the reader thread drain into the RX ring
+
+    start = time.perf_counter()
+    for _ in range(num_packets):
+        cmd, data = target_serial.read_packet(timeout=250)
+        if cmd != ord('f') or data != payload:
+            raise AssertionError("perf_read_packet: corrupted packet")
+    elapsed = time.perf_counter() - start
+    target_serial.close()
+    return elapsed / num_packets * 1e6
+
+
+def perf_test_position(num_executions=10000):
+    """Mean wall time in ms per execution through test_position,
+    measured over a full simulated campaign."""
+    from .sim_target import run_simulated_campaign
+    from simpleserial.simpleserial_readers.sim import SimTargetConfig
+
+    # Deterministic and crash-free: crashes cost a reset roundtrip and
+    # would dominate the mean with hardware-sized timeouts
+    config = SimTargetConfig(fault_probability=0.05, reset_probability=0,
+                             crash_probability=0, ack_latency_s=0,
+                             exec_latency_s=0, boot_latency_s=0,
+                             latency_jitter=0, seed=0)
+    positions = max(1, num_executions // 100)
+    start = time.perf_counter()
+    run_simulated_campaign(num_positions=positions, num_executions=100,
+                           sim_config=config)
+    elapsed = time.perf_counter() - start
+    return elapsed / (positions * 100) * 1000.0
+
+
+def run_perf_gate(quick=False):
+    """Run all timed scenarios against their budgets; returns the exit
+    code (0 = all within tolerance)."""
+    scale = 10 if quick else 1
+    measured = {
+        "read_packet_us": perf_read_packet(1000 // scale),
+        "execution_ms": perf_test_position(10000 // scale),
+    }
+
+    failed = False
+    for name, value in measured.items():
+        entry = PERF_BUDGETS[name]
+        limit = entry["budget"] * (1 + entry["tolerance"])
+        status = "ok" if value <= limit else "FAIL"
+        failed |= value > limit
+        print(f"{name:<16} {value:10.2f}  budget {entry['budget']:g} "
+              f"(limit {limit:g})  {status}")
+    return 1 if failed else 0
+
+
 def main():
     # ---------------------------------------------------------------------------- #
     #                             Commandline Arguments                            #
     # ---------------------------------------------------------------------------- #
+    # Run the simulated performance regression gates instead of a campaign
+    if "--perf-gate" in sys.argv:
+        sys.exit(run_perf_gate(quick="--quick" in sys.argv))
+
     build = False
     flash = False
     home = False
@@ -0,0 +1,117 @@
+"""
+Per-phase timing instrumentation for the execution pipeline.
+
+Every shot spends time in arming, charge waits, serial roundtrips,
+handlers and bookkeeping; every campaign additionally pays table travel.
+PhaseTimer accumulates monotonic phase durations into fixed log-spaced
+histograms so the breakdown is available at any campaign size: record()
+is one bisect plus integer increments on prebuilt lists - no locks (the
+increments are single bytecode operations under the GIL), no allocation
+on the hot path.
+
+CSProfiler keeps one instance as self.timing, dumps summary() into the
+results JSON and prints summary_table() at campaign end.
+"""
+
+import time
+from bisect import bisect_left
+from contextlib import contextmanager
+
+# Histogram bin upper edges in seconds: 10us .. ~84s in factor-2 steps,
+# plus one implicit overflow bin
+BIN_EDGES = tuple(1e-5 * 2 ** i for i in range(24))
+
+
+class PhaseTimer:
+    def __init__(self):
+        self._phases = {}
+
+    def _phase(self, name):
+        phase = self._phases.get(name)
+        if phase is None:
+            phase = self._phases[name] = {
+                "counts": [0] * (len(BIN_EDGES) + 1),
+                "total_s": 0.0,
+                "samples": 0,
+                "min_s": float("inf"),
+                "max_s": 0.0,
+            }
+        return phase
+
+    def record(self, name, seconds):
+        """Book one phase duration (seconds)."""
+        phase = self._phase(name)
+        phase["counts"][bisect_left(BIN_EDGES, seconds)] += 1
+        phase["total_s"] += seconds
+        phase["samples"] += 1
+        if seconds < phase["min_s"]:
+            phase["min_s"] = seconds
+        if seconds > phase["max_s"]:
+            phase["max_s"] = seconds
+
+    @contextmanager
+    def phase(self, name):
+        """Time a with-block as one sample of `name`. Records on every
+        exit path (return/raise included), so instrumented blocks keep
+        their original control flow."""
+        start = time.monotonic()
+        try:
+            yield
+        finally:
+            self.record(name, time.monotonic() - start)
+
+    @staticmethod
+    def _percentile(phase, quantile):
+        """Upper bin edge at the given quantile (histogram estimate)."""
+        target = phase["samples"] * quantile
+        cumulative = 0
+        for index, count in enumerate(phase["counts"]):
+            cumulative += count
+            if cumulative >= target:
+                return BIN_EDGES[min(index, len(BIN_EDGES) - 1)]
+        return phase["max_s"]
+
+    def summary(self):
+        """JSON-serializable per-phase summary (times in ms, percentiles
+        are histogram upper-edge estimates); empty bins are omitted."""
+        out = {}
+        for name, phase in sorted(self._phases.items()):
+            if not phase["samples"]:
+                continue
+            histogram = {
+                f"<={edge * 1000:g}ms": count
+                for edge, count in zip(BIN_EDGES, phase["counts"])
+                if count
+            }
+            if phase["counts"][-1]:
+                histogram[f">{BIN_EDGES[-1] * 1000:g}ms"] = phase["counts"][-1]
+            out[name] = {
+                "samples": phase["samples"],
+                "total_s": round(phase["total_s"], 3),
+                "mean_ms": round(phase["total_s"] / phase["samples"] * 1000.0, 3),
+                "min_ms": round(phase["min_s"] * 1000.0, 3),
+                "p50_ms": round(self._percentile(phase, 0.50) * 1000.0, 3),
+                "p90_ms": round(self._percentile(phase, 0.90) * 1000.0, 3),
+                "p99_ms": round(self._percentile(phase, 0.99) * 1000.0, 3),
+                "max_ms": round(phase["max_s"] * 1000.0, 3),
+                "histogram": histogram,
+            }
+        return out
+
+    def summary_table(self):
+        """Printable breakdown, phases sorted by total time spent."""
+        summary = self.summary()
+        if not summary:
+            return "(no phase timings recorded)"
+        lines = [
+            f"{'phase':<16}{'samples':>9}{'total s':>10}{'mean ms':>10}"
+            f"{'p50 ms':>9}{'p99 ms':>9}{'max ms':>10}"
+        ]
+        for name in sorted(summary, key=lambda key: -summary[key]["total_s"]):
+            entry = summary[name]
+            lines.append(
+                f"{name:<16}{entry['samples']:>9}{entry['total_s']:>10}"
+                f"{entry['mean_ms']:>10}{entry['p50_ms']:>9}{entry['p99_ms']:>9}"
+                f"{entry['max_ms']:>10}"
+            )
+        return "\n".join(lines)
@@ -0,0 +1,416 @@
+"""
+Streaming power-trace capture alongside fault injection.
+
+configure_scope set up single captures, but nothing in the execution
+loop recorded them - correlating faults with power signatures meant a
+separate bench pass. TraceCapture records one trace per execution into
+a flat binary sidecar without stalling the shot loop: the loop only
+arms the scope, while pulling the ADC samples over USB and writing them
+to disk happens on a collector thread that overlaps the next shot's
+non-scope legs (charge wait, arm, start packet). The CW-Lite ADC has a
+single sample bank - true segmented capture across N executions is a
+Husky feature - so the only synchronization point is re-arming, which
+waits for the collector to drain the previous capture. On segmented
+scopes, defer_readback batches window captures in the segment buffer
+and pulls them between positions instead (position_done), removing
+even the per-shot pull.
+
+Record format (fixed size, little endian, also documented in the
+results JSON header):
+
+    u32 position_index, u32 config_index, u32 execution_index,
+    u32 sample_count, float32[sample_count] samples
+
+By default records go through a chunked compressed container rather
+than raw to disk - week-long campaigns would otherwise swamp the bench
+machine's SSD with slowly-varying 10-bit samples stored as float32.
+Chunks of CHUNK_RECORDS records are XOR-delta-transformed on their
+32-bit words (the float deltas of a slowly varying trace zero out most
+high bytes) and deflated at the fastest zlib level, each framed with
+its own header so a crashed campaign's file remains readable; close()
+appends a chunk index footer for random access (chunk_index() rebuilds
+it from the frames when the footer never got written). read_traces()
+iterates either format back for analysis.
+"""
+
+import os
+import queue
+import struct
+import threading
+import zlib
+
+import numpy as np
+
+RECORD_HEADER = struct.Struct("<IIII")
+
+# Chunked compressed container layout: file header, framed chunks, then
+# an index footer written on close. All little endian.
+CONTAINER_MAGIC = b"CSTZ"
+_CONTAINER_HEADER = struct.Struct("<4sHH")   # magic, version, chunk_records
+_CHUNK_FRAME = struct.Struct("<4sIII")       # b"CHNK", comp_len, raw_len, records
+_INDEX_ENTRY = struct.Struct("<QIII")        # file offset of frame, comp_len, raw_len, records
+_INDEX_FOOTER = struct.Struct("<4sQI")       # b"CIDX", index offset, entry count
+CONTAINER_VERSION = 1
+
+# Records per compressed chunk: large enough for the delta transform
+# and deflate to see repeated structure, small enough that random
+# access to one trace decompresses well under a megabyte
+CHUNK_RECORDS = 16
+
+
+def _delta_encode(raw):
+    """XOR each 32-bit word with its predecessor (record sizes are
+    4-byte multiples, so the buffer always divides evenly)."""
+    words = np.frombuffer(raw, dtype="<u4")
+    encoded = np.empty_like(words)
+    encoded[0] = words[0]
+    encoded[1:] = words[1:] ^ words[:-1]
+    return encoded.tobytes()
+
+
+def _delta_decode(raw):
+    words = np.frombuffer(raw, dtype="<u4")
+    return np.bitwise_xor.accumulate(words).astype("<u4").tobytes()
+
+
+class ChunkedTraceWriter:
+    """Write side of the compressed container; records are buffered and
+    flushed a chunk at a time so the compression cost stays a single
+    cheap zlib call per CHUNK_RECORDS traces."""
+
+    def __init__(self, path, chunk_records=CHUNK_RECORDS):
+        self.chunk_records = chunk_records
+        self._file = open(path, "wb")
+        self._file.write(_CONTAINER_HEADER.pack(
+            CONTAINER_MAGIC, CONTAINER_VERSION, chunk_records))
+        self._pending = []
+        self._index = []
+
+    def append(self, record):
+        self._pending.append(record)
+        if len(self._pending) >= self.chunk_records:
+            self._flush_chunk()
+
+    def _flush_chunk(self):
+        if not self._pending:
+            return
+        raw = b"".join(self._pending)
+        compressed = zlib.compress(_delta_encode(raw), 1)
+        self._index.append(
+            (self._file.tell(), len(compressed), len(raw), len(self._pending))
+        )
+        self._file.write(_CHUNK_FRAME.pack(
+            b"CHNK", len(compressed), len(raw), len(self._pending)))
+        self._file.write(compressed)
+        self._pending = []
+
+    def close(self):
+        self._flush_chunk()
+        index_offset = self._file.tell()
+        for entry in self._index:
+            self._file.write(_INDEX_ENTRY.pack(*entry))
+        self._file.write(_INDEX_FOOTER.pack(
+            b"CIDX", index_offset, len(self._index)))
+        self._file.close()
+
+
+def is_container(path):
+    """Whether a sidecar uses the compressed container (raw files start
+    with a record header instead of the magic)."""
+    with open(path, "rb") as f:
+        return f.read(4) == CONTAINER_MAGIC
+
+
+def chunk_index(path):
+    """
+    The container's chunk index as a list of (frame_offset, comp_len,
+    raw_len, record_count). Read from the footer when close() wrote
+    one; rebuilt by walking the chunk frames otherwise (a campaign that
+    crashed mid-capture loses only the index, never the chunks).
+    """
+    with open(path, "rb") as f:
+        size = os.fstat(f.fileno()).st_size
+        if size >= _CONTAINER_HEADER.size + _INDEX_FOOTER.size:
+            f.seek(size - _INDEX_FOOTER.size)
+            magic, index_offset, count = _INDEX_FOOTER.unpack(
+                f.read(_INDEX_FOOTER.size))
+            if magic == b"CIDX":
+                f.seek(index_offset)
+                return [
+                    _INDEX_ENTRY.unpack(f.read(_INDEX_ENTRY.size))
+                    for _ in range(count)
+                ]
+        # No footer: rebuild from the frames
+        index = []
+        offset = _CONTAINER_HEADER.size
+        while offset + _CHUNK_FRAME.size <= size:
+            f.seek(offset)
+            magic, comp_len, raw_len, records = _CHUNK_FRAME.unpack(
+                f.read(_CHUNK_FRAME.size))
+            if magic != b"CHNK" or offset + _CHUNK_FRAME.size + comp_len > size:
+                break  # truncated final chunk from a crash
+            index.append((offset, comp_len, raw_len, records))
+            offset += _CHUNK_FRAME.size + comp_len
+        return index
+
+
+def read_chunk(path, entry):
+    """Decompress one indexed chunk back to raw record bytes."""
+    offset, comp_len, raw_len, _ = entry
+    with open(path, "rb") as f:
+        f.seek(offset + _CHUNK_FRAME.size)
+        raw = _delta_decode(zlib.decompress(f.read(comp_len)))
+    if len(raw) != raw_len:
+        raise ValueError(f"{path}: chunk at {offset} decompressed to "
+                         f"{len(raw)} bytes, expected {raw_len}")
+    return raw
+
+
+def decompress_to(path, raw_path):
+    """Expand a container into a flat raw sidecar (the analysis module
+    materializes one to keep its memory-mapped vectorized path)."""
+    with open(raw_path, "wb") as out:
+        for entry in chunk_index(path):
+            out.write(read_chunk(path, entry))
+
+# Named capture profiles (see CSProfiler.enable_trace_capture). USB time
+# per capture scales with the sample count, so anything but "full" is
+# about making capture-per-shot cheap: "overview" trades resolution for
+# a long decimated view of the whole execution, "window" (derived per
+# campaign by window_profile) moves only the injection window.
+CAPTURE_PROFILES = {
+    "full": {"samples": 24400, "offset": 25000, "decimate": 1},
+    "overview": {"samples": 3050, "offset": 0, "decimate": 8},
+    "window": None,  # computed from the campaign's pulse timing
+}
+
+
+def window_profile(sample_rate_hz, glitch_configs, margin=0.25,
+                   min_samples=256, max_samples=24400,
+                   pulse_triggered=False):
+    """
+    Capture settings covering just the injection window: from the
+    earliest pulse_offset to the end of the longest pulse train across
+    the campaign's configs, padded by `margin` on both sides. Uses the
+    scope-measured pulse width (osc_measured_pulse_width, filled by the
+    automatic first-execution measurement) when available, the
+    configured width otherwise. All pulse timing is in ns.
+
+    With pulse_triggered (the scope triggers from the pulse-generator
+    output itself, see CSProfiler.route_capture_trigger) the capture
+    starts at the injection instant, so pulse_offset drops out of the
+    computation entirely: offset is exactly zero and the window covers
+    just the pulse train - typically a few hundred samples.
+    """
+    starts = []
+    ends = []
+    for config in glitch_configs:
+        width = config.osc_measured_pulse_width or config.pulse_width
+        repeats = max(1, config.pulse_repeats)
+        train = repeats * width + (repeats - 1) * config.pulse_spacing
+        starts.append(0 if pulse_triggered else config.pulse_offset)
+        ends.append(starts[-1] + train)
+    span = max(ends) - min(starts)
+    pad = span * margin
+    start_s = max(0.0, min(starts) - pad) * 1e-9
+    length_s = (span + 2 * pad) * 1e-9
+    samples = max(min_samples, int(length_s * sample_rate_hz) + 1)
+    return {
+        # Clamped to the CW-Lite buffer; a window wider than that is
+        # no worse than the "full" profile it degenerates into
+        "samples": min(samples, max_samples),
+        "offset": int(start_s * sample_rate_hz),
+        "decimate": 1,
+    }
+
+
+class TraceCapture:
+    def __init__(self, scope, path, samples=24400, offset=25000, decimate=1,
+                 compress=True, configure=None, defer_readback=False):
+        self.scope = scope
+        self.path = path
+        self.samples = samples
+        if configure is not None:
+            # Cached delta-writing setup (CWUtils.configure_scope), so a
+            # capture-profile switch costs only the changed parameters
+            configure(samples=samples, offset=offset, decimate=decimate)
+        else:
+            scope.adc.samples = samples
+            scope.adc.offset = offset
+            scope.adc.decimate = decimate
+
+        # Deferred readback: segmented scopes (Husky; the CW-Lite has
+        # no adc.segments) accumulate a batch of window captures in the
+        # sample buffer with a single arm, and the whole batch is
+        # pulled between positions instead of per shot. Only worthwhile
+        # when several windows fit the buffer.
+        batch_limit = max(1, 24573 // samples)
+        self.deferred = (bool(defer_readback)
+                         and hasattr(scope.adc, "segments")
+                         and batch_limit > 1)
+        self._batch_limit = batch_limit if self.deferred else 1
+        if self.deferred:
+            scope.adc.segments = self._batch_limit
+        self._batch_tags = []
+        self._batch_armed = False
+
+        if compress:
+            self._writer = ChunkedTraceWriter(path)
+        else:
+            self._writer = _RawTraceWriter(path)
+        self._tag = None
+        self._jobs = queue.Queue()
+        self.records_written = 0
+        self.captures_failed = 0
+        self._thread = threading.Thread(target=self._collector_loop,
+                                        name="trace-capture", daemon=True)
+        self._thread.start()
+
+    def arm(self, position_index, config_index, execution_index):
+        """Arm the scope for the coming execution, tagged for the record
+        header. Blocks until the collector drained the previous capture
+        (the single ADC bank makes this the one point the shot loop can
+        wait on the capture path). In deferred mode only the first shot
+        of a batch arms - the following triggers land in further
+        segments with no host work at all."""
+        self._tag = (position_index, config_index, execution_index)
+        if self.deferred:
+            if not self._batch_armed:
+                self._jobs.join()
+                self.scope.arm()
+                self._batch_armed = True
+            return
+        self._jobs.join()
+        self.scope.arm()
+
+    def collect(self):
+        """Hand the armed capture to the collector thread and return
+        immediately; the USB pull and disk write overlap the next
+        shot. Deferred batches stay on the scope until full (or until
+        position_done)."""
+        if self._tag is None:
+            return
+        if self.deferred:
+            self._batch_tags.append(self._tag)
+            self._tag = None
+            if len(self._batch_tags) >= self._batch_limit:
+                self._jobs.put(("batch", self._batch_tags))
+                self._batch_tags = []
+                self._batch_armed = False
+            return
+        self._jobs.put(self._tag)
+        self._tag = None
+
+    def position_done(self):
+        """Flush a partly filled deferred batch; called when the scan
+        leaves a position, so the batch pull overlaps the table move.
+        The scope waits out its capture timeout for the segments that
+        never came - that cost sits on the collector thread, not the
+        shot loop. No-op in per-shot mode."""
+        if self.deferred and self._batch_tags:
+            self._jobs.put(("batch", self._batch_tags))
+            self._batch_tags = []
+            self._batch_armed = False
+
+    def _collector_loop(self):
+        while True:
+            job = self._jobs.get()
+            try:
+                if job is None:
+                    return
+                if job[0] == "batch":
+                    self._pull_batch(job[1])
+                else:
+                    self._pull(job)
+            except Exception:
+                self.captures_failed += 1
+            finally:
+                self._jobs.task_done()
+
+    def _pull(self, tag):
+        if self.scope.capture():
+            # True means the trigger never came (crashed target, glitch
+            # into the reset path): no trace to record
+            self.captures_failed += 1
+            return
+        trace = np.asarray(self.scope.get_last_trace(), dtype="<f4")
+        self._writer.append(
+            RECORD_HEADER.pack(*tag, len(trace)) + trace.tobytes())
+        self.records_written += 1
+
+    def _pull_batch(self, tags):
+        """Read a whole segment batch in one USB transfer and slice it
+        into per-execution records. A partial batch (early stop, crash
+        retries) times the capture out; whatever segments the scope
+        holds are salvaged, the rest book as failed captures."""
+        self.scope.capture()
+        trace = np.asarray(self.scope.get_last_trace(), dtype="<f4")
+        available = len(trace) // self.samples
+        written = min(available, len(tags))
+        for index in range(written):
+            segment = trace[index * self.samples:(index + 1) * self.samples]
+            self._writer.append(
+                RECORD_HEADER.pack(*tags[index], self.samples)
+                + segment.tobytes())
+        self.records_written += written
+        self.captures_failed += len(tags) - written
+
+    def close(self):
+        """Drain pending pulls, stop the collector, close the file."""
+        self.position_done()
+        self._jobs.join()
+        self._jobs.put(None)
+        self._thread.join()
+        try:
+            self._writer.close()
+        except OSError:
+            pass
+
+
+class _RawTraceWriter:
+    """Flat uncompressed sidecar, kept for compress=False and as the
+    format the analysis module memory-maps."""
+
+    def __init__(self, path):
+        self._file = open(path, "wb")
+
+    def append(self, record):
+        self._file.write(record)
+
+    def close(self):
+        self._file.close()
+
+
+def _iter_record_bytes(path):
+    """Raw record bytes of either sidecar format, in file order."""
+    if is_container(path):
+        for entry in chunk_index(path):
+            yield read_chunk(path, entry)
+        return
+    with open(path, "rb") as f:
+        while True:
+            block = f.read(1 << 20)
+            if not block:
+                return
+            yield block
+
+
+def read_traces(path):
+    """Iterate (position_index, config_index, execution_index, trace)
+    from a sidecar file (either format); traces come back as float32
+    arrays."""
+    pending = b""
+    for block in _iter_record_bytes(path):
+        pending += block
+        offset = 0
+        while offset + RECORD_HEADER.size <= len(pending):
+            position_index, config_index, execution_index, count = \
+                RECORD_HEADER.unpack_from(pending, offset)
+            end = offset + RECORD_HEADER.size + count * 4
+            if end > len(pending):
+                break
+            trace = np.frombuffer(
+                pending[offset + RECORD_HEADER.size:end], dtype="<f4")
+            yield position_index, config_index, execution_index, trace
+            offset = end
+        pending = pending[offset:]
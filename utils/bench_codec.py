@@ -0,0 +1,184 @@
+"""
+Codec benchmark suite: COBS + CRC, host and target.
+
+Exercises TargetSerial._cobs_stuff_data/_cobs_unstuff_data/_calc_crc in
+both implementations (pure Python and the _codec C extension when
+built) across payload sizes and frame-byte densities - density drives
+the COBS block-splitting worst case, so a codec change can look fine on
+random data and still regress the all-zeros path. With --target the 'k'
+control packet additionally times the firmware's cobs_stuff_data/
+calc_crc in DWT cycles on real hardware.
+
+Run from the repo root:
+
+    python3 -m utils.bench_codec [--target] [--json out.json]
+
+Results always go to JSON (bench_codec.json by default) so codec
+regressions are diffable between revisions; a summary table is printed.
+"""
+
+import json
+import sys
+import time
+from contextlib import contextmanager
+
+import simpleserial.simpleserial as ss_mod
+from simpleserial.simpleserial import TargetSerial
+
+PAYLOAD_SIZES = (16, 64, 254, 1024, 4096)
+TARGET_PAYLOAD_SIZES = (16, 64, 254, 512)  # capped by SS_CODEC_BENCH_BUF_SIZE
+
+# Frame-byte (0x00) densities: none is the COBS fast path, all is the
+# worst case (every input byte closes a one-byte block)
+DENSITIES = ("none", "sparse", "half", "all")
+
+TARGET_CPU_HZ = 7372800
+TARGET_ITERATIONS = 16
+
+
+def make_payload(size, density):
+    """Deterministic payload of the given size and frame-byte density."""
+    out = bytearray(size)
+    for i in range(size):
+        if density == "all":
+            out[i] = 0
+        elif density == "half" and i % 2:
+            out[i] = 0
+        elif density == "sparse" and i % 64 == 0:
+            out[i] = 0
+        else:
+            out[i] = i * 37 % 255 + 1  # never a frame byte
+    return bytes(out)
+
+
+@contextmanager
+def pure_python_codec():
+    """Force the pure-Python implementations regardless of whether the
+    _codec extension is built."""
+    saved = ss_mod._codec
+    ss_mod._codec = None
+    try:
+        yield
+    finally:
+        ss_mod._codec = saved
+
+
+def _time_op(func, arg, iterations):
+    start = time.perf_counter()
+    for _ in range(iterations):
+        func(arg)
+    return (time.perf_counter() - start) / iterations
+
+
+def bench_host_case(size, density):
+    """Benchmark all three codec functions on one payload; returns one
+    row per (implementation, function)."""
+    payload = make_payload(size, density)
+    iterations = max(8, 200_000 // size)
+
+    implementations = [("python", pure_python_codec)]
+    if ss_mod._codec is not None:
+        implementations.append(("c", None))
+
+    rows = []
+    reference = None
+    for impl_name, force in implementations:
+        context = force() if force else _null_context()
+        with context:
+            encoded = TargetSerial._cobs_stuff_data(payload)
+            decoded = TargetSerial._cobs_unstuff_data(encoded)
+            crc = TargetSerial._calc_crc(payload)
+            # Both implementations must agree before their numbers do
+            if decoded != payload:
+                raise AssertionError(f"{impl_name}: COBS roundtrip failed "
+                                     f"(size={size}, density={density})")
+            if reference is None:
+                reference = (encoded, crc)
+            elif (encoded, crc) != reference:
+                raise AssertionError(f"{impl_name}: output mismatch vs python "
+                                     f"(size={size}, density={density})")
+
+            timings = {
+                "cobs_stuff": _time_op(TargetSerial._cobs_stuff_data, payload, iterations),
+                "cobs_unstuff": _time_op(TargetSerial._cobs_unstuff_data, encoded, iterations),
+                "calc_crc": _time_op(TargetSerial._calc_crc, payload, iterations),
+            }
+        for op, seconds in timings.items():
+            rows.append({
+                "impl": impl_name,
+                "op": op,
+                "payload_bytes": size,
+                "density": density,
+                "us_per_op": round(seconds * 1e6, 3),
+                "mb_per_s": round(size / seconds / 1e6, 2),
+            })
+    return rows
+
+
+@contextmanager
+def _null_context():
+    yield
+
+
+def bench_target(sizes=TARGET_PAYLOAD_SIZES, cpu_hz=TARGET_CPU_HZ):
+    """Drive the firmware 'k' control packet and return cycle-accurate
+    rows for the on-target codec."""
+    from CWUtils import ChipWhisperer
+    from simpleserial.simpleserial_readers.cwlite import SimpleSerial_ChipWhispererLite
+
+    cw = ChipWhisperer()
+    target_serial = TargetSerial(SimpleSerial_ChipWhispererLite, cw.scope)
+
+    rows = []
+    for size in sizes:
+        for pattern, density in enumerate(("none", "half", "all")):
+            request = size.to_bytes(2, 'little') + bytes([pattern, TARGET_ITERATIONS])
+            target_serial.send_packet('k', request)
+            cmd, data = target_serial.read_packet(timeout=1000)
+            if cmd != ord('k') or data is None or len(data) != 16:
+                raise RuntimeError(f"bench_codec: bad 'k' reply (cmd={cmd})")
+
+            for offset, op in ((0, "calc_crc"), (4, "cobs_stuff"), (8, "cobs_unstuff")):
+                cycles = int.from_bytes(data[offset:offset + 4], 'little') / TARGET_ITERATIONS
+                rows.append({
+                    "impl": "target",
+                    "op": op,
+                    "payload_bytes": size,
+                    "density": density,
+                    "cycles_per_op": round(cycles, 1),
+                    "us_per_op": round(cycles / cpu_hz * 1e6, 3),
+                    "cycles_per_byte": round(cycles / size, 2),
+                })
+    return rows
+
+
+def main():
+    args = sys.argv[1:]
+
+    rows = []
+    for size in PAYLOAD_SIZES:
+        for density in DENSITIES:
+            rows.extend(bench_host_case(size, density))
+
+    if "--target" in args:
+        rows.extend(bench_target())
+
+    print(f"{'impl':<8}{'op':<14}{'bytes':>7}{'density':>9}{'us/op':>10}{'MB/s':>9}")
+    for row in rows:
+        print(f"{row['impl']:<8}{row['op']:<14}{row['payload_bytes']:>7}"
+              f"{row['density']:>9}{row['us_per_op']:>10}"
+              f"{row.get('mb_per_s', ''):>9}")
+
+    out_path = "bench_codec.json"
+    if "--json" in args:
+        out_path = args[args.index("--json") + 1]
+    with open(out_path, "w") as f:
+        json.dump({
+            "accelerated_codec_built": ss_mod._codec is not None,
+            "rows": rows,
+        }, f, indent=4)
+    print(f"\nWrote {out_path}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,156 @@
+"""
+Reset latency profiler.
+
+A reset follows every fault, so its cost multiplies across a campaign,
+yet reset_target has only ever been tuned by feel: CWUtils.reset_target
+sleeps 2x200ms around the nrst pulse and the serial scan runs with a
+5000ms timeout. This tool repeats R resets and splits each one into its
+legs:
+
+  nrst hold      - the low period of the pulse (a parameter we choose)
+  boot           - release-of-nrst to announce-queued, from the 't'
+                   boot-report cycles of an SS_FAST_BOOT build
+  announce wire  - the reset sequence shifting out at the current baud
+  host detect    - the residual: USB transport plus read_until scanning
+
+and prints the distribution per leg, plus the timeout the data supports.
+The settle sleep after the pulse is run at 0 here - the announce scan
+itself is the settle - so boot time is measured, not slept through.
+
+Run from the repo root against a fast-boot payload:
+
+    python3 -m utils.bench_reset [-r N] [--hold-ms MS] [--json out.json]
+
+Without SS_FAST_BOOT firmware the boot/host split is unavailable and
+only pulse + detect totals are reported.
+"""
+
+import json
+import sys
+import time
+
+from CWUtils import ChipWhisperer
+from simpleserial.simpleserial import TargetSerial
+from simpleserial.simpleserial_readers.cwlite import SimpleSerial_ChipWhispererLite
+
+DEFAULT_RESETS = 30
+DEFAULT_HOLD_MS = 20.0
+SCAN_TIMEOUT_MS = 5000
+
+# Target core clock for converting boot-report cycles to time: 7.37MHz
+# external CLKIN (fast boot runs the core off HSE)
+TARGET_CPU_HZ = 7372800
+
+
+def _percentile(values, quantile):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * quantile))]
+
+
+def _read_boot_cycles(target_serial):
+    """Consume the 't' boot-report packet of a fast-boot build; None for
+    firmware that does not send one."""
+    try:
+        cmd, data = target_serial.read_packet(timeout=250)
+    except Exception:
+        return None
+    if cmd == TargetSerial.type_convert_cmd('t') and data and len(data) == 4:
+        return int.from_bytes(data, 'little')
+    return None
+
+
+def profile_reset(cw, target_serial, hold_s, cpu_hz):
+    """One instrumented reset; returns the per-leg record in ms (boot
+    and host legs None without a boot report)."""
+    reset_seq = target_serial._reset_sequence
+    target_serial.flush()
+
+    pulse_start = time.perf_counter()
+    cw.reset_target(hold_s=hold_s, settle_s=0.0)
+    released = time.perf_counter()
+
+    data = target_serial.read_until(reset_seq, SCAN_TIMEOUT_MS)
+    detected = time.perf_counter()
+    if not data.endswith(reset_seq):
+        raise RuntimeError("bench_reset: target did not announce a reset")
+
+    boot_cycles = _read_boot_cycles(target_serial)
+
+    record = {
+        "pulse_ms": (released - pulse_start) * 1000.0,
+        "detect_ms": (detected - released) * 1000.0,
+        "total_ms": (detected - pulse_start) * 1000.0,
+        "boot_ms": None,
+        "host_ms": None,
+    }
+    if boot_cycles is not None:
+        # 10 bits per byte on the wire (start + 8 data + stop)
+        wire_ms = len(reset_seq) * 10.0 / target_serial.baud * 1000.0
+        boot_ms = boot_cycles / cpu_hz * 1000.0
+        record["boot_ms"] = boot_ms
+        record["host_ms"] = record["detect_ms"] - boot_ms - wire_ms
+    return record
+
+
+def run_benchmark(resets=DEFAULT_RESETS, hold_ms=DEFAULT_HOLD_MS,
+                  cpu_hz=TARGET_CPU_HZ):
+    cw = ChipWhisperer()
+    target_serial = TargetSerial(SimpleSerial_ChipWhispererLite, cw.scope)
+
+    records = [profile_reset(cw, target_serial, hold_ms / 1000.0, cpu_hz)
+               for _ in range(resets)]
+
+    legs = ("pulse_ms", "boot_ms", "host_ms", "total_ms")
+    summary = {}
+    print(f"\n{resets} resets, {hold_ms}ms nrst hold, "
+          f"{target_serial.baud} baud")
+    print(f"{'leg':>10}{'p50 ms':>9}{'p90 ms':>9}{'max ms':>9}")
+    for leg in legs:
+        values = [r[leg] for r in records if r[leg] is not None]
+        if not values:
+            print(f"{leg[:-3]:>10}        - (no fast-boot report)")
+            continue
+        summary[leg] = {
+            "p50": round(_percentile(values, 0.50), 3),
+            "p90": round(_percentile(values, 0.90), 3),
+            "max": round(max(values), 3),
+        }
+        print(f"{leg[:-3]:>10}"
+              f"{summary[leg]['p50']:>9}"
+              f"{summary[leg]['p90']:>9}"
+              f"{summary[leg]['max']:>9}")
+
+    # The scan timeout only needs to cover the observed worst case with
+    # headroom; the settle sleep is covered by the scan and can be 0
+    suggested = max(r["total_ms"] for r in records) * 2.0
+    print(f"\nSuggested reset_target timeout: {suggested:.0f}ms "
+          f"(2x worst observed total, was {SCAN_TIMEOUT_MS}ms)")
+    return {"resets": resets, "hold_ms": hold_ms, "cpu_hz": cpu_hz,
+            "baud": target_serial.baud, "legs": summary,
+            "suggested_timeout_ms": round(suggested, 1),
+            "samples": records}
+
+
+def main():
+    args = sys.argv[1:]
+    resets = DEFAULT_RESETS
+    if "-r" in args:
+        resets = int(args[args.index("-r") + 1])
+    hold_ms = DEFAULT_HOLD_MS
+    if "--hold-ms" in args:
+        hold_ms = float(args[args.index("--hold-ms") + 1])
+    cpu_hz = TARGET_CPU_HZ
+    if "--cpu-hz" in args:
+        cpu_hz = int(args[args.index("--cpu-hz") + 1])
+
+    result = run_benchmark(resets, hold_ms, cpu_hz)
+
+    if "--json" in args:
+        out_path = args[args.index("--json") + 1]
+        with open(out_path, "w") as f:
+            json.dump(result, f, indent=4)
+        print(f"Wrote {out_path}")
+
+
+if __name__ == "__main__":
+    main()
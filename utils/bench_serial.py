@@ -0,0 +1,141 @@
+"""
+Serial roundtrip latency microbenchmark.
+
+The serial path spans cwlite.py, TargetSerial.read_until and the
+firmware's readpacket/sendpacket; a campaign only ever sees their sum.
+This tool fires K echo transactions ('e' control packet, handled by
+ss_handle_control_packet in any payload build) per packet size and baud
+rate and splits the roundtrip three ways:
+
+  host encode       - CRC + COBS stuffing, timed directly on the host
+  target turnaround - frame-received to response-queued, reported by the
+                      target in DWT cycles inside the echo reply
+  wire + transport  - the residual (UART shifting plus USB latency)
+
+Run from the repo root against a flashed payload:
+
+    python3 -m utils.bench_serial [-k N] [--json out.json]
+
+Expects the target to be up (reset it first if unsure); baud rates are
+negotiated in sequence and left at the last rate on exit.
+"""
+
+import json
+import sys
+import time
+
+from CWUtils import ChipWhisperer
+from simpleserial.simpleserial import TargetSerial
+from simpleserial.simpleserial_readers.cwlite import SimpleSerial_ChipWhispererLite
+
+PACKET_SIZES = (0, 4, 16, 48, 96)
+BAUD_RATES = (38400, 230400, 921600)
+DEFAULT_TRANSACTIONS = 200
+
+# Target core clock for converting DWT cycles to time: 7.37MHz external
+# CLKIN (both the HAL bring-up and fast boot run the core off HSE)
+TARGET_CPU_HZ = 7372800
+
+
+def _percentile(values, quantile):
+    ordered = sorted(values)
+    return ordered[min(len(ordered) - 1, int(len(ordered) * quantile))]
+
+
+def measure_encode(target_serial, payload, iterations=2000):
+    """Mean host-side encode time (CRC + COBS) in seconds; packets with
+    no payload skip encoding entirely."""
+    if not payload:
+        return 0.0
+    calc_crc = target_serial._calc_crc
+    cobs_stuff = target_serial._cobs_stuff_data
+    start = time.perf_counter()
+    for _ in range(iterations):
+        cobs_stuff(payload + bytes([calc_crc(payload)]))
+    return (time.perf_counter() - start) / iterations
+
+
+def bench_point(target_serial, size, transactions, cpu_hz):
+    """Run K echo transactions of one payload size at the current baud
+    rate and return the summarized record."""
+    # Deterministic non-trivial payload (exercises COBS: no frame bytes,
+    # but varied content)
+    payload = bytes((i * 37 + size + 1) % 255 + 1 for i in range(size))
+
+    roundtrips_s = []
+    turnaround_cycles = []
+    for _ in range(transactions):
+        start = time.perf_counter()
+        target_serial.send_packet('e', payload if size else None)
+        cmd, data = target_serial.read_packet(timeout=500)
+        roundtrips_s.append(time.perf_counter() - start)
+
+        if cmd != ord('e') or data is None or data[4:] != payload:
+            raise RuntimeError(
+                f"bench_serial: bad echo reply for size {size} (cmd={cmd})"
+            )
+        turnaround_cycles.append(int.from_bytes(data[:4], 'little'))
+
+    encode_s = measure_encode(target_serial, payload)
+    p50_s = _percentile(roundtrips_s, 0.50)
+    turnaround_p50_s = _percentile(turnaround_cycles, 0.50) / cpu_hz
+    return {
+        "payload_bytes": size,
+        "transactions": transactions,
+        "roundtrip_p50_ms": round(p50_s * 1000.0, 4),
+        "roundtrip_p99_ms": round(_percentile(roundtrips_s, 0.99) * 1000.0, 4),
+        "roundtrip_max_ms": round(max(roundtrips_s) * 1000.0, 4),
+        "host_encode_us": round(encode_s * 1e6, 2),
+        "target_turnaround_us": round(turnaround_p50_s * 1e6, 2),
+        # Residual at p50: UART shifting + USB/driver latency
+        "wire_transport_ms": round(
+            (p50_s - encode_s - turnaround_p50_s) * 1000.0, 4
+        ),
+    }
+
+
+def run_benchmark(transactions=DEFAULT_TRANSACTIONS, cpu_hz=TARGET_CPU_HZ):
+    cw = ChipWhisperer()
+    target_serial = TargetSerial(SimpleSerial_ChipWhispererLite, cw.scope)
+
+    records = []
+    for baud in BAUD_RATES:
+        if baud != target_serial.baud:
+            target_serial.negotiate_baud(baud)
+        print(f"\n--- {baud} baud ---")
+        print(f"{'bytes':>6}{'p50 ms':>9}{'p99 ms':>9}{'max ms':>9}"
+              f"{'encode us':>11}{'target us':>11}{'wire ms':>9}")
+        for size in PACKET_SIZES:
+            record = bench_point(target_serial, size, transactions, cpu_hz)
+            record["baud"] = baud
+            records.append(record)
+            print(f"{record['payload_bytes']:>6}"
+                  f"{record['roundtrip_p50_ms']:>9}"
+                  f"{record['roundtrip_p99_ms']:>9}"
+                  f"{record['roundtrip_max_ms']:>9}"
+                  f"{record['host_encode_us']:>11}"
+                  f"{record['target_turnaround_us']:>11}"
+                  f"{record['wire_transport_ms']:>9}")
+    return records
+
+
+def main():
+    args = sys.argv[1:]
+    transactions = DEFAULT_TRANSACTIONS
+    if "-k" in args:
+        transactions = int(args[args.index("-k") + 1])
+    cpu_hz = TARGET_CPU_HZ
+    if "--cpu-hz" in args:
+        cpu_hz = int(args[args.index("--cpu-hz") + 1])
+
+    records = run_benchmark(transactions, cpu_hz)
+
+    if "--json" in args:
+        out_path = args[args.index("--json") + 1]
+        with open(out_path, "w") as f:
+            json.dump({"cpu_hz": cpu_hz, "points": records}, f, indent=4)
+        print(f"\nWrote {out_path}")
+
+
+if __name__ == "__main__":
+    main()
@@ -1,22 +1,193 @@
-from CSUtils import ChipShouter
-import time
+"""
+Binary-search threshold calibration for the ChipShouter.
 
-cs = ChipShouter()
-cs.disarm()
+Finding the minimal faulting voltage at a position used to mean a full
+linear voltage sweep as separate glitch configs - hundreds of shots for
+one number. This engine bisects instead, using live fault feedback
+through CSProfiler.test_execution: each probed value runs executions
+only until the first fault (the value is above threshold) or until
+enough fault-free executions rule out fault rates >= min_fault_rate at
+the requested confidence (the value is below). A 350V window at 5V
+resolution resolves in ~7 probe steps of a handful of shots each.
 
+The engine is importable - build a CSProfiler whose single glitch
+config is the calibration base, position the table, then
 
-cs.configure_pulsegen(
-    10,
-    100,
-    80
-)
-cs.voltage = 400
+    calibrated, history = calibrate_threshold(profiler, field="voltage",
+                                              low=150, high=500)
 
-cs.clear_faults()
-cs.arm()
-time.sleep(3)
-while True:
-    cs.pulse()
-    time.sleep(3)
+which returns a GlitchConfig with the field set to the lowest faulting
+value found. The same routine bisects pulse_width (or any other numeric
+GlitchConfig axis) by passing a different `field`.
 
-    # time.sleep(5)
\ No newline at end of file
+The CLI calibrates on real hardware with the loop payload (run from the
+directory containing the repo):
+
+    python3 -m <package>.utils.calibrate_cs --pos X Y Z \
+        --v-min 150 --v-max 500 [--w-min 40 --w-max 200] [--home]
+"""
+
+import math
+import os
+import sys
+from dataclasses import replace
+
+from ..config_classes import GlitchConfig, TargetConfig
+
+# Result categories that count as a successful disturbance when probing;
+# crashes and resets mean the pulse affected the target even if no clean
+# fault packet came back
+FAULT_CATEGORIES = ("faults", "crashes", "resets")
+
+
+def executions_for_confidence(min_fault_rate, confidence):
+    """Fault-free executions after which a probed value is declared
+    non-faulting: the smallest n with (1-min_fault_rate)^n <= 1-confidence,
+    so a point faulting at >= min_fault_rate slips through with
+    probability at most 1-confidence."""
+    return math.ceil(math.log(1 - confidence) / math.log(1 - min_fault_rate))
+
+
+def probe_value(profiler, field, value, position_index=0,
+                min_fault_rate=0.2, confidence=0.95,
+                fault_categories=FAULT_CATEGORIES):
+    """
+    Whether `field`=value faults at the current position.
+
+    Reconfigures the profiler's single glitch config in place, then runs
+    test_execution until the first fault (early exit) or the confidence
+    budget is exhausted. Returns (faults, executions_run).
+    """
+    glitch_config = profiler.glitch_configs[0]
+    setattr(glitch_config, field, value)
+    profiler.configure_chipshouter(glitch_config)
+    profiler.target_serial.resync()
+
+    budget = executions_for_confidence(min_fault_rate, confidence)
+    execution_index = 0
+    for executions_run in range(1, budget + 1):
+        execution_index, result_category, _ = profiler.test_execution(
+            position_index, 0, execution_index
+        )
+        if result_category in fault_categories:
+            return True, executions_run
+    return False, budget
+
+
+def calibrate_threshold(profiler, field, low, high, resolution=5,
+                        position_index=0, min_fault_rate=0.2,
+                        confidence=0.95, fault_categories=FAULT_CATEGORIES,
+                        log=print):
+    """
+    Bisect the faulting threshold of one GlitchConfig axis.
+
+    Verifies the endpoints first (`high` must fault, `low` must not -
+    a bisection over an unverified bracket converges to a lie), then
+    narrows the bracket to `resolution` and returns (calibrated
+    GlitchConfig, history). The calibrated config carries the lowest
+    faulting value; history is a list of {value, faults, executions}
+    records for the results metadata.
+
+    Raises
+    ------
+    ValueError
+        When an endpoint check fails, with the direction to extend the
+        bracket.
+    """
+    history = []
+
+    def probe(value):
+        faults, executions_run = probe_value(
+            profiler, field, value, position_index,
+            min_fault_rate, confidence, fault_categories
+        )
+        history.append({"value": value, "faults": faults,
+                        "executions": executions_run})
+        log(f"  {field}={value}: "
+            f"{'faults' if faults else 'clean'} ({executions_run} exec)")
+        return faults
+
+    if not probe(high):
+        raise ValueError(f"{field}={high} does not fault; raise the upper bound")
+    if probe(low):
+        raise ValueError(f"{field}={low} already faults; lower the lower bound")
+
+    while high - low > resolution:
+        mid = (low + high) // 2
+        if probe(mid):
+            high = mid
+        else:
+            low = mid
+
+    log(f"{field} threshold: {high} (clean below {low + 1})")
+    return replace(profiler.glitch_configs[0], **{field: high}), history
+
+
+def main():
+    from ..profile_target import CSProfiler
+
+    args = sys.argv[1:]
+
+    def int_arg(flag, default):
+        if flag in args:
+            return int(args[args.index(flag) + 1])
+        return default
+
+    if "--pos" not in args:
+        print(__doc__)
+        sys.exit(2)
+    pos_at = args.index("--pos")
+    x, y, z = (float(args[pos_at + i]) for i in (1, 2, 3))
+
+    v_min = int_arg("--v-min", 150)
+    v_max = int_arg("--v-max", 500)
+    w_min = int_arg("--w-min", None)
+    w_max = int_arg("--w-max", None)
+    resolution = int_arg("--resolution", 5)
+    confidence = float(args[args.index("--confidence") + 1]) \
+        if "--confidence" in args else 0.95
+
+    current_dir = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    target_config = TargetConfig(
+        firmware_build_dir=os.path.join(current_dir, "target-firmware", "build"),
+        firmware_build_command=["make", "loop"],
+        firmware_path=os.path.join(current_dir, "target-firmware", "build",
+                                   "emfi-profiler-CW308_STM32F4.hex"),
+    )
+    base_config = GlitchConfig(
+        probe="calibration",
+        voltage=v_max,
+        pulse_width=int_arg("--width", 80),
+        pulse_spacing=int_arg("--spacing", 50),
+        pulse_repeats=int_arg("--repeats", 0),
+        pulse_offset=int_arg("--offset", 0),
+        num_executions=0,
+        dead_timeout=int_arg("--dead-timeout", 100),
+    )
+
+    profiler = CSProfiler(target_config, [[x, y, z]], [base_config])
+    profiler.prepare_hardware()
+    if "--home" in args:
+        profiler.table.home_all()
+    profiler.move_table(x, y, z)
+    profiler.reset_target()
+
+    calibrated, _ = calibrate_threshold(
+        profiler, "voltage", v_min, v_max,
+        resolution=resolution, confidence=confidence
+    )
+    if w_min is not None and w_max is not None:
+        # Width search runs at the just-calibrated voltage
+        profiler.glitch_configs[0].voltage = calibrated.voltage
+        calibrated, _ = calibrate_threshold(
+            profiler, "pulse_width", w_min, w_max,
+            resolution=resolution, confidence=confidence
+        )
+
+    profiler.cs.disarm()
+    print("Calibrated config:")
+    print(calibrated)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,297 @@
+"""
+Cross-endpoint protocol conformance harness: firmware codec vs host codec.
+
+The firmware's stream-mode COBS encoder in sendpacket() and the host
+decoder TargetSerial._cobs_unstuff_data were written independently, and
+edge-case disagreements (0xFF-length blocks, trailing frame bytes)
+surface in the field as CRC-failure retry storms, not as crashes. This
+harness compiles the real target-firmware/simpleserial/simpleserial.c
+for the build host (I/O redirected through host/shim.c) and round-trips
+a generated corpus through both endpoints in both directions, for every
+framing x CRC mode combination:
+
+  firmware sendpacket() -> captured wire bytes -> host decode
+  host encode           -> fed wire bytes      -> firmware readpacket()
+
+Each direction also checks exact wire-length consumption, so a trailing
+stray byte fails here instead of desynchronizing a campaign. Per-case
+timing is captured alongside, making codec regressions diffable the
+same way bench_codec results are.
+
+Run from the repo root (requires a host C compiler):
+
+    python3 -m utils.conformance_codec [--json out.json]
+
+Exits nonzero on any conformance failure, so it can gate commits.
+"""
+
+import ctypes
+import json
+import os
+import random
+import subprocess
+import sys
+import time
+import zlib
+
+from simpleserial.simpleserial import TargetSerial
+from utils.bench_codec import DENSITIES, make_payload
+
+FIRMWARE_DIR = os.path.join(
+    os.path.dirname(os.path.dirname(os.path.abspath(__file__))),
+    "target-firmware", "simpleserial",
+)
+BUILD_DIR = os.path.expanduser("~/.cache/cs-profiler/conformance")
+
+# Edge sizes around the COBS 0xFF-block boundary (254 payload bytes per
+# block) plus the host->firmware cap (SS_STATIC_RX_BUF_SIZE bounds the
+# encoded frame, so larger payloads only travel firmware->host)
+EDGE_SIZES = (0, 1, 2, 63, 96, 253, 254, 255, 256, 507, 508, 509, 1024)
+HOST_TO_FW_MAX = 96
+RANDOM_CASES = 32
+
+# Directed cases the densities cannot produce: a frame byte immediately
+# behind a full 254-byte block (and behind two back-to-back full
+# blocks), where the encoder must emit an empty block for the zero
+# rather than folding it into the 0xFF-block boundary
+DIRECTED_CASES = (
+    bytes([0x5A]) * 254 + b"\x00",
+    bytes([0x5A]) * 254 + b"\x00" + bytes([0xA5]) * 7,
+    bytes([0x5A]) * 508 + b"\x00" + bytes([0xA5]) * 7,
+    (bytes([0x5A]) * 254 + b"\x00") * 2,
+)
+
+FRAMINGS = ("cobs", "len16")
+CRC_MODES = ("crc8", "crc32")
+
+
+def build_library():
+    """Compile simpleserial.c plus the I/O shim into a host shared
+    object, rebuilding only when a source or header changed."""
+    lib_path = os.path.join(BUILD_DIR, "libsscodec.so")
+    sources = [
+        os.path.join(FIRMWARE_DIR, "simpleserial.c"),
+        os.path.join(FIRMWARE_DIR, "host", "shim.c"),
+    ]
+    headers = [
+        os.path.join(FIRMWARE_DIR, "simpleserial.h"),
+        os.path.join(FIRMWARE_DIR, "host", "hal.h"),
+        os.path.join(FIRMWARE_DIR, "host", "hal", "stm32f4-hal.h"),
+        os.path.join(FIRMWARE_DIR, "host", "hal", "stm32f4-uart.h"),
+    ]
+    if os.path.exists(lib_path):
+        lib_mtime = os.path.getmtime(lib_path)
+        if all(os.path.getmtime(p) < lib_mtime for p in sources + headers):
+            return lib_path
+
+    os.makedirs(BUILD_DIR, exist_ok=True)
+    compiler = os.environ.get("CC", "cc")
+    subprocess.check_call(
+        [compiler, "-shared", "-fPIC", "-O2",
+         "-I", os.path.join(FIRMWARE_DIR, "host"),
+         "-o", lib_path] + sources
+    )
+    return lib_path
+
+
+def load_library(lib_path):
+    lib = ctypes.CDLL(lib_path)
+    lib.sendpacket.argtypes = [ctypes.c_uint8, ctypes.c_char_p, ctypes.c_size_t]
+    lib.sendpacket.restype = ctypes.c_int
+    lib.readpacket.argtypes = [
+        ctypes.POINTER(ctypes.c_uint8),
+        ctypes.POINTER(ctypes.POINTER(ctypes.c_uint8)),
+        ctypes.POINTER(ctypes.c_size_t),
+    ]
+    lib.readpacket.restype = ctypes.c_int
+    lib.ss_handle_control_packet.argtypes = [
+        ctypes.c_uint8, ctypes.c_char_p, ctypes.c_size_t]
+    lib.ss_handle_control_packet.restype = ctypes.c_int
+    lib.host_tx_data.restype = ctypes.POINTER(ctypes.c_uint8)
+    lib.host_tx_len.restype = ctypes.c_size_t
+    lib.host_rx_load.argtypes = [ctypes.c_char_p, ctypes.c_size_t]
+    lib.host_rx_remaining.restype = ctypes.c_size_t
+    return lib
+
+
+def set_firmware_modes(lib, framing, crc_mode):
+    """Drive the firmware's 'F' and 'C' control packets (their acks land
+    in the TX capture and are discarded)."""
+    if lib.ss_handle_control_packet(
+            ord('F'), bytes([FRAMINGS.index(framing)]), 1) != 0:
+        raise RuntimeError(f"firmware rejected framing {framing}")
+    if lib.ss_handle_control_packet(
+            ord('C'), bytes([CRC_MODES.index(crc_mode)]), 1) != 0:
+        raise RuntimeError(f"firmware rejected CRC mode {crc_mode}")
+    lib.host_tx_reset()
+
+
+def host_crc(payload, crc_mode):
+    if crc_mode == "crc32":
+        return zlib.crc32(payload).to_bytes(4, "little")
+    return bytes([TargetSerial._calc_crc(payload)])
+
+
+def host_encode(cmd, payload, framing, crc_mode):
+    """Host-side wire encoding, byte-identical to TargetSerial.send_packet."""
+    if framing == "len16":
+        frame = bytes([cmd]) + len(payload).to_bytes(2, "little")
+        if payload:
+            frame += payload + host_crc(payload, crc_mode)
+        return frame
+    if not payload:
+        return bytes([cmd, 0])
+    body = payload + host_crc(payload, crc_mode)
+    return bytes([cmd]) + TargetSerial._cobs_stuff_data(body) + bytes([0])
+
+
+def host_decode(frame, framing, crc_mode):
+    """Host-side wire decoding, mirroring TargetSerial.read_packet.
+    Returns (cmd, payload) and raises ValueError on any disagreement."""
+    crc_len = 4 if crc_mode == "crc32" else 1
+    if framing == "len16":
+        cmd = frame[0]
+        length = int.from_bytes(frame[1:3], "little")
+        if length == 0:
+            if len(frame) != 3:
+                raise ValueError("v2 empty frame with trailing bytes")
+            return cmd, b""
+        if len(frame) != 3 + length + crc_len:
+            raise ValueError("v2 frame length mismatch")
+        payload = frame[3:3 + length]
+        if frame[3 + length:] != host_crc(payload, crc_mode):
+            raise ValueError("v2 CRC mismatch")
+        return cmd, payload
+
+    if frame[-1] != 0 or 0 in frame[:-1]:
+        raise ValueError("bad COBS frame boundaries")
+    cmd = frame[0]
+    if len(frame) == 2:
+        return cmd, b""
+    decoded = TargetSerial._cobs_unstuff_data(frame[1:-1])
+    if len(decoded) < crc_len:
+        raise ValueError("decoded frame shorter than CRC trailer")
+    payload, crc = decoded[:-crc_len], decoded[-crc_len:]
+    if crc != host_crc(payload, crc_mode):
+        raise ValueError("COBS CRC mismatch")
+    return cmd, payload
+
+
+def make_corpus(max_size):
+    """Edge sizes across all frame-byte densities, directed full-block
+    boundary cases, plus seeded random payloads, capped at max_size."""
+    corpus = []
+    for size in EDGE_SIZES:
+        if size > max_size:
+            continue
+        for density in DENSITIES:
+            corpus.append(make_payload(size, density))
+    for payload in DIRECTED_CASES:
+        if len(payload) <= max_size:
+            corpus.append(payload)
+    rng = random.Random(0xC0B5)
+    for _ in range(RANDOM_CASES):
+        size = rng.randint(0, max_size)
+        corpus.append(bytes(rng.randint(0, 255) for _ in range(size)))
+    return corpus
+
+
+def run_combo(lib, framing, crc_mode):
+    """Both directions over the corpus for one mode combination."""
+    set_firmware_modes(lib, framing, crc_mode)
+    failures = []
+    fw_encode_s = host_decode_s = 0.0
+    host_encode_s = fw_decode_s = 0.0
+
+    # firmware encode -> host decode
+    tx_corpus = make_corpus(1024)
+    for case_index, payload in enumerate(tx_corpus):
+        lib.host_tx_reset()
+        start = time.perf_counter()
+        ret = lib.sendpacket(ord('e'), payload, len(payload))
+        fw_encode_s += time.perf_counter() - start
+        frame = ctypes.string_at(lib.host_tx_data(), lib.host_tx_len())
+        try:
+            if ret != 0:
+                raise ValueError(f"sendpacket returned {ret}")
+            start = time.perf_counter()
+            cmd, decoded = host_decode(frame, framing, crc_mode)
+            host_decode_s += time.perf_counter() - start
+            if cmd != ord('e') or decoded != payload:
+                raise ValueError("payload mismatch after host decode")
+        except ValueError as e:
+            failures.append(f"fw->host case {case_index} "
+                            f"(len {len(payload)}): {e}")
+
+    # host encode -> firmware decode
+    rx_corpus = make_corpus(HOST_TO_FW_MAX)
+    for case_index, payload in enumerate(rx_corpus):
+        start = time.perf_counter()
+        frame = host_encode(ord('c'), payload, framing, crc_mode)
+        host_encode_s += time.perf_counter() - start
+        lib.host_rx_load(frame, len(frame))
+        cmd = ctypes.c_uint8()
+        data = ctypes.POINTER(ctypes.c_uint8)()
+        data_len = ctypes.c_size_t()
+        start = time.perf_counter()
+        ret = lib.readpacket(ctypes.byref(cmd), ctypes.byref(data),
+                             ctypes.byref(data_len))
+        fw_decode_s += time.perf_counter() - start
+        decoded = ctypes.string_at(data, data_len.value) if data_len.value else b""
+        if (ret < 0 or cmd.value != ord('c') or decoded != payload
+                or lib.host_rx_remaining() != 0):
+            failures.append(
+                f"host->fw case {case_index} (len {len(payload)}): "
+                f"ret={ret} leftover={lib.host_rx_remaining()}")
+
+    return {
+        "framing": framing,
+        "crc_mode": crc_mode,
+        "cases": len(tx_corpus) + len(rx_corpus),
+        "failures": failures,
+        "fw_encode_us_mean": round(fw_encode_s / len(tx_corpus) * 1e6, 2),
+        "host_decode_us_mean": round(host_decode_s / len(tx_corpus) * 1e6, 2),
+        "host_encode_us_mean": round(host_encode_s / len(rx_corpus) * 1e6, 2),
+        "fw_decode_us_mean": round(fw_decode_s / len(rx_corpus) * 1e6, 2),
+    }
+
+
+def main():
+    args = sys.argv[1:]
+
+    lib = load_library(build_library())
+
+    records = []
+    failed = 0
+    print(f"{'framing':>8}{'crc':>7}{'cases':>7}{'fail':>6}"
+          f"{'fw enc us':>11}{'host dec us':>13}"
+          f"{'host enc us':>13}{'fw dec us':>11}")
+    for framing in FRAMINGS:
+        for crc_mode in CRC_MODES:
+            record = run_combo(lib, framing, crc_mode)
+            records.append(record)
+            failed += len(record["failures"])
+            print(f"{framing:>8}{crc_mode:>7}{record['cases']:>7}"
+                  f"{len(record['failures']):>6}"
+                  f"{record['fw_encode_us_mean']:>11}"
+                  f"{record['host_decode_us_mean']:>13}"
+                  f"{record['host_encode_us_mean']:>13}"
+                  f"{record['fw_decode_us_mean']:>11}")
+            for failure in record["failures"]:
+                print(f"    FAIL {failure}")
+
+    out_path = "conformance_codec.json"
+    if "--json" in args:
+        out_path = args[args.index("--json") + 1]
+    with open(out_path, "w") as f:
+        json.dump({"records": records}, f, indent=4)
+    print(f"\nWrote {out_path}")
+
+    if failed:
+        print(f"{failed} conformance failures")
+        sys.exit(1)
+    print("All conformance checks passed")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,52 @@
+"""
+Automatic maximum-baud discovery for a bench setup.
+
+Different probes, cable runs and targets top out at different baud
+rates, and campaigns conservatively stay at the 38400 boot default.
+This tool runs TargetSerial.autotune_baud(): the negotiated rate is
+ramped upward while echo transactions and the serial link-health
+counters judge each step, the link settles on the highest clean rate,
+and the verdict is cached per ChipWhisperer serial number
+(~/.cache/cs-profiler/tuned-baud.json) so the next run - and any
+session calling autotune_baud() with the same serial number - starts
+at the tuned rate after a single validation burst.
+
+Run from the repo root against a flashed payload:
+
+    python3 -m utils.tune_baud [--sn SERIAL] [-k N]
+
+Expects the target to be up (reset it first if unsure); the link is
+left at the settled rate on exit.
+"""
+
+import sys
+
+from CWUtils import ChipWhisperer
+from simpleserial.simpleserial import TargetSerial
+from simpleserial.simpleserial_readers.cwlite import SimpleSerial_ChipWhispererLite
+
+DEFAULT_TRANSACTIONS = 50
+
+
+def main():
+    args = sys.argv[1:]
+    sn = args[args.index("--sn") + 1] if "--sn" in args else None
+    transactions = DEFAULT_TRANSACTIONS
+    if "-k" in args:
+        transactions = int(args[args.index("-k") + 1])
+
+    cw = ChipWhisperer(sn=sn)
+    target_serial = TargetSerial(SimpleSerial_ChipWhispererLite, cw.scope)
+
+    # Same key CWUtils uses to address a single unnamed device
+    serial_id = sn if sn else "ChipWhisperer_Lite"
+    cached = TargetSerial.tuned_baud(serial_id)
+    if cached:
+        print(f"Cached verdict for {serial_id}: {cached} baud (re-validating)")
+
+    baud = target_serial.autotune_baud(serial_id, transactions=transactions)
+    print(f"Settled on {baud} baud, cached for {serial_id}")
+
+
+if __name__ == "__main__":
+    main()
@@ -6,59 +6,471 @@ from matplotlib.backends.backend_tkagg import FigureCanvasTkAgg
 from matplotlib.widgets import Button, TextBox
 from matplotlib import colors
 from matplotlib.patches import Patch
+import numpy as np
+import hashlib
+import os
 import sys
 import json
+import gzip
 import signal
 
 
 DEFAULT_JSON_PATH = 'results.json'
-def mix_colors(c1, c2, ratio):
-    """Linearly interpolate between two RGB tuples."""
-    return tuple(c1[i] * (1 - ratio) + c2[i] * ratio for i in range(3))
-
-def classify_color(num_nofaults, num_faults, num_crashes, num_resets, num_soft_bricked, num_hard_bricked, num_skipped):
-    """Return hex color for a given point based on result ratios."""
-
-    sum_results = num_nofaults + num_faults + num_crashes + num_resets + num_soft_bricked + num_hard_bricked # NOT including num_skipped
-    # num_nofaults, num_faults, num_skipped
+FOLLOW_POLL_MS = 500
+COUNTER_KEYS = ("num_nofaults", "num_faults", "num_crashes", "num_resets",
+                "num_soft_bricked", "num_hard_bricked", "num_skipped")
+
+# Above this size the results JSON is parsed incrementally (positions and
+# counters only, extradata fetched lazily per click) instead of json.load-ing
+# the whole tree - first paint in seconds at constant memory
+STREAM_LOAD_THRESHOLD = 256 * 2**20
+
+def _binary_opener(json_path):
+    return gzip.open(json_path, 'rb') if json_path.endswith('.gz') else open(json_path, 'rb')
+
+def _stream_load(json_path):
+    """Incrementally parse a results JSON with ijson, keeping only the
+    positions, the glitch config parameters and the per-position num_*
+    counters; the (potentially huge) extradata arrays are skipped.
+    Returns (data, meta) with meta holding the sidecar paths."""
+    import ijson
+
+    positions = []
+    configs = []
+    meta = {}
+    current_position = []
+    with _binary_opener(json_path) as f:
+        for prefix, event, value in ijson.parse(f):
+            if prefix == "positions.item.item":
+                current_position.append(float(value))
+            elif prefix == "positions.item" and event == "end_array":
+                positions.append(current_position)
+                current_position = []
+            elif prefix == "glitch_configs.item" and event == "start_map":
+                configs.append({"results": {}})
+            elif prefix.startswith("glitch_configs.item.results.num_"):
+                key = prefix.split(".")[3]
+                if prefix.endswith(".item"):
+                    configs[-1]["results"].setdefault(key, []).append(int(value))
+                elif event == "number":
+                    # legacy scalar num_skipped
+                    configs[-1]["results"][key] = int(value)
+            elif prefix.startswith("glitch_configs.item.results."):
+                pass  # extradata / effective_executions: lazy per-click fetch
+            elif (prefix.startswith("glitch_configs.item.")
+                    and "." not in prefix[len("glitch_configs.item."):]
+                    and event in ("string", "number", "boolean", "null")):
+                key = prefix[len("glitch_configs.item."):]
+                configs[-1][key] = float(value) if event == "number" else value
+            elif prefix in ("results_stream", "fault_blobs", "xy_map") and event == "string":
+                meta[prefix] = value
+
+    return {"positions": positions, "glitch_configs": configs}, meta
+
+def _iter_category_entries(json_path, target_config_index):
+    """Yield (category, entry) for every extradata entry of one glitch
+    config, re-scanning the results JSON incrementally."""
+    import ijson
+
+    with _binary_opener(json_path) as f:
+        config_index = -1
+        builder = None
+        entry_prefix = None
+        category = None
+        for prefix, event, value in ijson.parse(f):
+            if prefix == "glitch_configs.item" and event == "start_map":
+                config_index += 1
+            if config_index != target_config_index:
+                continue
+            if builder is None:
+                parts = prefix.split(".")
+                if (len(parts) == 5 and parts[2] == "results"
+                        and not parts[3].startswith("num_")
+                        and event == "start_map"):
+                    category = parts[3]
+                    entry_prefix = prefix
+                    builder = ijson.ObjectBuilder()
+            if builder is not None:
+                builder.event(event, value)
+                if prefix == entry_prefix and event == "end_map":
+                    yield category, builder.value
+                    builder = None
+
+def make_lazy_extradata_loader(json_path, meta):
+    """Loader(config_index, position_index) -> {category: [data, ...]} for
+    stream-loaded results. Reads the stream log when the results JSON
+    records one (fast line scan), otherwise re-scans the JSON with ijson -
+    either way one click costs one pass at constant memory."""
+    stream_path = meta.get("results_stream")
+    if stream_path and os.path.exists(stream_path):
+        def loader(config_index, position_index):
+            found = {}
+            with open(stream_path) as f:
+                for line in f:
+                    try:
+                        record = json.loads(line)
+                    except ValueError:
+                        continue
+                    if (record.get("config_index") == config_index
+                            and record.get("position_index") == position_index
+                            and "data" in record):
+                        found.setdefault(record["result_category"], []).append(record["data"])
+            return found
+        return loader
+
+    def loader(config_index, position_index):
+        found = {}
+        for category, entry in _iter_category_entries(json_path, config_index):
+            if entry.get("position_index") == position_index:
+                found.setdefault(category, []).append(entry.get("data"))
+        return found
+    return loader
+
+def load_results(json_path):
+    """Load a results JSON, streaming incrementally above
+    STREAM_LOAD_THRESHOLD. Returns (data, extradata_loader); the loader
+    is None when the full tree is in memory."""
+    try:
+        size = os.path.getsize(json_path)
+    except OSError:
+        size = 0
+    if size >= STREAM_LOAD_THRESHOLD:
+        try:
+            import ijson  # noqa: F401 (availability probe)
+        except ImportError:
+            print("Note: install ijson to stream-load large results files at constant memory")
+        else:
+            print(f"Streaming load of {size >> 20} MiB results file (extradata fetched per click)")
+            data, meta = _stream_load(json_path)
+            return data, make_lazy_extradata_loader(json_path, meta)
+
+    # Results may be gzip-compressed (profiler compress_results option)
+    opener = gzip.open if json_path.endswith('.gz') else open
+    with opener(json_path, 'rt') as f:
+        return json.load(f), None
+
+def _config_point_colors(results, num_positions):
+    """RGBA fill and edge arrays for one config: result classification
+    fills, pink perimeter where executions were skipped."""
+    point_colors = classify_colors(results, num_positions)
+    edgecolors = np.tile(np.asarray(colors.to_rgba("black")), (num_positions, 1))
+    num_skipped = _counter_array(results, "num_skipped", num_positions)
+    edgecolors[num_skipped > 0] = colors.to_rgba("#F80BD8")
+    # Orange perimeter: data (partly) from a *_partial results file
+    # (merge loader); the key only exists on merged datasets
+    partial_sourced = _counter_array(results, "num_partial_sourced", num_positions)
+    edgecolors[partial_sourced > 0] = colors.to_rgba("#FF8C00")
+    return point_colors, edgecolors
+
+def _file_digest(path):
+    digest = hashlib.sha256()
+    with open(path, "rb") as f:
+        for chunk in iter(lambda: f.read(1 << 20), b""):
+            digest.update(chunk)
+    return digest.hexdigest()
+
+def compute_or_load_heatmaps(json_path, data):
+    """
+    Per-config fill/edge RGBA arrays for every point, persisted in a
+    sidecar <results>.heatmap.npz keyed by the results file's sha256.
+    Results files are immutable, so the classification runs once on
+    first visualization; reopening the campaign (or batch-rendering
+    report figures off this API) just loads the arrays back.
+
+    Returns (fill, edge), each shaped (num_configs, num_positions, 4).
+    """
+    cache_path = json_path + ".heatmap.npz"
+    try:
+        digest = _file_digest(json_path)
+    except OSError:
+        digest = None
+    if digest and os.path.exists(cache_path):
+        try:
+            with np.load(cache_path) as cache:
+                if str(cache["digest"]) == digest:
+                    return cache["fill"], cache["edge"]
+        except (OSError, KeyError, ValueError) as e:
+            print(f"Ignoring heatmap cache {cache_path}: {e}")
+
+    num_positions = len(data["positions"])
+    fill, edge = [], []
+    for config in data["glitch_configs"]:
+        config_fill, config_edge = _config_point_colors(config["results"], num_positions)
+        fill.append(config_fill)
+        edge.append(config_edge)
+    fill, edge = np.stack(fill), np.stack(edge)
+
+    if digest:
+        try:
+            np.savez_compressed(cache_path, digest=digest, fill=fill, edge=edge)
+        except OSError as e:
+            print(f"Heatmap cache write failed: {e}")
+    return fill, edge
+
+def _total_executions(results, num_positions):
+    """Per-position execution count (all result types except skipped)."""
+    total = np.zeros(num_positions)
+    for key in COUNTER_KEYS:
+        if key != "num_skipped":
+            total += _counter_array(results, key, num_positions)
+    return total
+
+def load_diff_data(path_a, path_b):
+    """
+    Merge two results files into a diff dataset: positions aligned by
+    (x, y, z) coordinates (rounded to 1e-6, vectorized via intersect1d
+    on a structured view), per-point fault-rate delta B - A computed per
+    config pair. Each synthetic config carries both campaigns'
+    parameters (suffixed (A)/(B)) for the sidebar and num_* counters
+    from both sides plus the delta for point details.
+    """
+    data_a, _ = load_results(path_a)
+    data_b, _ = load_results(path_b)
+
+    coords = np.dtype([("x", float), ("y", float), ("z", float)])
+    pos_a = np.ascontiguousarray(np.round(np.asarray(data_a["positions"], dtype=float), 6))
+    pos_b = np.ascontiguousarray(np.round(np.asarray(data_b["positions"], dtype=float), 6))
+    _, index_a, index_b = np.intersect1d(
+        pos_a.view(coords).ravel(), pos_b.view(coords).ravel(),
+        return_indices=True
+    )
+    if len(index_a) == 0:
+        raise ValueError(f"{path_a} and {path_b} share no positions")
+
+    configs_a = data_a["glitch_configs"]
+    configs_b = data_b["glitch_configs"]
+    if len(configs_a) != len(configs_b):
+        print(f"Note: {len(configs_a)} vs {len(configs_b)} glitch configs, "
+              "diffing the common prefix")
+
+    configs = []
+    for config_a, config_b in zip(configs_a, configs_b):
+        results_a, results_b = config_a["results"], config_b["results"]
+        executions_a = _total_executions(results_a, len(pos_a))[index_a]
+        executions_b = _total_executions(results_b, len(pos_b))[index_b]
+        faults_a = _counter_array(results_a, "num_faults", len(pos_a))[index_a]
+        faults_b = _counter_array(results_b, "num_faults", len(pos_b))[index_b]
+        rate_a = faults_a / np.where(executions_a > 0, executions_a, 1)
+        rate_b = faults_b / np.where(executions_b > 0, executions_b, 1)
+
+        config = {}
+        for key, value in config_a.items():
+            if key != "results":
+                config[f"{key} (A)"] = value
+        for key, value in config_b.items():
+            if key != "results":
+                config[f"{key} (B)"] = value
+        # num_ prefixes so the point-details sidebar renders them as
+        # per-position values
+        config["results"] = {
+            "num_faults_a": faults_a.astype(int).tolist(),
+            "num_faults_b": faults_b.astype(int).tolist(),
+            "num_executions_a": executions_a.astype(int).tolist(),
+            "num_executions_b": executions_b.astype(int).tolist(),
+            "num_fault_rate_delta": np.round(rate_b - rate_a, 4).tolist(),
+        }
+        configs.append(config)
+
+    return {"positions": pos_a[index_a].tolist(), "glitch_configs": configs}
+
+def _position_key(position):
+    return tuple(round(float(coordinate), 6) for coordinate in position)
+
+def load_merged_results(paths):
+    """
+    Merge several results files (e.g. the results_N_partial.json
+    sequence of an interrupted-and-resumed campaign) into one in-memory
+    dataset - nothing is written to disk. Positions are unioned by
+    rounded coordinates, glitch configs must match across files
+    (parameters compared, ValueError otherwise). Counters are summed
+    per position with vectorized adds; extradata is NOT merged up
+    front - the returned loader fetches it per point on click, so files
+    with heavy fault payloads stay cheap to open.
+
+    Points whose executions came (partly) from a *_partial file get a
+    num_partial_sourced counter, shown in the sidebar and tagged with an
+    orange perimeter in the plot.
+
+    Returns (data, extradata_loader) like load_results.
+    """
+    loaded = []
+    for path in paths:
+        data, _ = load_results(path)
+        is_partial = "_partial" in os.path.basename(path)
+        loaded.append((path, data, is_partial))
+
+    # Config compatibility: identical parameters in file order
+    def config_parameters(data):
+        return [{key: value for key, value in config.items() if key != "results"}
+                for config in data["glitch_configs"]]
+    reference = config_parameters(loaded[0][1])
+    for path, data, _ in loaded[1:]:
+        if config_parameters(data) != reference:
+            raise ValueError(
+                f"{path} has glitch configs incompatible with {loaded[0][0]}"
+            )
+
+    # Union the position grids by coordinates; file_maps[i] maps file i's
+    # position indices into the union
+    union_index = {}
+    positions = []
+    file_maps = []
+    for path, data, _ in loaded:
+        mapping = []
+        for position in data["positions"]:
+            key = _position_key(position)
+            if key not in union_index:
+                union_index[key] = len(positions)
+                positions.append(list(position))
+            mapping.append(union_index[key])
+        file_maps.append(np.asarray(mapping, dtype=int))
+
+    num_positions = len(positions)
+    configs = []
+    for config_index, parameters in enumerate(reference):
+        file_results = [data["glitch_configs"][config_index]["results"]
+                        for _, data, _ in loaded]
+        counter_keys = set()
+        for results in file_results:
+            counter_keys |= {key for key in results if key.startswith("num_")}
+
+        merged = {}
+        partial_sourced = np.zeros(num_positions)
+        for key in sorted(counter_keys):
+            total = np.zeros(num_positions)
+            for (path, data, is_partial), mapping, results in zip(
+                    loaded, file_maps, file_results):
+                values = _counter_array(results, key, len(mapping))
+                np.add.at(total, mapping, values)
+                if is_partial and key != "num_skipped":
+                    np.add.at(partial_sourced, mapping, values)
+            merged[key] = total.astype(int).tolist()
+        merged["num_partial_sourced"] = partial_sourced.astype(int).tolist()
+
+        config = dict(parameters)
+        config["results"] = merged
+        configs.append(config)
+
+    def extradata_loader(config_index, position_index):
+        found = {}
+        for (path, data, _), mapping in zip(loaded, file_maps):
+            results = data["glitch_configs"][config_index]["results"]
+            for result_type, entries in results.items():
+                if result_type.startswith("num_") or not isinstance(entries, list):
+                    continue
+                for entry in entries:
+                    if not isinstance(entry, dict):
+                        continue
+                    file_position = entry.get("position_index")
+                    if (file_position is not None
+                            and file_position < len(mapping)
+                            and mapping[file_position] == position_index):
+                        found.setdefault(result_type, []).append(entry.get("data"))
+        return found
+
+    return {"positions": positions, "glitch_configs": configs}, extradata_loader
+
+def load_follow_data(checkpoint_path):
+    """Campaign header for follow mode: positions and config parameters
+    from a checkpoint_N.json, with zeroed counters (the stream log is
+    replayed from the start, so seeding the checkpointed counters would
+    double count). Returns (data, stream_path)."""
+    with open(checkpoint_path) as f:
+        state = json.load(f)
+    positions = state["positions"]
+    configs = state.get("glitch_configs")
+    if not configs:  # checkpoint from before configs were recorded
+        configs = [{} for _ in range(state.get("num_glitch_configs", 1))]
+
+    data = {"positions": positions, "glitch_configs": []}
+    for config in configs:
+        config = dict(config)
+        config["results"] = {key: [0] * len(positions) for key in COUNTER_KEYS}
+        data["glitch_configs"].append(config)
+    return data, state.get("results_stream")
+
+def _counter_array(results, key, num_positions):
+    """One num_* counter as a float array of length num_positions.
+    Missing counters count as 0, the legacy scalar num_skipped is
+    broadcast over all positions."""
+    values = results.get(key)
+    if values is None:
+        return np.zeros(num_positions)
+    values = np.asarray(values, dtype=float)
+    if values.ndim == 0:
+        return np.full(num_positions, float(values))
+    return values
+
+def classify_colors(results, num_positions):
+    """Return one (num_positions, 4) RGBA array coloring every point by
+    its result ratios. Vectorized over all positions: boolean masks pick
+    the category, the gradient categories mix their endpoint colors with
+    the fault/instability ratio in one array expression."""
+    num_nofaults = _counter_array(results, "num_nofaults", num_positions)
+    num_faults = _counter_array(results, "num_faults", num_positions)
+    num_crashes = _counter_array(results, "num_crashes", num_positions)
+    num_resets = _counter_array(results, "num_resets", num_positions)
+    num_soft_bricked = _counter_array(results, "num_soft_bricked", num_positions)
+    num_hard_bricked = _counter_array(results, "num_hard_bricked", num_positions)
+    num_skipped = _counter_array(results, "num_skipped", num_positions)
+
+    sum_results = (num_nofaults + num_faults + num_crashes + num_resets
+                   + num_soft_bricked + num_hard_bricked) # NOT including num_skipped
     num_instabilities = num_resets + num_crashes + num_soft_bricked + num_hard_bricked
 
     # Gray: if no data exists for that point (or all were skipped)
-    if sum_results == 0:
-        return "gray"
+    rgba = np.tile(np.asarray(colors.to_rgba("gray")), (num_positions, 1))
+    has_data = sum_results > 0
+    ratio_denominator = np.where(has_data, sum_results, 1)
 
     # Green: normal operation (no faults, crashes, resets or skips)
-    if (num_faults + num_resets + num_crashes + num_soft_bricked + num_hard_bricked + num_skipped) == 0:
-        return "green"
+    green = has_data & ((num_faults + num_instabilities + num_skipped) == 0)
+    rgba[green] = colors.to_rgba("green")
 
     # Red: Only faults
-    if num_faults > 0 and num_nofaults == 0 and num_resets == 0 and num_crashes == 0:
-        return "red"
+    red = (has_data & (num_faults > 0) & (num_nofaults == 0)
+           & (num_resets == 0) & (num_crashes == 0))
+    rgba[red] = colors.to_rgba("red")
 
     # Yellow - Red: Some faults occured (color depending on faults / n executions)
-    if num_faults > 0:
-        start_color = colors.to_rgb("#cffc03")  # yellow-green start
-        end_color = colors.to_rgb("#ff0000")    # red end
-        denom = num_nofaults + num_resets + num_crashes + num_soft_bricked + num_hard_bricked
-        ratio = num_faults / sum_results
-        return colors.to_hex(mix_colors(start_color, end_color, ratio))
-
-    # Blue: No faults, but resets or crashes (color depending on ration of (resets + crashes) / n executions)
-    if num_faults == 0 and num_instabilities > 0:
-        start_color = colors.to_rgb("#03fc9d")  # teal start
-        end_color = colors.to_rgb("#0000ff")    # blue end
-        ratio = num_instabilities / sum_results
-        return colors.to_hex(mix_colors(start_color, end_color, ratio))
-
-    return "gray"
+    faulty = has_data & (num_faults > 0) & ~red
+    start_color = np.asarray(colors.to_rgba("#cffc03"))  # yellow-green start
+    end_color = np.asarray(colors.to_rgba("#ff0000"))    # red end
+    ratio = (num_faults / ratio_denominator)[faulty, None]
+    rgba[faulty] = start_color * (1 - ratio) + end_color * ratio
+
+    # Blue: No faults, but resets or crashes (color depending on ratio of (resets + crashes) / n executions)
+    unstable = has_data & (num_faults == 0) & (num_instabilities > 0)
+    start_color = np.asarray(colors.to_rgba("#03fc9d"))  # teal start
+    end_color = np.asarray(colors.to_rgba("#0000ff"))    # blue end
+    ratio = (num_instabilities / ratio_denominator)[unstable, None]
+    rgba[unstable] = start_color * (1 - ratio) + end_color * ratio
+
+    return rgba
 
 class GlitchVisualizer:
-    def __init__(self, root, json_data):
+    def __init__(self, root, json_data, extradata_loader=None, heatmaps=None,
+                 regions=None):
         self.root = root
         root.title("Glitch Visualizer")
 
+        # Set for stream-loaded results: extradata is not in json_data,
+        # the point-details sidebar fetches it per click
+        self.extradata_loader = extradata_loader
+        # Fault-cluster regions (fault_clusters.region_stats) drawn as
+        # static outline overlays; None/empty draws nothing
+        self._cluster_regions = regions
+        # Precomputed (fill, edge) arrays from the sidecar heatmap cache;
+        # None when colors must be classified from the counters (follow
+        # mode, diff view)
+        self._heatmaps = heatmaps
+
         self.data = json_data
         self.positions = self.data['positions']
+        # Position coordinates never change per config; precompute once
+        self.positions_xy = [(x, y) for x, y, _ in self.positions]
+        self._xs = np.asarray([pos[0] for pos in self.positions], dtype=float)
+        self._ys = np.asarray([pos[1] for pos in self.positions], dtype=float)
         self.glitch_configs = self.data['glitch_configs']
         self.num_configs = len(self.glitch_configs)
         self.current_config_index = 0
@@ -91,6 +503,10 @@ class GlitchVisualizer:
         self.canvas = FigureCanvasTkAgg(self.fig, master=self.plot_frame)  # Changed to plot_frame
         self.canvas.get_tk_widget().pack(fill=tk.BOTH, expand=True)
 
+        # Connect click event once (the pickable scatter artist itself is
+        # recreated on every config switch / level-of-detail change)
+        self.canvas.mpl_connect('pick_event', self.on_point_click)
+
         # === Right Sidebar Pane divided into glitch_config (top) and point_info (bottom) ===
         self.sidebar_pane = PanedWindow(self.main_pane, orient=VERTICAL, bg='#f0f0f0')
         self.main_pane.add(self.sidebar_pane, minsize=200)  # Minimum width for sidebar
@@ -139,6 +555,13 @@ class GlitchVisualizer:
         self.point_tree.heading("Value", text="Value")
         self.point_tree.pack(fill="both", expand=True, padx=1, pady=1)
 
+        # Virtualized tree state: position-indexed extradata stores per
+        # (config, result_type) and the deferred children of collapsed
+        # container nodes
+        self._extradata_cache = {}
+        self._pending_children = {}
+        self.point_tree.bind('<<TreeviewOpen>>', self._on_tree_expand)
+
         # Initialize with empty data
         self.clear_point_details()
 
@@ -225,101 +648,241 @@ class GlitchVisualizer:
             if param != 'results':  # Skip the results data
                 self.param_tree.insert("", "end", values=(param, value))
 
+    # Level of detail: render true scatter points only while the visible
+    # region holds at most this many; above it the points are aggregated
+    # into a mean-color image so pan/zoom stays responsive on 100k+ point
+    # campaigns
+    LOD_SCATTER_MAX = 5000
+    LOD_IMAGE_BINS = 256
+
+    def _point_colors(self, results, num_positions):
+        """RGBA fill and edge arrays for all points of one config, served
+        from the persisted heatmap cache when one was loaded. Overridden
+        by the diff view."""
+        if self._heatmaps is not None:
+            fill, edge = self._heatmaps
+            return fill[self.current_config_index], edge[self.current_config_index]
+        return _config_point_colors(results, num_positions)
+
+    def _legend_elements(self):
+        return [
+            Patch(facecolor='green', edgecolor='black', label='Normal operation'),
+            Patch(facecolor='#ff0000', edgecolor='black', label='Faults'),
+            Patch(facecolor='#0000ff', edgecolor='black', label='Resets & Crashes'),
+            # Patch(facecolor='gray', edgecolor='black', label='No data')
+        ]
+
+    AXES_TITLE = "Fault Injection Point Matrix"
+
     def update_plot(self):
         """Update the plot with current config data"""
-        self.ax.clear()
-
-        config = self.glitch_configs[self.current_config_index]
-        results = config['results']
+        results = self.glitch_configs[self.current_config_index]['results']
 
-        # Get x,y positions
-        self.positions_xy = [(x, y) for x, y, _ in self.positions]
-        xs = [pos[0] for pos in self.positions]
-        ys = [pos[1] for pos in self.positions]
-
-        # Color points based on results
-        colors_list = [
-            classify_color(
-                results["num_nofaults"][i],
-                results["num_faults"][i],
-                results["num_crashes"][i],
-                results["num_resets"][i],
-                results["num_soft_bricked"][i] if "num_soft_bricked" in results else 0,
-                results["num_hard_bricked"][i] if "num_hard_bricked" in results else 0,
-                results["num_skipped"][i]      if "num_skipped" in results else 0,
-            ) for i in range(len(self.positions_xy))
-        ]
+        # Color points based on results (one RGBA array for all points)
+        num_positions = len(self.positions_xy)
+        self._colors, self._edgecolors = self._point_colors(results, num_positions)
 
-        # Highlight points where exeutions were skipped with pink perimeter
-        if "num_skipped" in results:
-            edgecolors_list = [
-                ("#F80BD8" if num_skipped > 0 else "black") for num_skipped in results["num_skipped"]
-            ]
+        if self._first_plot_update:
+            self._setup_axes()
         else:
-            edgecolors_list = "black"
-
-        # Create scatter plot
-        self.scat = self.ax.scatter(xs, ys, c=colors_list, s=120, linewidths=2, edgecolors=edgecolors_list)
+            # Config flip: axes, legend and artist survive - only the
+            # color arrays change, blitted onto the cached background
+            self._apply_current_colors()
+
+    def _setup_axes(self):
+        """One-time axes construction: static labels/legend/limits, the
+        initial level-of-detail render, pan/zoom callbacks and the blit
+        setup. Everything per-config afterwards is just artist colors."""
+        self.scat = None
+        self._lod_image = None
+        self._visible_indices = None
+        self._in_lod_render = False
+        self._blit_background = None
+        self._render_lod(full_extent=True)
+        if self._cluster_regions:
+            # Static overlay: outlines live in the blit background, so
+            # config flips and point updates never touch them
+            from .fault_clusters import overlay_outlines
+            overlay_outlines(self.ax, self._cluster_regions)
+        self.ax.autoscale_view()
+        self.ax.set_autoscale_on(False)
+        self.ax.callbacks.connect('xlim_changed', self._on_limits_change)
+        self.ax.callbacks.connect('ylim_changed', self._on_limits_change)
         self.ax.set_xlabel("X")
         self.ax.set_ylabel("Y")
-        self.ax.set_title(f"Fault Injection Point Matrix (Config {self.current_config_index})")
+        # Static title - the config spinbox shows the selected config, so
+        # config flips leave the whole background untouched
+        self.ax.set_title(self.AXES_TITLE)
         self.ax.set_aspect('equal', 'box')
         self.ax.invert_yaxis()
 
         # Add legend
-        legend_elements = [
-            Patch(facecolor='green', edgecolor='black', label='Normal operation'),
-            Patch(facecolor='#ff0000', edgecolor='black', label='Faults'),
-            Patch(facecolor='#0000ff', edgecolor='black', label='Resets & Crashes'),
-            # Patch(facecolor='gray', edgecolor='black', label='No data')
-        ]
         # self.ax.legend(handles=legend_elements, bbox_to_anchor=(1.05, 1), loc='upper left')
-
         self.ax.legend(
-            handles=legend_elements,
+            handles=self._legend_elements(),
             bbox_to_anchor=(0.5, -0.15),
             loc='upper center',
             ncol=3,
             borderaxespad=0.5
         )
 
-        # Connect click event
-        self.canvas.mpl_connect('pick_event', self.on_point_click)
-        self.scat.set_picker(True)  # Enable picking on the scatter plot
-
+        # Recapture the blit background after every full draw (resize,
+        # zoom, ...); the animated point artist is excluded from those
+        # draws and painted on top here and in _blit()
+        self.canvas.mpl_connect('draw_event', self._on_draw)
 
         # Critical steps to make Tkinter respect the new layout:
         # 1. First draw the canvas to calculate sizes
         self.canvas.draw()
 
-        if self._first_plot_update:
-            # 2. Adjust the figure size to include legend space
-            fig_width, fig_height = self.fig.get_size_inches()
-            legend_height = 0.4  # Inches to allocate for legend
-            self.fig.set_size_inches(fig_width, fig_height + legend_height)
+        # 2. Adjust the figure size to include legend space
+        fig_width, fig_height = self.fig.get_size_inches()
+        legend_height = 0.4  # Inches to allocate for legend
+        self.fig.set_size_inches(fig_width, fig_height + legend_height)
+
+        # 3. Adjust subplot parameters to make room
+        self.fig.subplots_adjust(bottom=0.25)  # Increase bottom margin
+
+        # 4. Force Tkinter to recalculate layout
+        self.canvas.get_tk_widget().update_idletasks()
+        self.root.update_idletasks()
+
+        # 5. Redraw everything
+        self.canvas.draw_idle()
+        self._first_plot_update = False
+
+    def _apply_current_colors(self):
+        """Push self._colors/_edgecolors into the existing artist: the
+        scatter updates in place and blits, the aggregate image is
+        rebuilt from the new colors."""
+        if self.scat is not None and self._visible_indices is not None:
+            self.scat.set_facecolor(self._colors[self._visible_indices])
+            self.scat.set_edgecolor(self._edgecolors[self._visible_indices])
+            self._blit()
+        else:
+            self._render_lod()
+
+    def _draw_dynamic_artist(self):
+        artist = self.scat if self.scat is not None else self._lod_image
+        if artist is not None:
+            self.ax.draw_artist(artist)
 
-            # 3. Adjust subplot parameters to make room
-            self.fig.subplots_adjust(bottom=0.25)  # Increase bottom margin
+    def _on_draw(self, event):
+        self._blit_background = self.canvas.copy_from_bbox(self.ax.bbox)
+        self._draw_dynamic_artist()
 
-            # 4. Force Tkinter to recalculate layout
-            self.canvas.get_tk_widget().update_idletasks()
-            self.root.update_idletasks()
+    def _blit(self):
+        """Redraw only the point artist over the cached background."""
+        if self._blit_background is None:
+            self.canvas.draw()
+            return
+        self.canvas.restore_region(self._blit_background)
+        self._draw_dynamic_artist()
+        self.canvas.blit(self.ax.bbox)
+        self.canvas.flush_events()
+
+    def _on_limits_change(self, ax):
+        """Re-render at the appropriate level of detail after pan/zoom."""
+        if not self._in_lod_render:
+            self._render_lod()
 
-            # 5. Redraw everything
-            self.canvas.draw_idle()
-            self._first_plot_update = False
+    def _render_lod(self, full_extent=False):
+        """
+        Draw the visible region at the appropriate level of detail:
+        a pickable scatter when it holds at most LOD_SCATTER_MAX points,
+        a mean-color density image otherwise. Called for the full extent
+        on config switches and again on every pan/zoom.
+        """
+        self._in_lod_render = True
+        try:
+            if full_extent:
+                visible = np.ones(len(self._xs), dtype=bool)
+            else:
+                x0, x1 = sorted(self.ax.get_xlim())
+                y0, y1 = sorted(self.ax.get_ylim())
+                visible = ((self._xs >= x0) & (self._xs <= x1)
+                           & (self._ys >= y0) & (self._ys <= y1))
+
+            if self.scat is not None:
+                self.scat.remove()
+                self.scat = None
+            if self._lod_image is not None:
+                self._lod_image.remove()
+                self._lod_image = None
+
+            if visible.sum() <= self.LOD_SCATTER_MAX:
+                self._visible_indices = np.flatnonzero(visible)
+                self.scat = self.ax.scatter(
+                    self._xs[visible], self._ys[visible],
+                    c=self._colors[visible], s=120, linewidths=2,
+                    edgecolors=self._edgecolors[visible]
+                )
+                self.scat.set_picker(True)  # Enable picking on the scatter plot
+                self.scat.set_animated(True)  # excluded from full draws, blitted on top
+            else:
+                # Too many points for interactive scatter: aggregate into
+                # an image (no picking until zoomed in to scatter level)
+                self._visible_indices = None
+                self._lod_image = self._draw_density_image(visible)
+                self._lod_image.set_animated(True)
+        finally:
+            self._in_lod_render = False
+        self.canvas.draw_idle()
+
+    def _draw_density_image(self, visible):
+        """Aggregate the visible points into a LOD_IMAGE_BINS² mean-color
+        RGBA image via histogram2d; empty bins stay transparent."""
+        xs = self._xs[visible]
+        ys = self._ys[visible]
+        rgba = self._colors[visible]
+        bins = self.LOD_IMAGE_BINS
+        value_range = [[xs.min(), xs.max()], [ys.min(), ys.max()]]
+
+        counts, xedges, yedges = np.histogram2d(xs, ys, bins=bins, range=value_range)
+        image = np.zeros((bins, bins, 4))
+        for channel in range(4):
+            sums, _, _ = np.histogram2d(
+                xs, ys, bins=bins, range=value_range, weights=rgba[:, channel]
+            )
+            image[..., channel] = np.divide(
+                sums, counts, out=np.zeros_like(sums), where=counts > 0
+            )
+
+        # histogram2d indexes (x, y); imshow wants rows = y
+        image = np.transpose(image, (1, 0, 2))
+        return self.ax.imshow(
+            image,
+            extent=(xedges[0], xedges[-1], yedges[0], yedges[-1]),
+            origin='lower', interpolation='nearest', zorder=0
+        )
 
     def clear_point_details(self):
         """Clear the point details table"""
         for row in self.point_tree.get_children():
             self.point_tree.delete(row)
+        self._pending_children.clear()
         self.point_tree.insert("", "end", text="No point", values=("selected"))
 
+    def _extradata_for_point(self, result_type, result):
+        """Extradata entries of one result type for the selected point.
+        Served from a position-indexed store built once per
+        (config, result_type), so a click is a dict lookup instead of a
+        scan over every record."""
+        cache_key = (self.current_config_index, result_type)
+        store = self._extradata_cache.get(cache_key)
+        if store is None:
+            store = {}
+            for entry in result:
+                store.setdefault(entry["position_index"], []).append(entry["data"])
+            self._extradata_cache[cache_key] = store
+        return store.get(self.current_point_index, [])
+
     def update_point_details_sidebar(self):
         """Update the point details table with information for the given point"""
         # Clear existing rows
         for row in self.point_tree.get_children():
             self.point_tree.delete(row)
+        self._pending_children.clear()
 
         config = self.glitch_configs[self.current_config_index]
         results = config['results']
@@ -333,7 +896,16 @@ class GlitchVisualizer:
             if result_type.startswith("num_"):
                 self._insert_point_param("", result_type, result[self.current_point_index])
             else:
-                extradata = [extradata["data"] for extradata in result if extradata["position_index"] == self.current_point_index]
+                extradata = self._extradata_for_point(result_type, result)
+                if len(extradata) == 1:
+                    extradata = extradata[0]
+                self._insert_point_param("", result_type, extradata)
+
+        # Stream-loaded results: extradata is fetched on demand
+        if self.extradata_loader is not None:
+            fetched = self.extradata_loader(self.current_config_index,
+                                            self.current_point_index)
+            for result_type, extradata in fetched.items():
                 if len(extradata) == 1:
                     extradata = extradata[0]
                 self._insert_point_param("", result_type, extradata)
@@ -343,27 +915,48 @@ class GlitchVisualizer:
 
     def _insert_point_param(self, parent, key, value, tag=None):
         """
-        Recursively insert a key/value into the Treeview.
-        If value is a dict, create child items for each key.
-        If value is a list, create child items for each element.
-        Otherwise, insert as a leaf node.
+        Insert a key/value into the Treeview, virtualized: dict and list
+        values get a collapsed summary node with the element count, and
+        their children are only materialized when the node is expanded
+        (_on_tree_expand). A point with hundreds of fault records inserts
+        a handful of nodes per click instead of the whole subtree.
         """
         if isinstance(value, dict):
             # Parent node for this dict
-            node = self.point_tree.insert(parent, "end", text=str(key), values=("dict",), open=True, tags=(tag,) if tag else ())
-            for k, v in value.items():
-                self._insert_point_param(node, k, v, tag=tag)
+            node = self.point_tree.insert(parent, "end", text=str(key), values=(f"dict[{len(value)}]",), open=False, tags=(tag,) if tag else ())
+            self._defer_children(node, value, tag)
         elif isinstance(value, list):
             # Parent node for list
-            node = self.point_tree.insert(parent, "end", text=str(key), values=(f"list[{len(value)}]",), open=True, tags=(tag,) if tag else ())
-            for i, item in enumerate(value):
-                self._insert_point_param(node, f"{i+1}", item, tag=tag)
+            node = self.point_tree.insert(parent, "end", text=str(key), values=(f"list[{len(value)}]",), open=False, tags=(tag,) if tag else ())
+            self._defer_children(node, value, tag)
         else:
             # Leaf node
             node = self.point_tree.insert(parent, "end", text=str(key), values=(str(value),), tags=(tag,) if tag else ())
 
         return node
 
+    def _defer_children(self, node, value, tag):
+        """Remember a container's children for materialization on expand;
+        the placeholder child makes the expander arrow show up."""
+        if len(value):
+            self._pending_children[node] = (value, tag)
+            self.point_tree.insert(node, "end", text="...")
+
+    def _on_tree_expand(self, event):
+        """Materialize the children of a virtualized node on first expand."""
+        node = self.point_tree.focus()
+        pending = self._pending_children.pop(node, None)
+        if pending is None:
+            return
+        value, tag = pending
+        self.point_tree.delete(*self.point_tree.get_children(node))
+        if isinstance(value, dict):
+            for k, v in value.items():
+                self._insert_point_param(node, k, v, tag=tag)
+        else:
+            for i, item in enumerate(value):
+                self._insert_point_param(node, f"{i+1}", item, tag=tag)
+
 
     def copy_fault_data(self, event):
         """Copy selected fault data to clipboard"""
@@ -387,18 +980,155 @@ class GlitchVisualizer:
             return  # Not a valid pick event
 
         point_index = event.ind[0]  # Get the index of the clicked point
+        if self._visible_indices is not None:
+            # Scatter holds only the visible subset at this zoom level;
+            # map the artist index back to the position index
+            point_index = int(self._visible_indices[point_index])
         self.last_clicked_index = point_index
 
         self.current_point_index = point_index
         self.update_point_details_sidebar()
 
-def main():
-    json_path = DEFAULT_JSON_PATH
-    if len(sys.argv) > 1:
-        json_path = sys.argv[1]
+    def follow(self, stream_path):
+        """Start follow mode: tail the profiler's stream log and update
+        point colors in place as execution records arrive."""
+        self._follow_stream_path = stream_path
+        self._follow_offset = 0
+        self._follow_buffer = ""
+        self.root.title("Glitch Visualizer (following)")
+        self.root.after(FOLLOW_POLL_MS, self._poll_follow)
+
+    def _poll_follow(self):
+        """Ingest stream records appended since the last poll."""
+        try:
+            with open(self._follow_stream_path) as f:
+                f.seek(self._follow_offset)
+                chunk = f.read()
+                self._follow_offset = f.tell()
+        except OSError:
+            chunk = ""  # log not created yet / temporarily unreadable
+
+        if chunk:
+            self._follow_buffer += chunk
+            lines = self._follow_buffer.split("\n")
+            # Keep a partially flushed trailing record for the next poll
+            self._follow_buffer = lines.pop()
+            current_config_dirty = False
+            for line in lines:
+                try:
+                    record = json.loads(line)
+                except ValueError:
+                    continue
+                if self._ingest_follow_record(record):
+                    current_config_dirty = True
+            if current_config_dirty:
+                self._refresh_point_colors()
+
+        self.root.after(FOLLOW_POLL_MS, self._poll_follow)
+
+    def _ingest_follow_record(self, record):
+        """Book one stream record into the in-memory results. Returns
+        whether it touched the currently displayed config."""
+        config_index = record["config_index"]
+        position_index = record["position_index"]
+        category = record["result_category"]
+        if (config_index >= len(self.glitch_configs)
+                or position_index >= len(self.positions)):
+            # Adaptive refinement grows the grid mid-campaign; positions
+            # beyond the checkpointed header only show up after a restart
+            return False
+
+        results = self.glitch_configs[config_index]["results"]
+        counters = results.setdefault(
+            f"num_{category}", [0] * len(self.positions)
+        )
+        counters[position_index] += 1
+        if "data" in record:
+            # Same {position_index, data} list shape store_results writes,
+            # so the point-details sidebar works unchanged
+            results.setdefault(category, []).append(
+                {"position_index": position_index, "data": record["data"]}
+            )
+            # The position-indexed sidebar store for this category is
+            # stale now; it is rebuilt on the next click
+            self._extradata_cache.pop((config_index, category), None)
+        return config_index == self.current_config_index
+
+    def _refresh_point_colors(self):
+        """Recolor the displayed points in place - no axes clear, no new
+        artists - so follow updates stay cheap at any campaign size."""
+        results = self.glitch_configs[self.current_config_index]["results"]
+        self._colors, self._edgecolors = self._point_colors(results, len(self.positions))
+        self._apply_current_colors()
+
+class GlitchDiffVisualizer(GlitchVisualizer):
+    """Diff view over two campaigns (visualize.py --diff A B): point
+    color is the signed change in fault rate at each aligned position -
+    red where campaign B faults more, blue where it faults less, gray
+    where either side has no executions."""
+
+    AXES_TITLE = "Fault Rate Delta (B - A)"
+
+    def __init__(self, root, diff_data):
+        super().__init__(root, diff_data)
+        root.title("Glitch Visualizer (diff)")
+
+    def _point_colors(self, results, num_positions):
+        delta = np.asarray(results["num_fault_rate_delta"], dtype=float)
+        rgba = plt.get_cmap("coolwarm")((np.clip(delta, -1, 1) + 1) / 2)
+        no_data = ((_counter_array(results, "num_executions_a", num_positions) == 0)
+                   | (_counter_array(results, "num_executions_b", num_positions) == 0))
+        rgba[no_data] = colors.to_rgba("gray")
+        edgecolors = np.tile(np.asarray(colors.to_rgba("black")), (num_positions, 1))
+        return rgba, edgecolors
+
+    def _legend_elements(self):
+        return [
+            Patch(facecolor=plt.get_cmap("coolwarm")(1.0), edgecolor='black', label='More faults in B'),
+            Patch(facecolor=plt.get_cmap("coolwarm")(0.5), edgecolor='black', label='No change'),
+            Patch(facecolor=plt.get_cmap("coolwarm")(0.0), edgecolor='black', label='Fewer faults in B'),
+        ]
 
-    with open(json_path, 'r') as f:
-        data = json.load(f)
+def main():
+    # visualize.py [--follow] [--clusters] [results_N.json[.gz] | checkpoint_N.json]
+    # visualize.py --diff <results_A> <results_B>
+    # visualize.py --merge <results...> (e.g. the *_partial.json sequence)
+    args = [arg for arg in sys.argv[1:] if not arg.startswith('--')]
+    follow = '--follow' in sys.argv[1:]
+    diff = '--diff' in sys.argv[1:]
+    merge = '--merge' in sys.argv[1:]
+    clusters = '--clusters' in sys.argv[1:]
+    json_path = args[0] if args else DEFAULT_JSON_PATH
+
+    stream_path = None
+    extradata_loader = None
+    heatmaps = None
+    if diff:
+        if len(args) < 2:
+            print("usage: visualize.py --diff <results_A> <results_B>")
+            sys.exit(1)
+        data = load_diff_data(args[0], args[1])
+    elif merge:
+        if len(args) < 2:
+            print("usage: visualize.py --merge <results...>")
+            sys.exit(1)
+        data, extradata_loader = load_merged_results(args)
+    elif follow:
+        # Live mode: campaign header from the running campaign's
+        # checkpoint, counters filled by tailing its stream log
+        data, stream_path = load_follow_data(json_path)
+        if not stream_path:
+            print(f"{json_path} records no stream log, cannot follow")
+            sys.exit(1)
+    else:
+        data, extradata_loader = load_results(json_path)
+        heatmaps = compute_or_load_heatmaps(json_path, data)
+
+    regions = None
+    if clusters and not diff:
+        from .fault_clusters import regions_from_results
+        _, regions = regions_from_results(data)
+        print(f"Fault clustering: {len(regions)} regions")
 
     root = tk.Tk()
     # root.attributes("-fullscreen", True)  # substitute `Tk` for whatever your `Tk()` object is called
@@ -419,7 +1149,13 @@ def main():
     signal.signal(signal.SIGINT, sigint_handler)
 
     # Display GlitchVisualizer App
-    app = GlitchVisualizer(root, data)
+    if diff:
+        app = GlitchDiffVisualizer(root, data)
+    else:
+        app = GlitchVisualizer(root, data, extradata_loader=extradata_loader,
+                               heatmaps=heatmaps, regions=regions)
+    if follow:
+        app.follow(stream_path)
 
     try:
         root.mainloop()